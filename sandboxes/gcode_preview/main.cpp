@@ -0,0 +1,150 @@
+#include <iostream>
+#include <string>
+#include <cstdio>
+#include <cmath>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/nowide/cstdio.hpp>
+
+#include "libslic3r/GCode/GCodeProcessor.hpp"
+#include "libslic3r/GCode/PreviewGeometry.hpp"
+#include "libslic3r/LocalesUtils.hpp"
+
+#include "libnest2d/tools/benchmark.h"
+
+const std::string USAGE_STR = {
+    "Usage: gcode_preview [gcodefile.gcode]\n"
+    "Measures the build of the G-code preview geometry of the layers, sequential and in parallel.\n"
+    "A synthetic G-code is generated if no file is given."
+};
+
+namespace Slic3r {
+
+static std::string make_gcode(size_t layers)
+{
+    std::string gcode = "G90\nM83\nM104 S220\nM140 S60\nG28\n";
+    char buf[128];
+    for (size_t layer = 0; layer < layers; ++ layer) {
+        gcode += "; CHANGE_LAYER\n; Z_HEIGHT: ";
+        gcode += std::to_string(0.2 * (layer + 1));
+        gcode += "\n; FEATURE: Outer wall\n; LINE_WIDTH: 0.42\n";
+        snprintf(buf, sizeof(buf), "G1 Z%.2f F600\n", 0.2 * (layer + 1));
+        gcode += buf;
+        for (int i = 0; i < 5000; ++ i) {
+            if (i % 500 == 0) {
+                snprintf(buf, sizeof(buf), "G1 E-0.8 F1800\nG0 X%.3f Y%.3f F9000\nG1 E0.8 F1800\n", 100. + 20. * std::cos(i), 100. + 20. * std::sin(i));
+                gcode += buf;
+            }
+            snprintf(buf, sizeof(buf), "G1 X%.3f Y%.3f E%.5f F3000\n", 100. + 20. * std::cos(0.01 * i), 100. + 20. * std::sin(0.01 * i), 0.01);
+            gcode += buf;
+        }
+    }
+    return gcode;
+}
+
+// The layers of the preview split as the G-code viewer does: a layer spans the moves from the last travel
+// before its first extrusion to its last move before a travel, the seams are attached to the previous move.
+static std::vector<GCodePreview::LayerGeometry> split_layers(const GCodeProcessorResult &result, std::vector<size_t> &sid_to_mid,
+                                                             std::vector<std::vector<size_t>> &sid_to_seam_mids)
+{
+    std::vector<GCodePreview::LayerGeometry> layers;
+    float  last_z           = 0.f;
+    size_t last_travel_s_id = 0;
+    for (size_t i = 0; i < result.moves.size(); ++ i) {
+        const GCodeProcessorResult::MoveVertex &move = result.moves[i];
+        if (move.type == EMoveType::Seam) {
+            if (! sid_to_seam_mids.empty())
+                sid_to_seam_mids.back().emplace_back(i);
+            continue;
+        }
+        const uint32_t sid = uint32_t(sid_to_mid.size());
+        sid_to_mid.emplace_back(i);
+        sid_to_seam_mids.emplace_back();
+        if (move.type == EMoveType::Extrude) {
+            if (layers.empty() || std::abs(move.position.z() - last_z) > EPSILON) {
+                layers.emplace_back();
+                layers.back().start_sid = uint32_t(last_travel_s_id);
+                last_z = move.position.z();
+            }
+            layers.back().end_sid = sid;
+        } else if (move.type == EMoveType::Travel) {
+            if (sid > last_travel_s_id && ! layers.empty())
+                layers.back().end_sid = sid;
+            last_travel_s_id = sid;
+        }
+    }
+    return layers;
+}
+
+static void measure_preview(const std::string &path)
+{
+    GCodeProcessor processor;
+    processor.apply_config(FullPrintConfig::defaults());
+    processor.process_file(path);
+    const GCodeProcessorResult &result = processor.get_result();
+
+    std::vector<size_t> sid_to_mid;
+    std::vector<std::vector<size_t>> sid_to_seam_mids;
+    const std::vector<GCodePreview::LayerGeometry> layers = split_layers(result, sid_to_mid, sid_to_seam_mids);
+
+    Benchmark b;
+    std::vector<GCodePreview::LayerGeometry> sequential = layers;
+    b.start();
+    for (GCodePreview::LayerGeometry &layer : sequential)
+        GCodePreview::build_layer_geometry(layer, sid_to_mid, sid_to_seam_mids, result);
+    b.stop();
+    const double sequential_ms = b.getElapsedSec() * 1e3;
+
+    std::vector<GCodePreview::LayerGeometry> parallel = layers;
+    b.start();
+    GCodePreview::build_layers_geometry(parallel, sid_to_mid, sid_to_seam_mids, result);
+    b.stop();
+    const double parallel_ms = b.getElapsedSec() * 1e3;
+
+    size_t segments = 0;
+    bool   same     = true;
+    for (size_t i = 0; i < layers.size(); ++ i) {
+        segments += parallel[i].segments.size();
+        same &= parallel[i].segments.size() == sequential[i].segments.size() &&
+                parallel[i].position_data.size() == sequential[i].position_data.size();
+    }
+
+    std::cout << "Preview geometry of " << result.moves.size() << " moves, " << layers.size() << " layers, " << segments << " segments\n";
+    std::cout << "  sequential: " << sequential_ms << " ms\n";
+    std::cout << "  parallel:   " << parallel_ms << " ms\n";
+    if (! same)
+        std::cout << "  the parallel build differs from the sequential one!\n";
+}
+
+} // namespace Slic3r
+
+int main(const int argc, const char *argv[])
+{
+    using namespace Slic3r;
+
+    if (argc > 2) {
+        std::cout << USAGE_STR << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    CNumericLocalesSetter locales_setter;
+    std::string path;
+    bool        temporary = argc < 2;
+    if (temporary) {
+        path = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("gcode-%%%%-%%%%.gcode")).string();
+        const std::string gcode = make_gcode(500);
+        FILE *f = boost::nowide::fopen(path.c_str(), "wb");
+        if (f == nullptr)
+            return EXIT_FAILURE;
+        fwrite(gcode.data(), 1, gcode.size(), f);
+        fclose(f);
+    } else
+        path = argv[1];
+
+    measure_preview(path);
+
+    if (temporary)
+        boost::filesystem::remove(path);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,175 @@
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <memory>
+#include <functional>
+#include <cstdio>
+#include <algorithm>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/nowide/cstdio.hpp>
+
+#include "libslic3r/GCode/GCodeProcessor.hpp"
+#include "libslic3r/LocalesUtils.hpp"
+
+#include "libnest2d/tools/benchmark.h"
+
+const std::string USAGE_STR = {
+    "Usage: gcode_processor [gcodefile.gcode]\n"
+    "Measures the per line cost of the command dispatch and of the G-code processing.\n"
+    "A synthetic G-code is generated if no file is given."
+};
+
+namespace Slic3r {
+
+// The dispatch of CommandProcessor before the dense table: a trie with a hash map per character.
+class TrieDispatcher
+{
+    struct TrieNode {
+        CommandProcessor::command_handler_t handler{ nullptr };
+        std::unordered_map<char, std::unique_ptr<TrieNode>> children;
+    };
+    TrieNode root;
+
+public:
+    void register_command(const std::string &str, CommandProcessor::command_handler_t handler)
+    {
+        TrieNode *node = &root;
+        for (char ch : str) {
+            std::unique_ptr<TrieNode> &child = node->children[ch];
+            if (!child)
+                child = std::make_unique<TrieNode>();
+            node = child.get();
+        }
+        node->handler = handler;
+    }
+
+    bool process_comand(std::string_view cmd, const GCodeReader::GCodeLine &line)
+    {
+        const TrieNode *node = &root;
+        for (char ch : cmd) {
+            auto it = node->children.find(ch);
+            if (it == node->children.end())
+                return false;
+            node = it->second.get();
+        }
+        if (!node->handler)
+            return false;
+        node->handler(line);
+        return true;
+    }
+};
+
+static std::string make_gcode(size_t layers)
+{
+    std::string gcode = "G90\nM83\nM104 S220\nM140 S60\nG28\n";
+    char buf[128];
+    for (size_t layer = 0; layer < layers; ++ layer) {
+        gcode += "; CHANGE_LAYER\n; Z_HEIGHT: ";
+        gcode += std::to_string(0.2 * (layer + 1));
+        gcode += "\n; FEATURE: Outer wall\n; LINE_WIDTH: 0.42\n";
+        snprintf(buf, sizeof(buf), "G1 Z%.2f F600\nM106 S255\nM204 S5000\n", 0.2 * (layer + 1));
+        gcode += buf;
+        for (int i = 0; i < 1000; ++ i) {
+            snprintf(buf, sizeof(buf), "G1 X%.3f Y%.3f E%.5f F3000\n", 100. + (i % 37), 100. + (i % 41), 0.02 + 0.001 * (i % 7));
+            gcode += buf;
+            if (i % 100 == 0)
+                gcode += "G1 E-0.8 F1800\nG0 X120 Y120 F9000\nG1 E0.8 F1800\n";
+        }
+    }
+    return gcode;
+}
+
+static void measure_dispatch(const std::string &gcode)
+{
+    static const char *commands[] = { "G0", "G1", "G2", "G3", "G4", "G28", "G90", "G91", "G92", "M82", "M83", "M104", "M106",
+                                      "M107", "M109", "M140", "M190", "M201", "M203", "M204", "M205", "M221", "M400", "M1020" };
+    size_t calls = 0;
+    auto handler = [&calls](const GCodeReader::GCodeLine &) { ++ calls; };
+    CommandProcessor table;
+    TrieDispatcher   trie;
+    for (const char *cmd : commands) {
+        table.register_command(cmd, handler);
+        trie.register_command(cmd, handler);
+    }
+
+    // parse once, only the dispatch is measured
+    std::vector<GCodeReader::GCodeLine> lines;
+    GCodeReader reader;
+    reader.parse_buffer(gcode, [&lines](GCodeReader &, const GCodeReader::GCodeLine &line) { lines.emplace_back(line); });
+
+    Benchmark b;
+    const int repeats = 10;
+    b.start();
+    for (int r = 0; r < repeats; ++ r)
+        for (const GCodeReader::GCodeLine &line : lines)
+            trie.process_comand(line.cmd(), line);
+    b.stop();
+    const double trie_ns = b.getElapsedSec() * 1e9 / double(repeats * lines.size());
+
+    b.start();
+    for (int r = 0; r < repeats; ++ r)
+        for (const GCodeReader::GCodeLine &line : lines)
+            table.process_comand(line.cmd(), line);
+    b.stop();
+    const double table_ns = b.getElapsedSec() * 1e9 / double(repeats * lines.size());
+
+    std::cout << "Dispatch of " << lines.size() << " lines (" << calls / 2 / repeats << " handled)\n";
+    std::cout << "  trie:        " << trie_ns << " ns/line\n";
+    std::cout << "  dense table: " << table_ns << " ns/line\n";
+}
+
+static void measure_processing(const std::string &path)
+{
+    size_t lines = 0;
+    {
+        FILE *f = boost::nowide::fopen(path.c_str(), "rb");
+        if (f == nullptr)
+            return;
+        for (int c = fgetc(f); c != EOF; c = fgetc(f))
+            lines += c == '\n';
+        fclose(f);
+    }
+
+    Benchmark b;
+    GCodeProcessor processor;
+    processor.apply_config(FullPrintConfig::defaults());
+    b.start();
+    processor.process_file(path);
+    b.stop();
+    std::cout << "Processing of " << lines << " lines: " << b.getElapsedSec() * 1e9 / double(std::max<size_t>(1, lines)) << " ns/line\n";
+}
+
+} // namespace Slic3r
+
+int main(const int argc, const char *argv[])
+{
+    using namespace Slic3r;
+
+    if (argc > 2) {
+        std::cout << USAGE_STR << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    CNumericLocalesSetter locales_setter;
+    std::string path;
+    bool        temporary = argc < 2;
+    if (temporary) {
+        path = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("gcode-%%%%-%%%%.gcode")).string();
+        const std::string gcode = make_gcode(200);
+        FILE *f = boost::nowide::fopen(path.c_str(), "wb");
+        if (f == nullptr)
+            return EXIT_FAILURE;
+        fwrite(gcode.data(), 1, gcode.size(), f);
+        fclose(f);
+        measure_dispatch(gcode);
+    } else
+        path = argv[1];
+
+    measure_processing(path);
+
+    if (temporary)
+        boost::filesystem::remove(path);
+    return EXIT_SUCCESS;
+}
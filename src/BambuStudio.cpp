@@ -20,9 +20,12 @@
 #include <cstdio>
 #include <string>
 #include <cstring>
+#include <exception>
 #include <iomanip>
 #include <iostream>
+#include <list>
 #include <math.h>
+#include <mutex>
 #include <regex>
 #include "nlohmann/json.hpp"
 
@@ -44,12 +47,16 @@ using namespace nlohmann;
 #include <boost/dll/runtime_symbol_info.hpp>
 #include <boost/log/trivial.hpp>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
 #include "unix/fhs.hpp"  // Generated by CMake from ../platform/unix/fhs.hpp.in
 
 #include "libslic3r/libslic3r.h"
 #include "libslic3r/Config.hpp"
 #include "libslic3r/Geometry.hpp"
 #include "libslic3r/GCode/PostProcessor.hpp"
+#include "libslic3r/GCode/ThumbnailRasterizer.hpp"
 #include "libslic3r/Model.hpp"
 #include "libslic3r/ModelArrange.hpp"
 #include "libslic3r/Platform.hpp"
@@ -231,6 +238,43 @@ typedef struct _sliced_info {
     std::vector<std::string> downward_machines;
     std::vector<std::string> upward_compatibility_taint;
 }sliced_info_t;
+
+//result of Print::process() of a plate processed together with the other plates, used by the following export of the plate
+typedef struct _processed_plate_result {
+    bool processed {false};
+    long long process_time {0};
+    std::unordered_map<std::string, long long> slice_time;
+    std::vector<PrintBase::SlicingStatus> slicing_warnings;
+    std::exception_ptr exception;
+}processed_plate_result_t;
+
+//model part loaded for the software thumbnail renderer, the counterpart of a GLVolume in glvolume_collection
+typedef struct _cpu_thumbnail_volume {
+    ThumbnailRasterizer::Mesh mesh;
+    //painted parts are rendered per filament, except for picking
+    std::vector<ThumbnailRasterizer::Mesh> color_meshes;
+    BoundingBoxf3 bounding_box;
+    bool printable {true};
+}cpu_thumbnail_volume_t;
+
+static ThumbnailRasterizer::View cpu_thumbnail_view(Slic3r::GUI::Camera::ViewAngleType view_angle)
+{
+    switch (view_angle) {
+    case Slic3r::GUI::Camera::ViewAngleType::Iso_1:     return ThumbnailRasterizer::View::Iso_1;
+    case Slic3r::GUI::Camera::ViewAngleType::Iso_2:     return ThumbnailRasterizer::View::Iso_2;
+    case Slic3r::GUI::Camera::ViewAngleType::Iso_3:     return ThumbnailRasterizer::View::Iso_3;
+    case Slic3r::GUI::Camera::ViewAngleType::Top_Front: return ThumbnailRasterizer::View::TopFront;
+    case Slic3r::GUI::Camera::ViewAngleType::Left:      return ThumbnailRasterizer::View::Left;
+    case Slic3r::GUI::Camera::ViewAngleType::Right:     return ThumbnailRasterizer::View::Right;
+    case Slic3r::GUI::Camera::ViewAngleType::Top:       return ThumbnailRasterizer::View::Top;
+    case Slic3r::GUI::Camera::ViewAngleType::Bottom:    return ThumbnailRasterizer::View::Bottom;
+    case Slic3r::GUI::Camera::ViewAngleType::Front:     return ThumbnailRasterizer::View::Front;
+    case Slic3r::GUI::Camera::ViewAngleType::Rear:      return ThumbnailRasterizer::View::Rear;
+    case Slic3r::GUI::Camera::ViewAngleType::Top_Plate: return ThumbnailRasterizer::View::TopPlate;
+    default:                                            return ThumbnailRasterizer::View::Iso;
+    }
+}
+
 std::vector<PrintBase::SlicingStatus> g_slicing_warnings;
 
 static void append_feature_type_time(std::vector<feature_type_time_t>& feature_type_times, const std::string& name, float time)
@@ -1674,9 +1718,9 @@ int CLI::run(int argc, char **argv)
     PlateDataPtrs plate_data_src;
     std::vector<plate_obj_size_info_t> plate_obj_size_infos;
     //int arrange_option;
-    int plate_to_slice = 0, filament_count = 0, duplicate_count = 0, real_duplicate_count = 0, current_extruder_count = 1, new_extruder_count = 1, current_printer_variant_count = 1, current_print_variant_count = 1, new_printer_variant_count = 1;
+    int plate_to_slice = 0, filament_count = 0, duplicate_count = 0, real_duplicate_count = 0, current_extruder_count = 1, new_extruder_count = 1, current_printer_variant_count = 1, current_print_variant_count = 1, new_printer_variant_count = 1, parallel_plates = 0;
     bool first_file = true, is_bbl_3mf = false, need_arrange = true, has_thumbnails = false, up_config_to_date = false, normative_check = true, duplicate_single_object = false, use_first_fila_as_default = false, minimum_save = false, enable_timelapse = false, has_support = false, estimate_mode = false;
-    bool allow_rotations = true, skip_modified_gcodes = false, avoid_extrusion_cali_region = false, skip_useless_pick = false, allow_newer_file = false, current_is_multi_extruder = false, new_is_multi_extruder = false, allow_mix_temp = false, enable_wrapping_detect = false;
+    bool allow_rotations = true, skip_modified_gcodes = false, avoid_extrusion_cali_region = false, skip_useless_pick = false, allow_newer_file = false, current_is_multi_extruder = false, new_is_multi_extruder = false, allow_mix_temp = false, enable_wrapping_detect = false, cpu_thumbnails = false;
     Semver file_version;
     Slic3r::GUI::Camera::ViewAngleType camera_view = Slic3r::GUI::Camera::ViewAngleType::Iso;
     std::map<size_t, bool> orients_requirement;
@@ -1752,6 +1796,14 @@ int CLI::run(int argc, char **argv)
     if (camera_view_option)
         camera_view = (Slic3r::GUI::Camera::ViewAngleType)(camera_view_option->value);
 
+    ConfigOptionInt* parallel_plates_option = m_config.option<ConfigOptionInt>("parallel_plates");
+    if (parallel_plates_option)
+        parallel_plates = parallel_plates_option->value;
+
+    ConfigOptionBool* cpu_thumbnails_option = m_config.option<ConfigOptionBool>("cpu_thumbnails");
+    if (cpu_thumbnails_option)
+        cpu_thumbnails = cpu_thumbnails_option->value;
+
     ConfigOptionBool* avoid_extrusion_cali_region_option = m_config.option<ConfigOptionBool>("avoid_extrusion_cali_region");
     if (avoid_extrusion_cali_region_option)
         avoid_extrusion_cali_region = avoid_extrusion_cali_region_option->value;
@@ -6212,7 +6264,9 @@ int CLI::run(int argc, char **argv)
     p_opengl_mgr->set_legacy_framebuffer_enabled(false);
     std::shared_ptr<GLShaderProgram> shader = nullptr;
     GLVolumeCollection glvolume_collection;
-    bool opengl_valid = false;
+    bool opengl_valid = false, thumbnails_valid = false;
+    std::vector<cpu_thumbnail_volume_t> cpu_thumbnail_volumes;
+    std::list<indexed_triangle_set> cpu_thumbnail_painted_meshes;
     const ConfigOptionStrings* filament_color = dynamic_cast<const ConfigOptionStrings *>(m_print_config.option("filament_colour"));
     std::vector<std::string> colors;
     if (filament_color) {
@@ -6332,6 +6386,120 @@ int CLI::run(int argc, char **argv)
         BOOST_LOG_TRIVIAL(info) << boost::format("init_opengl_and_colors finished, gl_valid=%1%")%gl_valid;
         return gl_valid;
     };
+    //load the model parts for the software thumbnail renderer, the same way as the glvolume_collection above
+    auto init_cpu_thumbnails = [&colors_out, &cpu_thumbnail_volumes, &cpu_thumbnail_painted_meshes, &filament_color](Model &model, std::vector<std::string>& f_colors) -> bool {
+        unsigned char rgb_color[4] = {};
+        for (const std::string& color : f_colors) {
+            Slic3r::GUI::BitmapCache::parse_color4(color, rgb_color);
+            size_t color_idx = &color - &f_colors.front();
+            colors_out[color_idx] = { float(rgb_color[0]) / 255.f, float(rgb_color[1]) / 255.f, float(rgb_color[2]) / 255.f, float(rgb_color[3]) / 255.f };
+        }
+
+        int obj_extruder_id = 1, volume_extruder_id = 1;
+        for (unsigned int obj_idx = 0; obj_idx < (unsigned int)model.objects.size(); ++ obj_idx) {
+            const ModelObject &model_object = *model.objects[obj_idx];
+            const ConfigOption* option = model_object.config.option("extruder");
+            if (option)
+                obj_extruder_id = (dynamic_cast<const ConfigOptionInt *>(option))->getInt();
+            else
+                obj_extruder_id = 1;
+            for (int volume_idx = 0; volume_idx < (int)model_object.volumes.size(); ++ volume_idx) {
+                const ModelVolume &model_volume = *model_object.volumes[volume_idx];
+                //modifiers are never rendered into the thumbnails
+                if (!model_volume.is_model_part())
+                    continue;
+                option = model_volume.config.option("extruder");
+                if (option)
+                    volume_extruder_id = (dynamic_cast<const ConfigOptionInt *>(option))->getInt();
+                else
+                    volume_extruder_id = obj_extruder_id;
+
+                std::string color = filament_color?filament_color->get_at(volume_extruder_id - 1):"#00FF00FF";
+                Slic3r::GUI::BitmapCache::parse_color4(color, rgb_color);
+                std::array<float, 4> volume_color = { float(rgb_color[0]) / 255.f, float(rgb_color[1]) / 255.f, float(rgb_color[2]) / 255.f, float(rgb_color[3]) / 255.f };
+
+                std::vector<const indexed_triangle_set*> painted_meshes;
+                if (!model_volume.mmu_segmentation_facets.empty()) {
+                    std::vector<indexed_triangle_set> its_per_color;
+                    model_volume.mmu_segmentation_facets.get_facets(model_volume, its_per_color);
+                    for (indexed_triangle_set &its : its_per_color) {
+                        cpu_thumbnail_painted_meshes.emplace_back(std::move(its));
+                        painted_meshes.push_back(&cpu_thumbnail_painted_meshes.back());
+                    }
+                }
+
+                for (int instance_idx = 0; instance_idx < (int)model_object.instances.size(); ++ instance_idx) {
+                    const ModelInstance &model_instance = *model_object.instances[instance_idx];
+                    cpu_thumbnail_volume_t volume;
+                    volume.mesh.its         = &model_volume.mesh().its;
+                    volume.mesh.trafo       = model_instance.get_matrix() * model_volume.get_matrix();
+                    volume.mesh.color       = volume_color;
+                    volume.mesh.extruder_id = model_volume.extruder_id();
+                    volume.mesh.picking_id  = (unsigned int)((model_instance.loaded_id > 0) ? model_instance.loaded_id : model_instance.id().id);
+                    volume.bounding_box     = model_volume.mesh().transformed_bounding_box(volume.mesh.trafo);
+                    volume.printable        = model_instance.printable;
+                    for (size_t color_idx = 0; color_idx < painted_meshes.size(); ++color_idx) {
+                        if (painted_meshes[color_idx]->indices.empty())
+                            continue;
+                        //same filament as GLVolume::simple_render()
+                        int extruder_id = (color_idx == 0) ? model_volume.extruder_id() : (int)color_idx;
+                        if ((extruder_id <= 0) || (extruder_id > (int)colors_out.size()))
+                            extruder_id = 1;
+                        ThumbnailRasterizer::Mesh color_mesh = volume.mesh;
+                        color_mesh.its         = painted_meshes[color_idx];
+                        color_mesh.color       = colors_out[extruder_id - 1];
+                        color_mesh.extruder_id = extruder_id;
+                        volume.color_meshes.push_back(color_mesh);
+                    }
+                    cpu_thumbnail_volumes.push_back(std::move(volume));
+                }
+            }
+        }
+        BOOST_LOG_TRIVIAL(info) << boost::format("init_cpu_thumbnails finished, volumes count %1%")%cpu_thumbnail_volumes.size();
+        return true;
+    };
+    //OpenGL is tried first unless cpu_thumbnails is set, the software renderer is also used when no OpenGL context can be created
+    auto init_thumbnails = [&opengl_valid, &cpu_thumbnails, &init_opengl_and_colors, &init_cpu_thumbnails](Model &model, std::vector<std::string>& f_colors) -> bool {
+        if (!cpu_thumbnails) {
+            opengl_valid = init_opengl_and_colors(model, f_colors);
+            if (opengl_valid)
+                return true;
+            BOOST_LOG_TRIVIAL(warning) << "opengl not available, render thumbnails on cpu" << std::endl;
+        }
+        return init_cpu_thumbnails(model, f_colors);
+    };
+    auto render_thumbnail = [&p_opengl_mgr, &partplate_list, &glvolume_collection, &colors_out, &shader, &opengl_valid, &cpu_thumbnail_volumes](ThumbnailData& thumbnail_data,
+        unsigned int w, unsigned int h, const ThumbnailsParams& thumbnail_params, Model& model,
+        Slic3r::GUI::Camera::ViewAngleType camera_view_angle, bool for_picking, bool ban_light) {
+        if (opengl_valid) {
+            Slic3r::GUI::GLCanvas3D::render_thumbnail_framebuffer(p_opengl_mgr, thumbnail_data,
+                w, h, thumbnail_params,
+                partplate_list, model.objects, glvolume_collection, colors_out, shader, Slic3r::GUI::Camera::EType::Ortho, camera_view_angle, for_picking, ban_light);
+            return;
+        }
+
+        BoundingBoxf3 plate_box = partplate_list.get_plate(thumbnail_params.plate_id)->get_build_volume();
+        BoundingBoxf3 contain_box = plate_box;
+        contain_box.min(2) = -1e10;
+        std::vector<ThumbnailRasterizer::Mesh> meshes;
+        for (const cpu_thumbnail_volume_t& volume : cpu_thumbnail_volumes) {
+            //same as GLCanvas3D::is_volume_in_plate_boundingbox()
+            if (thumbnail_params.use_plate_box && (!volume.printable || !contain_box.contains(volume.bounding_box) || (volume.bounding_box.max(2) <= 0)))
+                continue;
+            if (for_picking || volume.color_meshes.empty())
+                meshes.push_back(volume.mesh);
+            else
+                meshes.insert(meshes.end(), volume.color_meshes.begin(), volume.color_meshes.end());
+        }
+
+        ThumbnailRasterizer::Params params;
+        params.view = cpu_thumbnail_view(camera_view_angle);
+        params.mode = for_picking ? ThumbnailRasterizer::Mode::Picking : (ban_light ? ThumbnailRasterizer::Mode::NoLight : ThumbnailRasterizer::Mode::Shaded);
+        params.background_color = thumbnail_params.background_color;
+        params.plate_box = plate_box;
+        ThumbnailRasterizer::render(thumbnail_data, w, h, meshes, params);
+        BOOST_LOG_TRIVIAL(info) << boost::format("render_thumbnail on cpu: plate_idx %1%, meshes count %2%, view %3%, for_picking %4%") % thumbnail_params.plate_id % meshes.size() % (int)camera_view_angle % for_picking;
+    };
 
     for (auto const &opt_key : m_actions) {
         if (opt_key == "help") {
@@ -6472,6 +6640,7 @@ int CLI::run(int argc, char **argv)
                 std::string outfile;
                 //Print       fff_print;
                 std::vector<size_t> plate_triangle_counts(partplate_list.get_plate_count(), 0);
+                std::vector<processed_plate_result_t> processed_plate_results;
 
                 while(!finished)
                 {
@@ -6975,7 +7144,12 @@ int CLI::run(int argc, char **argv)
                             part_plate->set_filament_volume_maps(final_volume_maps);
                         }
 
-                        print->apply(model, new_print_config);
+                        PrintBase::ApplyStatus apply_status = print->apply(model, new_print_config);
+                        if ((apply_status != PrintBase::APPLY_STATUS_UNCHANGED) && (index < processed_plate_results.size()) && processed_plate_results[index].processed) {
+                            //the plate changed since it was processed together with the other plates, process it again
+                            BOOST_LOG_TRIVIAL(warning) << boost::format("plate %1%: changed after the parallel print::process, apply_status %2%")%(index+1) %apply_status;
+                            processed_plate_results[index] = processed_plate_result_t();
+                        }
                         BOOST_LOG_TRIVIAL(info) << boost::format("set no_check to %1%:")%no_check;
                         print->set_no_check_flag(no_check);//BBS
                         StringObjectException warning;
@@ -7093,6 +7267,16 @@ int CLI::run(int argc, char **argv)
                                         BOOST_LOG_TRIVIAL(info) << "plate "<< index+1<< ": finished print::process.";
                                     }
                                 }
+                                else if ((index < processed_plate_results.size()) && processed_plate_results[index].processed) {
+                                    //processed together with the other plates after the pre check
+                                    processed_plate_result_t& plate_result = processed_plate_results[index];
+                                    if (plate_result.exception)
+                                        std::rethrow_exception(plate_result.exception);
+                                    slice_time = plate_result.slice_time;
+                                    start_time -= plate_result.process_time;
+                                    g_slicing_warnings.insert(g_slicing_warnings.end(), plate_result.slicing_warnings.begin(), plate_result.slicing_warnings.end());
+                                    BOOST_LOG_TRIVIAL(info) << boost::format("plate %1%: use the result of the parallel print::process, process time %2% ms.")%(index+1) %plate_result.process_time;
+                                }
                                 else {
                                     print->process(&slice_time);
                                     BOOST_LOG_TRIVIAL(info) << "print::process: first time_using_cache is " << slice_time[TIME_USING_CACHE] << " secs.";
@@ -7147,22 +7331,24 @@ int CLI::run(int argc, char **argv)
                                     }
                                     sliced_plate_info.triangle_count = plate_triangle_counts[index];
 
-                                    auto cli_generate_thumbnails = [&partplate_list, &model, &glvolume_collection, &colors_out, &shader, &p_opengl_mgr](const ThumbnailsParams& params) -> ThumbnailsList{
+                                    auto cli_generate_thumbnails = [&model, &shader, &p_opengl_mgr, &opengl_valid, &render_thumbnail](const ThumbnailsParams& params) -> ThumbnailsList{
                                         ThumbnailsList thumbnails;
-                                        p_opengl_mgr->bind_vao();
-                                        p_opengl_mgr->bind_shader(shader);
+                                        if (opengl_valid) {
+                                            p_opengl_mgr->bind_vao();
+                                            p_opengl_mgr->bind_shader(shader);
+                                        }
                                         for (const Vec2d& size : params.sizes) {
                                             thumbnails.push_back(ThumbnailData());
                                             Point isize(size); // round to ints
                                             ThumbnailData& thumbnail_data = thumbnails.back();
-                                            Slic3r::GUI::GLCanvas3D::render_thumbnail_framebuffer(p_opengl_mgr, thumbnail_data,
-                                                isize.x(), isize.y(), params,
-                                                partplate_list, model.objects, glvolume_collection, colors_out, shader, Slic3r::GUI::Camera::EType::Ortho);
+                                            render_thumbnail(thumbnail_data, isize.x(), isize.y(), params, model, Slic3r::GUI::Camera::ViewAngleType::Iso, false, false);
                                             if (!thumbnails.back().is_valid())
                                                 thumbnails.pop_back();
                                         }
-                                        p_opengl_mgr->unbind_shader();
-                                        p_opengl_mgr->unbind_vao();
+                                        if (opengl_valid) {
+                                            p_opengl_mgr->unbind_shader();
+                                            p_opengl_mgr->unbind_vao();
+                                        }
                                         return thumbnails;
                                     };
 
@@ -7181,9 +7367,9 @@ int CLI::run(int argc, char **argv)
                                         outfile = print_fff->export_gcode(outfile, gcode_result, nullptr);
                                     }
                                     else {
-                                        if (!opengl_valid)
-                                            opengl_valid = init_opengl_and_colors(model, colors);
-                                        outfile = opengl_valid ? print_fff->export_gcode(outfile, gcode_result, cli_generate_thumbnails) : print_fff->export_gcode(outfile, gcode_result, nullptr);
+                                        if (!thumbnails_valid)
+                                            thumbnails_valid = init_thumbnails(model, colors);
+                                        outfile = thumbnails_valid ? print_fff->export_gcode(outfile, gcode_result, cli_generate_thumbnails) : print_fff->export_gcode(outfile, gcode_result, nullptr);
                                     }
                                     slice_time[TIME_USING_CACHE] = slice_time[TIME_USING_CACHE] + ((long long)Slic3r::Utils::get_current_milliseconds_time_utc() - temp_time);
                                     BOOST_LOG_TRIVIAL(info) << "export_gcode finished: time_using_cache update to " << slice_time[TIME_USING_CACHE] << " secs.";
@@ -7425,8 +7611,65 @@ int CLI::run(int argc, char **argv)
                             }
                         }
                     }
-                    if (pre_check&& (partplate_list.get_plate_count() > 1))
+                    if (pre_check&& (partplate_list.get_plate_count() > 1)) {
                         pre_check = false;
+                        //BBS: all the plates have been applied and validated by the pre check,
+                        //process up to parallel_plates of them at once, the export of each plate stays serial
+                        if ((parallel_plates > 1) && !load_slicedata && (printer_technology == ptFFF)) {
+                            std::vector<std::pair<int, Print*>> plate_prints;
+                            for (int index = 0; index < partplate_list.get_plate_count(); index ++)
+                            {
+                                PrintBase* plate_print = nullptr;
+                                Slic3r::GUI::GCodeResult* plate_gcode_result = nullptr;
+                                int plate_print_index;
+                                partplate_list.get_plate(index)->get_print(&plate_print, &plate_gcode_result, &plate_print_index);
+                                Print* plate_print_fff = dynamic_cast<Print*>(plate_print);
+                                if (plate_print_fff && !plate_print_fff->empty())
+                                    plate_prints.emplace_back(index, plate_print_fff);
+                            }
+                            if (!plate_prints.empty()) {
+                                //the brim generation reads these static tables, which only depend on the printer and filament settings shared by all the plates
+                                Model::setExtruderParams(m_print_config, filament_count);
+                                Model::setPrintSpeedTable(m_print_config, plate_prints.front().second->config());
+                            }
+                            BOOST_LOG_TRIVIAL(info) << boost::format("process %1% plates, %2% at once")%plate_prints.size() %parallel_plates;
+
+                            processed_plate_results.assign(partplate_list.get_plate_count(), processed_plate_result_t());
+                            std::mutex warnings_mutex;
+                            for (size_t batch_start = 0; batch_start < plate_prints.size(); batch_start += size_t(parallel_plates)) {
+                                size_t batch_end = std::min(plate_prints.size(), batch_start + size_t(parallel_plates));
+                                tbb::parallel_for(tbb::blocked_range<size_t>(batch_start, batch_end, 1),
+                                    [&plate_prints, &processed_plate_results, &warnings_mutex](const tbb::blocked_range<size_t>& range) {
+                                    for (size_t i = range.begin(); i < range.end(); ++ i) {
+                                        int plate_index = plate_prints[i].first;
+                                        Print* plate_print = plate_prints[i].second;
+                                        processed_plate_result_t& plate_result = processed_plate_results[plate_index];
+                                        //keep the warnings of each plate apart, they are reported by its export
+                                        plate_print->set_status_callback([&plate_result, &warnings_mutex, plate_index](const PrintBase::SlicingStatus& slicing_status) {
+                                            if (slicing_status.warning_step != -1) {
+                                                std::lock_guard<std::mutex> lock(warnings_mutex);
+                                                plate_result.slicing_warnings.push_back(slicing_status);
+                                            }
+                                            BOOST_LOG_TRIVIAL(debug) << boost::format("plate %1%: percent=%2%, warning_step=%3%, message=%4%")%(plate_index+1) %slicing_status.percent %slicing_status.warning_step %slicing_status.text;
+                                        });
+                                        long long process_start_time = (long long)Slic3r::Utils::get_current_milliseconds_time_utc();
+                                        try {
+                                            plate_print->process(&plate_result.slice_time);
+                                        }
+                                        catch (...) {
+                                            plate_result.exception = std::current_exception();
+                                        }
+                                        plate_result.process_time = (long long)Slic3r::Utils::get_current_milliseconds_time_utc() - process_start_time;
+                                        plate_result.processed = true;
+                                        BOOST_LOG_TRIVIAL(info) << boost::format("plate %1%: parallel print::process finished in %2% ms")%(plate_index+1) %plate_result.process_time;
+                                    }
+                                });
+                            }
+                            //the callbacks refer to warnings_mutex, which goes out of scope here
+                            for (auto& plate_print : plate_prints)
+                                plate_print.second->set_status_default();
+                        }
+                    }
                     else
                         finished = true;
                 }//end for partplate
@@ -7623,8 +7866,8 @@ int CLI::run(int argc, char **argv)
         }
 
         if (need_regenerate_thumbnail || need_regenerate_no_light_thumbnail || need_regenerate_top_thumbnail) {
-            if (!opengl_valid)
-                opengl_valid = init_opengl_and_colors(m_models[0], colors);
+            if (!thumbnails_valid)
+                thumbnails_valid = init_thumbnails(m_models[0], colors);
             /*std::vector<std::string> colors;
             if (filament_color) {
                 colors= filament_color->vserialize();
@@ -7741,10 +7984,12 @@ int CLI::run(int argc, char **argv)
                         BOOST_LOG_TRIVIAL(error) << boost::format("can not get shader for rendering thumbnail");
                     }
                     else {*/
-                    if (opengl_valid) {
+                    if (thumbnails_valid) {
                         Model &model = m_models[0];
-                        p_opengl_mgr->bind_vao();
-                        p_opengl_mgr->bind_shader(shader);
+                        if (opengl_valid) {
+                            p_opengl_mgr->bind_vao();
+                            p_opengl_mgr->bind_shader(shader);
+                        }
                         for (int i = 0; i < partplate_list.get_plate_count(); i++) {
                             Slic3r::GUI::PartPlate *part_plate      = partplate_list.get_plate(i);
                             PlateData *plate_data = plate_data_list[i];
@@ -7786,9 +8031,8 @@ int CLI::run(int argc, char **argv)
                                     const ThumbnailsParams thumbnail_params = {{}, false, true, true, true, i};
 
                                     BOOST_LOG_TRIVIAL(info) << boost::format("plate %1%'s thumbnail, need to regenerate")%(i+1);
-                                    Slic3r::GUI::GLCanvas3D::render_thumbnail_framebuffer(p_opengl_mgr, *thumbnail_data,
-                                        thumbnail_width, thumbnail_height, thumbnail_params,
-                                        partplate_list, model.objects, glvolume_collection, colors_out, shader, Slic3r::GUI::Camera::EType::Ortho);
+                                    render_thumbnail(*thumbnail_data, thumbnail_width, thumbnail_height, thumbnail_params, model,
+                                        Slic3r::GUI::Camera::ViewAngleType::Iso, false, false);
                                     BOOST_LOG_TRIVIAL(info) << boost::format("plate %1%'s thumbnail,finished rendering")%(i+1);
                                 }
                             }
@@ -7819,11 +8063,8 @@ int CLI::run(int argc, char **argv)
                                     const ThumbnailsParams thumbnail_params = { {}, false, true, false, true, i };
 
                                     BOOST_LOG_TRIVIAL(info) << boost::format("plate %1%'s no_light_thumbnail_file missed, need to regenerate")%(i+1);
-                                    Slic3r::GUI::GLCanvas3D::render_thumbnail_framebuffer(p_opengl_mgr, *no_light_thumbnail,
-                                        thumbnail_width, thumbnail_height, thumbnail_params,
-                                        partplate_list, model.objects, glvolume_collection, colors_out, shader,
-                                        Slic3r::GUI::Camera::EType::Ortho, Slic3r::GUI::Camera::ViewAngleType::Iso,
-                                        false, true);
+                                    render_thumbnail(*no_light_thumbnail, thumbnail_width, thumbnail_height, thumbnail_params, model,
+                                        Slic3r::GUI::Camera::ViewAngleType::Iso, false, true);
                                     plate_data->no_light_thumbnail_file = "valid_no_light";
                                     BOOST_LOG_TRIVIAL(info) << boost::format("plate %1%'s no_light thumbnail,finished rendering")%(i+1);
                                 }
@@ -7886,17 +8127,13 @@ int CLI::run(int argc, char **argv)
                                         BOOST_LOG_TRIVIAL(info) << boost::format("skip rendering for top&&pick");
                                     }
                                     else {
-                                        const auto fb_type = Slic3r::GUI::OpenGLManager::get_framebuffers_type();
-                                        BOOST_LOG_TRIVIAL(info) << boost::format("framebuffer_type: %1%") % Slic3r::GUI::OpenGLManager::framebuffer_type_to_string(fb_type).c_str();
-                                        Slic3r::GUI::GLCanvas3D::render_thumbnail_framebuffer(p_opengl_mgr, *top_thumbnail,
-                                            thumbnail_width, thumbnail_height, thumbnail_params,
-                                            partplate_list, model.objects, glvolume_collection, colors_out, shader,
-                                            Slic3r::GUI::Camera::EType::Ortho, Slic3r::GUI::Camera::ViewAngleType::Top_Plate,
-                                            false);
-                                        Slic3r::GUI::GLCanvas3D::render_thumbnail_framebuffer(p_opengl_mgr, *picking_thumbnail,
-                                            thumbnail_width, thumbnail_height, thumbnail_params,
-                                            partplate_list, model.objects, glvolume_collection, colors_out, shader,
-                                            Slic3r::GUI::Camera::EType::Ortho,
+                                        if (opengl_valid) {
+                                            const auto fb_type = Slic3r::GUI::OpenGLManager::get_framebuffers_type();
+                                            BOOST_LOG_TRIVIAL(info) << boost::format("framebuffer_type: %1%") % Slic3r::GUI::OpenGLManager::framebuffer_type_to_string(fb_type).c_str();
+                                        }
+                                        render_thumbnail(*top_thumbnail, thumbnail_width, thumbnail_height, thumbnail_params, model,
+                                            Slic3r::GUI::Camera::ViewAngleType::Top_Plate, false, false);
+                                        render_thumbnail(*picking_thumbnail, thumbnail_width, thumbnail_height, thumbnail_params, model,
                                             Slic3r::GUI::Camera::ViewAngleType::Top_Plate, true, true);
                                         plate_data->top_file = "valid_top";
                                         plate_data->pick_file = "valid_pick";
@@ -7911,8 +8148,10 @@ int CLI::run(int argc, char **argv)
                                 BOOST_LOG_TRIVIAL(info) << boost::format("plate %1%: add thumbnail data for top and pick into group")%(i+1);
                             }
                         }
-                        p_opengl_mgr->unbind_shader();
-                        p_opengl_mgr->unbind_vao();
+                        if (opengl_valid) {
+                            p_opengl_mgr->unbind_shader();
+                            p_opengl_mgr->unbind_vao();
+                        }
                     }
                 }
         }
@@ -8183,13 +8422,15 @@ int CLI::run(int argc, char **argv)
         std::vector<ThumbnailData*> thumbnails;
         PlateDataPtrs plate_data_list;
         partplate_list.store_to_3mf_structure(plate_data_list);
-        if (!opengl_valid)
-            opengl_valid = init_opengl_and_colors(m_models[0], colors);
+        if (!thumbnails_valid)
+            thumbnails_valid = init_thumbnails(m_models[0], colors);
 
-        if (opengl_valid) {
+        if (thumbnails_valid) {
             Model& model = m_models[0];
-            p_opengl_mgr->bind_vao();
-            p_opengl_mgr->bind_shader(shader);
+            if (opengl_valid) {
+                p_opengl_mgr->bind_vao();
+                p_opengl_mgr->bind_shader(shader);
+            }
             for (int i = 0; i < partplate_list.get_plate_count(); i++) {
                 Slic3r::GUI::PartPlate* part_plate = partplate_list.get_plate(i);
                 PlateData* plate_data = plate_data_list[i];
@@ -8203,9 +8444,7 @@ int CLI::run(int argc, char **argv)
                     const ThumbnailsParams thumbnail_params = { {}, false, true, true, true, i };
 
                     BOOST_LOG_TRIVIAL(info) << boost::format("plate %1%'s png, need to generate") % (i + 1);
-                    Slic3r::GUI::GLCanvas3D::render_thumbnail_framebuffer(p_opengl_mgr, *thumbnail_data,
-                        thumbnail_width, thumbnail_height, thumbnail_params,
-                        partplate_list, model.objects, glvolume_collection, colors_out, shader, Slic3r::GUI::Camera::EType::Ortho, camera_view);
+                    render_thumbnail(*thumbnail_data, thumbnail_width, thumbnail_height, thumbnail_params, model, camera_view, false, false);
                     BOOST_LOG_TRIVIAL(info) << boost::format("plate %1%'s png,finished rendering") % (i + 1);
 
                     std::string pnf_file = "plate_" + std::to_string(i + 1) + "_" + std::to_string((int)camera_view)+".png";
@@ -8222,8 +8461,10 @@ int CLI::run(int argc, char **argv)
                     }
                 }
             }
-            p_opengl_mgr->unbind_shader();
-            p_opengl_mgr->unbind_vao();
+            if (opengl_valid) {
+                p_opengl_mgr->unbind_shader();
+                p_opengl_mgr->unbind_vao();
+            }
         }
     }
 
@@ -26,6 +26,12 @@
 #include <math.h>
 #include <assert.h>
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <boost/filesystem/path.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
 #include <boost/log/trivial.hpp>
 #include <boost/nowide/cstdio.hpp>
 #include <boost/predef/other/endian.h>
@@ -35,6 +41,10 @@
 
 #include "libslic3r/LocalesUtils.hpp"
 
+#include <fast_float/fast_float.h>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
 #ifndef SEEK_SET
 #error "SEEK_SET not defined"
 #endif
@@ -151,10 +161,264 @@ static FILE *stl_open_count_facets(stl_file *stl, const char *file, unsigned int
   	return fp;
 }
 
+// Write the facet into memory if none of facet vertices is NAN.
+static void stl_add_facet(stl_file *stl, uint32_t idx, const stl_facet &facet, bool &first)
+{
+#if 0
+	// Report close to zero vertex coordinates. Due to the nature of the floating point numbers,
+	// close to zero values may be represented with singificantly higher precision than the rest of the vertices.
+	// It may be worth to round these numbers to zero during loading to reduce the number of errors reported
+	// during the STL import.
+	for (size_t j = 0; j < 3; ++ j) {
+	if (facet.vertex[j](0) > -1e-12f && facet.vertex[j](0) < 1e-12f)
+	    printf("stl_read: facet %d(0) = %e\r\n", j, facet.vertex[j](0));
+	if (facet.vertex[j](1) > -1e-12f && facet.vertex[j](1) < 1e-12f)
+	    printf("stl_read: facet %d(1) = %e\r\n", j, facet.vertex[j](1));
+	if (facet.vertex[j](2) > -1e-12f && facet.vertex[j](2) < 1e-12f)
+	    printf("stl_read: facet %d(2) = %e\r\n", j, facet.vertex[j](2));
+	}
+#endif
+
+	for (size_t j = 0; j < 3; ++j)
+		if (isnan(facet.vertex[j](0)) || isnan(facet.vertex[j](1)) || isnan(facet.vertex[j](2))) {
+			// Leave a zero facet in place, it will be removed as a degenerate one.
+			memset(&stl->facet_start[idx], 0, sizeof(stl_facet));
+			return;
+		}
+	stl->facet_start[idx] = facet;
+	stl_facet_stats(stl, facet, first);
+}
+
+static bool stl_report_progress(ImportstlProgressFn stlFn, uint32_t current, uint32_t total)
+{
+	bool cb_cancel = false;
+	if (stlFn)
+		stlFn(current, total, cb_cancel, model_id, country_code, ml_region, ml_name, ml_id);
+	return ! cb_cancel;
+}
+
+// Read the facets of a binary .STL file. We assume little-endian architecture!
+static bool stl_read_binary_facets(stl_file *stl, const char *data, size_t size, size_t header_size, uint32_t first_facet, bool &first, ImportstlProgressFn stlFn)
+{
+	uint32_t facets_num = stl->stats.number_of_facets;
+	if (size < header_size + size_t(facets_num - first_facet) * SIZEOF_STL_FACET)
+		return false;
+	const char *facets_data = data + header_size;
+	uint32_t unit = facets_num / LOAD_STL_UNIT_NUM + 1;
+	for (uint32_t begin = first_facet; begin < facets_num;) {
+		if (! stl_report_progress(stlFn, begin, facets_num))
+			return false;
+		uint32_t end = std::min(facets_num, (begin / unit + 1) * unit);
+		tbb::parallel_for(tbb::blocked_range<uint32_t>(begin, end, 16384), [stl, facets_data, first_facet](const tbb::blocked_range<uint32_t> &range) {
+			for (uint32_t i = range.begin(); i < range.end(); ++ i) {
+				memcpy(&stl->facet_start[i], facets_data + size_t(i - first_facet) * SIZEOF_STL_FACET, SIZEOF_STL_FACET);
+#if BOOST_ENDIAN_BIG_BYTE
+				// Convert the loaded little endian data to big endian.
+				stl_internal_reverse_quads((char*)&stl->facet_start[i], 48);
+#endif /* BOOST_ENDIAN_BIG_BYTE */
+			}
+		});
+		// The bounding box and the shortest edge are taken in the order of the facets.
+		for (uint32_t i = begin; i < end; ++ i)
+			stl_add_facet(stl, i, stl->facet_start[i], first);
+		begin = end;
+	}
+	return true;
+}
+
+namespace {
+
+inline bool stl_is_space(char c)
+{
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+// Cursor over the text of an ASCII .STL file. It consumes the input the same way as the fscanf() / fgets() calls
+// of the former sequential reader did, including the partial match of a literal.
+struct StlAsciiCursor
+{
+	const char *ptr;
+	const char *end;
+
+	void skip_whitespaces() { while (ptr != end && stl_is_space(*ptr)) ++ ptr; }
+	void skip_line() {
+		ptr = static_cast<const char*>(memchr(ptr, '\n', end - ptr));
+		ptr = ptr ? ptr + 1 : end;
+	}
+	bool match(const char *literal) {
+		for (; *literal != 0; ++ literal, ++ ptr)
+			if (ptr == end || *ptr != *literal)
+				return false;
+		return true;
+	}
+	// Keyword followed by a whitespace, the rest of the line is ignored.
+	bool match_line(const char *keyword) {
+		bool ok = match(keyword) && ptr != end && (*ptr == '\r' || *ptr == '\n' || *ptr == ' ' || *ptr == '\t');
+		skip_line();
+		return ok;
+	}
+	// %31s
+	std::pair<const char*, const char*> token() {
+		skip_whitespaces();
+		const char *begin = ptr;
+		while (ptr != end && ! stl_is_space(*ptr) && ptr - begin < 31)
+			++ ptr;
+		return { begin, ptr };
+	}
+	// %f
+	bool parse_float(float &value) {
+		skip_whitespaces();
+		const char *ptr_end = parse_float(ptr, end, value);
+		if (ptr_end == nullptr)
+			return false;
+		ptr = ptr_end;
+		return true;
+	}
+	static const char* parse_float(const char *begin, const char *end, float &value) {
+		// fast_float does not accept the leading plus sign, which scanf() does.
+		if (begin != end && *begin == '+' && (++ begin == end || *begin == '-'))
+			return nullptr;
+		fast_float::from_chars_result res = fast_float::from_chars(begin, end, value);
+		return res.ec == std::errc::invalid_argument || res.ptr == begin ? nullptr : res.ptr;
+	}
+
+	// Read a single facet, skipping the solid/endsolid lines in front of it.
+	bool parse_facet(stl_facet &facet) {
+		skip_whitespaces();
+		if (! match("facet"))
+			return false;
+		skip_whitespaces();
+		if (! match("normal"))
+			return false;
+		// The facet normal is parsed as a single string as to workaround for not a numbers in the normal definition.
+		std::pair<const char*, const char*> normal[3];
+		for (std::pair<const char*, const char*> &token : normal)
+			if (token = this->token(); token.first == token.second)
+				return false;
+		skip_whitespaces();
+		if (match("outer")) {
+			skip_whitespaces();
+			match("loop");
+		}
+		for (stl_vertex &vertex : facet.vertex) {
+			skip_whitespaces();
+			if (! match("vertex") || ! parse_float(vertex(0)) || ! parse_float(vertex(1)) || ! parse_float(vertex(2)))
+				return false;
+		}
+		// Some G-code generators tend to produce text after "endloop" and "endfacet". Just ignore it.
+		skip_whitespaces();
+		if (! match_line("endloop"))
+			return false;
+		skip_whitespaces();
+		if (! match_line("endfacet"))
+			return false;
+		for (int i = 0; i < 3; ++ i)
+			if (parse_float(normal[i].first, normal[i].second, facet.normal(i)) == nullptr) {
+				// Normal was mangled. Maybe denormals or "not a number" were stored?
+				// Just reset the normal and silently ignore it.
+				memset(&facet.normal, 0, sizeof(facet.normal));
+				break;
+			}
+		return true;
+	}
+
+	// Skip solid/endsolid
+	// (in this order, otherwise it won't work when they are paired in the middle of a file)
+	void skip_solid() {
+		skip_whitespaces();
+		if (match("endsolid"))
+			skip_line();
+		skip_whitespaces();
+		// name might contain spaces and it also can be empty (just "solid")
+		if (match("solid"))
+			skip_line();
+		skip_whitespaces();
+	}
+};
+
+} // namespace
+
+// Find the first facet starting at or after pos. Only used to split the file into chunks, so a "facet normal"
+// inside of a solid name is not expected.
+static const char* stl_find_ascii_facet(const char *pos, const char *begin, const char *end)
+{
+	while (pos != end && (pos = static_cast<const char*>(memchr(pos, 'f', end - pos))) != nullptr) {
+		StlAsciiCursor cursor{ pos, end };
+		if ((pos == begin || stl_is_space(pos[-1])) && cursor.match("facet") && cursor.ptr != end && stl_is_space(*cursor.ptr)) {
+			cursor.skip_whitespaces();
+			if (cursor.match("normal"))
+				return pos;
+		}
+		++ pos;
+	}
+	return end;
+}
+
+// Parse the facets starting in [begin, chunk_end), returns false if the chunk contains a syntax error.
+// The last facet may extend behind chunk_end.
+static bool stl_parse_ascii_chunk(const char *begin, const char *chunk_end, const char *end, std::vector<stl_facet> &facets)
+{
+	StlAsciiCursor cursor{ begin, end };
+	for (;;) {
+		cursor.skip_solid();
+		if (cursor.ptr >= chunk_end)
+			return true;
+		stl_facet facet;
+		if (! cursor.parse_facet(facet))
+			return false;
+		facets.emplace_back(facet);
+	}
+}
+
+// Read the facets of an ASCII .STL file. The file is split into chunks at the facet boundaries, which are parsed
+// in parallel. The facets are stored in the order of the file, a syntax error before the counted number of facets
+// is read fails the import, the text after them is ignored.
+static bool stl_read_ascii_facets(stl_file *stl, const char *data, size_t size, uint32_t first_facet, bool &first, ImportstlProgressFn stlFn)
+{
+	static constexpr size_t chunk_size = 1024 * 1024;
+
+	uint32_t    facets_num = stl->stats.number_of_facets;
+	const char *end        = data + size;
+	// At least one chunk per progress step.
+	size_t      num_chunks = std::max<size_t>(size / chunk_size, LOAD_STL_UNIT_NUM);
+	std::vector<const char*> chunks(num_chunks + 1, end);
+	chunks.front() = data;
+	for (size_t i = 1; i < num_chunks; ++ i)
+		chunks[i] = stl_find_ascii_facet(std::max(chunks[i - 1], data + i * size / num_chunks), data, end);
+
+	std::vector<std::vector<stl_facet>> chunk_facets(num_chunks);
+	std::vector<char>                   chunk_ok(num_chunks, false);
+	uint32_t                            idx = first_facet;
+	for (size_t unit = 0; unit < LOAD_STL_UNIT_NUM && idx < facets_num; ++ unit) {
+		if (! stl_report_progress(stlFn, idx, facets_num))
+			return false;
+		size_t chunk_begin = unit * num_chunks / LOAD_STL_UNIT_NUM;
+		size_t chunk_end   = (unit + 1) * num_chunks / LOAD_STL_UNIT_NUM;
+		tbb::parallel_for(tbb::blocked_range<size_t>(chunk_begin, chunk_end, 1), [&chunks, &chunk_facets, &chunk_ok, end](const tbb::blocked_range<size_t> &range) {
+			for (size_t i = range.begin(); i < range.end(); ++ i)
+				chunk_ok[i] = stl_parse_ascii_chunk(chunks[i], chunks[i + 1], end, chunk_facets[i]);
+		});
+		for (size_t i = chunk_begin; i < chunk_end && idx < facets_num; ++ i) {
+			for (size_t j = 0; j < chunk_facets[i].size() && idx < facets_num; ++ j)
+				stl_add_facet(stl, idx ++, chunk_facets[i][j], first);
+			if (! chunk_ok[i] && idx < facets_num) {
+				BOOST_LOG_TRIVIAL(error) << "Something is syntactically very wrong with this ASCII STL! ";
+				return false;
+			}
+			chunk_facets[i] = std::vector<stl_facet>();
+		}
+	}
+	if (idx < facets_num) {
+		BOOST_LOG_TRIVIAL(error) << "Something is syntactically very wrong with this ASCII STL! ";
+		return false;
+	}
+	return true;
+}
+
 /* Reads the contents of the file pointed to by fp into the stl structure,
    starting at facet first_facet.  The second argument says if it's our first
    time running this for the stl and therefore we should reset our max and min stats. */
-static bool stl_read(stl_file *stl, FILE *fp, int first_facet, bool first, ImportstlProgressFn stlFn, int custom_header_length)
+static bool stl_read(stl_file *stl, FILE *fp, const char *file, int first_facet, bool first, ImportstlProgressFn stlFn, int custom_header_length)
 {
     if (stl->stats.type == binary) {
         int header_size = custom_header_length + NUM_FACET_SIZE;
@@ -230,107 +494,19 @@ static bool stl_read(stl_file *stl, FILE *fp, int first_facet, bool first, Impor
 	}
 
 
-  	char normal_buf[3][32];
-
-	uint32_t facets_num = stl->stats.number_of_facets;
-	uint32_t unit = facets_num / LOAD_STL_UNIT_NUM + 1;
-    for (uint32_t i = first_facet; i < facets_num; ++ i) {
-        if ((i % unit) == 0) {
-            bool cb_cancel = false;
-            if (stlFn) {
-                stlFn(i, facets_num, cb_cancel, model_id, country_code, ml_region, ml_name, ml_id);
-                if (cb_cancel)
-                    return false;
-            }
-        }
-
-  	  	stl_facet facet;
-
-    	if (stl->stats.type == binary) {
-
-
-      		// Read a single facet from a binary .STL file. We assume little-endian architecture!
-      		if (fread(&facet, 1, SIZEOF_STL_FACET, fp) != SIZEOF_STL_FACET)
-      			return false;
-
-
-#if BOOST_ENDIAN_BIG_BYTE
-      		// Convert the loaded little endian data to big endian.
-      		stl_internal_reverse_quads((char*)&facet, 48);
-#endif /* BOOST_ENDIAN_BIG_BYTE */
-    	} else {
-			// Read a single facet from an ASCII .STL file
-			// skip solid/endsolid
-			// (in this order, otherwise it won't work when they are paired in the middle of a file)
-			fscanf(fp, " endsolid%*[^\n]\n");
-			fscanf(fp, " solid%*[^\n]\n");  // name might contain spaces so %*s doesn't work and it also can be empty (just "solid")
-			// Leading space in the fscanf format skips all leading white spaces including numerous new lines and tabs.
-			int res_normal     = fscanf(fp, " facet normal %31s %31s %31s", normal_buf[0], normal_buf[1], normal_buf[2]);
-			assert(res_normal == 3);
-			int res_outer_loop = fscanf(fp, " outer loop");
-			assert(res_outer_loop == 0);
-			int res_vertex1    = fscanf(fp, " vertex %f %f %f", &facet.vertex[0](0), &facet.vertex[0](1), &facet.vertex[0](2));
-			assert(res_vertex1 == 3);
-			int res_vertex2    = fscanf(fp, " vertex %f %f %f", &facet.vertex[1](0), &facet.vertex[1](1), &facet.vertex[1](2));
-			assert(res_vertex2 == 3);
-			// Trailing whitespace is there to eat all whitespaces and empty lines up to the next non-whitespace.
-			int res_vertex3    = fscanf(fp, " vertex %f %f %f ", &facet.vertex[2](0), &facet.vertex[2](1), &facet.vertex[2](2));
-			assert(res_vertex3 == 3);
-			// Some G-code generators tend to produce text after "endloop" and "endfacet". Just ignore it.
-			char buf[2048];
-			fgets(buf, 2047, fp);
-			bool endloop_ok = strncmp(buf, "endloop", 7) == 0 && (buf[7] == '\r' || buf[7] == '\n' || buf[7] == ' ' || buf[7] == '\t');
-			assert(endloop_ok);
-			// Skip the trailing whitespaces and empty lines.
-			fscanf(fp, " ");
-			fgets(buf, 2047, fp);
-			bool endfacet_ok = strncmp(buf, "endfacet", 8) == 0 && (buf[8] == '\r' || buf[8] == '\n' || buf[8] == ' ' || buf[8] == '\t');
-			assert(endfacet_ok);
-			if (res_normal != 3 || res_outer_loop != 0 || res_vertex1 != 3 || res_vertex2 != 3 || res_vertex3 != 3 || ! endloop_ok || ! endfacet_ok) {
-				BOOST_LOG_TRIVIAL(error) << "Something is syntactically very wrong with this ASCII STL! ";
-				return false;
-			}
-
-			// The facet normal has been parsed as a single string as to workaround for not a numbers in the normal definition.
-			if (sscanf(normal_buf[0], "%f", &facet.normal(0)) != 1 ||
-			    sscanf(normal_buf[1], "%f", &facet.normal(1)) != 1 ||
-			    sscanf(normal_buf[2], "%f", &facet.normal(2)) != 1) {
-			    // Normal was mangled. Maybe denormals or "not a number" were stored?
-			  	// Just reset the normal and silently ignore it.
-			  	memset(&facet.normal, 0, sizeof(facet.normal));
-			}
-		}
-
-#if 0
-		// Report close to zero vertex coordinates. Due to the nature of the floating point numbers,
-		// close to zero values may be represented with singificantly higher precision than the rest of the vertices.
-		// It may be worth to round these numbers to zero during loading to reduce the number of errors reported
-		// during the STL import.
-		for (size_t j = 0; j < 3; ++ j) {
-		if (facet.vertex[j](0) > -1e-12f && facet.vertex[j](0) < 1e-12f)
-		    printf("stl_read: facet %d(0) = %e\r\n", j, facet.vertex[j](0));
-		if (facet.vertex[j](1) > -1e-12f && facet.vertex[j](1) < 1e-12f)
-		    printf("stl_read: facet %d(1) = %e\r\n", j, facet.vertex[j](1));
-		if (facet.vertex[j](2) > -1e-12f && facet.vertex[j](2) < 1e-12f)
-		    printf("stl_read: facet %d(2) = %e\r\n", j, facet.vertex[j](2));
-		}
-#endif
-
-		// Write the facet into memory if none of facet vertices is NAN.
-		bool someone_is_nan = false;
-		for (size_t j = 0; j < 3; ++j) {
-			if (isnan(facet.vertex[j](0)) || isnan(facet.vertex[j](1)) || isnan(facet.vertex[j](2))) {
-				someone_is_nan = true;
-				break;
-			}
-		}
-		if(someone_is_nan)
-            continue;
-
-		stl->facet_start[i] = facet;
-		stl_facet_stats(stl, facet, first);
-  	}
-
+    bool result = false;
+    try {
+        // The file is parsed from a memory mapping, the FILE handle was only used for counting the facets and for the header.
+        boost::iostreams::mapped_file_source mapped{ boost::filesystem::path(file) };
+        result = stl->stats.type == binary ?
+            stl_read_binary_facets(stl, mapped.data(), mapped.size(), custom_header_length + NUM_FACET_SIZE, first_facet, first, stlFn) :
+            stl_read_ascii_facets(stl, mapped.data(), mapped.size(), first_facet, first, stlFn);
+    } catch (const std::exception &err) {
+        BOOST_LOG_TRIVIAL(error) << "stl_read: Couldn't map " << file << " for reading, reason = " << err.what();
+        return false;
+    }
+    if (! result)
+        return false;
   	stl->stats.size = stl->stats.max - stl->stats.min;
   	stl->stats.bounding_diameter = stl->stats.size.norm();
   	return true;
@@ -348,7 +524,7 @@ bool stl_open(stl_file *stl, const char *file, ImportstlProgressFn stlFn, int cu
 	if (fp == nullptr)
 		return false;
 	stl_allocate(stl);
-    bool result = stl_read(stl, fp, 0, true, stlFn, custom_header_length);
+    bool result = stl_read(stl, fp, file, 0, true, stlFn, custom_header_length);
   	fclose(fp);
   	return result;
 }
@@ -85,7 +85,7 @@ AABBMesh::AABBMesh(const TriangleMesh &mesh, bool calculate_epsilon)
     : m_tm(&mesh.its)
     , m_aabb(new AABBImpl())
     , m_vfidx{mesh.its}
-    , m_fnidx{its_face_neighbors(mesh.its)}
+    , m_fnidx{*mesh.face_neighbors()}
 {
     init(mesh, calculate_epsilon);
 }
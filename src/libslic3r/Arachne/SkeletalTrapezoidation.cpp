@@ -432,6 +432,9 @@ void SkeletalTrapezoidation::constructFromPolygons(const Polygons& polys)
 #endif
 
     assert(this->graph.edges.empty() && this->graph.nodes.empty() && this->vd_edge_to_he_edge.empty() && this->vd_node_to_he_node.empty());
+    // Every Voronoi edge and vertex is mapped at most once, avoid rehashing while the graph is built.
+    vd_edge_to_he_edge.reserve(voronoi_diagram.num_edges());
+    vd_node_to_he_node.reserve(voronoi_diagram.num_vertices());
     for (const VD::cell_type &cell : voronoi_diagram.cells()) {
         if (!cell.incident_edge())
             continue; // There is no spoon
@@ -2,7 +2,7 @@
 //CuraEngine is released under the terms of the AGPLv3 or higher.
 
 #include "SkeletalTrapezoidationGraph.hpp"
-#include <unordered_map>
+#include <ankerl/unordered_dense.h>
 
 #include <boost/log/trivial.hpp>
 
@@ -180,9 +180,11 @@ bool STHalfEdgeNode::isLocalMaximum(bool strict) const
 
 void SkeletalTrapezoidationGraph::collapseSmallEdges(coord_t snap_dist)
 {
-    std::unordered_map<edge_t*, std::list<edge_t>::iterator> edge_locator;
-    std::unordered_map<node_t*, std::list<node_t>::iterator> node_locator;
-    
+    ankerl::unordered_dense::map<edge_t*, edges_t::iterator> edge_locator;
+    ankerl::unordered_dense::map<node_t*, nodes_t::iterator> node_locator;
+    edge_locator.reserve(edges.size());
+    node_locator.reserve(nodes.size());
+
     for (auto edge_it = edges.begin(); edge_it != edges.end(); ++edge_it)
     {
         edge_locator.emplace(&*edge_it, edge_it);
@@ -193,7 +195,7 @@ void SkeletalTrapezoidationGraph::collapseSmallEdges(coord_t snap_dist)
         node_locator.emplace(&*node_it, node_it);
     }
     
-    auto safelyRemoveEdge = [this, &edge_locator](edge_t* to_be_removed, std::list<edge_t>::iterator& current_edge_it, bool& edge_it_is_updated)
+    auto safelyRemoveEdge = [this, &edge_locator](edge_t* to_be_removed, edges_t::iterator& current_edge_it, bool& edge_it_is_updated)
     {
         if (current_edge_it != edges.end()
             && to_be_removed == &*current_edge_it)
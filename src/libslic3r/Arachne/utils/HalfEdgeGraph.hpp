@@ -7,6 +7,9 @@
 
 #include <list>
 #include <cassert>
+#include <cstddef>
+#include <memory>
+#include <vector>
 
 
 
@@ -15,14 +18,142 @@
 
 namespace Slic3r::Arachne
 {
+/*!
+ * Memory of the nodes and edges of a HalfEdgeGraph.
+ *
+ * The graph is built for every region of every layer with a single allocation per node and edge.
+ * The elements are allocated from large blocks instead. When the graph is destroyed, the arena keeps
+ * its first block, which is reused by the next graph built on the same thread.
+ */
+class HalfEdgeGraphArena
+{
+public:
+    HalfEdgeGraphArena() = default;
+    HalfEdgeGraphArena(const HalfEdgeGraphArena &) = delete;
+    HalfEdgeGraphArena& operator=(const HalfEdgeGraphArena &) = delete;
+
+    void* allocate(size_t size, size_t alignment)
+    {
+        assert(alignment <= alignof(std::max_align_t));
+        for (;;) {
+            if (m_block_idx < m_blocks.size()) {
+                Block  &block  = m_blocks[m_block_idx];
+                size_t  offset = (m_offset + alignment - 1) & ~(alignment - 1);
+                if (offset + size <= block.size) {
+                    m_offset = offset + size;
+                    return block.data.get() + offset;
+                }
+                // Continue with the next block, the rest of this one stays unused until reset().
+                ++ m_block_idx;
+                m_offset = 0;
+            } else
+                m_blocks.push_back({ std::make_unique<char[]>(std::max(size, block_size)), std::max(size, block_size) });
+        }
+    }
+
+    // Make all the memory available again. The elements allocated before have to be destroyed already.
+    void reset() { m_block_idx = 0; m_offset = 0; }
+
+    // Free all the blocks but the first regular one, which is enough for the graph of an average region.
+    void trim()
+    {
+        this->reset();
+        if (! m_blocks.empty() && m_blocks.front().size > block_size)
+            m_blocks.clear();
+        else if (m_blocks.size() > 1)
+            m_blocks.erase(m_blocks.begin() + 1, m_blocks.end());
+    }
+
+    // Arena of the calling thread, which is not used by any other graph. Return it by release().
+    static HalfEdgeGraphArena* acquire()
+    {
+        std::vector<std::unique_ptr<HalfEdgeGraphArena>> &pool = thread_pool();
+        if (pool.empty())
+            return new HalfEdgeGraphArena();
+        HalfEdgeGraphArena *arena = pool.back().release();
+        pool.pop_back();
+        return arena;
+    }
+
+    // The arena keeps a single block, the pool of a thread does not hold the memory of the largest graph built on it.
+    static void release(HalfEdgeGraphArena *arena)
+    {
+        arena->trim();
+        thread_pool().emplace_back(arena);
+    }
+
+private:
+    static constexpr size_t block_size = 256 * 1024;
+
+    struct Block
+    {
+        std::unique_ptr<char[]> data;
+        size_t                  size;
+    };
+
+    static std::vector<std::unique_ptr<HalfEdgeGraphArena>>& thread_pool()
+    {
+        static thread_local std::vector<std::unique_ptr<HalfEdgeGraphArena>> pool;
+        return pool;
+    }
+
+    std::vector<Block> m_blocks;
+    size_t             m_block_idx { 0 };
+    size_t             m_offset { 0 };
+};
+
+// Allocator of the nodes and edges lists, the memory is reclaimed at once when the graph releases its arena.
+template<class T>
+class HalfEdgeGraphAllocator
+{
+public:
+    using value_type = T;
+
+    explicit HalfEdgeGraphAllocator(HalfEdgeGraphArena *arena) noexcept : m_arena(arena) {}
+    template<class U>
+    HalfEdgeGraphAllocator(const HalfEdgeGraphAllocator<U> &other) noexcept : m_arena(other.arena()) {}
+
+    T*   allocate(size_t n) { return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T))); }
+    void deallocate(T*, size_t) noexcept {}
+
+    HalfEdgeGraphArena* arena() const noexcept { return m_arena; }
+
+    template<class U>
+    bool operator==(const HalfEdgeGraphAllocator<U> &other) const noexcept { return m_arena == other.arena(); }
+    template<class U>
+    bool operator!=(const HalfEdgeGraphAllocator<U> &other) const noexcept { return m_arena != other.arena(); }
+
+private:
+    HalfEdgeGraphArena *m_arena;
+};
+
 template<class node_data_t, class edge_data_t, class derived_node_t, class derived_edge_t> // types of data contained in nodes and edges
 class HalfEdgeGraph
 {
+    // Holds the arena of the graph, declared before the lists to outlive them.
+    struct ArenaHolder
+    {
+        ArenaHolder() : arena(HalfEdgeGraphArena::acquire()) {}
+        ~ArenaHolder() { HalfEdgeGraphArena::release(arena); }
+        ArenaHolder(const ArenaHolder &) = delete;
+        ArenaHolder& operator=(const ArenaHolder &) = delete;
+        HalfEdgeGraphArena *arena;
+    };
+    ArenaHolder m_arena_holder;
+
 public:
     using edge_t = derived_edge_t;
     using node_t = derived_node_t;
-    std::list<edge_t> edges;
-    std::list<node_t> nodes;
+    using edges_t = std::list<edge_t, HalfEdgeGraphAllocator<edge_t>>;
+    using nodes_t = std::list<node_t, HalfEdgeGraphAllocator<node_t>>;
+
+    HalfEdgeGraph() : edges(HalfEdgeGraphAllocator<edge_t>(m_arena_holder.arena)), nodes(HalfEdgeGraphAllocator<node_t>(m_arena_holder.arena)) {}
+    // The nodes and edges reference each other, the graph is not copied nor moved.
+    HalfEdgeGraph(const HalfEdgeGraph &) = delete;
+    HalfEdgeGraph& operator=(const HalfEdgeGraph &) = delete;
+
+    edges_t edges;
+    nodes_t nodes;
 };
 
 } // namespace Slic3r::Arachne
@@ -41,15 +41,19 @@ void ArcFitter::do_arc_fitting(const Points& points, std::vector<PathFittingData
     bool can_fit = false;
     Points current_segment;
     current_segment.reserve(points.size());
+    // length of current_segment, accumulated in the same order as Polyline::length() would do
+    double current_length = 0.;
     ArcSegment target_arc;
     for (size_t i = 0; i < points.size(); i++) {
         //BBS: point in stack is not enough, build stack first
         back_index = i;
+        if (!current_segment.empty())
+            current_length += (points[i] - current_segment.back()).cast<double>().norm();
         current_segment.push_back(points[i]);
         if (back_index - front_index < 2)
             continue;
 
-        can_fit = ArcSegment::try_create_arc(current_segment, target_arc, Polyline(current_segment).length(),
+        can_fit = ArcSegment::try_create_arc(current_segment, target_arc, current_length,
                                              DEFAULT_SCALED_MAX_RADIUS,
                                              tolerance,
                                              DEFAULT_ARC_LENGTH_PERCENT_TOLERANCE);
@@ -82,6 +86,7 @@ void ArcFitter::do_arc_fitting(const Points& points, std::vector<PathFittingData
             current_segment.clear();
             current_segment.push_back(points[front_index]);
             current_segment.push_back(points[front_index + 1]);
+            current_length = (points[front_index + 1] - points[front_index]).cast<double>().norm();
         }
     }
 	//BBS: handle the remain data
@@ -115,6 +120,7 @@ void ArcFitter::do_arc_fitting_and_simplify(Points& points, std::vector<PathFitt
         simplified_points.reserve(points.size());
         simplified_points.push_back(points[0]);
         std::vector<size_t> reduce_count(result.size(), 0);
+        Points straight_or_arc_part;
         for (size_t i = 0; i < result.size(); i++)
         {
             size_t start_index = result[i].start_point_index;
@@ -124,10 +130,7 @@ void ArcFitter::do_arc_fitting_and_simplify(Points& points, std::vector<PathFitt
             //For arc part, theoretically, we only need to keep the start and end point, and
             //delete all other point. But when considering wipe operation, we must keep the original
             //point data and shouldn't reduce too much by only saving start and end point.
-            Points straight_or_arc_part;
-            straight_or_arc_part.reserve(end_index - start_index + 1);
-            for (size_t j = start_index; j <= end_index; j++)
-                straight_or_arc_part.push_back(points[j]);
+            straight_or_arc_part.assign(points.begin() + start_index, points.begin() + end_index + 1);
             straight_or_arc_part = MultiPoint::_douglas_peucker(straight_or_arc_part, tolerance);
             //BBS: how many point has been reduced
             reduce_count[i] = end_index - start_index + 1 - straight_or_arc_part.size();
@@ -137,7 +140,7 @@ void ArcFitter::do_arc_fitting_and_simplify(Points& points, std::vector<PathFitt
             }
         }
         //BBS: save and will return the simplified_points
-        points = simplified_points;
+        points = std::move(simplified_points);
         //BBS: modify the index in result because the point index must be changed to match the simplified points
         for (size_t j = 1; j < reduce_count.size(); j++)
             reduce_count[j] += reduce_count[j - 1];
@@ -1,7 +1,7 @@
 #ifndef PERFORMCSGMESHBOOLEANS_HPP
 #define PERFORMCSGMESHBOOLEANS_HPP
 
-#include <stack>
+#include <iterator>
 #include <vector>
 
 #include <boost/log/trivial.hpp>
@@ -95,20 +95,27 @@ inline void perform_csg(CSGType op, CGALMeshPtr &dst, CGALMeshPtr &src)
     }
 }
 
-template<class Ex, class It>
-std::vector<CGALMeshPtr> get_cgalptrs(Ex policy, const Range<It> &csgrange)
-{
-    std::vector<CGALMeshPtr> ret(csgrange.size());
-    execution::for_each(policy, size_t(0), csgrange.size(),
-                        [&csgrange, &ret](size_t i) {
-        auto it = csgrange.begin();
-        std::advance(it, i);
-        auto &csgpart = *it;
-        ret[i]        = get_cgalmesh(csgpart);
-    });
+struct Kernel {
+    using MeshPtr = CGALMeshPtr;
 
-    return ret;
-}
+    template<class CSGPartT> static MeshPtr convert(const CSGPartT &csgpart) { return get_cgalmesh(csgpart); }
+    static MeshPtr empty_mesh() { return MeshBoolean::cgal::triangle_mesh_to_cgal(indexed_triangle_set{}); }
+    static bool    empty(const MeshPtr &m) { return !m || MeshBoolean::cgal::empty(*m); }
+    static void    merge(MeshPtr &dst, MeshPtr &src) { MeshBoolean::cgal::merge(*dst, *src); }
+    static void    perform(CSGType op, MeshPtr &dst, MeshPtr &src) { perform_csg(op, dst, src); }
+    // The union is made on a copy, a failed operation may leave its target modified.
+    static bool    try_union(MeshPtr &dst, MeshPtr &src)
+    {
+        MeshPtr result = MeshBoolean::cgal::clone(*dst);
+        try {
+            MeshBoolean::cgal::plus(*result, *src);
+        } catch (const std::exception &) {
+            return false;
+        }
+        dst = std::move(result);
+        return true;
+    }
+};
 
 } // namespace detail
 
@@ -139,124 +146,257 @@ namespace detail_mcut {
         }
     }
 
-    template<class Ex, class It>
-    std::vector<McutMeshPtr> get_mcutptrs(Ex policy, const Range<It>& csgrange)
-    {
-        std::vector<McutMeshPtr> ret(csgrange.size());
-        execution::for_each(policy, size_t(0), csgrange.size(),
-            [&csgrange, &ret](size_t i) {
-                auto it = csgrange.begin();
-                std::advance(it, i);
-                auto& csgpart = *it;
-                ret[i] = get_mcutmesh(csgpart);
-            });
-
-        return ret;
-    }
+    struct Kernel {
+        using MeshPtr = McutMeshPtr;
+
+        template<class CSGPartT> static MeshPtr convert(const CSGPartT &csgpart) { return get_mcutmesh(csgpart); }
+        static MeshPtr empty_mesh() { return MeshBoolean::mcut::triangle_mesh_to_mcut(indexed_triangle_set{}); }
+        static bool    empty(const MeshPtr &m) { return !m || MeshBoolean::mcut::empty(*m); }
+        static void    merge(MeshPtr &dst, MeshPtr &src) { MeshBoolean::mcut::merge(*dst, *src); }
+        static void    perform(CSGType op, MeshPtr &dst, MeshPtr &src) { perform_csg(op, dst, src); }
+        static bool    try_union(MeshPtr &dst, MeshPtr &src)
+        {
+            MeshPtr result = MeshBoolean::mcut::clone(*dst);
+            if (!MeshBoolean::mcut::do_boolean(*result, *src, "UNION"))
+                return false;
+            dst = std::move(result);
+            return true;
+        }
+    };
 
 } // namespace mcut_detail
 
-// Process the sequence of CSG parts with CGAL.
+namespace detail {
+
+// The CSG parts parsed into a tree. A group spans the parts from a Push to the matching Pop,
+// it is evaluated independently of its siblings and then applied to its parent with the operation of the Push.
+struct CSGNode {
+    CSGType              op    = CSGType::Union;
+    bool                 group = false;
+    // index of the CSG part of a leaf
+    size_t               part  = 0;
+    // operands of a group, applied in this order
+    std::vector<CSGNode> children;
+};
+
 template<class It>
-void perform_csgmesh_booleans_cgal(MeshBoolean::cgal::CGALMeshPtr &cgalm,
-                              const Range<It>                &csgrange)
+CSGNode build_csg_tree(const Range<It> &csgrange)
 {
-    using MeshBoolean::cgal::CGALMesh;
-    using MeshBoolean::cgal::CGALMeshPtr;
-    using namespace detail_cgal;
+    std::vector<CSGNode> stack(1);
+    stack.front().group = true;
 
-    struct Frame {
-        CSGType op; CGALMeshPtr cgalptr;
-        explicit Frame(CSGType csgop = CSGType::Union)
-            : op{ csgop }
-            , cgalptr{ MeshBoolean::cgal::triangle_mesh_to_cgal(indexed_triangle_set{}) }
-        {}
+    auto pop_group = [&stack]() {
+        CSGNode group = std::move(stack.back());
+        stack.pop_back();
+        stack.back().children.emplace_back(std::move(group));
     };
 
-    std::stack opstack{ std::vector<Frame>{} };
+    size_t csgidx = 0;
+    for (auto &csgpart : csgrange) {
+        if (get_stack_operation(csgpart) == CSGStackOp::Push) {
+            CSGNode group;
+            group.op    = get_operation(csgpart);
+            group.group = true;
+            stack.emplace_back(std::move(group));
+        }
 
-    opstack.push(Frame{});
+        // The part of a Push or Pop belongs to the group, it may carry a mesh too.
+        CSGNode leaf;
+        leaf.op   = get_operation(csgpart);
+        leaf.part = csgidx++;
+        stack.back().children.emplace_back(std::move(leaf));
 
-    std::vector<CGALMeshPtr> cgalmeshes = get_cgalptrs(ex_tbb, csgrange);
+        if (get_stack_operation(csgpart) == CSGStackOp::Pop && stack.size() > 1)
+            pop_group();
+    }
 
-    size_t csgidx = 0;
-    for (auto& csgpart : csgrange) {
+    // Groups without a Pop are closed at the end of the range.
+    while (stack.size() > 1)
+        pop_group();
 
-        auto op = get_operation(csgpart);
-        CGALMeshPtr& cgalptr = cgalmeshes[csgidx++];
+    return std::move(stack.front());
+}
 
-        if (get_stack_operation(csgpart) == CSGStackOp::Push) {
-            opstack.push(Frame{ op });
-            op = CSGType::Union;
-        }
+// A mesh in the representation of the boolean kernel together with a conservative bounding box of it.
+template<class MeshPtr>
+struct CSGResult {
+    MeshPtr       mesh;
+    BoundingBoxf3 bbox;
+};
+
+template<class CSGPartT>
+BoundingBoxf3 csgpart_bounding_box(const CSGPartT &csgpart)
+{
+    BoundingBoxf3 bbox;
+    if (const indexed_triangle_set *its = csg::get_mesh(csgpart)) {
+        const Transform3d tr = get_transform(csgpart).template cast<double>();
+        for (const stl_vertex &v : its->vertices)
+            bbox.merge(Vec3d(tr * v.template cast<double>()));
+    }
+    return bbox;
+}
+
+// Apply src to dst. The operands with disjoint bounding boxes are not passed to the kernel, their union
+// is a plain merge of the meshes, the difference keeps dst and the intersection is empty.
+// Parts which failed to convert (null src) are skipped like before.
+template<class Kernel>
+void perform_csg(CSGType op, CSGResult<typename Kernel::MeshPtr> &dst, CSGResult<typename Kernel::MeshPtr> &src)
+{
+    if (!src.mesh)
+        return;
 
-        Frame* top = &opstack.top();
+    if (Kernel::empty(src.mesh)) {
+        if (op == CSGType::Intersection)
+            dst = {};
+        return;
+    }
 
-        perform_csg(get_operation(csgpart), top->cgalptr, cgalptr);
+    if (Kernel::empty(dst.mesh)) {
+        if (op == CSGType::Union)
+            dst = std::move(src);
+        return;
+    }
 
-        if (get_stack_operation(csgpart) == CSGStackOp::Pop) {
-            CGALMeshPtr src = std::move(top->cgalptr);
-            auto popop = opstack.top().op;
-            opstack.pop();
-            CGALMeshPtr& dst = opstack.top().cgalptr;
-            perform_csg(popop, dst, src);
+    if (!MeshBoolean::bounding_boxes_overlap(dst.bbox, src.bbox)) {
+        switch (op) {
+        case CSGType::Union:
+            Kernel::merge(dst.mesh, src.mesh);
+            dst.bbox.merge(src.bbox);
+            break;
+        case CSGType::Difference:
+            break;
+        case CSGType::Intersection:
+            dst = {};
+            break;
         }
+        return;
     }
 
-    cgalm = std::move(opstack.top().cgalptr);
+    Kernel::perform(op, dst.mesh, src.mesh);
+    switch (op) {
+    case CSGType::Union:
+        dst.bbox.merge(src.bbox);
+        break;
+    case CSGType::Difference:
+        break;
+    case CSGType::Intersection:
+        dst.bbox.min = dst.bbox.min.cwiseMax(src.bbox.min);
+        dst.bbox.max = dst.bbox.max.cwiseMin(src.bbox.max);
+        break;
+    }
 }
 
-// Process the sequence of CSG parts with mcut.
-template<class It>
-void perform_csgmesh_booleans_mcut(MeshBoolean::mcut::McutMeshPtr& mcutm,
-    const Range<It>& csgrange)
+// Union of src into dst, returns false and leaves both unchanged if the kernel fails.
+template<class Kernel>
+bool try_union(CSGResult<typename Kernel::MeshPtr> &dst, CSGResult<typename Kernel::MeshPtr> &src)
 {
-    using MeshBoolean::mcut::McutMesh;
-    using MeshBoolean::mcut::McutMeshPtr;
-    using namespace detail_mcut;
-
-    struct Frame {
-        CSGType op; McutMeshPtr mcutptr;
-        explicit Frame(CSGType csgop = CSGType::Union)
-            : op{ csgop }
-            , mcutptr{ MeshBoolean::mcut::triangle_mesh_to_mcut(indexed_triangle_set{}) }
-        {}
-    };
-
-    std::stack opstack{ std::vector<Frame>{} };
+    if (!src.mesh || Kernel::empty(src.mesh) || Kernel::empty(dst.mesh) || !MeshBoolean::bounding_boxes_overlap(dst.bbox, src.bbox)) {
+        // no kernel involved
+        perform_csg<Kernel>(CSGType::Union, dst, src);
+        return true;
+    }
+    if (!Kernel::try_union(dst.mesh, src.mesh))
+        return false;
+    dst.bbox.merge(src.bbox);
+    return true;
+}
 
-    opstack.push(Frame{});
+// Union of the operands reduced pairwise, the pairs of one level are independent and run in parallel.
+// Returns the pieces of the union: a single one unless the kernel failed to unite some operands, which are then
+// returned separately to be applied one by one, as if the operations had not been regrouped.
+template<class Kernel>
+std::vector<CSGResult<typename Kernel::MeshPtr>> union_operands(std::vector<CSGResult<typename Kernel::MeshPtr>> &&operands)
+{
+    using Result = CSGResult<typename Kernel::MeshPtr>;
+    std::vector<std::vector<Result>> pieces(operands.size());
+    for (size_t i = 0; i < operands.size(); ++i)
+        pieces[i].emplace_back(std::move(operands[i]));
+
+    for (size_t step = 1; step < pieces.size(); step *= 2)
+        execution::for_each(ex_tbb, size_t(0), (pieces.size() + 2 * step - 1) / (2 * step), [&pieces, step](size_t i) {
+            size_t dst = 2 * i * step;
+            size_t src = dst + step;
+            if (src >= pieces.size())
+                return;
+            if (pieces[dst].size() == 1 && pieces[src].size() == 1 && try_union<Kernel>(pieces[dst].front(), pieces[src].front()))
+                return;
+            BOOST_LOG_TRIVIAL(warning) << "CSG union of the operands of a run failed, they are applied one by one";
+            std::move(pieces[src].begin(), pieces[src].end(), std::back_inserter(pieces[dst]));
+        });
+    return pieces.empty() ? std::vector<Result>{} : std::move(pieces.front());
+}
 
-    std::vector<McutMeshPtr> McutMeshes = get_mcutptrs(ex_tbb, csgrange);
+template<class Kernel, class It>
+CSGResult<typename Kernel::MeshPtr> evaluate_csg_node(const CSGNode &node, const Range<It> &csgrange)
+{
+    using Result = CSGResult<typename Kernel::MeshPtr>;
 
-    size_t csgidx = 0;
-    for (auto& csgpart : csgrange) {
+    if (!node.group) {
+        auto it = csgrange.begin();
+        std::advance(it, node.part);
+        return Result{ Kernel::convert(*it), csgpart_bounding_box(*it) };
+    }
 
-        auto op = get_operation(csgpart);
-        McutMeshPtr& mcutptr = McutMeshes[csgidx++];
+    // The leaves are converted and the nested groups evaluated in parallel.
+    const std::vector<CSGNode> &children = node.children;
+    std::vector<Result>         operands(children.size());
+    execution::for_each(ex_tbb, size_t(0), children.size(), [&children, &operands, &csgrange](size_t i) {
+        operands[i] = evaluate_csg_node<Kernel>(children[i], csgrange);
+    });
 
-        if (get_stack_operation(csgpart) == CSGStackOp::Push) {
-            opstack.push(Frame{ op });
-            op = CSGType::Union;
+    // A run of unions or differences is applied as the union of its operands:
+    // A + B + C == A + (B + C) and A - B - C == A - (B + C).
+    Result result;
+    for (size_t i = 0; i < children.size();) {
+        const CSGType op  = children[i].op;
+        size_t        end = i + 1;
+        if (op != CSGType::Intersection)
+            while (end < children.size() && children[end].op == op)
+                ++end;
+        if (end - i == 1)
+            perform_csg<Kernel>(op, result, operands[i]);
+        else if (!(op == CSGType::Difference && Kernel::empty(result.mesh))) {
+            std::vector<Result> run;
+            run.reserve(end - i);
+            for (size_t j = i; j < end; ++j)
+                // a subtractor outside of the minuend does not need to be united with the other ones
+                if (op != CSGType::Difference || MeshBoolean::bounding_boxes_overlap(result.bbox, operands[j].bbox))
+                    run.emplace_back(std::move(operands[j]));
+            for (Result &piece : union_operands<Kernel>(std::move(run)))
+                perform_csg<Kernel>(op, result, piece);
         }
+        i = end;
+    }
 
-        Frame* top = &opstack.top();
-
-        perform_csg(get_operation(csgpart), top->mcutptr, mcutptr);
+    return result;
+}
 
-        if (get_stack_operation(csgpart) == CSGStackOp::Pop) {
-            McutMeshPtr src = std::move(top->mcutptr);
-            auto popop = opstack.top().op;
-            opstack.pop();
-            McutMeshPtr& dst = opstack.top().mcutptr;
-            perform_csg(popop, dst, src);
-        }
-    }
+template<class Kernel, class It>
+typename Kernel::MeshPtr perform_csgmesh_booleans(const Range<It> &csgrange)
+{
+    typename Kernel::MeshPtr ret = evaluate_csg_node<Kernel>(build_csg_tree(csgrange), csgrange).mesh;
+    if (!ret)
+        ret = Kernel::empty_mesh();
+    return ret;
+}
 
-    mcutm = std::move(opstack.top().mcutptr);
+} // namespace detail
 
+// Process the sequence of CSG parts with CGAL.
+template<class It>
+void perform_csgmesh_booleans_cgal(MeshBoolean::cgal::CGALMeshPtr &cgalm,
+                              const Range<It>                &csgrange)
+{
+    cgalm = detail::perform_csgmesh_booleans<detail_cgal::Kernel>(csgrange);
 }
 
+// Process the sequence of CSG parts with mcut.
+template<class It>
+void perform_csgmesh_booleans_mcut(MeshBoolean::mcut::McutMeshPtr& mcutm,
+    const Range<It>& csgrange)
+{
+    mcutm = detail::perform_csgmesh_booleans<detail_mcut::Kernel>(csgrange);
+}
 
 template<class It, class Visitor>
 std::tuple<BooleanFailReason,std::string> check_csgmesh_booleans(const Range<It> &csgrange, Visitor &&vfn)
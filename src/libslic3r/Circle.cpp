@@ -81,7 +81,9 @@ bool Circle::try_create_circle(const Points& points, const double max_radius, co
             // BBS: We already checked this one, and it failed. don't need to do again
             continue;
 
-        if (Circle::try_create_circle(points[0], points[index], points[count - 1], max_radius, test_circle) && test_circle.get_deviation_sum_squared(points, tolerance, current_deviation))
+        if (Circle::try_create_circle(points[0], points[index], points[count - 1], max_radius, test_circle) &&
+            test_circle.get_deviation_sum_squared(points, tolerance, current_deviation,
+                                                  found_circle ? least_deviation : std::numeric_limits<double>::max()))
         {
             if (!found_circle || current_deviation < least_deviation)
             {
@@ -152,7 +154,7 @@ bool Circle::get_closest_perpendicular_point(const Point& p1, const Point& p2, c
     return true;
 }
 
-bool Circle::get_deviation_sum_squared(const Points& points, const double tolerance, double& total_deviation)
+bool Circle::get_deviation_sum_squared(const Points& points, const double tolerance, double& total_deviation, const double max_sum_deviation)
 {
     total_deviation = 0;
     Point temp;
@@ -166,7 +168,7 @@ bool Circle::get_deviation_sum_squared(const Points& points, const double tolera
         distance_from_center = sqrt((double)temp.x() * (double)temp.x() + (double)temp.y() * (double)temp.y());
         deviation = std::fabs(distance_from_center - radius);
         total_deviation += deviation * deviation;
-        if (deviation > tolerance)
+        if (deviation > tolerance || total_deviation >= max_sum_deviation)
             return false;
 
     }
@@ -179,7 +181,7 @@ bool Circle::get_deviation_sum_squared(const Points& points, const double tolera
             distance_from_center = sqrt((double)temp.x() * (double)temp.x() + (double)temp.y() * (double)temp.y());
             deviation = std::fabs(distance_from_center - radius);
             total_deviation += deviation * deviation;
-            if (deviation > tolerance)
+            if (deviation > tolerance || total_deviation >= max_sum_deviation)
                 return false;
         }
     }
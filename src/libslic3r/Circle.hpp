@@ -4,6 +4,8 @@
 #include "Point.hpp"
 #include "Line.hpp"
 
+#include <limits>
+
 namespace Slic3r {
 
 constexpr double ZERO_TOLERANCE = 0.000005;
@@ -30,7 +32,10 @@ public:
     static bool try_create_circle(const Points& points, const double max_radius, const double tolerance, Circle& new_circle);
     double get_polar_radians(const Point& p1) const;
     bool is_over_deviation(const Points& points, const double tolerance);
-    bool get_deviation_sum_squared(const Points& points, const double tolerance, double& sum_deviation);
+    // Fails as soon as a point is out of tolerance or the sum reaches max_sum_deviation,
+    // so that a candidate, which cannot beat the best circle found so far, is rejected early.
+    bool get_deviation_sum_squared(const Points& points, const double tolerance, double& sum_deviation,
+                                   const double max_sum_deviation = std::numeric_limits<double>::max());
 
     //BBS: only support calculate on X-Y plane, Z is useless
     static Vec3f calc_tangential_vector(const Vec3f& pos, const Vec3f& center_pos, const bool is_ccw);
@@ -0,0 +1,89 @@
+#include "CompactExPolygons.hpp"
+
+#include <limits>
+
+namespace Slic3r {
+
+void CompactExPolygons::assign(const ExPolygons &expolygons)
+{
+    this->clear();
+    if (expolygons.empty())
+        return;
+
+    size_t num_polygons = 0;
+    size_t num_points   = 0;
+    for (const ExPolygon &expoly : expolygons) {
+        num_polygons += expoly.num_contours();
+        num_points   += expoly.contour.size();
+        for (const Polygon &hole : expoly.holes)
+            num_points += hole.size();
+    }
+    assert(num_points <= size_t(std::numeric_limits<uint32_t>::max()));
+
+    m_bbox = get_extents(expolygons);
+    m_points.reserve(num_points);
+    m_polygon_offsets.reserve(num_polygons + 1);
+    m_expolygon_offsets.reserve(expolygons.size() + 1);
+
+    auto add_polygon = [this](const Polygon &polygon) {
+        m_polygon_offsets.emplace_back(uint32_t(m_points.size()));
+        m_points.insert(m_points.end(), polygon.points.begin(), polygon.points.end());
+    };
+    for (const ExPolygon &expoly : expolygons) {
+        m_expolygon_offsets.emplace_back(uint32_t(m_polygon_offsets.size()));
+        add_polygon(expoly.contour);
+        for (const Polygon &hole : expoly.holes)
+            add_polygon(hole);
+    }
+    m_polygon_offsets.emplace_back(uint32_t(m_points.size()));
+    m_expolygon_offsets.emplace_back(uint32_t(m_polygon_offsets.size() - 1));
+}
+
+void CompactExPolygons::clear()
+{
+    m_bbox = BoundingBox();
+    m_points.clear();
+    m_polygon_offsets.clear();
+    m_expolygon_offsets.clear();
+}
+
+void CompactExPolygons::shrink_to_fit()
+{
+    m_points.shrink_to_fit();
+    m_polygon_offsets.shrink_to_fit();
+    m_expolygon_offsets.shrink_to_fit();
+}
+
+ExPolygon CompactExPolygons::expolygon(size_t idx) const
+{
+    assert(idx < this->size());
+    const uint32_t first = m_expolygon_offsets[idx];
+    const uint32_t last  = m_expolygon_offsets[idx + 1];
+    ExPolygon out;
+    this->decode_polygon(first, out.contour.points);
+    out.holes.resize(last - first - 1);
+    for (uint32_t i = first + 1; i < last; ++ i)
+        this->decode_polygon(i, out.holes[i - first - 1].points);
+    return out;
+}
+
+ExPolygons CompactExPolygons::expolygons() const
+{
+    ExPolygons out;
+    this->append_to(out);
+    return out;
+}
+
+void CompactExPolygons::append_to(ExPolygons &out) const
+{
+    out.reserve(out.size() + this->size());
+    for (size_t i = 0; i < this->size(); ++ i)
+        out.emplace_back(this->expolygon(i));
+}
+
+size_t CompactExPolygons::memory_used() const
+{
+    return m_points.capacity() * sizeof(Point) + (m_polygon_offsets.capacity() + m_expolygon_offsets.capacity()) * sizeof(uint32_t);
+}
+
+} // namespace Slic3r
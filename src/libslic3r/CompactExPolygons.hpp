@@ -0,0 +1,58 @@
+#ifndef slic3r_CompactExPolygons_hpp_
+#define slic3r_CompactExPolygons_hpp_
+
+#include "ExPolygon.hpp"
+#include "BoundingBox.hpp"
+
+namespace Slic3r {
+
+// Read mostly storage of ExPolygons, which are kept for a long time but rarely accessed, for example the backup of the slices of a layer.
+// All points are stored in a single buffer, the contours and holes are addressed by offsets into that buffer.
+// This saves the per polygon allocations and the per polygon overhead of ExPolygons.
+class CompactExPolygons
+{
+public:
+    CompactExPolygons() = default;
+    explicit CompactExPolygons(const ExPolygons &expolygons) { this->assign(expolygons); }
+
+    CompactExPolygons& operator=(const ExPolygons &expolygons) { this->assign(expolygons); return *this; }
+
+    void        assign(const ExPolygons &expolygons);
+    void        clear();
+    // Release the memory reserved over the current size.
+    void        shrink_to_fit();
+
+    bool        empty() const { return m_expolygon_offsets.size() < 2; }
+    // Number of stored ExPolygons.
+    size_t      size() const { return this->empty() ? 0 : m_expolygon_offsets.size() - 1; }
+    // Number of stored contours and holes.
+    size_t      polygons_count() const { return m_polygon_offsets.empty() ? 0 : m_polygon_offsets.size() - 1; }
+    size_t      points_count() const { return m_polygon_offsets.empty() ? 0 : m_polygon_offsets.back(); }
+    // Bounding box of all the stored points, valid without decoding the geometry.
+    const BoundingBox& bounding_box() const { return m_bbox; }
+
+    // Decode a single ExPolygon.
+    ExPolygon   expolygon(size_t idx) const;
+    // Decode all the stored ExPolygons.
+    ExPolygons  expolygons() const;
+    void        append_to(ExPolygons &out) const;
+
+    // Memory allocated by the container, for memory usage statistics.
+    size_t      memory_used() const;
+
+private:
+    void        decode_polygon(size_t polygon_idx, Points &out) const
+        { out.assign(m_points.begin() + m_polygon_offsets[polygon_idx], m_points.begin() + m_polygon_offsets[polygon_idx + 1]); }
+
+    BoundingBox            m_bbox;
+    // Points of all the contours and holes.
+    Points                 m_points;
+    // First point of each polygon, terminated by the total number of points.
+    std::vector<uint32_t>  m_polygon_offsets;
+    // First polygon (the contour) of each ExPolygon, terminated by the total number of polygons.
+    std::vector<uint32_t>  m_expolygon_offsets;
+};
+
+} // namespace Slic3r
+
+#endif /* slic3r_CompactExPolygons_hpp_ */
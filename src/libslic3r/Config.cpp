@@ -523,6 +523,62 @@ t_config_option_keys ConfigBase::equal(const ConfigBase &other) const
     return equal;
 }
 
+void ConfigBase::collect_digest(ConfigDigest &digest) const
+{
+    const ConfigDef *def = this->def();
+    for (const t_config_option_key &opt_key : this->keys()) {
+        const ConfigOption *opt = this->option(opt_key);
+        if (const ConfigOptionDef *optdef = def->get(opt_key); optdef != nullptr)
+            digest.add(optdef, opt);
+        else
+            digest.add_undefined(opt_key, opt);
+    }
+}
+
+ConfigDigest::ConfigDigest(const ConfigBase &config)
+{
+    const ConfigDef *def = config.def();
+    if (def == nullptr)
+        throw NoDefinitionException();
+    m_items.assign(def->max_serialization_key_ordinal() + 1, Item());
+    config.collect_digest(*this);
+}
+
+void ConfigDigest::add(const ConfigOptionDef *def, const ConfigOption *opt)
+{
+    assert(def != nullptr && opt != nullptr);
+    size_t ordinal = def->serialization_key_ordinal;
+    if (ordinal >= m_items.size())
+        m_items.resize(ordinal + 1);
+    assert(m_items[ordinal].opt == nullptr);
+    m_items[ordinal] = { def, opt, opt->hash() };
+    m_ordinals.emplace_back(ordinal);
+}
+
+void ConfigDigest::update(const ConfigOptionDef *def)
+{
+    if (def == nullptr || def->serialization_key_ordinal >= m_items.size())
+        return;
+    Item &item = m_items[def->serialization_key_ordinal];
+    if (item.opt != nullptr)
+        item.hash = item.opt->hash();
+}
+
+// Returns options differing in the two configs, ignoring options not present in both configs.
+t_config_option_keys ConfigDigest::diff(const ConfigDigest &other) const
+{
+    t_config_option_keys diff;
+    for (size_t ordinal : m_ordinals)
+        if (other.option(ordinal) != nullptr && ! this->equal(other, ordinal))
+            diff.emplace_back(this->key(ordinal));
+    for (const auto &[opt_key, this_opt] : m_undefined) {
+        auto it = std::find_if(other.m_undefined.begin(), other.m_undefined.end(), [&opt_key](const auto &kvp) { return kvp.first == opt_key; });
+        if (it != other.m_undefined.end() && *this_opt != *it->second)
+            diff.emplace_back(opt_key);
+    }
+    return diff;
+}
+
 // Best-effort, never-throwing diagnostic dump of an option's raw values, used to record the
 // "crime scene" when serialization fails (e.g. a NaN in a non-nullable float vector). It bypasses
 // serialize() on purpose so it works even for the very values that make serialize() throw.
@@ -1852,6 +1908,22 @@ bool DynamicConfig::equals(const DynamicConfig &other, const std::set<std::strin
         skipped_keys);
 }
 
+void DynamicConfig::collect_digest(ConfigDigest &digest) const
+{
+    const ConfigDef *def = this->def();
+    if (def == nullptr)
+        throw NoDefinitionException();
+    auto it_def = def->options.begin();
+    for (const auto &kvp : this->options) {
+        while (it_def != def->options.end() && it_def->first < kvp.first)
+            ++ it_def;
+        if (it_def != def->options.end() && it_def->first == kvp.first)
+            digest.add(&it_def->second, kvp.second.get());
+        else
+            digest.add_undefined(kvp.first, kvp.second.get());
+    }
+}
+
 // Returns options differing in the two configs, ignoring options not present in both configs.
 t_config_option_keys DynamicConfig::diff(const DynamicConfig &other) const
 {
@@ -2464,6 +2464,10 @@ public:
             out.push_back(kvp.first);
         return out;
     }
+    // The serialization_key_ordinal is assigned to the option definitions of all the ConfigDefs from a single counter,
+    // so it densely enumerates the option keys and it is used to index options without looking up their keys.
+    size_t                  max_serialization_key_ordinal() const
+        { return this->by_serialization_key_ordinal.empty() ? 0 : this->by_serialization_key_ordinal.rbegin()->first; }
 
     // Iterate through all of the CLI options and write them to a stream.
     std::ostream&           print_cli_help(
@@ -2518,6 +2522,8 @@ public:
 
 
 
+class ConfigDigest;
+
 // An abstract configuration store.
 class ConfigBase : public ConfigOptionResolver
 {
@@ -2538,6 +2544,9 @@ public:
     virtual ConfigOption*           optptr(const t_config_option_key &opt_key, bool create = false) = 0;
     // Collect names of all configuration values maintained by this configuration store.
     virtual t_config_option_keys    keys() const = 0;
+    // Collect all configuration values maintained by this configuration store into a digest.
+    // The default implementation looks up each key, the configuration stores override it to enumerate their options directly.
+    virtual void                    collect_digest(ConfigDigest &digest) const;
 
 protected:
     // Verify whether the opt_key has not been obsoleted or renamed.
@@ -2777,6 +2786,8 @@ public:
     ConfigOption*           optptr(const t_config_option_key &opt_key, bool create = false) override;
     // Overrides ConfigBase::keys(). Collect names of all configuration values maintained by this configuration store.
     t_config_option_keys    keys() const override;
+    // Overrides ConfigBase::collect_digest(). Walk the options along with their definitions, both are sorted by the option keys.
+    void                    collect_digest(ConfigDigest &digest) const override;
     bool                    empty() const { return options.empty(); }
 
     // Set a value for an opt_key. Returns true if the value did not exist yet.
@@ -2865,6 +2876,56 @@ protected:
     void set_defaults();
 };
 
+// Options of a config indexed by the serialization_key_ordinal of their definitions, together with the hashes of their values.
+// The digest of a config is collected once and then compared against the digests of other configs without looking up
+// any option key. The hashes are compared first, ConfigOption::operator==() is only called to confirm the options
+// with equal hashes, so that the result is exactly the same as of ConfigBase::diff().
+// A digest points to the options of its config, which must not be modified while the digest is in use.
+class ConfigDigest
+{
+public:
+    ConfigDigest() = default;
+    // May throw NoDefinitionException if the config has no definition.
+    explicit ConfigDigest(const ConfigBase &config);
+
+    // To be called by ConfigBase::collect_digest() in the order of the option keys.
+    void                        add(const ConfigOptionDef *def, const ConfigOption *opt);
+    // Options without a definition are only compared by their keys.
+    void                        add_undefined(const t_config_option_key &opt_key, const ConfigOption *opt) { m_undefined.emplace_back(opt_key, opt); }
+    // Recalculate the hash of an option of this digest after its value was modified in place.
+    void                        update(const ConfigOptionDef *def);
+
+    bool                        empty() const { return m_ordinals.empty() && m_undefined.empty(); }
+    // Ordinals of the options of this digest in the order of their keys.
+    const std::vector<size_t>&  ordinals() const { return m_ordinals; }
+    const t_config_option_key&  key(size_t ordinal) const { return m_items[ordinal].def->opt_key; }
+    const ConfigOption*         option(size_t ordinal) const { return ordinal < m_items.size() ? m_items[ordinal].opt : nullptr; }
+    const std::vector<std::pair<t_config_option_key, const ConfigOption*>>& undefined_options() const { return m_undefined; }
+
+    // Is the option present in both digests with an equal value?
+    bool                        equal(const ConfigDigest &other, size_t ordinal) const
+    {
+        const ConfigOption *this_opt  = this->option(ordinal);
+        const ConfigOption *other_opt = other.option(ordinal);
+        return this_opt != nullptr && other_opt != nullptr &&
+               m_items[ordinal].hash == other.m_items[ordinal].hash && *this_opt == *other_opt;
+    }
+    // Returns options differing in the two configs, ignoring options not present in both configs.
+    t_config_option_keys        diff(const ConfigDigest &other) const;
+
+private:
+    struct Item
+    {
+        const ConfigOptionDef  *def  { nullptr };
+        const ConfigOption     *opt  { nullptr };
+        size_t                  hash { 0 };
+    };
+    // Indexed by the serialization_key_ordinal.
+    std::vector<Item>                                                 m_items;
+    std::vector<size_t>                                               m_ordinals;
+    std::vector<std::pair<t_config_option_key, const ConfigOption*>>  m_undefined;
+};
+
 }
 
 #endif
@@ -9,6 +9,9 @@
 #include <assert.h>
 #include <string_view>
 #include <numeric>
+#include <new>
+
+#include <oneapi/tbb/scalable_allocator.h>
 
 namespace Slic3r {
 
@@ -160,6 +163,16 @@ public:
         return *this;
     }
 
+    // Extrusion entities are allocated and released by millions from all the slicing threads.
+    // They are served from the thread local pools of the TBB scalable allocator instead of the global heap.
+    static void* operator new(size_t size)
+    {
+        if (void *ptr = scalable_malloc(size))
+            return ptr;
+        throw std::bad_alloc();
+    }
+    static void operator delete(void *ptr) { scalable_free(ptr); }
+
     virtual ExtrusionRole role() const = 0;
     virtual bool is_collection() const { return false; }
     virtual bool is_loop() const { return false; }
@@ -5,13 +5,26 @@
 #include <random>
 #include <cassert>
 #include <sstream>
+#include <atomic>
+#include <mutex>
 #include <boost/log/trivial.hpp>
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/task_arena.h>
 
 namespace Slic3r
 {
     using namespace FilamentGroupUtils;
     static constexpr long long ENUM_THRESHOLD = 10000;
     static constexpr long long ENUM_EARLY_EXIT = 10000000;
+    // above this count the search is seeded by k-medoids and may stop on timeout
+    static constexpr long long BRANCH_AND_BOUND_THRESHOLD = 2000000;
+
+    static constexpr int UNPLACEABLE_LIMIT_REWARD = 10000;
+    static constexpr int MAX_SIZE_LIMIT_REWARD = 5000;
+    static constexpr int SUPPORT_PREFER_REWARD = 100;
+    static constexpr int BEST_FIT_LIMIT_REWARD = 10;
     constexpr uint32_t GOLDEN_RATIO_32 = 0x9e3779b9;
 
     // clear the array and heap,save the groups in heap to the array
@@ -93,7 +106,8 @@ namespace Slic3r
         const std::vector<int>& filament_nozzle_map,
         const FilamentGroupContext& ctx,
         std::optional<std::function<bool(int, std::vector<int>&)>> get_custom_seq = std::nullopt,
-        int* out_flush = nullptr)
+        int* out_flush = nullptr,
+        FilamentOrderCache* order_cache = nullptr)
     {
         auto group_res = MultiNozzleUtils::LayeredNozzleGroupResult::create(filament_nozzle_map, ctx.nozzle_info.nozzle_list, used_filaments);
         if (!group_res) {
@@ -123,7 +137,8 @@ namespace Slic3r
             ctx.model_info.flush_matrix,
             get_custom_seq ? *get_custom_seq : std::function<bool(int, std::vector<int>&)>{},
             &filament_sequences,
-            initial_status
+            initial_status,
+            order_cache
         );
 
         if (out_flush) *out_flush = flush;
@@ -203,149 +218,364 @@ namespace Slic3r
         return total / std::max(dedup_factor, 1);
     }
 
-    std::vector<int> FilamentGroup::calc_group_by_enum(
-        int k,
-        const std::vector<unsigned int>& used_filaments,
-        const std::unordered_map<int, std::vector<int>>& unplaceable_limits,
-        int* cost)
+    // Lowest flush needed to enter each filament of a layer from another filament of the same layer.
+    // Within one nozzle every filament except the first one of the layer is entered from a filament of the same layer,
+    // so summing these values and dropping the largest one never overestimates the flush of that nozzle in the layer.
+    struct LayerFlushBound
     {
-        static constexpr int UNPLACEABLE_LIMIT_REWARD = 10000;
-        static constexpr int MAX_SIZE_LIMIT_REWARD = 5000;
-        static constexpr int SUPPORT_PREFER_REWARD = 100;
-        static constexpr int BEST_FIT_LIMIT_REWARD = 10;
-
-        int n = (int)used_filaments.size();
+        std::vector<int> members;               // index in used filaments
+        std::vector<std::vector<int>> min_in;   // [extruder][member]
+        int count{ 0 };                         // layers sharing the same filament set
+    };
 
-        std::vector<std::vector<int>> candidates(n);
-        for (int i = 0; i < n; i++) {
-            std::unordered_set<int> group_set;
-            if (auto it = unplaceable_limits.find(i); it != unplaceable_limits.end()) {
-                for (int g = 0; g < k; g++) group_set.insert(g);
-                for (int g : it->second) group_set.erase(g);
-            } else {
-                for (int g = 0; g < k; g++) group_set.insert(g);
+    static std::vector<LayerFlushBound> build_layer_flush_bounds(const std::vector<unsigned int>& used_filaments, const FilamentGroupContext& ctx)
+    {
+        // the filament sets of the layers are kept as 64 bit masks. Without the bounds the search is still exact, only pruned less
+        if (used_filaments.size() > 64)
+            return {};
+
+        std::map<uint64_t, int> layer_set_count;
+        for (const auto& lf : ctx.model_info.layer_filaments) {
+            uint64_t mask = 0;
+            for (auto f : lf) {
+                auto iter = std::lower_bound(used_filaments.begin(), used_filaments.end(), f);
+                if (iter != used_filaments.end() && *iter == f)
+                    mask |= (1ULL << (iter - used_filaments.begin()));
             }
-            candidates[i].assign(group_set.begin(), group_set.end());
+            if (mask != 0)
+                layer_set_count[mask]++;
         }
 
-        auto vector_equal = [](const std::vector<uint64_t>& a, const std::vector<uint64_t>& b) -> bool {
-            if (a.size() != b.size()) return false;
-            for (size_t i = 0; i < a.size(); i++) {
-                if (a[i] != b[i]) return false;
+        std::vector<LayerFlushBound> bounds;
+        bounds.reserve(layer_set_count.size());
+        for (auto& [mask, count] : layer_set_count) {
+            LayerFlushBound bound;
+            bound.count = count;
+            for (int idx = 0; idx < (int)used_filaments.size(); ++idx)
+                if (mask & (1ULL << idx))
+                    bound.members.emplace_back(idx);
+
+            bound.min_in.resize(ctx.model_info.flush_matrix.size(), std::vector<int>(bound.members.size(), 0));
+            if (bound.members.size() > 1) {
+                for (size_t extruder_id = 0; extruder_id < ctx.model_info.flush_matrix.size(); ++extruder_id) {
+                    const FlushMatrix& matrix = ctx.model_info.flush_matrix[extruder_id];
+                    for (size_t to = 0; to < bound.members.size(); ++to) {
+                        float min_flush = std::numeric_limits<float>::max();
+                        unsigned int to_filament = used_filaments[bound.members[to]];
+                        for (size_t from = 0; from < bound.members.size(); ++from) {
+                            unsigned int from_filament = used_filaments[bound.members[from]];
+                            if (from == to || from_filament >= matrix.size() || to_filament >= matrix[from_filament].size()) {
+                                if (from != to) min_flush = 0;
+                                continue;
+                            }
+                            min_flush = std::min(min_flush, matrix[from_filament][to_filament]);
+                        }
+                        // the flush is accumulated as integer, so keep the bound integral as well
+                        bound.min_in[extruder_id][to] = std::max(0, (int)std::floor(min_flush));
+                    }
+                }
             }
-            return true;
-        };
-        auto vector_hash = [](const std::vector<uint64_t>& v) -> size_t {
-            size_t h = 0;
-            for (auto val : v) { h ^= val + GOLDEN_RATIO_32 + (h << 6) + (h >> 2); }
-            return h;
-        };
-        std::unordered_set<std::vector<uint64_t>, decltype(vector_hash), decltype(vector_equal)> group_set(0, vector_hash, vector_equal);
-        std::vector<uint64_t> group_hashs;
+            bounds.emplace_back(std::move(bound));
+        }
+        return bounds;
+    }
+
+    std::vector<int> FilamentGroup::calc_group_by_branch_and_bound(
+        int k,
+        const std::vector<unsigned int>& used_filaments,
+        const std::unordered_map<int, std::vector<int>>& unplaceable_limits,
+        const std::vector<int>& seed_labels,
+        int* cost,
+        int timeout_ms)
+    {
+        const int n = (int)used_filaments.size();
+        const int master_ex_id = ctx.machine_info.master_extruder_id;
+        const double gap_threshold = ctx.group_info.max_gap_threshold;
+
+        std::vector<std::vector<bool>> placeable(n, std::vector<bool>(k, true));
+        for (auto& [idx, groups] : unplaceable_limits) {
+            if (idx < 0 || idx >= n) continue;
+            for (int g : groups)
+                if (g >= 0 && g < k) placeable[idx][g] = false;
+        }
 
-        std::vector<size_t> nozzles_hash(k);
+        // nozzles with the same hash are interchangeable, only the group filling them in index order is searched
+        std::vector<uint64_t> nozzles_hash(k, 0);
+        std::vector<int> nozzle_extruder(k, 0);
         for (const auto& nozzle : ctx.nozzle_info.nozzle_list) {
             if (nozzle.group_id < k) {
                 auto it = ctx.nozzle_info.nozzle_status.find(nozzle.group_id);
                 int loaded_filament = (it != ctx.nozzle_info.nozzle_status.end()) ? it->second : -1;
                 nozzles_hash[nozzle.group_id] = fnv_hash_nozzle(nozzle.volume_type, nozzle.group_id > 0, loaded_filament);
+                nozzle_extruder[nozzle.group_id] = std::clamp(nozzle.extruder_id, 0, std::max(0, (int)ctx.model_info.flush_matrix.size() - 1));
             }
         }
+        std::vector<std::vector<int>> same_nozzles_before(k);
+        for (int g = 0; g < k; ++g)
+            for (int h = 0; h < g; ++h)
+                if (nozzles_hash[h] == nozzles_hash[g])
+                    same_nozzles_before[g].emplace_back(h);
+
+        std::vector<bool> is_support_only(n, false);
+        for (int i = 0; i < n; ++i)
+            is_support_only[i] = ctx.model_info.filament_info[used_filaments[i]].usage_type == SupportOnly;
+        auto prefer_non_model = [&](int g) {
+            return g < (int)ctx.machine_info.prefer_non_model_filament.size() && ctx.machine_info.prefer_non_model_filament[g];
+        };
+        bool has_prefer_non_model = false;
+        for (int g = 0; g < k; ++g)
+            has_prefer_non_model |= prefer_non_model(g);
 
-        std::vector<int> best_full_map(ctx.group_info.total_filament_num, ctx.machine_info.master_extruder_id);
-        double best_score = std::numeric_limits<double>::max();
-        int best_prefer_level = 0;
-        int best_flush = 0;
-
-        const long long total = (long long)std::pow(k, n);
-        for (long long mask = 0; mask < total; mask++) {
-            long long num = mask;
-            std::unordered_map<int, std::vector<int>> nozzles_filaments;
-            std::vector<int> groups_count(k, 0);
-            std::vector<int> used_labels(n, 0);
-
-            for (int i = 0; i < n; i++) {
-                int g_id = num % k;
-                num /= k;
-                used_labels[i] = g_id;
-                nozzles_filaments[g_id].emplace_back(i);
-                groups_count[g_id]++;
-            }
+        auto exceed_group_size = [&](int g, int count) {
+            return g < (int)ctx.machine_info.max_group_size.size() && count > ctx.machine_info.max_group_size[g];
+        };
 
-            // Hash dedup
-            group_hashs.clear();
-            for (auto& nf : nozzles_filaments) {
-                uint64_t filament_mask = 0;
-                for (int filament : nf.second) filament_mask |= (1ULL << filament);
-                size_t gh = nozzles_hash[nf.first];
-                gh ^= (std::hash<uint64_t>{}(filament_mask) + GOLDEN_RATIO_32 + (gh << 6) + (gh >> 2));
-                group_hashs.emplace_back(gh);
-            }
-            std::sort(group_hashs.begin(), group_hashs.end());
-            if (group_set.find(group_hashs) != group_set.end()) continue;
-            group_set.insert(group_hashs);
-
-            // Prefer level
-            int prefer_level = 0;
-            int placeable_count = 0;
-            for (int i = 0; i < n; i++) {
-                if (std::find(candidates[i].begin(), candidates[i].end(), used_labels[i]) != candidates[i].end())
-                    placeable_count++;
-            }
-            prefer_level += placeable_count * UNPLACEABLE_LIMIT_REWARD;
+        const std::vector<LayerFlushBound> layer_bounds = build_layer_flush_bounds(used_filaments, ctx);
 
-            bool size_ok = true;
-            for (int g = 0; g < k; g++) {
-                if (g < (int)ctx.machine_info.max_group_size.size() && groups_count[g] > ctx.machine_info.max_group_size[g])
-                    size_ok = false;
-            }
-            if (size_ok)
-                prefer_level += MAX_SIZE_LIMIT_REWARD;
+        // partial group, filaments are assigned from the last one to the first one so that the search visits
+        // the groups in the same order as counting up a base-k number
+        struct SearchState
+        {
+            std::vector<int> labels;
+            std::vector<int> groups_count;
+            int placeable_count{ 0 };
+            int exceed_count{ 0 };
+            int support_reward{ 0 };
+            std::vector<int> layer_sum;
+            std::vector<int> layer_max;
+        };
+
+        auto assign = [&](SearchState& state, int idx, int g, int sign) {
+            if (sign > 0) state.labels[idx] = g;
+            bool exceed_before = exceed_group_size(g, state.groups_count[g]);
+            state.groups_count[g] += sign;
+            bool exceed_after = exceed_group_size(g, state.groups_count[g]);
+            state.exceed_count += (int)exceed_after - (int)exceed_before;
+            if (placeable[idx][g]) state.placeable_count += sign;
+            if (is_support_only[idx] && prefer_non_model(g)) state.support_reward += sign * SUPPORT_PREFER_REWARD;
+            if (sign < 0) state.labels[idx] = -1;
+        };
 
+        auto calc_prefer_level = [&](const SearchState& state) {
+            int prefer_level = state.placeable_count * UNPLACEABLE_LIMIT_REWARD;
+            if (state.exceed_count == 0)
+                prefer_level += MAX_SIZE_LIMIT_REWARD;
             if (ctx.group_info.strategy == FGStrategy::BestFit) {
                 bool all_full = true;
                 for (int g = 0; g < k; g++) {
-                    if (g < (int)ctx.machine_info.max_group_size.size() && groups_count[g] < ctx.machine_info.max_group_size[g])
+                    if (g < (int)ctx.machine_info.max_group_size.size() && state.groups_count[g] < ctx.machine_info.max_group_size[g])
                         all_full = false;
                 }
                 if (all_full)
                     prefer_level += BEST_FIT_LIMIT_REWARD;
             }
+            return prefer_level + state.support_reward;
+        };
 
-            for (int g = 0; g < k; g++) {
-                if (g < (int)ctx.machine_info.prefer_non_model_filament.size() && ctx.machine_info.prefer_non_model_filament[g]) {
-                    for (int fidx : nozzles_filaments[g]) {
-                        if (ctx.model_info.filament_info[used_filaments[fidx]].usage_type == SupportOnly)
-                            prefer_level += SUPPORT_PREFER_REWARD;
-                    }
+        // filaments [0, depth) are still unassigned
+        auto calc_prefer_level_upper_bound = [&](const SearchState& state, int depth) {
+            int remaining_support = 0;
+            if (has_prefer_non_model)
+                for (int i = 0; i < depth; ++i)
+                    remaining_support += is_support_only[i];
+            int prefer_level = (state.placeable_count + depth) * UNPLACEABLE_LIMIT_REWARD;
+            if (state.exceed_count == 0)
+                prefer_level += MAX_SIZE_LIMIT_REWARD;
+            if (ctx.group_info.strategy == FGStrategy::BestFit)
+                prefer_level += BEST_FIT_LIMIT_REWARD;
+            return prefer_level + state.support_reward + remaining_support * SUPPORT_PREFER_REWARD;
+        };
+
+        auto calc_flush_lower_bound = [&](SearchState& state) {
+            long long flush = 0;
+            for (const auto& layer : layer_bounds) {
+                std::fill(state.layer_sum.begin(), state.layer_sum.end(), 0);
+                std::fill(state.layer_max.begin(), state.layer_max.end(), 0);
+                for (size_t m = 0; m < layer.members.size(); ++m) {
+                    int g = state.labels[layer.members[m]];
+                    if (g < 0) continue;
+                    int min_in = layer.min_in[nozzle_extruder[g]][m];
+                    state.layer_sum[g] += min_in;
+                    state.layer_max[g] = std::max(state.layer_max[g], min_in);
                 }
+                for (int g = 0; g < k; ++g)
+                    flush += (long long)(state.layer_sum[g] - state.layer_max[g]) * layer.count;
             }
+            return flush;
+        };
 
-            // Build full map and evaluate
-            std::vector<int> full_map(ctx.group_info.total_filament_num, ctx.machine_info.master_extruder_id);
+        auto make_state = [&]() {
+            SearchState state;
+            state.labels.assign(n, -1);
+            state.groups_count.assign(k, 0);
+            state.layer_sum.assign(k, 0);
+            state.layer_max.assign(k, 0);
+            return state;
+        };
+
+        auto build_full_map = [&](const std::vector<int>& labels) {
+            std::vector<int> full_map(ctx.group_info.total_filament_num, master_ex_id);
             for (int i = 0; i < n; ++i)
-                full_map[used_filaments[i]] = used_labels[i];
+                full_map[used_filaments[i]] = labels[i];
+            return full_map;
+        };
 
-            int flush_vol = 0;
-            double score = full_evaluate(used_filaments, full_map, ctx, get_custom_seq, &flush_vol);
+        struct SearchResult
+        {
+            std::vector<int> labels;
+            double score{ std::numeric_limits<double>::max() };
+            int prefer_level{ -1 };
+            int flush{ 0 };
+            MemoryedGroupHeap memoryed_heap;
+
+            bool update(const std::vector<int>& labels_, double score_, int prefer_level_, int flush_) {
+                if (prefer_level_ > prefer_level || (prefer_level_ == prefer_level && score_ < score)) {
+                    labels = labels_;
+                    score = score_;
+                    prefer_level = prefer_level_;
+                    flush = flush_;
+                    return true;
+                }
+                return false;
+            }
+        };
+
+        // best group found by any thread, used for pruning only
+        std::mutex bound_mutex;
+        int bound_prefer_level = -1;
+        double bound_score = std::numeric_limits<double>::max();
+        auto update_bound = [&](int prefer_level, double score) {
+            std::lock_guard<std::mutex> lock(bound_mutex);
+            if (prefer_level > bound_prefer_level || (prefer_level == bound_prefer_level && score < bound_score)) {
+                bound_prefer_level = prefer_level;
+                bound_score = score;
+            }
+        };
 
-            int master_ex_id = ctx.machine_info.master_extruder_id;
-            if (master_ex_id < k && groups_count[master_ex_id] < (int)(used_filaments.size() + 1) / 2)
+        // a subtree can be dropped if none of its groups could become the best one or be memoryed
+        auto can_prune = [&](SearchState& state, int depth) {
+            int prefer_level_ub = calc_prefer_level_upper_bound(state, depth);
+            int best_prefer_level;
+            double best_score;
+            {
+                std::lock_guard<std::mutex> lock(bound_mutex);
+                best_prefer_level = bound_prefer_level;
+                best_score = bound_score;
+            }
+            if (prefer_level_ub < best_prefer_level)
+                return true;
+            if (prefer_level_ub > best_prefer_level)
+                return false;
+            double tolerance = std::max(ABSOLUTE_FLUSH_GAP_TOLERANCE * 6.0, best_score * gap_threshold);
+            double score_lb = evaluate_score(calc_flush_lower_bound(state), 0, true);
+            return score_lb > best_score + tolerance;
+        };
+
+        FlushTimeMachine T;
+        T.time_machine_start();
+        std::atomic<bool> timeout{ false };
+        tbb::enumerable_thread_specific<FilamentOrderCache> order_caches;
+
+        auto evaluate_group = [&](SearchState& state, SearchResult& result, FilamentOrderCache& order_cache) {
+            int flush_vol = 0;
+            double score = full_evaluate(used_filaments, build_full_map(state.labels), ctx, get_custom_seq, &flush_vol, &order_cache);
+            if (master_ex_id < k && state.groups_count[master_ex_id] < (n + 1) / 2)
                 score += ABSOLUTE_FLUSH_GAP_TOLERANCE;
 
-            if (prefer_level > best_prefer_level || (prefer_level == best_prefer_level && score < best_score)) {
-                best_score = score;
-                best_prefer_level = prefer_level;
-                best_full_map = full_map;
-                best_flush = flush_vol;
+            int prefer_level = calc_prefer_level(state);
+            if (result.update(state.labels, score, prefer_level, flush_vol))
+                update_bound(prefer_level, score);
+            update_memoryed_groups(MemoryedGroup(state.labels, score, prefer_level), gap_threshold, result.memoryed_heap);
+        };
+
+        auto search = [&](auto&& self, SearchState& state, int depth, SearchResult& result, FilamentOrderCache& order_cache) -> void {
+            if (timeout.load(std::memory_order_relaxed))
+                return;
+            if (depth == 0) {
+                evaluate_group(state, result, order_cache);
+                if (timeout_ms > 0 && T.time_machine_end() > timeout_ms)
+                    timeout.store(true, std::memory_order_relaxed);
+                return;
+            }
+            int idx = depth - 1;
+            for (int g = 0; g < k; ++g) {
+                if (state.groups_count[g] == 0 &&
+                    std::any_of(same_nozzles_before[g].begin(), same_nozzles_before[g].end(), [&](int h) { return state.groups_count[h] == 0; }))
+                    continue;
+                assign(state, idx, g, 1);
+                if (!can_prune(state, idx))
+                    self(self, state, idx, result, order_cache);
+                assign(state, idx, g, -1);
             }
+        };
+
+        SearchResult best;
+        if ((int)seed_labels.size() == n && std::all_of(seed_labels.begin(), seed_labels.end(), [k](int g) { return g >= 0 && g < k; })) {
+            SearchState state = make_state();
+            for (int i = 0; i < n; ++i)
+                assign(state, i, seed_labels[i], 1);
+            evaluate_group(state, best, order_caches.local());
+        }
+
+        // split the top of the search tree into independent subtrees
+        int split_depth = 0;
+        for (long long count = 1; split_depth < n && count < 8LL * tbb::this_task_arena::max_concurrency(); ++split_depth)
+            count *= k;
+
+        std::vector<std::vector<int>> prefixes;
+        {
+            SearchState state = make_state();
+            auto collect_prefixes = [&](auto&& self, int depth) -> void {
+                if (depth == n - split_depth) {
+                    prefixes.emplace_back(state.labels);
+                    return;
+                }
+                int idx = depth - 1;
+                for (int g = 0; g < k; ++g) {
+                    if (state.groups_count[g] == 0 &&
+                        std::any_of(same_nozzles_before[g].begin(), same_nozzles_before[g].end(), [&](int h) { return state.groups_count[h] == 0; }))
+                        continue;
+                    assign(state, idx, g, 1);
+                    self(self, idx);
+                    assign(state, idx, g, -1);
+                }
+            };
+            collect_prefixes(collect_prefixes, n);
+        }
 
-            MemoryedGroup mg(used_labels, score, prefer_level);
-            update_memoryed_groups(mg, ctx.group_info.max_gap_threshold, m_memoryed_heap);
+        std::vector<SearchResult> results(prefixes.size());
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, prefixes.size()), [&](const tbb::blocked_range<size_t>& range) {
+            for (size_t i = range.begin(); i < range.end(); ++i) {
+                SearchState state = make_state();
+                for (int idx = n - split_depth; idx < n; ++idx)
+                    assign(state, idx, prefixes[i][idx], 1);
+                if (!can_prune(state, n - split_depth))
+                    search(search, state, n - split_depth, results[i], order_caches.local());
+            }
+        });
+
+        // merge in search order so that ties are resolved the same way as a serial search
+        for (auto& result : results) {
+            if (result.prefer_level >= 0)
+                best.update(result.labels, result.score, result.prefer_level, result.flush);
+            while (!result.memoryed_heap.empty()) {
+                best.memoryed_heap.push(result.memoryed_heap.top());
+                result.memoryed_heap.pop();
+            }
         }
+        m_memoryed_heap = MemoryedGroupHeap();
+        while (!best.memoryed_heap.empty()) {
+            update_memoryed_groups(best.memoryed_heap.top(), gap_threshold, m_memoryed_heap);
+            best.memoryed_heap.pop();
+        }
+
+        if (timeout)
+            BOOST_LOG_TRIVIAL(info) << "filament group search timed out after " << T.time_machine_end() << " ms, use the best group found";
 
-        if (cost) *cost = best_flush;
-        return best_full_map;
+        if (best.labels.empty())
+            best.labels.assign(n, master_ex_id);
+        if (cost) *cost = best.flush;
+        return build_full_map(best.labels);
     }
 
     std::vector<int> FilamentGroup::calc_group_by_kmedoids(
@@ -885,7 +1115,15 @@ namespace Slic3r
 
         long long estimated = estimate_dedup_enum_count(k, n, ctx);
         if (estimated < ENUM_THRESHOLD)
-            result = calc_group_by_enum(k, used_filaments, unplaceable_limits, cost);
+            result = calc_group_by_branch_and_bound(k, used_filaments, unplaceable_limits, {}, cost, 0);
+        else if (estimated < BRANCH_AND_BOUND_THRESHOLD && n <= 64) {
+            // a good initial group lets the search prune most of the tree
+            auto seed_map = calc_group_by_kmedoids(k, used_filaments, unplaceable_limits, nullptr, 1000);
+            std::vector<int> seed_labels(n);
+            for (int i = 0; i < n; ++i)
+                seed_labels[i] = seed_map[used_filaments[i]];
+            result = calc_group_by_branch_and_bound(k, used_filaments, unplaceable_limits, seed_labels, cost, 2000);
+        }
         else
             result = calc_group_by_kmedoids(k, used_filaments, unplaceable_limits, cost, 3000);
 
@@ -157,10 +157,17 @@ namespace Slic3r
         std::vector<int> calc_filament_group_for_flush(int* cost = nullptr);
         std::vector<int> calc_filament_group_for_tpu(int* cost = nullptr);
     private:
+        // the tests compare calc_min_flush_group with a plain enumeration of the groups
+        friend struct FilamentGroupTestAccess;
+
         std::vector<int> calc_min_flush_group(int* cost = nullptr);
 
-        std::vector<int> calc_group_by_enum(int k, const std::vector<unsigned int>& used_filaments,
-            const std::unordered_map<int, std::vector<int>>& unplaceable_limits, int* cost = nullptr);
+        // exact search over all distinct groups, pruned by a flush lower bound and evaluated in parallel.
+        // seed_labels is an optional known group used as initial bound. With a positive timeout_ms the search stops
+        // at the timeout with the best group found so far, otherwise it runs until the whole tree is searched
+        std::vector<int> calc_group_by_branch_and_bound(int k, const std::vector<unsigned int>& used_filaments,
+            const std::unordered_map<int, std::vector<int>>& unplaceable_limits, const std::vector<int>& seed_labels = {},
+            int* cost = nullptr, int timeout_ms = 0);
         std::vector<int> calc_group_by_kmedoids(int k, const std::vector<unsigned int>& used_filaments,
             const std::unordered_map<int, std::vector<int>>& unplaceable_limits, int* cost = nullptr, int timeout_ms = 500);
 
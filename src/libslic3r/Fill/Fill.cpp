@@ -1,6 +1,7 @@
 #include <assert.h>
 #include <stdio.h>
 #include <memory>
+#include <optional>
 
 #include "../ClipperUtils.hpp"
 #include "../Geometry.hpp"
@@ -8,6 +9,7 @@
 #include "../Print.hpp"
 #include "../PrintConfig.hpp"
 #include "../Surface.hpp"
+#include "../ThreadLocalCache.hpp"
 
 #include "FillBase.hpp"
 #include "FillRectilinear.hpp"
@@ -16,6 +18,8 @@
 #include "FillConcentric.hpp"
 #include "FillFloatingConcentric.hpp"
 
+#include <boost/functional/hash.hpp>
+
 #define NARROW_INFILL_AREA_THRESHOLD 3
 
 namespace Slic3r {
@@ -594,6 +598,125 @@ void Layer::set_outlook_range(LockRegionParam &lock_param){
         }
     }
 }
+
+// Part of the infill of a layer depending on the index of the layer, see Fill::_layer_angle() and FillGrid::fill_surface().
+// Patterns depending on the print_z, on the neighbour layers or on a per layer state are not listed and are not cached.
+static std::optional<size_t> fill_layer_phase(InfillPattern pattern, size_t layer_id, unsigned short thickness_layers)
+{
+    switch (pattern) {
+    case ipAlignedRectilinear:
+    case ipTriangles:
+    case ipStars:               return 0;
+    case ipRectilinear:
+    case ipMonotonic:
+    case ipMonotonicLine:
+    case ipLine:                return (layer_id / thickness_layers) % 2;
+    case ipHoneycomb:           return (layer_id / thickness_layers) % 3;
+    case ipGrid:                return layer_id % 2;
+    default:                    return std::nullopt;
+    }
+}
+
+// Inputs of filling a surface by a filler. The rectilinear, grid or line infill repeats with the period of two or three layers,
+// the phase of the layer in that period is a part of the key.
+struct FillExtrusionsKey
+{
+    ExPolygon      expolygon;
+    ExPolygons     no_overlap_expolygons;
+    SurfaceType    surface_type;
+    double         thickness;
+    unsigned short thickness_layers;
+    double         bridge_angle;
+    size_t         layer_phase;
+    float          angle;
+    coordf_t       spacing;
+    coord_t        link_max_length;
+    coord_t        loop_clipping;
+    BoundingBox    bounding_box;
+    float          gap_compensation_ratio;
+    FillParams     params;
+    size_t         hash;
+
+    // Key of filling the surface by the filler, empty if the pattern is not cached.
+    static std::optional<FillExtrusionsKey> make(const Fill &fill, const Surface &surface, const FillParams &params)
+    {
+        std::optional<size_t> layer_phase = fill_layer_phase(params.pattern, fill.layer_id, surface.thickness_layers);
+        if (! layer_phase)
+            return std::nullopt;
+        const auto *fill_monoline = dynamic_cast<const FillMonotonicLineWGapFill*>(&fill);
+        FillExtrusionsKey key { surface.expolygon, fill.no_overlap_expolygons, surface.surface_type, surface.thickness, surface.thickness_layers,
+                                surface.bridge_angle, *layer_phase, fill.angle, fill.spacing, fill.link_max_length, fill.loop_clipping, fill.bounding_box,
+                                fill_monoline ? fill_monoline->gap_compensation_ratio : 0.f, params, 0 };
+        key.hash = size_t(params.pattern);
+        boost::hash_combine(key.hash, key.layer_phase);
+        hash_expolygon(key.hash, key.expolygon);
+        for (const ExPolygon &expolygon : key.no_overlap_expolygons)
+            hash_expolygon(key.hash, expolygon);
+        return key;
+    }
+
+    bool operator==(const FillExtrusionsKey &rhs) const {
+        return this->hash == rhs.hash && this->surface_type == rhs.surface_type && this->thickness == rhs.thickness &&
+               this->thickness_layers == rhs.thickness_layers && this->bridge_angle == rhs.bridge_angle && this->layer_phase == rhs.layer_phase &&
+               this->angle == rhs.angle && this->spacing == rhs.spacing && this->link_max_length == rhs.link_max_length &&
+               this->loop_clipping == rhs.loop_clipping && this->bounding_box.min == rhs.bounding_box.min &&
+               this->bounding_box.max == rhs.bounding_box.max && this->gap_compensation_ratio == rhs.gap_compensation_ratio &&
+               fill_params_equal(this->params, rhs.params) && this->expolygon == rhs.expolygon &&
+               this->no_overlap_expolygons == rhs.no_overlap_expolygons;
+    }
+
+private:
+    static void hash_expolygon(size_t &hash, const ExPolygon &expolygon) {
+        boost::hash_combine(hash, expolygon.holes.size());
+        for (const Point &pt : expolygon.contour.points) {
+            boost::hash_combine(hash, pt.x());
+            boost::hash_combine(hash, pt.y());
+        }
+        for (const Polygon &hole : expolygon.holes)
+            for (const Point &pt : hole.points) {
+                boost::hash_combine(hash, pt.x());
+                boost::hash_combine(hash, pt.y());
+            }
+    }
+
+    static bool fill_params_equal(const FillParams &lhs, const FillParams &rhs) {
+        return lhs.filter_out_gap_fill == rhs.filter_out_gap_fill && lhs.density == rhs.density && lhs.multiline == rhs.multiline &&
+               lhs.anchor_length == rhs.anchor_length && lhs.anchor_length_max == rhs.anchor_length_max && lhs.resolution == rhs.resolution &&
+               lhs.dont_adjust == rhs.dont_adjust && lhs.monotonic == rhs.monotonic && lhs.complete == rhs.complete &&
+               lhs.use_arachne == rhs.use_arachne && lhs.layer_height == rhs.layer_height && lhs.pattern == rhs.pattern && lhs.flow == rhs.flow &&
+               lhs.extrusion_role == rhs.extrusion_role && lhs.using_internal_flow == rhs.using_internal_flow &&
+               lhs.no_extrusion_overlap == rhs.no_extrusion_overlap && lhs.dont_sort == rhs.dont_sort && lhs.can_reverse == rhs.can_reverse &&
+               lhs.horiz_move == rhs.horiz_move && lhs.symmetric_infill_y_axis == rhs.symmetric_infill_y_axis &&
+               lhs.symmetric_y_axis == rhs.symmetric_y_axis && lhs.locked_zag == rhs.locked_zag &&
+               lhs.lattice_angle_1 == rhs.lattice_angle_1 && lhs.lattice_angle_2 == rhs.lattice_angle_2;
+    }
+};
+
+// Enough for the surfaces of several regions over the two or three layers of the pattern period.
+static ThreadLocalLRUCache<FillExtrusionsKey, ExtrusionEntityCollection, 32> fill_extrusions_cache;
+
+// Fill the surface by the filler or copy the infill of the same surface filled before by this thread.
+static void fill_surface_extrusion_cached(Fill &fill, const Surface &surface, const FillParams &params, ExtrusionEntitiesPtr &out)
+{
+    std::optional<FillExtrusionsKey> key = FillExtrusionsKey::make(fill, surface, params);
+    if (! key) {
+        fill.fill_surface_extrusion(&surface, params, out);
+        return;
+    }
+    if (const ExtrusionEntityCollection *cached = fill_extrusions_cache.find(*key); cached) {
+        for (const ExtrusionEntity *entity : cached->entities)
+            out.emplace_back(entity->clone());
+        return;
+    }
+    size_t idx = out.size();
+    fill.fill_surface_extrusion(&surface, params, out);
+    ExtrusionEntityCollection cached;
+    cached.entities.reserve(out.size() - idx);
+    for (size_t i = idx; i < out.size(); ++ i)
+        cached.entities.emplace_back(out[i]->clone());
+    fill_extrusions_cache.insert(std::move(*key), std::move(cached));
+}
+
 // friend to Layer
 void Layer::make_fills(FillAdaptive::Octree* adaptive_fill_octree, FillAdaptive::Octree* support_fill_octree, FillLightning::Generator* lightning_generator)
 {
@@ -757,7 +880,7 @@ void Layer::make_fills(FillAdaptive::Octree* adaptive_fill_octree, FillAdaptive:
 			f->spacing = surface_fill.params.spacing;
 			surface_fill.surface.expolygon = std::move(expoly);
 			// BBS: make fill
-			f->fill_surface_extrusion(&surface_fill.surface, params, m_regions[surface_fill.region_id]->fills.entities);
+			fill_surface_extrusion_cached(*f, surface_fill.surface, params, m_regions[surface_fill.region_id]->fills.entities);
 		}
     }
 
@@ -500,13 +500,30 @@ void SL1Archive::export_print(Zipper& zipper,
         zipper.add_entry("prusaslicer.ini");
         zipper << to_ini(slicerconf);
 
-        size_t i = 0;
-        for (const sla::EncodedRaster &rst : m_layers) {
-
-            std::string imgname = project + string_printf("%.5d", i++) + "." +
+        auto write_layer = [&zipper, &project](size_t i, const sla::EncodedRaster &rst) {
+            std::string imgname = project + string_printf("%.5d", i) + "." +
                                   rst.extension();
 
-            zipper.add_entry(imgname.c_str(), rst.data(), rst.size());
+            // the layer images are compressed already
+            zipper.add_entry(imgname.c_str(), rst.data(), rst.size(), Zipper::NO_COMPRESSION);
+        };
+
+        if (m_layers.empty()) {
+            // The layers were not rasterized into this archive, they are drawn,
+            // encoded and written through a bounded pipeline without keeping them.
+            const std::vector<SLAPrint::PrintLayer> &layers = print.print_layers();
+            stream_layers(
+                layers.size(),
+                [&layers](sla::RasterBase &raster, size_t idx) {
+                    for (const ExPolygon &poly : layers[idx].transformed_slices())
+                        raster.draw(poly);
+                },
+                [&write_layer](size_t idx, sla::EncodedRaster &&rst) { write_layer(idx, rst); },
+                []() { return false; },
+                2 * execution::max_concurrency(ex_tbb));
+        } else {
+            for (size_t i = 0; i < m_layers.size(); ++i)
+                write_layer(i, m_layers[i]);
         }
     } catch(std::exception& e) {
         BOOST_LOG_TRIVIAL(error) << e.what();
@@ -39,6 +39,7 @@
 #include "TopExp_Explorer.hxx"
 #include "TopExp_Explorer.hxx"
 #include "BRep_Tool.hxx"
+#include "BRep_Builder.hxx"
 #include "BRepTools.hxx"
 #include <IMeshTools_Parameters.hxx>
 
@@ -384,6 +385,64 @@ static void getNamedSolids(const TopLoc_Location& location,
     }
 }
 
+int NamedSolid::tessellate(double linear_defletion, double angle_defletion, const std::function<bool(const TopoDS_Shape&)> &mesh_fn)
+{
+    auto it = std::find_if(this->tessellations.begin(), this->tessellations.end(), [&](const SolidTessellation &tessellation) {
+        return tessellation.linear_defletion == linear_defletion && tessellation.angle_defletion == angle_defletion;
+    });
+    if (it != this->tessellations.end()) {
+        // Move the reused triangulation to the back, the front one is dropped first.
+        std::rotate(it, it + 1, this->tessellations.end());
+        const SolidTessellation &tessellation = this->tessellations.back();
+        BRep_Builder builder;
+        size_t       face_idx = 0;
+        for (TopExp_Explorer anExpSF(this->solid, TopAbs_FACE); anExpSF.More() && face_idx < tessellation.faces.size(); anExpSF.Next(), ++face_idx)
+            builder.UpdateFace(TopoDS::Face(anExpSF.Current()), tessellation.faces[face_idx]);
+        return tessellation.tri_face_count;
+    }
+
+    BRepTools::Clean(this->solid);
+    if (!mesh_fn(this->solid))
+        return 0;
+    SolidTessellation tessellation;
+    tessellation.linear_defletion = linear_defletion;
+    tessellation.angle_defletion  = angle_defletion;
+    for (TopExp_Explorer anExpSF(this->solid, TopAbs_FACE); anExpSF.More(); anExpSF.Next()) {
+        TopLoc_Location aLoc;
+        Handle(Poly_Triangulation) aTriangulation = BRep_Tool::Triangulation(TopoDS::Face(anExpSF.Current()), aLoc);
+        if (!aTriangulation.IsNull())
+            tessellation.tri_face_count += aTriangulation->NbTriangles();
+        tessellation.faces.emplace_back(aTriangulation);
+    }
+    if (this->tessellations.size() >= max_tessellations)
+        this->tessellations.erase(this->tessellations.begin(), this->tessellations.end() - (max_tessellations - 1));
+    this->tessellations.emplace_back(std::move(tessellation));
+    return this->tessellations.back().tri_face_count;
+}
+
+void NamedSolid::clear_tessellations()
+{
+    BRepTools::Clean(this->solid);
+    this->tessellations.clear();
+}
+
+// Solids to be imported from the solids collected by getNamedSolids() without splitting the compounds,
+// with the compounds split the same way getNamedSolids() splits them. The split solids share the faces with their compound.
+static std::vector<NamedSolid> split_named_solids(const std::vector<NamedSolid> &named_solids, bool isSplitCompound)
+{
+    std::vector<NamedSolid> out;
+    for (const NamedSolid &named_solid : named_solids) {
+        const TopAbs_ShapeEnum shape_type = named_solid.solid.ShapeType();
+        if (isSplitCompound && (shape_type == TopAbs_COMPOUND || shape_type == TopAbs_COMPSOLID)) {
+            int i = 0;
+            for (TopExp_Explorer explorer(named_solid.solid, TopAbs_SOLID); explorer.More(); explorer.Next())
+                out.emplace_back(TopoDS::Solid(explorer.Current()), named_solid.name + "-SOLID-" + std::to_string(++i), named_solid.object_name, named_solid.object_key);
+        } else
+            out.emplace_back(named_solid.solid, named_solid.name, named_solid.object_name, named_solid.object_key);
+    }
+    return out;
+}
+
 //bool load_step(const char *path, Model *model, bool& is_cancel,
 //               double linear_defletion/*=0.003*/,
 //               double angle_defletion/*= 0.5*/,
@@ -689,6 +748,10 @@ Step::Step_Status Step::mesh(Model* model,
     bool cb_cancel = false;
     float progress = .0;
     std::atomic<int> meshed_solid_num = 0;
+    // The solids collected by load() keep the triangulations calculated by get_triangle_num() for the mesh dialog,
+    // triangulate only those, which were not triangulated with the same deflections yet.
+    const bool reuse_solids = !m_name_solids.empty();
+    std::atomic<int> tessellated_solid_num = 0;
     std::vector<NamedSolid> namedSolids;
     float progress_2 = .0;
     const char* last_slash = strrchr(m_path.c_str(), DIR_SEPARATOR);
@@ -704,19 +767,38 @@ Step::Step_Status Step::mesh(Model* model,
         unsigned int objectId{ 1 };
         Standard_Integer topShapeLength = topLevelShapes.Length() + 1;
 
-        for (Standard_Integer iLabel = 1; iLabel < topShapeLength; ++iLabel) {
-            progress = static_cast<double>(iLabel) / (topShapeLength-1);
-            if (cb_cancel) {
+        if (reuse_solids) {
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, m_name_solids.size()), [&](const tbb::blocked_range<size_t>& range) {
+                for (size_t i = range.begin(); i < range.end(); i++) {
+                    if (cb_cancel)
+                        return;
+                    m_name_solids[i].tessellate(linear_defletion, angle_defletion, [&](const TopoDS_Shape& shape) {
+                        BRepMesh_IncrementalMesh mesh(shape, linear_defletion, false, angle_defletion, true);
+                        return true;
+                    });
+                    tessellated_solid_num.fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+            if (cb_cancel)
                 return;
+            namedSolids = split_named_solids(m_name_solids, isSplitCompound);
+        } else {
+            for (Standard_Integer iLabel = 1; iLabel < topShapeLength; ++iLabel) {
+                progress = static_cast<double>(iLabel) / (topShapeLength-1);
+                if (cb_cancel) {
+                    return;
+                }
+                getNamedSolids(TopLoc_Location{}, "", "", id, objectId, m_shape_tool, topLevelShapes.Value(iLabel), namedSolids, isSplitCompound);
             }
-            getNamedSolids(TopLoc_Location{}, "", "", id, objectId, m_shape_tool, topLevelShapes.Value(iLabel), namedSolids, isSplitCompound);
         }
 
         std::vector<stl_file> stl;
         stl.resize(namedSolids.size());
         tbb::parallel_for(tbb::blocked_range<size_t>(0, namedSolids.size()), [&](const tbb::blocked_range<size_t>& range) {
             for (size_t i = range.begin(); i < range.end(); i++) {
-                BRepMesh_IncrementalMesh mesh(namedSolids[i].solid, linear_defletion, false, angle_defletion, true);
+                if (!reuse_solids) {
+                    BRepMesh_IncrementalMesh mesh(namedSolids[i].solid, linear_defletion, false, angle_defletion, true);
+                }
                 // BBS: calculate total number of the nodes and triangles
                 int aNbNodes = 0;
                 int aNbTriangles = 0;
@@ -862,6 +944,9 @@ Step::Step_Status Step::mesh(Model* model,
                 int meshed_solid = meshed_solid_num.load();
                 update_process(LOAD_STEP_STAGE_GET_SOLID, static_cast<int>((float)meshed_solid / namedSolids.size() * 10) + 10, 20, cb_cancel);
             } else {
+                if (reuse_solids)
+                    // first progress, the triangulation of the solids collected by load() stands for their collection
+                    progress = static_cast<float>(tessellated_solid_num.load()) / m_name_solids.size();
                 if (progress > 0) {
                     // first progress
                     update_process(LOAD_STEP_STAGE_GET_SOLID, static_cast<int>(progress * 10), 20, cb_cancel);
@@ -895,9 +980,8 @@ Step::Step_Status Step::mesh(Model* model,
 
 void Step::clean_mesh_data()
 {
-    for (const auto& name_solid : m_name_solids) {
-        BRepTools::Clean(name_solid.solid);
-    }
+    for (auto& name_solid : m_name_solids)
+        name_solid.clear_tessellations();
 }
 
 unsigned int Step::get_triangle_num(double linear_defletion, double angle_defletion)
@@ -905,20 +989,15 @@ unsigned int Step::get_triangle_num(double linear_defletion, double angle_deflet
     unsigned int tri_num = 0;
     try {
         Handle(StepProgressIncdicator) progress = new StepProgressIncdicator(m_stop_mesh);
-        clean_mesh_data();
         IMeshTools_Parameters param;
         param.Deflection = linear_defletion;
         param.Angle = angle_defletion;
         param.InParallel = true;
         for (int i = 0; i < m_name_solids.size(); ++i) {
-            BRepMesh_IncrementalMesh mesh(m_name_solids[i].solid, param, progress->Start());
-            for (TopExp_Explorer anExpSF(m_name_solids[i].solid, TopAbs_FACE); anExpSF.More(); anExpSF.Next()) {
-                TopLoc_Location aLoc;
-                Handle(Poly_Triangulation) aTriangulation = BRep_Tool::Triangulation(TopoDS::Face(anExpSF.Current()), aLoc);
-                if (!aTriangulation.IsNull()) {
-                    tri_num += aTriangulation->NbTriangles();
-                }
-            }
+            tri_num += m_name_solids[i].tessellate(linear_defletion, angle_defletion, [&](const TopoDS_Shape& shape) {
+                BRepMesh_IncrementalMesh mesh(shape, param, progress->Start());
+                return !m_stop_mesh.load();
+            });
             if (m_stop_mesh.load()) {
                 return 0;
             }
@@ -932,20 +1011,13 @@ unsigned int Step::get_triangle_num(double linear_defletion, double angle_deflet
 unsigned int Step::get_triangle_num_tbb(double linear_defletion, double angle_defletion)
 {
     unsigned int tri_num = 0;
-    clean_mesh_data();
     tbb::parallel_for(tbb::blocked_range<size_t>(0, m_name_solids.size()),
     [&](const tbb::blocked_range<size_t>& range) {
         for (size_t i = range.begin(); i < range.end(); i++) {
-            unsigned int solids_tri_num = 0;
-            BRepMesh_IncrementalMesh mesh(m_name_solids[i].solid, linear_defletion, false, angle_defletion, true);
-            for (TopExp_Explorer anExpSF(m_name_solids[i].solid, TopAbs_FACE); anExpSF.More(); anExpSF.Next()) {
-                TopLoc_Location aLoc;
-                Handle(Poly_Triangulation) aTriangulation = BRep_Tool::Triangulation(TopoDS::Face(anExpSF.Current()), aLoc);
-                if (!aTriangulation.IsNull()) {
-                    solids_tri_num += aTriangulation->NbTriangles();
-                }
-            }
-            m_name_solids[i].tri_face_cout = solids_tri_num;
+            m_name_solids[i].tri_face_cout = m_name_solids[i].tessellate(linear_defletion, angle_defletion, [&](const TopoDS_Shape& shape) {
+                BRepMesh_IncrementalMesh mesh(shape, linear_defletion, false, angle_defletion, true);
+                return true;
+            });
         }
 
     });
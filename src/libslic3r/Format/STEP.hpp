@@ -6,7 +6,9 @@
 #include <boost/filesystem/path.hpp>
 #include <boost/filesystem.hpp>
 #include <Message_ProgressIndicator.hxx>
+#include <Poly_Triangulation.hxx>
 #include <atomic>
+#include <functional>
 
 namespace fs = boost::filesystem;
 
@@ -41,6 +43,15 @@ struct StepImportTreeNode
     int                 component_count{0};
 };
 
+// Triangulation of the faces of a solid calculated with the given deflections, in the order of TopExp_Explorer.
+struct SolidTessellation
+{
+    double                                  linear_defletion{ 0. };
+    double                                  angle_defletion{ 0. };
+    std::vector<Handle(Poly_Triangulation)> faces;
+    int                                     tri_face_count{ 0 };
+};
+
 struct NamedSolid
 {
     NamedSolid(const TopoDS_Shape& s,
@@ -53,6 +64,17 @@ struct NamedSolid
     const std::string  object_name;
     const std::string  object_key;
     int tri_face_cout = 0;
+    // Triangulations calculated most recently, to switch between deflections without meshing the solid again.
+    // The least recently used one is dropped when there are more than max_tessellations of them.
+    std::vector<SolidTessellation> tessellations;
+    static constexpr size_t max_tessellations = 3;
+
+    // Triangulate the solid with the deflections by mesh_fn, unless it has been triangulated with the same deflections recently.
+    // In that case the cached triangulation is attached to the faces again. mesh_fn returns false if the meshing was canceled,
+    // then the triangulation is not cached. Returns the number of triangles.
+    int  tessellate(double linear_defletion, double angle_defletion, const std::function<bool(const TopoDS_Shape&)> &mesh_fn);
+    // Remove the triangulation from the faces and drop the cached ones.
+    void clear_tessellations();
 };
 
 //BBS: Load an step file into a provided model.
@@ -138,6 +160,7 @@ private:
     Handle(XCAFApp_Application) m_app = XCAFApp_Application::GetApplication();
     Handle(TDocStd_Document) m_doc;
     Handle(XCAFDoc_ShapeTool) m_shape_tool;
+    // Solids collected by load(), they keep their triangulations between get_triangle_num() and mesh().
     std::vector<NamedSolid> m_name_solids;
     std::vector<std::string> m_unclosed_shells;
 };
@@ -26,6 +26,8 @@
 #include <utility>
 #include <string_view>
 
+#include <fast_float/fast_float.h>
+
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/find.hpp>
 #include <boost/foreach.hpp>
@@ -369,53 +371,119 @@ static std::vector<Vec2d> get_path_of_change_filament(const Print& print)
             : gcodegen.config().nozzle_temperature.get_at(gcodegen.writer().filament()->id());
     }
 
-    std::string transform_gcode(const std::string &gcode, Vec2f pos, const Vec2f &translation, float angle)
+    namespace {
+    // Rotates and translates the XY coordinates of the wipe tower moves line by line. The lines are scanned in place,
+    // only the moves which are rewritten are copied, and the coordinates are formatted without string streams.
+    // The output is the same as when reading the G-code through std::getline() and parsing each line with a stream.
+    class WipeTowerMovesTransformer
     {
-        Vec2f              extruder_offset(0, 0);
-        std::istringstream gcode_str(gcode);
-        std::string        gcode_out;
-        std::string        line;
-        Vec2f              transformed_pos = pos;
-        Vec2f              old_pos(-1000.1f, -1000.1f);
-
-        while (gcode_str) {
-            std::getline(gcode_str, line); // we read the gcode line by line
-
-            if (line.find("G1 ") == 0) {
-                bool never_skip = false;
-                auto it         = line.find(WipeTower::never_skip_tag());
-                if (it != std::string::npos) {
-                    // remove the tag and remember we saw it
-                    never_skip = true;
-                    line.erase(it, it + WipeTower::never_skip_tag().size());
-                }
-                std::ostringstream line_out;
-                std::istringstream line_str(line);
-                line_str >> std::noskipws; // don't skip whitespace
-                char ch = 0;
-                while (line_str >> ch) {
-                    if (ch == 'X' || ch == 'Y')
-                        line_str >> (ch == 'X' ? pos.x() : pos.y());
-                    else
-                        line_out << ch;
-                }
+    public:
+        WipeTowerMovesTransformer(const Vec2f &pos, const Vec2f &translation, float angle, bool transform_arcs) :
+            pos(pos), transformed_pos(pos), m_rotation(angle), m_translation(translation), m_transform_arcs(transform_arcs) {}
 
-                transformed_pos = Eigen::Rotation2Df(angle) * pos + translation;
-
-                if (transformed_pos != old_pos || never_skip) {
-                    line = line_out.str();
-                    std::ostringstream oss;
-                    oss << std::fixed << std::setprecision(3) << "G1 ";
-                    if (transformed_pos.x() != old_pos.x() || never_skip) oss << " X" << transformed_pos.x() - extruder_offset.x();
-                    if (transformed_pos.y() != old_pos.y() || never_skip) oss << " Y" << transformed_pos.y() - extruder_offset.y();
-                    oss << " ";
-                    line.replace(line.find("G1 "), 3, oss.str());
-                    old_pos = transformed_pos;
+        Vec2f pos;
+        Vec2f transformed_pos;
+        Vec2f old_pos { -1000.1f, -1000.1f };
+        Vec2f extruder_offset { 0.f, 0.f };
+
+        // Calls fn for each line of gcode without its new line, as a std::getline() loop would.
+        template<typename Fn> static void for_each_line(const std::string &gcode, Fn &&fn)
+        {
+            std::string_view view(gcode);
+            for (size_t begin = 0;;) {
+                size_t end = view.find('\n', begin);
+                if (end == std::string_view::npos) {
+                    fn(view.substr(begin));
+                    break;
                 }
+                fn(view.substr(begin, end - begin));
+                begin = end + 1;
+            }
+        }
+
+        // All G1 (and optionally G2 / G3) commands are translated and rotated. X and Y coords are
+        // only pushed to the output when they differ from last time.
+        // WT generator can override this by appending the never_skip_tag
+        void append_line(std::string_view line, std::string &out)
+        {
+            if (! (boost::starts_with(line, "G1 ") || (m_transform_arcs && (boost::starts_with(line, "G2 ") || boost::starts_with(line, "G3 "))))) {
+                out += line;
+                out += '\n';
+                return;
+            }
+            const std::string_view gcode_start = line.substr(0, 3);
+            const std::string     &tag         = WipeTower::never_skip_tag();
+            bool                   never_skip  = false;
+            if (size_t it = line.find(tag); it != std::string_view::npos) {
+                // remove the tag and remember we saw it
+                never_skip = true;
+                m_line.assign(line.data(), line.size());
+                m_line.erase(it, it + tag.size());
+                line = m_line;
+            }
+            // copy the line without the X and Y coordinates, a coordinate which fails to parse is zeroed and ends the line
+            m_line_out.clear();
+            for (const char *c = line.data(), *end = line.data() + line.size(); c != end; ++ c) {
+                if (*c == 'X' || *c == 'Y') {
+                    float &v = *c == 'X' ? pos.x() : pos.y();
+                    auto [pend, ec] = fast_float::from_chars(c + 1, end, v);
+                    if (ec != std::errc()) {
+                        v = 0.f;
+                        break;
+                    }
+                    c = pend - 1;
+                } else
+                    m_line_out += *c;
             }
 
-            gcode_out += line + "\n";
+            transformed_pos = m_rotation * pos + m_translation;
+
+            size_t gcode_start_pos;
+            if ((transformed_pos != old_pos || never_skip) && (gcode_start_pos = m_line_out.find(gcode_start)) != std::string::npos) {
+                out.append(m_line_out, 0, gcode_start_pos);
+                out += gcode_start;
+                if (transformed_pos.x() != old_pos.x() || never_skip) {
+                    out += " X";
+                    append_float_decimal_point(out, transformed_pos.x() - extruder_offset.x(), 3);
+                }
+                if (transformed_pos.y() != old_pos.y() || never_skip) {
+                    out += " Y";
+                    append_float_decimal_point(out, transformed_pos.y() - extruder_offset.y(), 3);
+                }
+                out += ' ';
+                out.append(m_line_out, gcode_start_pos + 3);
+                old_pos = transformed_pos;
+            } else
+                out += line;
+            out += '\n';
         }
+
+        // Continuous move after the extruder offset changed.
+        void append_offset_move(std::string &out) const
+        {
+            out += "G1 X";
+            append_float_decimal_point(out, transformed_pos.x() - extruder_offset.x(), 3);
+            out += " Y";
+            append_float_decimal_point(out, transformed_pos.y() - extruder_offset.y(), 3);
+            out += '\n';
+        }
+
+    private:
+        Eigen::Rotation2Df m_rotation;
+        Vec2f              m_translation;
+        bool               m_transform_arcs;
+        // buffers reused between the lines
+        std::string        m_line;
+        std::string        m_line_out;
+    };
+    } // namespace
+
+    std::string transform_gcode(const std::string &gcode, Vec2f pos, const Vec2f &translation, float angle)
+    {
+        WipeTowerMovesTransformer transformer(pos, translation, angle, false);
+        std::string               gcode_out;
+        gcode_out.reserve(gcode.size() + gcode.size() / 4);
+        WipeTowerMovesTransformer::for_each_line(gcode, [&transformer, &gcode_out](std::string_view line) { transformer.append_line(line, gcode_out); });
         return gcode_out;
     }
 
@@ -1240,78 +1308,29 @@ static std::vector<Vec2d> get_path_of_change_filament(const Print& print)
         else
             extruder_offset = m_extruder_offsets[tcr.initial_tool].cast<float>();
 
-        std::istringstream gcode_str(tcr.gcode);
+        WipeTowerMovesTransformer transformer(tcr.start_pos, translation, angle, true);
+        transformer.extruder_offset = extruder_offset;
         std::string gcode_out;
-        std::string line;
-        Vec2f pos = tcr.start_pos;
-        Vec2f transformed_pos = pos;
-        Vec2f old_pos(-1000.1f, -1000.1f);
-
-        while (gcode_str) {
-            std::getline(gcode_str, line);  // we read the gcode line by line
-
-            // All G1 commands should be translated and rotated. X and Y coords are
-            // only pushed to the output when they differ from last time.
-            // WT generator can override this by appending the never_skip_tag
-            if (line.find("G1 ") == 0 || line.find("G2 ") == 0 || line.find("G3 ") == 0) {
-                std::string cur_gcode_start = line.find("G1 ") == 0 ? "G1 " : (line.find("G2 ") == 0 ? "G2 " : "G3 ");
-                bool never_skip = false;
-                auto it = line.find(WipeTower::never_skip_tag());
-                if (it != std::string::npos) {
-                    // remove the tag and remember we saw it
-                    never_skip = true;
-                    line.erase(it, it + WipeTower::never_skip_tag().size());
-                }
-                std::ostringstream line_out;
-                std::istringstream line_str(line);
-                line_str >> std::noskipws;  // don't skip whitespace
-                char ch = 0;
-                while (line_str >> ch) {
-                    if (ch == 'X' || ch == 'Y')
-                        line_str >> (ch == 'X' ? pos.x() : pos.y());
-                    else
-                        line_out << ch;
-                }
-
-                transformed_pos = Eigen::Rotation2Df(angle) * pos + translation;
-
-                if (transformed_pos != old_pos || never_skip) {
-                    line = line_out.str();
-                    std::ostringstream oss;
-                    oss << std::fixed << std::setprecision(3) << cur_gcode_start;
-                    if (transformed_pos.x() != old_pos.x() || never_skip)
-                        oss << " X" << transformed_pos.x() - extruder_offset.x();
-                    if (transformed_pos.y() != old_pos.y() || never_skip)
-                        oss << " Y" << transformed_pos.y() - extruder_offset.y();
-                    oss << " ";
-                    line.replace(line.find(cur_gcode_start), 3, oss.str());
-                    old_pos = transformed_pos;
-                }
-            }
+        gcode_out.reserve(tcr.gcode.size() + tcr.gcode.size() / 4);
 
-            gcode_out += line + "\n";
+        WipeTowerMovesTransformer::for_each_line(tcr.gcode, [this, &tcr, &transformer, &gcode_out](std::string_view line) {
+            transformer.append_line(line, gcode_out);
 
             // If this was a toolchange command, we should change current extruder offset
             if (line == "[change_filament_gcode]") {
                 // BBS
                 if (!m_single_extruder_multi_material) {
-                    extruder_offset = m_extruder_offsets[tcr.new_tool].cast<float>();
+                    transformer.extruder_offset = m_extruder_offsets[tcr.new_tool].cast<float>();
 
                     // If the extruder offset changed, add an extra move so everything is continuous
-                    if (extruder_offset != m_extruder_offsets[tcr.initial_tool].cast<float>()) {
-                        std::ostringstream oss;
-                        oss << std::fixed << std::setprecision(3)
-                            << "G1 X" << transformed_pos.x() - extruder_offset.x()
-                            << " Y" << transformed_pos.y() - extruder_offset.y()
-                            << "\n";
-                        gcode_out += oss.str();
-                    }
+                    if (transformer.extruder_offset != m_extruder_offsets[tcr.initial_tool].cast<float>())
+                        transformer.append_offset_move(gcode_out);
                 }
-                old_pos = Vec2f{-1000.1f, -1000.1f};
-                pos     = tcr.tool_change_start_pos;
-                transformed_pos = pos;
+                transformer.old_pos         = Vec2f{-1000.1f, -1000.1f};
+                transformer.pos             = tcr.tool_change_start_pos;
+                transformer.transformed_pos = transformer.pos;
             }
-        }
+        });
         return gcode_out;
     }
 
@@ -65,6 +65,9 @@ public:
     std::string wipe(GCode &gcodegen, bool toolchange = false, bool is_last = false);
 };
 
+// Rotates and translates the X and Y coordinates of the G1 moves of the wipe tower G-code, pos is the position before the first move.
+std::string transform_gcode(const std::string &gcode, Vec2f pos, const Vec2f &translation, float angle);
+
 class WipeTowerIntegration {
 public:
     WipeTowerIntegration(
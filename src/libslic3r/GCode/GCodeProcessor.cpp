@@ -13,6 +13,8 @@
 #include <boost/filesystem/path.hpp>
 
 #include <fast_float/fast_float.h>
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
 
 #include <float.h>
 #include <assert.h>
@@ -116,6 +118,62 @@ static float get_option_value(const ConfigOptionFloatsNullable& option, size_t i
         ((id < option.values.size()) ? static_cast<float>(option.values[id]) : static_cast<float>(option.values.back()));
 }
 
+static float limits_min_feedrate(const MachineEnvelopeConfig& limits, size_t mode_id, float feedrate)
+{
+    return limits.machine_min_extruding_rate.empty() ? feedrate : std::max(feedrate, get_option_value(limits.machine_min_extruding_rate, mode_id));
+}
+
+static float limits_min_travel_feedrate(const MachineEnvelopeConfig& limits, size_t mode_id, float feedrate)
+{
+    return limits.machine_min_travel_rate.empty() ? feedrate : std::max(feedrate, get_option_value(limits.machine_min_travel_rate, mode_id));
+}
+
+// The speed and acceleration limits are stored for each extruder, normal and stealth mode interleaved.
+static float limits_axis_max_feedrate(const MachineEnvelopeConfig& limits, size_t mode_id, Axis axis, int extruder_id)
+{
+    size_t matched_pos = extruder_id * 2 + mode_id;
+    switch (axis)
+    {
+    case X: { return get_option_value(limits.machine_max_speed_x, matched_pos); }
+    case Y: { return get_option_value(limits.machine_max_speed_y, matched_pos); }
+    case Z: { return get_option_value(limits.machine_max_speed_z, matched_pos); }
+    case E: { return get_option_value(limits.machine_max_speed_e, matched_pos); }
+    default: { return 0.0f; }
+    }
+}
+
+static float limits_axis_max_acceleration(const MachineEnvelopeConfig& limits, size_t mode_id, Axis axis, int extruder_id)
+{
+    size_t matched_pos = extruder_id * 2 + mode_id;
+    switch (axis)
+    {
+    case X: { return get_option_value(limits.machine_max_acceleration_x, matched_pos); }
+    case Y: { return get_option_value(limits.machine_max_acceleration_y, matched_pos); }
+    case Z: { return get_option_value(limits.machine_max_acceleration_z, matched_pos); }
+    case E: { return get_option_value(limits.machine_max_acceleration_e, matched_pos); }
+    default: { return 0.0f; }
+    }
+}
+
+static float limits_axis_max_jerk(const MachineEnvelopeConfig& limits, size_t mode_id, Axis axis)
+{
+    switch (axis)
+    {
+    case X: { return get_option_value(limits.machine_max_jerk_x, mode_id); }
+    case Y: { return get_option_value(limits.machine_max_jerk_y, mode_id); }
+    case Z: { return get_option_value(limits.machine_max_jerk_z, mode_id); }
+    case E: { return get_option_value(limits.machine_max_jerk_e, mode_id); }
+    default: { return 0.0f; }
+    }
+}
+
+static Vec3f limits_xyz_max_jerk(const MachineEnvelopeConfig& limits, size_t mode_id)
+{
+    return Vec3f(get_option_value(limits.machine_max_jerk_x, mode_id),
+        get_option_value(limits.machine_max_jerk_y, mode_id),
+        get_option_value(limits.machine_max_jerk_z, mode_id));
+}
+
 static float estimated_acceleration_distance(float initial_rate, float target_rate, float acceleration)
 {
     return (acceleration == 0.0f) ? 0.0f : (sqr(target_rate) - sqr(initial_rate)) / (2.0f * acceleration);
@@ -183,8 +241,43 @@ CommandProcessor::CommandProcessor()
     root = std::make_unique<TrieNode>();
 }
 
+bool CommandProcessor::parse_numbered_command(std::string_view cmd, size_t& letter_id, size_t& number)
+{
+    // the number is written without leading zeros, as registered
+    if (cmd.size() < 2 || (cmd[1] == '0' && cmd.size() > 2))
+        return false;
+    char letter = cmd[0];
+    if (letter >= 'a' && letter <= 'z')
+        letter_id = size_t(letter - 'a');
+    else if (letter >= 'A' && letter <= 'Z')
+        letter_id = size_t(letter - 'A');
+    else
+        return false;
+    number = 0;
+    for (size_t i = 1; i < cmd.size(); ++i) {
+        if (cmd[i] < '0' || cmd[i] > '9')
+            return false;
+        number = number * 10 + size_t(cmd[i] - '0');
+        // longer numbers are matched by the trie, they would blow up the table
+        if (number > max_command_number)
+            return false;
+    }
+    return true;
+}
+
 void CommandProcessor::register_command(const std::string& str, command_handler_t handler, bool early_quit)
 {
+    size_t letter_id;
+    size_t number;
+    if (!early_quit && parse_numbered_command(str, letter_id, number)) {
+        std::vector<command_handler_t>& handlers = numbered_handlers[letter_id];
+        if (handlers.size() <= number)
+            handlers.resize(number + 1);
+        // the lower case and the upper case commands share the slot
+        handlers[number] = handler;
+        return;
+    }
+
     TrieNode* node = root.get();
     for (char ch : str) {
         auto iter = node->children.find(ch);
@@ -207,6 +300,17 @@ void CommandProcessor::register_command(const std::string& str, command_handler_
 
 bool CommandProcessor::process_comand(std::string_view cmd, const GCodeReader::GCodeLine& line)
 {
+    size_t letter_id;
+    size_t number;
+    if (parse_numbered_command(cmd, letter_id, number)) {
+        const std::vector<command_handler_t>& handlers = numbered_handlers[letter_id];
+        if (number < handlers.size() && handlers[number]) {
+            handlers[number](line);
+            return true;
+        }
+        // may still match an early quit command, as T
+    }
+
     TrieNode* node = root.get();
     for (char ch : cmd) {
         if (node->early_quit && node->handler) {
@@ -413,6 +517,296 @@ void GCodeProcessor::TimeMachine::handle_time_block(const TimeBlock& block, floa
     result.moves[block.move_id].time[activate_machine_idx] = time;
 }
 
+void GCodeProcessor::TimeMachine::init_accelerations(const MachineEnvelopeConfig& limits, size_t mode_id)
+{
+    max_acceleration = get_option_value(limits.machine_max_acceleration_extruding, mode_id);
+    acceleration = (max_acceleration > 0.0f) ? max_acceleration : DEFAULT_ACCELERATION;
+    max_retract_acceleration = get_option_value(limits.machine_max_acceleration_retracting, mode_id);
+    retract_acceleration = (max_retract_acceleration > 0.0f) ? max_retract_acceleration : DEFAULT_RETRACT_ACCELERATION;
+    max_travel_acceleration = get_option_value(limits.machine_max_acceleration_travel, mode_id);
+    travel_acceleration = (max_travel_acceleration > 0.0f) ? max_travel_acceleration : DEFAULT_TRAVEL_ACCELERATION;
+}
+
+void GCodeProcessor::TimeMachine::set_acceleration(float value)
+{
+    // Clamp the acceleration with the maximum.
+    acceleration = (max_acceleration == 0.0f) ? value : std::min(value, max_acceleration);
+}
+
+void GCodeProcessor::TimeMachine::set_retract_acceleration(float value)
+{
+    retract_acceleration = (max_retract_acceleration == 0.0f) ? value : std::min(value, max_retract_acceleration);
+}
+
+void GCodeProcessor::TimeMachine::set_travel_acceleration(float value)
+{
+    travel_acceleration = (max_travel_acceleration == 0.0f) ? value : std::min(value, max_travel_acceleration);
+}
+
+void GCodeProcessor::TimeMachine::plan_move(const PlannerRecord::Move& move, const PlannerRecord::Arc* arc, const MachineEnvelopeConfig& limits, size_t mode_id)
+{
+    TimeBlock block;
+    block.move_type = move.move_type;
+    block.skippable_type = move.skippable_type;
+    block.role = move.role;
+    block.distance = move.distance;
+    block.move_id = move.move_id;
+    block.g1_line_id = move.g1_line_id;
+    block.layer_id = move.layer_id;
+    block.flags.prepare_stage = move.prepare_stage;
+
+    if (move.kind == PlannerRecord::EMoveKind::ToolChange) {
+        // filament change, its time is added by the following synchronization
+        block.distance = 0;
+        block.calculate_trapezoid();
+        blocks.push_back(block);
+        return;
+    }
+
+    const AxisCoords& delta_pos = move.delta_pos;
+    const bool is_arc = move.kind == PlannerRecord::EMoveKind::Arc;
+    assert(!is_arc || arc != nullptr);
+    const bool is_extrusion_only_move = delta_pos[X] == 0.0f && delta_pos[Y] == 0.0f && delta_pos[Z] == 0.0f && delta_pos[E] != 0.0f;
+    const float inv_distance = 1.0f / move.distance;
+    // the arcs are limited by the acceleration before applying the limits of the axes
+    float block_acceleration;
+
+    if (is_arc) {
+        curr.feedrate = (move.move_type == EMoveType::Travel) ?
+            limits_min_travel_feedrate(limits, mode_id, move.feedrate) :
+            limits_min_feedrate(limits, mode_id, move.feedrate);
+
+        //BBS: calculeta enter and exit direction
+        curr.enter_direction = arc->start_dir;
+        curr.exit_direction = arc->end_dir;
+
+        // BBS: calculates block cruise feedrate
+        // For arc move, we need to limite the cruise according to centripetal acceleration which is
+        // same with acceleration in x-y plane. Because arc move part is only on x-y plane, we use x-y acceleration directly
+        float max_feedrate_by_centri_acc = sqrtf(acceleration * arc->radius) / (arc->length * inv_distance);
+        curr.feedrate = std::min(curr.feedrate, max_feedrate_by_centri_acc);
+
+        float min_feedrate_factor = 1.0f;
+        for (unsigned char a = X; a <= E; ++a) {
+            if (a == X || a == Y)
+                //BBS: use resultant feedrate in x-y plane
+                curr.axis_feedrate[a] = curr.feedrate * arc->length * inv_distance;
+            else if (a == Z)
+                curr.axis_feedrate[a] = curr.feedrate * delta_pos[a] * inv_distance;
+            else
+                curr.axis_feedrate[a] *= extrude_factor_override_percentage;
+
+            curr.abs_axis_feedrate[a] = std::abs(curr.axis_feedrate[a]);
+            if (curr.abs_axis_feedrate[a] != 0.0f) {
+                float axis_max_feedrate = limits_axis_max_feedrate(limits, mode_id, static_cast<Axis>(a), move.machine_config_idx);
+                if (axis_max_feedrate != 0.0f) min_feedrate_factor = std::min<float>(min_feedrate_factor, axis_max_feedrate / curr.abs_axis_feedrate[a]);
+            }
+        }
+        curr.feedrate *= min_feedrate_factor;
+        block.feedrate_profile.cruise = curr.feedrate;
+        if (min_feedrate_factor < 1.0f) {
+            for (unsigned char a = X; a <= E; ++a) {
+                curr.axis_feedrate[a] *= min_feedrate_factor;
+                curr.abs_axis_feedrate[a] *= min_feedrate_factor;
+            }
+        }
+
+        //BBS: calculates block acceleration
+        block_acceleration = (move.move_type == EMoveType::Travel) ? travel_acceleration : acceleration;
+        float min_acc_factor = 1.0f;
+        AxisCoords axis_acc;
+        for (unsigned char a = X; a <= Z; ++a) {
+            if (a == X || a == Y)
+                //BBS: use resultant feedrate in x-y plane
+                axis_acc[a] = block_acceleration * arc->length * inv_distance;
+            else
+                axis_acc[a] = block_acceleration * std::abs(delta_pos[a]) * inv_distance;
+
+            if (axis_acc[a] != 0.0f) {
+                float axis_max_acceleration = limits_axis_max_acceleration(limits, mode_id, static_cast<Axis>(a), move.machine_config_idx);
+                if (axis_max_acceleration != 0.0f && axis_acc[a] > axis_max_acceleration) min_acc_factor = std::min<float>(min_acc_factor, axis_max_acceleration / axis_acc[a]);
+            }
+        }
+        block.acceleration = block_acceleration * min_acc_factor;
+    }
+    else {
+        // m_feedrate 从gcode中解析获得，在保证最小速度限制的情况下赋给feedrate
+        curr.feedrate = (delta_pos[E] == 0.0f) ?
+            limits_min_travel_feedrate(limits, mode_id, move.feedrate) :
+            limits_min_feedrate(limits, mode_id, move.feedrate);
+
+        //BBS: calculeta enter and exit direction
+        curr.enter_direction = { static_cast<float>(delta_pos[X]), static_cast<float>(delta_pos[Y]), static_cast<float>(delta_pos[Z]) };
+        float norm = curr.enter_direction.norm();
+        if (!is_extrusion_only_move)
+            curr.enter_direction = curr.enter_direction / norm;
+        curr.exit_direction = curr.enter_direction;
+
+        // calculates block acceleration，计算当前block的最高能到达的加速度
+        block_acceleration =
+            (move.move_type == EMoveType::Travel) ? travel_acceleration :
+            (is_extrusion_only_move ? retract_acceleration : acceleration);
+
+        //BBS: limite the cruise according to centripetal acceleration
+        //Only need to handle when both prev and curr segment has movement in x-y plane
+        if ((prev.exit_direction(0) != 0.0f || prev.exit_direction(1) != 0.0f) &&
+            (curr.enter_direction(0) != 0.0f || curr.enter_direction(1) != 0.0f) &&
+            !is_extrusion_only_move) {
+            Vec3f v1 = prev.exit_direction;
+            v1(2, 0) = 0.0f;
+            v1.normalize();
+            Vec3f v2 = curr.enter_direction;
+            v2(2, 0) = 0.0f;
+            v2.normalize();
+            float norm_diff = (v2 - v1).norm();
+            //BBS: don't need to consider limitation of centripetal acceleration
+            //when angle changing is larger than 28.96 degree or two lines are almost collinear.
+            //Attention!!! these two value must be same with MC side.
+            if (norm_diff < 0.5f && norm_diff > 0.00001f) {
+                //BBS: calculate angle
+                float dot = v1(0) * v2(0) + v1(1) * v2(1);
+                float cross = v1(0) * v2(1) - v1(1) * v2(0);
+                float angle = float(atan2(double(cross), double(dot)));
+                float sin_theta_2 = sqrt((1.0f - cos(angle)) * 0.5f);
+                float r = sqrt(sqr(delta_pos[X]) + sqr(delta_pos[Y])) * 0.5 / sin_theta_2;
+                curr.feedrate = std::min(curr.feedrate, sqrt(block_acceleration * r));
+            }
+        }
+
+        // calculates block cruise feedrate
+        // 刨除前后关系，单纯计算当前block最高能到达的速度
+        float min_feedrate_factor = 1.0f;
+        for (unsigned char a = X; a <= E; ++a) {
+            curr.axis_feedrate[a] = curr.feedrate * delta_pos[a] * inv_distance;
+            if (a == E)
+                curr.axis_feedrate[a] *= extrude_factor_override_percentage;
+
+            curr.abs_axis_feedrate[a] = std::abs(curr.axis_feedrate[a]);
+            if (curr.abs_axis_feedrate[a] != 0.0f) {
+                float axis_max_feedrate = limits_axis_max_feedrate(limits, mode_id, static_cast<Axis>(a), move.machine_config_idx);
+                if (axis_max_feedrate != 0.0f) min_feedrate_factor = std::min<float>(min_feedrate_factor, axis_max_feedrate / curr.abs_axis_feedrate[a]);
+            }
+        }
+        //BBS: update curr.feedrate
+        curr.feedrate *= min_feedrate_factor;
+        block.feedrate_profile.cruise = curr.feedrate;
+
+        if (min_feedrate_factor < 1.0f) {
+            for (unsigned char a = X; a <= E; ++a) {
+                curr.axis_feedrate[a] *= min_feedrate_factor;
+                curr.abs_axis_feedrate[a] *= min_feedrate_factor;
+            }
+        }
+
+        //BBS
+        for (unsigned char a = X; a <= E; ++a) {
+            float axis_max_acceleration = limits_axis_max_acceleration(limits, mode_id, static_cast<Axis>(a), move.machine_config_idx);
+            if (block_acceleration * std::abs(delta_pos[a]) * inv_distance > axis_max_acceleration)
+                block_acceleration = axis_max_acceleration / (std::abs(delta_pos[a]) * inv_distance);
+        }
+
+        block.acceleration = block_acceleration;
+
+        // calculates block exit feedrate
+        curr.safe_feedrate = block.feedrate_profile.cruise;
+    }
+
+    for (unsigned char a = X; a <= E; ++a) {
+        float axis_max_jerk = limits_axis_max_jerk(limits, mode_id, static_cast<Axis>(a));
+        if (curr.abs_axis_feedrate[a] > axis_max_jerk)
+            curr.safe_feedrate = std::min(curr.safe_feedrate, axis_max_jerk);
+    }
+
+    block.feedrate_profile.exit = curr.safe_feedrate;
+
+    static const float PREVIOUS_FEEDRATE_THRESHOLD = 0.0001f;
+
+    // calculates block entry feedrate
+    float vmax_junction = curr.safe_feedrate;
+    if (!blocks.empty() && prev.feedrate > PREVIOUS_FEEDRATE_THRESHOLD) {
+        //BBS: Pick the smaller of the nominal speeds. Higher speed shall not be achieved at the junction during coasting.
+        vmax_junction = std::min(prev.feedrate, block.feedrate_profile.cruise);
+
+        // Limit an axis. We have to differentiate coasting from the reversal of an axis movement, or a full stop.
+        bool limited = false;
+        Vec3f exit_direction_unit = prev.exit_direction.normalized();
+        Vec3f enter_direction_unit = curr.enter_direction.normalized();
+        float k, k_min = 10000.f;
+
+        Vec3f jerk_v = enter_direction_unit - exit_direction_unit;
+        jerk_v = Vec3f(abs(jerk_v.x()), abs(jerk_v.y()), abs(jerk_v.z()));
+        Vec3f max_xyz_jerk_v = limits_xyz_max_jerk(limits, mode_id);
+
+        for (size_t i = 0; i < 3; i++) {
+            if (jerk_v[i] > 0) {
+                limited = true;
+                k = max_xyz_jerk_v[i] / jerk_v[i];
+                if (k < k_min)
+                    k_min = k;
+            }
+        }
+
+        if (limited)
+            vmax_junction = k_min;
+
+        // Now the transition velocity is known, which maximizes the shared exit / entry velocity while
+        // respecting the jerk factors, it may be possible, that applying separate safe exit / entry velocities will achieve faster prints.
+        float vmax_junction_threshold = vmax_junction * 0.99f;
+
+        // Not coasting. The machine will stop and start the movements anyway, better to start the segment from start.
+        if (prev.safe_feedrate > vmax_junction_threshold && curr.safe_feedrate > vmax_junction_threshold)
+            vmax_junction = curr.safe_feedrate;
+    }
+
+    float v_allowable = max_allowable_speed(-block_acceleration, curr.safe_feedrate, block.distance);
+    block.feedrate_profile.entry = std::min(vmax_junction, v_allowable);
+
+    block.max_entry_speed = vmax_junction;
+    block.flags.nominal_length = (block.feedrate_profile.cruise <= v_allowable);
+    block.flags.recalculate = true;
+    block.safe_feedrate = curr.safe_feedrate;
+
+    // calculates block trapezoid
+    block.calculate_trapezoid();
+
+    // updates previous
+    prev = curr;
+
+    blocks.push_back(block);
+}
+
+std::vector<std::pair<CustomGCode::Type, std::pair<float, float>>> GCodeProcessor::TimeMachine::get_custom_gcode_times(bool include_remaining) const
+{
+    std::vector<std::pair<CustomGCode::Type, std::pair<float, float>>> ret;
+    float total_time = 0.0f;
+    for (const auto& [type, time] : gcode_time.times) {
+        float remaining = include_remaining ? this->time - total_time : 0.0f;
+        ret.push_back({ type, { time, remaining } });
+        total_time += time;
+    }
+    return ret;
+}
+
+std::vector<std::pair<EMoveType, float>> GCodeProcessor::TimeMachine::get_moves_time() const
+{
+    std::vector<std::pair<EMoveType, float>> ret;
+    for (size_t i = 0; i < moves_time.size(); ++i) {
+        if (moves_time[i] > 0.0f)
+            ret.push_back({ static_cast<EMoveType>(i), moves_time[i] });
+    }
+    return ret;
+}
+
+std::vector<std::pair<ExtrusionRole, float>> GCodeProcessor::TimeMachine::get_roles_time() const
+{
+    std::vector<std::pair<ExtrusionRole, float>> ret;
+    for (size_t i = 0; i < roles_time.size(); ++i) {
+        if (roles_time[i] > 0.0f)
+            ret.push_back({ static_cast<ExtrusionRole>(i), roles_time[i] });
+    }
+    return ret;
+}
+
 GCodeProcessor::TimeMachine::AdditionalBuffer GCodeProcessor::TimeMachine::merge_adjacent_addtional_time_blocks(const AdditionalBuffer& buffer)
 {
     AdditionalBuffer merged;
@@ -519,6 +913,15 @@ void GCodeProcessor::TimeMachine::calculate_time(size_t keep_last_n_blocks, floa
         blocks.clear();
 }
 
+void GCodeProcessor::PlannerRecord::reset()
+{
+    moves = std::vector<Move>();
+    arcs = std::vector<Arc>();
+    events = std::vector<Event>();
+    enabled_modes.fill(false);
+    valid = true;
+}
+
 void GCodeProcessor::TimeProcessor::reset()
 {
     extruder_unloaded = true;
@@ -1985,17 +2388,8 @@ void GCodeProcessor::apply_config(const PrintConfig& config)
     m_time_processor.hotend_change_times = static_cast<float>(config.machine_hotend_change_time.value);
     m_time_processor.prepare_compensation_time = static_cast<float>(config.machine_prepare_compensation_time.value);
 
-    for (size_t i = 0; i < static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count); ++i) {
-        float max_acceleration = get_option_value(m_time_processor.machine_limits.machine_max_acceleration_extruding, i);
-        m_time_processor.machines[i].max_acceleration = max_acceleration;
-        m_time_processor.machines[i].acceleration = (max_acceleration > 0.0f) ? max_acceleration : DEFAULT_ACCELERATION;
-        float max_retract_acceleration = get_option_value(m_time_processor.machine_limits.machine_max_acceleration_retracting, i);
-        m_time_processor.machines[i].max_retract_acceleration = max_retract_acceleration;
-        m_time_processor.machines[i].retract_acceleration = (max_retract_acceleration > 0.0f) ? max_retract_acceleration : DEFAULT_RETRACT_ACCELERATION;
-        float max_travel_acceleration = get_option_value(m_time_processor.machine_limits.machine_max_acceleration_travel, i);
-        m_time_processor.machines[i].max_travel_acceleration = max_travel_acceleration;
-        m_time_processor.machines[i].travel_acceleration = (max_travel_acceleration > 0.0f) ? max_travel_acceleration : DEFAULT_TRAVEL_ACCELERATION;
-    }
+    for (size_t i = 0; i < static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count); ++i)
+        m_time_processor.machines[i].init_accelerations(m_time_processor.machine_limits, i);
 
     const ConfigOptionFloat* initial_layer_print_height = config.option<ConfigOptionFloat>("initial_layer_print_height");
     if (initial_layer_print_height != nullptr)
@@ -2402,17 +2796,8 @@ void GCodeProcessor::apply_config(const DynamicPrintConfig& config)
             m_time_processor.machine_limits.machine_min_travel_rate.values = machine_min_travel_rate->values;
     }
 
-    for (size_t i = 0; i < static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count); ++i) {
-        float max_acceleration = get_option_value(m_time_processor.machine_limits.machine_max_acceleration_extruding, i);
-        m_time_processor.machines[i].max_acceleration = max_acceleration;
-        m_time_processor.machines[i].acceleration = (max_acceleration > 0.0f) ? max_acceleration : DEFAULT_ACCELERATION;
-        float max_retract_acceleration = get_option_value(m_time_processor.machine_limits.machine_max_acceleration_retracting, i);
-        m_time_processor.machines[i].max_retract_acceleration = max_retract_acceleration;
-        m_time_processor.machines[i].retract_acceleration = (max_retract_acceleration > 0.0f) ? max_retract_acceleration : DEFAULT_RETRACT_ACCELERATION;
-        float max_travel_acceleration = get_option_value(m_time_processor.machine_limits.machine_max_acceleration_travel, i);
-        m_time_processor.machines[i].max_travel_acceleration = max_travel_acceleration;
-        m_time_processor.machines[i].travel_acceleration = (max_travel_acceleration > 0.0f) ? max_travel_acceleration : DEFAULT_TRAVEL_ACCELERATION;
-    }
+    for (size_t i = 0; i < static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count); ++i)
+        m_time_processor.machines[i].init_accelerations(m_time_processor.machine_limits, i);
 
     if (m_flavor == gcfMarlinLegacy || m_flavor == gcfMarlinFirmware) {
         const ConfigOptionBool* silent_mode = config.option<ConfigOptionBool>("silent_mode");
@@ -2521,7 +2906,9 @@ void GCodeProcessor::reset()
     m_producer = EProducer::Unknown;
 
     m_time_processor.reset();
+    m_planner_record.reset();
     m_used_filaments.reset();
+    m_checkpoints.reset();
 
     m_result.reset();
     m_result.id = ++s_result_id;
@@ -2624,20 +3011,35 @@ void GCodeProcessor::process_file(const std::string& filename, std::function<voi
     m_result.id = ++s_result_id;
     // 1st move must be a dummy move
     m_result.moves.emplace_back(GCodeProcessorResult::MoveVertex());
-    size_t parse_line_callback_cntr = 10000;
-    m_parser.parse_file(filename, [this, cancel_callback, &parse_line_callback_cntr](GCodeReader& reader, const GCodeReader::GCodeLine& line) {
-        if (-- parse_line_callback_cntr == 0) {
-            // Don't call the cancel_callback() too often, do it every at every 10000'th line.
-            parse_line_callback_cntr = 10000;
-            if (cancel_callback)
-                cancel_callback();
-        }
-        this->process_gcode_line(line, true);
-    }, m_result.lines_ends);
-    m_result.update_imgui_flag = true;
-    m_result.is_helio_gcode = m_is_helio_gcode;
-    // Don't post-process the G-code to update time stamps.
-    this->finalize(false);
+    m_result.lines_ends.clear();
+    m_checkpoints.reset();
+    process_lines(filename, 0, 0, cancel_callback);
+}
+
+void GCodeProcessor::reprocess_file(const std::string& filename, size_t first_modified_line, std::function<void()> cancel_callback)
+{
+    CNumericLocalesSetter locales_setter;
+
+#if ENABLE_GCODE_VIEWER_STATISTICS
+    m_start_time = std::chrono::high_resolution_clock::now();
+#endif // ENABLE_GCODE_VIEWER_STATISTICS
+
+    // resume from the last checkpoint whose lines were all processed before the modified one
+    std::vector<Checkpoint>& checkpoints = m_checkpoints.items;
+    auto it = std::partition_point(checkpoints.begin(), checkpoints.end(), [first_modified_line](const Checkpoint& checkpoint) {
+        return checkpoint.lines_count < first_modified_line;
+    });
+    if (it == checkpoints.begin())
+        throw Slic3r::RuntimeError(std::string("G-code reprocessing failed.\nThe G-code was not processed with checkpoints.\n"));
+    checkpoints.erase(it, checkpoints.end());
+
+    const Checkpoint& checkpoint = checkpoints.back();
+    BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << boost::format(": resume processing from line %1% of %2% moves") % checkpoint.lines_count % checkpoint.moves_count;
+    restore_checkpoint(checkpoint);
+
+    m_result.filename = filename;
+    m_result.id = ++s_result_id;
+    process_lines(filename, checkpoint.file_pos, checkpoint.lines_count, cancel_callback);
 }
 
 void GCodeProcessor::initialize(const std::string& filename)
@@ -2690,6 +3092,8 @@ void GCodeProcessor::finalize(bool post_process)
         if (gcode_time.needed && gcode_time.cache != 0.0f)
             gcode_time.times.push_back({ CustomGCode::ColorChange, gcode_time.cache });
     }
+    for (size_t i = 0; i < static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count); ++i)
+        m_planner_record.enabled_modes[i] = m_planner_record_enabled && m_time_processor.machines[i].enabled;
 
     m_used_filaments.process_caches(this);
 
@@ -2767,43 +3171,23 @@ std::string GCodeProcessor::get_time_dhm(PrintEstimatedStatistics::ETimeMode mod
 
 std::vector<std::pair<CustomGCode::Type, std::pair<float, float>>> GCodeProcessor::get_custom_gcode_times(PrintEstimatedStatistics::ETimeMode mode, bool include_remaining) const
 {
-    std::vector<std::pair<CustomGCode::Type, std::pair<float, float>>> ret;
-    if (mode < PrintEstimatedStatistics::ETimeMode::Count) {
-        const TimeMachine& machine = m_time_processor.machines[static_cast<size_t>(mode)];
-        float total_time = 0.0f;
-        for (const auto& [type, time] : machine.gcode_time.times) {
-            float remaining = include_remaining ? machine.time - total_time : 0.0f;
-            ret.push_back({ type, { time, remaining } });
-            total_time += time;
-        }
-    }
-    return ret;
+    return (mode < PrintEstimatedStatistics::ETimeMode::Count) ?
+        m_time_processor.machines[static_cast<size_t>(mode)].get_custom_gcode_times(include_remaining) :
+        std::vector<std::pair<CustomGCode::Type, std::pair<float, float>>>();
 }
 
 std::vector<std::pair<EMoveType, float>> GCodeProcessor::get_moves_time(PrintEstimatedStatistics::ETimeMode mode) const
 {
-    std::vector<std::pair<EMoveType, float>> ret;
-    if (mode < PrintEstimatedStatistics::ETimeMode::Count) {
-        for (size_t i = 0; i < m_time_processor.machines[static_cast<size_t>(mode)].moves_time.size(); ++i) {
-            float time = m_time_processor.machines[static_cast<size_t>(mode)].moves_time[i];
-            if (time > 0.0f)
-                ret.push_back({ static_cast<EMoveType>(i), time });
-        }
-    }
-    return ret;
+    return (mode < PrintEstimatedStatistics::ETimeMode::Count) ?
+        m_time_processor.machines[static_cast<size_t>(mode)].get_moves_time() :
+        std::vector<std::pair<EMoveType, float>>();
 }
 
 std::vector<std::pair<ExtrusionRole, float>> GCodeProcessor::get_roles_time(PrintEstimatedStatistics::ETimeMode mode) const
 {
-    std::vector<std::pair<ExtrusionRole, float>> ret;
-    if (mode < PrintEstimatedStatistics::ETimeMode::Count) {
-        for (size_t i = 0; i < m_time_processor.machines[static_cast<size_t>(mode)].roles_time.size(); ++i) {
-            float time = m_time_processor.machines[static_cast<size_t>(mode)].roles_time[i];
-            if (time > 0.0f)
-                ret.push_back({ static_cast<ExtrusionRole>(i), time });
-        }
-    }
-    return ret;
+    return (mode < PrintEstimatedStatistics::ETimeMode::Count) ?
+        m_time_processor.machines[static_cast<size_t>(mode)].get_roles_time() :
+        std::vector<std::pair<ExtrusionRole, float>>();
 }
 
 ConfigSubstitutions load_from_superslicer_gcode_file(const std::string& filename, DynamicPrintConfig& config, ForwardCompatibilitySubstitutionRule compatibility_rule)
@@ -2846,6 +3230,82 @@ std::vector<float> GCodeProcessor::get_layers_time(PrintEstimatedStatistics::ETi
         std::vector<float>();
 }
 
+bool GCodeProcessor::estimate_times(const MachineEnvelopeConfig& machine_limits, PrintEstimatedStatistics& statistics) const
+{
+    const PlannerRecord& record = m_planner_record;
+    if (!record.valid || !record.enabled_modes[static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Normal)])
+        return false;
+
+    std::array<TimeMachine, static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count)> machines;
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, machines.size(), 1), [&record, &machine_limits, &machines](const tbb::blocked_range<size_t>& range) {
+        auto no_handler = [](const TimeBlock&, const float) {};
+        for (size_t i = range.begin(); i < range.end(); ++i) {
+            TimeMachine& machine = machines[i];
+            machine.reset();
+            if (!record.enabled_modes[i])
+                continue;
+            machine.enabled = true;
+            machine.init_accelerations(machine_limits, i);
+
+            // replays the moves and the events in the order they were processed
+            size_t arc_id = 0;
+            auto it_event = record.events.begin();
+            for (size_t move_id = 0; move_id <= record.moves.size(); ++move_id) {
+                for (; it_event != record.events.end() && it_event->moves_count == move_id; ++it_event) {
+                    const PlannerRecord::Event& event = *it_event;
+                    if (event.mode != PrintEstimatedStatistics::ETimeMode::Count && static_cast<size_t>(event.mode) != i)
+                        continue;
+                    switch (event.type)
+                    {
+                    case PlannerRecord::EEventType::Synchronize: { machine.simulate_st_synchronize(event.value, event.role, no_handler); break; }
+                    case PlannerRecord::EEventType::CustomGCodeTime: {
+                        machine.gcode_time.needed = true;
+                        machine.simulate_st_synchronize(0, erNone, no_handler);
+                        if (machine.gcode_time.cache != 0.0f) {
+                            machine.gcode_time.times.push_back({ event.code, machine.gcode_time.cache });
+                            machine.gcode_time.cache = 0.0f;
+                        }
+                        break;
+                    }
+                    case PlannerRecord::EEventType::Acceleration: { machine.set_acceleration(event.value); break; }
+                    case PlannerRecord::EEventType::RetractAcceleration: { machine.set_retract_acceleration(event.value); break; }
+                    case PlannerRecord::EEventType::TravelAcceleration: { machine.set_travel_acceleration(event.value); break; }
+                    case PlannerRecord::EEventType::ExtrudeFactor: { machine.extrude_factor_override_percentage = event.value; break; }
+                    }
+                }
+                if (move_id == record.moves.size())
+                    break;
+
+                const PlannerRecord::Move& move = record.moves[move_id];
+                const PlannerRecord::Arc* arc = (move.kind == PlannerRecord::EMoveKind::Arc) ? &record.arcs[arc_id++] : nullptr;
+                machine.plan_move(move, arc, machine_limits, i);
+                if (move.kind != PlannerRecord::EMoveKind::ToolChange && machine.blocks.size() > TimeProcessor::Planner::refresh_threshold)
+                    machine.calculate_time(TimeProcessor::Planner::queue_size, 0, erNone, no_handler);
+            }
+
+            machine.calculate_time(0, 0, erNone, no_handler);
+            if (machine.gcode_time.needed && machine.gcode_time.cache != 0.0f)
+                machine.gcode_time.times.push_back({ CustomGCode::ColorChange, machine.gcode_time.cache });
+        }
+    });
+
+    for (size_t i = 0; i < machines.size(); ++i) {
+        PrintEstimatedStatistics::Mode& data = statistics.modes[i];
+        const TimeMachine& machine = machines[i];
+        if (!machine.enabled) {
+            data.reset();
+            continue;
+        }
+        data.time = machine.time;
+        data.prepare_time = machine.prepare_time;
+        data.custom_gcode_times = machine.get_custom_gcode_times(true);
+        data.moves_times = machine.get_moves_time();
+        data.roles_times = machine.get_roles_time();
+        data.layers_times = machine.layers_time;
+    }
+    return true;
+}
+
 void GCodeProcessor::apply_config_simplify3d(const std::string& filename)
 {
     struct BedSize
@@ -2958,6 +3418,16 @@ void GCodeProcessor::process_gcode_line(const GCodeReader::GCodeLine& line, bool
     }
 
     if (cmd.length() > 1) {
+        // the moves are most of the lines, they skip the lookup of the handler
+        if (cmd.length() == 2 && (cmd[0] == 'G' || cmd[0] == 'g')) {
+            switch (cmd[1]) {
+            case '0': { process_G0(line); return; }
+            case '1': { process_G1(line); return; }
+            case '2':
+            case '3': { process_G2_G3(line); return; }
+            default: { break; }
+            }
+        }
         // process command lines
         m_command_processor.process_comand(cmd, line);
     }
@@ -2965,11 +3435,11 @@ void GCodeProcessor::process_gcode_line(const GCodeReader::GCodeLine& line, bool
         const std::string &comment = line.raw();
         if (comment.length() > 2 && comment.front() == ';')
         {
-            std::string comment_content = comment.substr(1); // only format like ";V{cmd}" is valid
+            std::string_view comment_content = std::string_view(comment).substr(1); // only format like ";V{cmd}" is valid
             if (comment_content[0] == 'V' || comment_content[0] == 'v') {
                 GCodeReader reader;
                 GCodeReader::GCodeLine new_line;
-                reader.parse_line(comment_content, [&new_line](const auto& greader, const auto& gline) {
+                reader.parse_line(std::string(comment_content), [&new_line](const auto& greader, const auto& gline) {
                     new_line = gline;
                     });
                 m_command_processor.process_comand(new_line.cmd(), new_line);
@@ -4118,192 +4588,24 @@ void GCodeProcessor::process_G1(const GCodeReader::GCodeLine& line)
         return (sq_xyz_length > 0.0f) ? std::sqrt(sq_xyz_length) : std::abs(delta_pos[E]);
     };
 
-    auto is_extrusion_only_move = [](const AxisCoords& delta_pos) {
-        return delta_pos[X] == 0.0f && delta_pos[Y] == 0.0f && delta_pos[Z] == 0.0f && delta_pos[E] != 0.0f;
-    };
-
     float distance = move_length(delta_pos);
     assert(distance != 0.0f);
-    float inv_distance = 1.0f / distance;
-
-    for (size_t i = 0; i < static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count); ++i) {
-        TimeMachine& machine = m_time_processor.machines[i];
-        if (!machine.enabled)
-            continue;
-
-        TimeMachine::State& curr = machine.curr;
-        TimeMachine::State& prev = machine.prev;
-        std::vector<TimeBlock>& blocks = machine.blocks;
-
-        // m_feedrate 从gcode中解析获得，在保证最小速度限制的情况下赋给feedrate
-        curr.feedrate = (delta_pos[E] == 0.0f) ?
-            minimum_travel_feedrate(static_cast<PrintEstimatedStatistics::ETimeMode>(i), m_feedrate) :
-            minimum_feedrate(static_cast<PrintEstimatedStatistics::ETimeMode>(i), m_feedrate);
-
-        //BBS: calculeta enter and exit direction
-        curr.enter_direction = { static_cast<float>(delta_pos[X]), static_cast<float>(delta_pos[Y]), static_cast<float>(delta_pos[Z]) };
-        float norm = curr.enter_direction.norm();
-        if (!is_extrusion_only_move(delta_pos))
-            curr.enter_direction = curr.enter_direction / norm;
-        curr.exit_direction = curr.enter_direction;
-
-        TimeBlock block;
-        block.move_type = type;
-        block.skippable_type = m_skippable_type;
-        //BBS: don't calculate travel time into extrusion path, except travel inside start and end gcode.
-        block.role = (type != EMoveType::Travel || m_extrusion_role == erCustom) ? m_extrusion_role : erNone;
-        block.distance = distance;
-        block.move_id = m_result.moves.size(); // new move will be pushed back at the end of the func, so use size of move as idx
-        block.g1_line_id = m_g1_line_id;
-        block.layer_id = std::max<unsigned int>(1, m_layer_id);
-        block.flags.prepare_stage = m_processing_start_custom_gcode;
-
-        // calculates block acceleration，计算当前block的最高能到达的加速度
-        float acceleration =
-            (type == EMoveType::Travel) ? get_travel_acceleration(static_cast<PrintEstimatedStatistics::ETimeMode>(i)) :
-            (is_extrusion_only_move(delta_pos) ?
-                get_retract_acceleration(static_cast<PrintEstimatedStatistics::ETimeMode>(i)) :
-                get_acceleration(static_cast<PrintEstimatedStatistics::ETimeMode>(i)));
 
-        //BBS: limite the cruise according to centripetal acceleration
-        //Only need to handle when both prev and curr segment has movement in x-y plane
-        if ((prev.exit_direction(0) != 0.0f || prev.exit_direction(1) != 0.0f) &&
-            (curr.enter_direction(0) != 0.0f || curr.enter_direction(1) != 0.0f) &&
-            !is_extrusion_only_move(delta_pos)) {
-            Vec3f v1 = prev.exit_direction;
-            v1(2, 0) = 0.0f;
-            v1.normalize();
-            Vec3f v2 = curr.enter_direction;
-            v2(2, 0) = 0.0f;
-            v2.normalize();
-            float norm_diff = (v2 - v1).norm();
-            //BBS: don't need to consider limitation of centripetal acceleration
-            //when angle changing is larger than 28.96 degree or two lines are almost collinear.
-            //Attention!!! these two value must be same with MC side.
-            if (norm_diff < 0.5f && norm_diff > 0.00001f) {
-                //BBS: calculate angle
-                float dot = v1(0) * v2(0) + v1(1) * v2(1);
-                float cross = v1(0) * v2(1) - v1(1) * v2(0);
-                float angle = float(atan2(double(cross), double(dot)));
-                float sin_theta_2 = sqrt((1.0f - cos(angle)) * 0.5f);
-                float r = sqrt(sqr(delta_pos[X]) + sqr(delta_pos[Y])) * 0.5 / sin_theta_2;
-                curr.feedrate = std::min(curr.feedrate, sqrt(acceleration * r));
-            }
-        }
-
-        // calculates block cruise feedrate
-        // 刨除前后关系，单纯计算当前block最高能到达的速度
-        float min_feedrate_factor = 1.0f;
-        for (unsigned char a = X; a <= E; ++a) {
-            curr.axis_feedrate[a] = curr.feedrate * delta_pos[a] * inv_distance;
-            if (a == E)
-                curr.axis_feedrate[a] *= machine.extrude_factor_override_percentage;
-
-            curr.abs_axis_feedrate[a] = std::abs(curr.axis_feedrate[a]);
-            if (curr.abs_axis_feedrate[a] != 0.0f) {
-                float axis_max_feedrate = get_axis_max_feedrate(static_cast<PrintEstimatedStatistics::ETimeMode>(i), static_cast<Axis>(a), get_machine_config_idx(get_filament_id()));
-                if (axis_max_feedrate != 0.0f) min_feedrate_factor = std::min<float>(min_feedrate_factor, axis_max_feedrate / curr.abs_axis_feedrate[a]);
-            }
-        }
-        //BBS: update curr.feedrate
-        curr.feedrate *= min_feedrate_factor;
-        block.feedrate_profile.cruise = curr.feedrate;
-
-        if (min_feedrate_factor < 1.0f) {
-            for (unsigned char a = X; a <= E; ++a) {
-                curr.axis_feedrate[a] *= min_feedrate_factor;
-                curr.abs_axis_feedrate[a] *= min_feedrate_factor;
-            }
-        }
-
-
-        //BBS
-        for (unsigned char a = X; a <= E; ++a) {
-            float axis_max_acceleration = get_axis_max_acceleration(static_cast<PrintEstimatedStatistics::ETimeMode>(i), static_cast<Axis>(a), get_machine_config_idx(get_filament_id()));
-            if (acceleration * std::abs(delta_pos[a]) * inv_distance > axis_max_acceleration)
-                acceleration = axis_max_acceleration / (std::abs(delta_pos[a]) * inv_distance);
-        }
-
-        block.acceleration = acceleration;
-
-        // calculates block exit feedrate
-        curr.safe_feedrate = block.feedrate_profile.cruise;
-
-        for (unsigned char a = X; a <= E; ++a) {
-            float axis_max_jerk = get_axis_max_jerk(static_cast<PrintEstimatedStatistics::ETimeMode>(i), static_cast<Axis>(a));
-            if (curr.abs_axis_feedrate[a] > axis_max_jerk)
-                curr.safe_feedrate = std::min(curr.safe_feedrate, axis_max_jerk);
-        }
-
-        block.feedrate_profile.exit = curr.safe_feedrate;
-
-        static const float PREVIOUS_FEEDRATE_THRESHOLD = 0.0001f;
-
-        // calculates block entry feedrate
-        float vmax_junction = curr.safe_feedrate;
-        if (!blocks.empty() && prev.feedrate > PREVIOUS_FEEDRATE_THRESHOLD) {
-            vmax_junction = std::min(prev.feedrate, block.feedrate_profile.cruise);
-
-            bool limited = false;
-            Vec3f exit_direction_unit = prev.exit_direction.normalized();
-            Vec3f enter_direction_unit = curr.enter_direction.normalized();
-            float k, k_min = 10000.f;
-
-            for (unsigned char a = X; a <= Z; ++a) {
-                // Limit an axis. We have to differentiate coasting from the reversal of an axis movement, or a full stop.
-                if (a == X) {
-                    Vec3f jerk_v = enter_direction_unit - exit_direction_unit;
-                    jerk_v = Vec3f(abs(jerk_v.x()), abs(jerk_v.y()), abs(jerk_v.z()));
-                    Vec3f max_xyz_jerk_v = get_xyz_max_jerk(static_cast<PrintEstimatedStatistics::ETimeMode>(i));
-
-                    for (size_t i = 0; i < 3; i++){
-                        if (jerk_v[i] > 0) {
-                            limited = true;
-                            k = max_xyz_jerk_v[i] / jerk_v[i];
-                            if (k < k_min)
-                                k_min = k;
-                        }
-                    }
-                }
-                else if (a == Y || a == Z) {
-                    continue;
-                }
-            }
-
-            if (limited)
-                vmax_junction = k_min;
-
-            // Now the transition velocity is known, which maximizes the shared exit / entry velocity while
-            // respecting the jerk factors, it may be possible, that applying separate safe exit / entry velocities will achieve faster prints.
-            float vmax_junction_threshold = vmax_junction * 0.99f;
-
-            // Not coasting. The machine will stop and start the movements anyway, better to start the segment from start.
-            if (prev.safe_feedrate > vmax_junction_threshold && curr.safe_feedrate > vmax_junction_threshold)
-                vmax_junction = curr.safe_feedrate;
-        }
-
-        float v_allowable = max_allowable_speed(-acceleration, curr.safe_feedrate, block.distance);
-        block.feedrate_profile.entry = std::min(vmax_junction, v_allowable);
-
-        block.max_entry_speed = vmax_junction;
-        block.flags.nominal_length = (block.feedrate_profile.cruise <= v_allowable);
-        block.flags.recalculate = true;
-        block.safe_feedrate = curr.safe_feedrate;
-
-        // calculates block trapezoid
-        block.calculate_trapezoid();
-
-        // updates previous
-        prev = curr;
-
-        blocks.push_back(block);
-
-        if (blocks.size() > TimeProcessor::Planner::refresh_threshold) {
-            machine.calculate_time(TimeProcessor::Planner::queue_size, 0, erNone, [&result=m_result, i,&machine](const TimeBlock& block, int time) {
-                machine.handle_time_block(block,time,i,result);
-            });
-        }
-    }
+    PlannerRecord::Move move;
+    move.kind = PlannerRecord::EMoveKind::Line;
+    move.move_type = type;
+    move.skippable_type = m_skippable_type;
+    //BBS: don't calculate travel time into extrusion path, except travel inside start and end gcode.
+    move.role = (type != EMoveType::Travel || m_extrusion_role == erCustom) ? m_extrusion_role : erNone;
+    move.prepare_stage = m_processing_start_custom_gcode;
+    move.machine_config_idx = get_machine_config_idx(get_filament_id());
+    move.move_id = m_result.moves.size(); // new move will be pushed back at the end of the func, so use size of move as idx
+    move.g1_line_id = m_g1_line_id;
+    move.layer_id = std::max<unsigned int>(1, m_layer_id);
+    move.feedrate = m_feedrate;
+    move.distance = distance;
+    move.delta_pos = delta_pos;
+    plan_move(move);
 
     if (m_seams_detector.is_active()) {
         // check for seam starting vertex
@@ -4531,6 +4833,9 @@ void GCodeProcessor::process_VG1(const GCodeReader::GCodeLine& line)
     assert(distance != 0.0f);
     float inv_distance = 1.0f / distance;
 
+    // the planner of the virtual moves is not recorded
+    m_planner_record.valid = false;
+
     for (size_t i = 0; i < static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count); ++i) {
         TimeMachine& machine = m_time_processor.machines[i];
         if (!machine.enabled)
@@ -4935,166 +5240,23 @@ void  GCodeProcessor::process_G2_G3(const GCodeReader::GCodeLine& line)
 
     //BBS: time estimate section
     assert(delta_xyz != 0.0f);
-    float inv_distance = 1.0f / delta_xyz;
-    float radius = ArcSegment::calc_arc_radius(start_point, m_arc_center);
-
-    for (size_t i = 0; i < static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count); ++i) {
-        TimeMachine& machine = m_time_processor.machines[i];
-        if (!machine.enabled)
-            continue;
-
-        TimeMachine::State& curr = machine.curr;
-        TimeMachine::State& prev = machine.prev;
-        std::vector<TimeBlock>& blocks = machine.blocks;
-
-        curr.feedrate = (type == EMoveType::Travel) ?
-            minimum_travel_feedrate(static_cast<PrintEstimatedStatistics::ETimeMode>(i), m_feedrate) :
-            minimum_feedrate(static_cast<PrintEstimatedStatistics::ETimeMode>(i), m_feedrate);
-
-        //BBS: calculeta enter and exit direction
-        curr.enter_direction = start_dir;
-        curr.exit_direction = end_dir;
-
-        TimeBlock block;
-        block.move_type = type;
-        block.skippable_type = m_skippable_type;
-        //BBS: don't calculate travel time into extrusion path, except travel inside start and end gcode.
-        block.role = (type != EMoveType::Travel || m_extrusion_role == erCustom) ? m_extrusion_role : erNone;
-        block.distance = delta_xyz;
-        block.move_id = m_result.moves.size();
-        block.g1_line_id = m_g1_line_id;
-        block.layer_id = std::max<unsigned int>(1, m_layer_id);
-        block.flags.prepare_stage = m_processing_start_custom_gcode;
-
-        // BBS: calculates block cruise feedrate
-        // For arc move, we need to limite the cruise according to centripetal acceleration which is
-        // same with acceleration in x-y plane. Because arc move part is only on x-y plane, we use x-y acceleration directly
-        float centripetal_acceleration = get_acceleration(static_cast<PrintEstimatedStatistics::ETimeMode>(i));
-        float max_feedrate_by_centri_acc = sqrtf(centripetal_acceleration * radius) / (arc_length * inv_distance);
-        curr.feedrate = std::min(curr.feedrate, max_feedrate_by_centri_acc);
-
-        float min_feedrate_factor = 1.0f;
-        for (unsigned char a = X; a <= E; ++a) {
-            if (a == X || a == Y)
-                //BBS: use resultant feedrate in x-y plane
-                curr.axis_feedrate[a] = curr.feedrate * arc_length * inv_distance;
-            else if (a == Z)
-                curr.axis_feedrate[a] = curr.feedrate * delta_pos[a] * inv_distance;
-            else
-                curr.axis_feedrate[a] *= machine.extrude_factor_override_percentage;
-
-            curr.abs_axis_feedrate[a] = std::abs(curr.axis_feedrate[a]);
-            if (curr.abs_axis_feedrate[a] != 0.0f) {
-                float axis_max_feedrate = get_axis_max_feedrate(static_cast<PrintEstimatedStatistics::ETimeMode>(i), static_cast<Axis>(a), get_machine_config_idx(get_filament_id()));
-                if (axis_max_feedrate != 0.0f) min_feedrate_factor = std::min<float>(min_feedrate_factor, axis_max_feedrate / curr.abs_axis_feedrate[a]);
-            }
-        }
-        curr.feedrate *= min_feedrate_factor;
-        block.feedrate_profile.cruise = curr.feedrate;
-        if (min_feedrate_factor < 1.0f) {
-            for (unsigned char a = X; a <= E; ++a) {
-                curr.axis_feedrate[a] *= min_feedrate_factor;
-                curr.abs_axis_feedrate[a] *= min_feedrate_factor;
-            }
-        }
 
-        //BBS: calculates block acceleration
-        float acceleration = (type == EMoveType::Travel) ?
-                              get_travel_acceleration(static_cast<PrintEstimatedStatistics::ETimeMode>(i)) :
-                              get_acceleration(static_cast<PrintEstimatedStatistics::ETimeMode>(i));
-        float min_acc_factor = 1.0f;
-        AxisCoords axis_acc;
-        for (unsigned char a = X; a <= Z; ++a) {
-            if (a == X || a == Y)
-                //BBS: use resultant feedrate in x-y plane
-                axis_acc[a] = acceleration * arc_length * inv_distance;
-            else
-                axis_acc[a] = acceleration * std::abs(delta_pos[a]) * inv_distance;
-
-            if (axis_acc[a] != 0.0f) {
-                float axis_max_acceleration = get_axis_max_acceleration(static_cast<PrintEstimatedStatistics::ETimeMode>(i), static_cast<Axis>(a), get_machine_config_idx(get_filament_id()));
-                if (axis_max_acceleration != 0.0f && axis_acc[a] > axis_max_acceleration) min_acc_factor = std::min<float>(min_acc_factor, axis_max_acceleration / axis_acc[a]);
-            }
-        }
-        block.acceleration = acceleration * min_acc_factor;
-
-        //BBS: calculates block exit feedrate
-        for (unsigned char a = X; a <= E; ++a) {
-            float axis_max_jerk = get_axis_max_jerk(static_cast<PrintEstimatedStatistics::ETimeMode>(i), static_cast<Axis>(a));
-            if (curr.abs_axis_feedrate[a] > axis_max_jerk)
-                curr.safe_feedrate = std::min(curr.safe_feedrate, axis_max_jerk);
-        }
-        block.feedrate_profile.exit = curr.safe_feedrate;
-
-        //BBS: calculates block entry feedrate
-        static const float PREVIOUS_FEEDRATE_THRESHOLD = 0.0001f;
-        float vmax_junction = curr.safe_feedrate;
-        if (!blocks.empty() && prev.feedrate > PREVIOUS_FEEDRATE_THRESHOLD) {
-            //BBS: Pick the smaller of the nominal speeds. Higher speed shall not be achieved at the junction during coasting.
-            vmax_junction = std::min(prev.feedrate, block.feedrate_profile.cruise);
-
-            bool limited = false;
-
-            Vec3f exit_direction_unit = prev.exit_direction.normalized();
-            Vec3f entry_direction_unit = curr.enter_direction.normalized();
-            float k=0, k_min = 10000.f;
-
-            for (unsigned char a = X; a <= Z; ++a) {
-                //BBS: Limit an axis. We have to differentiate coasting from the reversal of an axis movement, or a full stop.
-                if (a == X) {
-                    Vec3f jerk_v = entry_direction_unit - exit_direction_unit;
-                    jerk_v = Vec3f(abs(jerk_v.x()), abs(jerk_v.y()), abs(jerk_v.z()));
-                    Vec3f max_xyz_jerk_v = get_xyz_max_jerk(static_cast<PrintEstimatedStatistics::ETimeMode>(i));
-
-                    for (size_t i = 0; i < 3; i++)
-                    {
-                        if(jerk_v[i] > 0){
-                            limited = true;
-                            k = max_xyz_jerk_v[i] / jerk_v[i];
-                            if(k < k_min)
-                                k_min = k;
-                        }
-                    }
-                }
-                else if (a == Y || a == Z) {
-                    continue;
-                }
-            }
-
-            if (limited)
-                vmax_junction = k_min;
-
-            //BBS: Now the transition velocity is known, which maximizes the shared exit / entry velocity while
-            // respecting the jerk factors, it may be possible, that applying separate safe exit / entry velocities will achieve faster prints.
-            float vmax_junction_threshold = vmax_junction * 0.99f;
-
-            //BBS: Not coasting. The machine will stop and start the movements anyway, better to start the segment from start.
-            if ((prev.safe_feedrate > vmax_junction_threshold) && (curr.safe_feedrate > vmax_junction_threshold))
-                vmax_junction = curr.safe_feedrate;
-        }
-
-        float v_allowable = max_allowable_speed(-acceleration, curr.safe_feedrate, block.distance);
-        block.feedrate_profile.entry = std::min(vmax_junction, v_allowable);
-
-        block.max_entry_speed = vmax_junction;
-        block.flags.nominal_length = (block.feedrate_profile.cruise <= v_allowable);
-        block.flags.recalculate = true;
-        block.safe_feedrate = curr.safe_feedrate;
-
-        //BBS: calculates block trapezoid
-        block.calculate_trapezoid();
-
-        //BBS: updates previous
-        prev = curr;
-
-        blocks.push_back(block);
-
-        if (blocks.size() > TimeProcessor::Planner::refresh_threshold) {
-            machine.calculate_time(TimeProcessor::Planner::queue_size, 0, erNone, [&result=m_result, i,&machine](const TimeBlock& block, int time) {
-                machine.handle_time_block(block,time,i,result);
-            });
-        }
-    }
+    PlannerRecord::Move move;
+    move.kind = PlannerRecord::EMoveKind::Arc;
+    move.move_type = type;
+    move.skippable_type = m_skippable_type;
+    //BBS: don't calculate travel time into extrusion path, except travel inside start and end gcode.
+    move.role = (type != EMoveType::Travel || m_extrusion_role == erCustom) ? m_extrusion_role : erNone;
+    move.prepare_stage = m_processing_start_custom_gcode;
+    move.machine_config_idx = get_machine_config_idx(get_filament_id());
+    move.move_id = m_result.moves.size();
+    move.g1_line_id = m_g1_line_id;
+    move.layer_id = std::max<unsigned int>(1, m_layer_id);
+    move.feedrate = m_feedrate;
+    move.distance = delta_xyz;
+    move.delta_pos = delta_pos;
+    PlannerRecord::Arc arc{ start_dir, end_dir, arc_length, ArcSegment::calc_arc_radius(start_point, m_arc_center) };
+    plan_move(move, &arc);
 
     //BBS: seam detector
     Vec3f plate_offset = {(float) m_x_offset, (float) m_y_offset, 0.0f};
@@ -5602,6 +5764,7 @@ void GCodeProcessor::process_M221(const GCodeReader::GCodeLine& line)
         for (size_t i = 0; i < static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count); ++i) {
             m_time_processor.machines[i].extrude_factor_override_percentage = value_s;
         }
+        record_planner_event(PlannerRecord::EEventType::ExtrudeFactor, PrintEstimatedStatistics::ETimeMode::Count, value_s);
     }
 }
 
@@ -5943,24 +6106,17 @@ void GCodeProcessor::process_filament_change(int id, int nozzle_id)
     store_move_vertex(EMoveType::Tool_change);
 
     // construct a new time block to handle filament change
-    for (size_t i = 0; i < static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count); ++i) {
-        TimeMachine& machine = m_time_processor.machines[i];
-        if (!machine.enabled)
-            continue;
-        TimeBlock block;
-        block.skippable_type = m_skippable_type;
-        block.move_id = m_result.moves.size() - 1;
-        block.role = erFlush;
-        block.move_type = EMoveType::Tool_change;
-        block.layer_id = std::max<unsigned int>(1, m_layer_id);
-        block.g1_line_id = m_g1_line_id;
-        block.flags.prepare_stage = m_processing_start_custom_gcode;
-        block.distance = 0;
-        block.calculate_trapezoid();
-
-        // when do st_sync, we will clear all of the blocks without keeping last n blocks, so we can directly add the new block into the blocks
-        machine.blocks.push_back(block);
-    }
+    PlannerRecord::Move move;
+    move.kind = PlannerRecord::EMoveKind::ToolChange;
+    move.move_type = EMoveType::Tool_change;
+    move.skippable_type = m_skippable_type;
+    move.role = erFlush;
+    move.prepare_stage = m_processing_start_custom_gcode;
+    move.move_id = m_result.moves.size() - 1;
+    move.g1_line_id = m_g1_line_id;
+    move.layer_id = std::max<unsigned int>(1, m_layer_id);
+    // when do st_sync, we will clear all of the blocks without keeping last n blocks, so we can directly add the new block into the blocks
+    plan_move(move);
 
     simulate_st_synchronize(extra_time, erFlush);
 }
@@ -6056,63 +6212,32 @@ void GCodeProcessor::set_skippable_type(const std::string_view type)
 
 float GCodeProcessor::minimum_feedrate(PrintEstimatedStatistics::ETimeMode mode, float feedrate) const
 {
-    if (m_time_processor.machine_limits.machine_min_extruding_rate.empty())
-        return feedrate;
-
-    return std::max(feedrate, get_option_value(m_time_processor.machine_limits.machine_min_extruding_rate, static_cast<size_t>(mode)));
+    return limits_min_feedrate(m_time_processor.machine_limits, static_cast<size_t>(mode), feedrate);
 }
 
 float GCodeProcessor::minimum_travel_feedrate(PrintEstimatedStatistics::ETimeMode mode, float feedrate) const
 {
-    if (m_time_processor.machine_limits.machine_min_travel_rate.empty())
-        return feedrate;
-
-    return std::max(feedrate, get_option_value(m_time_processor.machine_limits.machine_min_travel_rate, static_cast<size_t>(mode)));
+    return limits_min_travel_feedrate(m_time_processor.machine_limits, static_cast<size_t>(mode), feedrate);
 }
 
 float GCodeProcessor::get_axis_max_feedrate(PrintEstimatedStatistics::ETimeMode mode, Axis axis, int extruder_id) const
 {
-    int matched_pos = extruder_id * 2;
-    switch (axis)
-    {
-    case X: { return get_option_value(m_time_processor.machine_limits.machine_max_speed_x, matched_pos + static_cast<size_t>(mode)); }
-    case Y: { return get_option_value(m_time_processor.machine_limits.machine_max_speed_y, matched_pos + static_cast<size_t>(mode)); }
-    case Z: { return get_option_value(m_time_processor.machine_limits.machine_max_speed_z, matched_pos + static_cast<size_t>(mode)); }
-    case E: { return get_option_value(m_time_processor.machine_limits.machine_max_speed_e, matched_pos + static_cast<size_t>(mode)); }
-    default: { return 0.0f; }
-    }
+    return limits_axis_max_feedrate(m_time_processor.machine_limits, static_cast<size_t>(mode), axis, extruder_id);
 }
 
 float GCodeProcessor::get_axis_max_acceleration(PrintEstimatedStatistics::ETimeMode mode, Axis axis, int extruder_id) const
 {
-    int matched_pos = extruder_id * 2;
-    switch (axis)
-    {
-    case X: { return get_option_value(m_time_processor.machine_limits.machine_max_acceleration_x, matched_pos + static_cast<size_t>(mode)); }
-    case Y: { return get_option_value(m_time_processor.machine_limits.machine_max_acceleration_y, matched_pos + static_cast<size_t>(mode)); }
-    case Z: { return get_option_value(m_time_processor.machine_limits.machine_max_acceleration_z, matched_pos + static_cast<size_t>(mode)); }
-    case E: { return get_option_value(m_time_processor.machine_limits.machine_max_acceleration_e, matched_pos + static_cast<size_t>(mode)); }
-    default: { return 0.0f; }
-    }
+    return limits_axis_max_acceleration(m_time_processor.machine_limits, static_cast<size_t>(mode), axis, extruder_id);
 }
 
 float GCodeProcessor::get_axis_max_jerk(PrintEstimatedStatistics::ETimeMode mode, Axis axis) const
 {
-    switch (axis)
-    {
-    case X: { return get_option_value(m_time_processor.machine_limits.machine_max_jerk_x, static_cast<size_t>(mode)); }
-    case Y: { return get_option_value(m_time_processor.machine_limits.machine_max_jerk_y, static_cast<size_t>(mode)); }
-    case Z: { return get_option_value(m_time_processor.machine_limits.machine_max_jerk_z, static_cast<size_t>(mode)); }
-    case E: { return get_option_value(m_time_processor.machine_limits.machine_max_jerk_e, static_cast<size_t>(mode)); }
-    default: { return 0.0f; }
-    }
+    return limits_axis_max_jerk(m_time_processor.machine_limits, static_cast<size_t>(mode), axis);
 }
 
 Vec3f GCodeProcessor::get_xyz_max_jerk(PrintEstimatedStatistics::ETimeMode mode) const
 {
-    return Vec3f(get_option_value(m_time_processor.machine_limits.machine_max_jerk_x, static_cast<size_t>(mode)),
-        get_option_value(m_time_processor.machine_limits.machine_max_jerk_y, static_cast<size_t>(mode)),
-        get_option_value(m_time_processor.machine_limits.machine_max_jerk_z, static_cast<size_t>(mode)));
+    return limits_xyz_max_jerk(m_time_processor.machine_limits, static_cast<size_t>(mode));
 }
 
 float GCodeProcessor::get_retract_acceleration(PrintEstimatedStatistics::ETimeMode mode) const
@@ -6125,9 +6250,8 @@ void GCodeProcessor::set_retract_acceleration(PrintEstimatedStatistics::ETimeMod
 {
     size_t id = static_cast<size_t>(mode);
     if (id < m_time_processor.machines.size()) {
-        m_time_processor.machines[id].retract_acceleration = (m_time_processor.machines[id].max_retract_acceleration == 0.0f) ? value :
-            // Clamp the acceleration with the maximum.
-            std::min(value, m_time_processor.machines[id].max_retract_acceleration);
+        m_time_processor.machines[id].set_retract_acceleration(value);
+        record_planner_event(PlannerRecord::EEventType::RetractAcceleration, mode, value);
     }
 }
 
@@ -6141,9 +6265,8 @@ void GCodeProcessor::set_acceleration(PrintEstimatedStatistics::ETimeMode mode,
 {
     size_t id = static_cast<size_t>(mode);
     if (id < m_time_processor.machines.size()) {
-        m_time_processor.machines[id].acceleration = (m_time_processor.machines[id].max_acceleration == 0.0f) ? value :
-            // Clamp the acceleration with the maximum.
-            std::min(value, m_time_processor.machines[id].max_acceleration);
+        m_time_processor.machines[id].set_acceleration(value);
+        record_planner_event(PlannerRecord::EEventType::Acceleration, mode, value);
     }
 }
 
@@ -6157,9 +6280,8 @@ void GCodeProcessor::set_travel_acceleration(PrintEstimatedStatistics::ETimeMode
 {
     size_t id = static_cast<size_t>(mode);
     if (id < m_time_processor.machines.size()) {
-        m_time_processor.machines[id].travel_acceleration = (m_time_processor.machines[id].max_travel_acceleration == 0.0f) ? value :
-            // Clamp the acceleration with the maximum.
-            std::min(value, m_time_processor.machines[id].max_travel_acceleration);
+        m_time_processor.machines[id].set_travel_acceleration(value);
+        record_planner_event(PlannerRecord::EEventType::TravelAcceleration, mode, value);
     }
 }
 
@@ -6197,6 +6319,8 @@ int GCodeProcessor::get_filament_vitrification_temperature(size_t extrude_id)
 
 void GCodeProcessor::process_custom_gcode_time(CustomGCode::Type code)
 {
+    record_planner_event(PlannerRecord::EEventType::CustomGCodeTime, PrintEstimatedStatistics::ETimeMode::Count, 0.0f, erNone, code);
+
     for (size_t i = 0; i < static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count); ++i) {
         TimeMachine& machine = m_time_processor.machines[i];
         if (!machine.enabled)
@@ -6231,8 +6355,195 @@ void GCodeProcessor::process_filaments(CustomGCode::Type code)
     }
 }
 
+void GCodeProcessor::plan_move(const PlannerRecord::Move& move, const PlannerRecord::Arc* arc)
+{
+    if (m_planner_record_enabled) {
+        m_planner_record.moves.push_back(move);
+        if (arc != nullptr)
+            m_planner_record.arcs.push_back(*arc);
+    }
+
+    for (size_t i = 0; i < static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count); ++i) {
+        TimeMachine& machine = m_time_processor.machines[i];
+        if (!machine.enabled)
+            continue;
+
+        machine.plan_move(move, arc, m_time_processor.machine_limits, i);
+
+        // the tool change block is always followed by a synchronization
+        if (move.kind != PlannerRecord::EMoveKind::ToolChange && machine.blocks.size() > TimeProcessor::Planner::refresh_threshold) {
+            machine.calculate_time(TimeProcessor::Planner::queue_size, 0, erNone, [&result=m_result, i,&machine](const TimeBlock& block, int time) {
+                machine.handle_time_block(block,time,i,result);
+            });
+        }
+    }
+}
+
+void GCodeProcessor::record_planner_event(PlannerRecord::EEventType type, PrintEstimatedStatistics::ETimeMode mode, float value, ExtrusionRole role, CustomGCode::Type code)
+{
+    if (!m_planner_record_enabled)
+        return;
+
+    PlannerRecord::Event event;
+    event.moves_count = m_planner_record.moves.size();
+    event.type = type;
+    event.mode = mode;
+    event.role = role;
+    event.code = code;
+    event.value = value;
+    m_planner_record.events.push_back(event);
+}
+
+void GCodeProcessor::process_lines(const std::string& filename, size_t file_pos, size_t lines_count, std::function<void()> cancel_callback)
+{
+    size_t parse_line_callback_cntr = 10000;
+    m_parser.parse_file(filename, file_pos, [this, cancel_callback, &parse_line_callback_cntr, &lines_count](GCodeReader& reader, const GCodeReader::GCodeLine& line) {
+        if (-- parse_line_callback_cntr == 0) {
+            // Don't call the cancel_callback() too often, do it every at every 10000'th line.
+            parse_line_callback_cntr = 10000;
+            if (cancel_callback)
+                cancel_callback();
+        }
+        // The checkpoint of a layer is saved at the line following the layer change, the parser has then updated its position.
+        // The lines not terminated by '\n' have no line end to resume from, the checkpoints are skipped after them.
+        if (m_checkpoints.enabled && (m_checkpoints.items.empty() || m_checkpoints.items.back().layer_id != m_layer_id) &&
+            m_result.lines_ends.size() == lines_count && !m_options_z_corrector.is_pending())
+            save_checkpoint(m_result.lines_ends.empty() ? 0 : m_result.lines_ends.back(), lines_count);
+        this->process_gcode_line(line, true);
+        ++lines_count;
+    }, m_result.lines_ends);
+    m_result.update_imgui_flag = true;
+    m_result.is_helio_gcode = m_is_helio_gcode;
+
+    if (m_checkpoints.enabled) {
+        // finalize() replaces the layer ids of the moves with the layer durations
+        m_checkpoints.moves_layer_ids.reserve(m_result.moves.size());
+        for (size_t i = m_checkpoints.moves_layer_ids.size(); i < m_result.moves.size(); ++i)
+            m_checkpoints.moves_layer_ids.push_back(static_cast<unsigned int>(m_result.moves[i].layer_duration));
+    }
+
+    // Don't post-process the G-code to update time stamps.
+    this->finalize(false);
+}
+
+void GCodeProcessor::save_checkpoint(size_t file_pos, size_t lines_count)
+{
+    Checkpoint& checkpoint = m_checkpoints.items.emplace_back();
+    checkpoint.file_pos = file_pos;
+    checkpoint.lines_count = lines_count;
+    checkpoint.parser_position = { m_parser.x(), m_parser.y(), m_parser.z(), m_parser.e(), m_parser.f(), m_parser.i(), m_parser.j() };
+
+    BOOST_PP_SEQ_FOR_EACH(GCODE_PROCESSOR_CHECKPOINT_STATE_SAVE, checkpoint, GCODE_PROCESSOR_CHECKPOINT_STATE)
+
+    std::array<std::vector<TimeMachine::G1LinesCacheItem>, static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count)> g1_times_caches;
+    std::array<std::vector<float>, static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count)> layers_times;
+    std::array<std::vector<TimeMachine::StopTime>, static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count)> stop_times;
+    for (size_t i = 0; i < static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count); ++i) {
+        TimeMachine& machine = m_time_processor.machines[i];
+        std::vector<TimeMachine::G1LinesCacheItem>& cache = machine.g1_times_cache;
+        checkpoint.g1_times_cache_size[i] = cache.size();
+        checkpoint.g1_times_cache_back[i] = cache.empty() ? TimeMachine::G1LinesCacheItem{ 0, 0.0f } : cache.back();
+        g1_times_caches[i].swap(cache);
+
+        // the times of the layers and of the stops reached by the blocks still in the planner or by the next blocks may still change
+        unsigned int first_layer_id = std::max<unsigned int>(1, m_layer_id);
+        unsigned int first_g1_line_id = m_g1_line_id;
+        for (const TimeBlock& block : machine.blocks) {
+            first_layer_id = std::min(first_layer_id, std::max<unsigned int>(1, block.layer_id));
+            first_g1_line_id = std::min(first_g1_line_id, block.g1_line_id);
+        }
+        checkpoint.layers_time_size[i] = machine.layers_time.size();
+        checkpoint.layers_time_back[i].assign(machine.layers_time.begin() + std::min<size_t>(first_layer_id - 1, machine.layers_time.size()), machine.layers_time.end());
+        layers_times[i].swap(machine.layers_time);
+        checkpoint.stop_times_size[i] = machine.stop_times.size();
+        checkpoint.stop_times_back[i].assign(std::lower_bound(machine.stop_times.begin(), machine.stop_times.end(), first_g1_line_id,
+            [](const TimeMachine::StopTime& t, unsigned int value) { return t.g1_line_id < value; }), machine.stop_times.end());
+        stop_times[i].swap(machine.stop_times);
+    }
+    checkpoint.time_processor = m_time_processor;
+    for (size_t i = 0; i < static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count); ++i) {
+        TimeMachine& machine = m_time_processor.machines[i];
+        g1_times_caches[i].swap(machine.g1_times_cache);
+        layers_times[i].swap(machine.layers_time);
+        stop_times[i].swap(machine.stop_times);
+    }
+    checkpoint.skippable_part_time = m_result.skippable_part_time;
+
+    checkpoint.planner_moves_count = m_planner_record.moves.size();
+    checkpoint.planner_arcs_count = m_planner_record.arcs.size();
+    checkpoint.planner_events_count = m_planner_record.events.size();
+    checkpoint.planner_record_valid = m_planner_record.valid;
+    checkpoint.moves_count = m_result.moves.size();
+    checkpoint.custom_gcode_per_print_z_count = m_result.custom_gcode_per_print_z.size();
+    checkpoint.spiral_vase_layers_count = m_result.spiral_vase_layers.size();
+    if (!m_result.spiral_vase_layers.empty())
+        checkpoint.spiral_vase_layers_back = m_result.spiral_vase_layers.back();
+}
+
+void GCodeProcessor::restore_checkpoint(const Checkpoint& checkpoint)
+{
+    m_parser.x() = checkpoint.parser_position[0];
+    m_parser.y() = checkpoint.parser_position[1];
+    m_parser.z() = checkpoint.parser_position[2];
+    m_parser.e() = checkpoint.parser_position[3];
+    m_parser.f() = checkpoint.parser_position[4];
+    m_parser.i() = checkpoint.parser_position[5];
+    m_parser.j() = checkpoint.parser_position[6];
+
+    BOOST_PP_SEQ_FOR_EACH(GCODE_PROCESSOR_CHECKPOINT_STATE_RESTORE, checkpoint, GCODE_PROCESSOR_CHECKPOINT_STATE)
+    // the checkpoints are not saved while a z correction is pending
+    m_options_z_corrector.reset();
+
+    std::array<std::vector<TimeMachine::G1LinesCacheItem>, static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count)> g1_times_caches;
+    std::array<std::vector<float>, static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count)> layers_times;
+    std::array<std::vector<TimeMachine::StopTime>, static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count)> stop_times;
+    for (size_t i = 0; i < static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count); ++i) {
+        TimeMachine& machine = m_time_processor.machines[i];
+        g1_times_caches[i].swap(machine.g1_times_cache);
+        layers_times[i].swap(machine.layers_time);
+        stop_times[i].swap(machine.stop_times);
+    }
+    m_time_processor = checkpoint.time_processor;
+    for (size_t i = 0; i < static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count); ++i) {
+        TimeMachine& machine = m_time_processor.machines[i];
+        std::vector<TimeMachine::G1LinesCacheItem>& cache = g1_times_caches[i];
+        cache.resize(checkpoint.g1_times_cache_size[i]);
+        if (!cache.empty())
+            cache.back() = checkpoint.g1_times_cache_back[i];
+        cache.swap(machine.g1_times_cache);
+
+        std::vector<float>& layers_time = layers_times[i];
+        layers_time.resize(checkpoint.layers_time_size[i]);
+        std::copy(checkpoint.layers_time_back[i].begin(), checkpoint.layers_time_back[i].end(), layers_time.end() - checkpoint.layers_time_back[i].size());
+        layers_time.swap(machine.layers_time);
+        std::vector<TimeMachine::StopTime>& stops = stop_times[i];
+        stops.resize(checkpoint.stop_times_size[i]);
+        std::copy(checkpoint.stop_times_back[i].begin(), checkpoint.stop_times_back[i].end(), stops.end() - checkpoint.stop_times_back[i].size());
+        stops.swap(machine.stop_times);
+    }
+    m_result.skippable_part_time = checkpoint.skippable_part_time;
+
+    m_planner_record.moves.resize(checkpoint.planner_moves_count);
+    m_planner_record.arcs.resize(checkpoint.planner_arcs_count);
+    m_planner_record.events.resize(checkpoint.planner_events_count);
+    m_planner_record.valid = checkpoint.planner_record_valid;
+
+    // the moves before the checkpoint are kept, their times are completed by the blocks still in the planner
+    m_result.moves.erase(m_result.moves.begin() + checkpoint.moves_count, m_result.moves.end());
+    m_checkpoints.moves_layer_ids.resize(checkpoint.moves_count);
+    for (size_t i = 0; i < checkpoint.moves_count; ++i)
+        m_result.moves[i].layer_duration = static_cast<float>(m_checkpoints.moves_layer_ids[i]);
+    m_result.lines_ends.resize(checkpoint.lines_count);
+    m_result.custom_gcode_per_print_z.erase(m_result.custom_gcode_per_print_z.begin() + checkpoint.custom_gcode_per_print_z_count, m_result.custom_gcode_per_print_z.end());
+    m_result.spiral_vase_layers.resize(checkpoint.spiral_vase_layers_count);
+    if (!m_result.spiral_vase_layers.empty())
+        m_result.spiral_vase_layers.back() = checkpoint.spiral_vase_layers_back;
+}
+
 void GCodeProcessor::simulate_st_synchronize(float additional_time, ExtrusionRole target_role)
 {
+    record_planner_event(PlannerRecord::EEventType::Synchronize, PrintEstimatedStatistics::ETimeMode::Count, additional_time, target_role);
+
     for (size_t i = 0; i < static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count); ++i) {
         TimeMachine& machine = m_time_processor.machines[i];
         if (!machine.enabled)
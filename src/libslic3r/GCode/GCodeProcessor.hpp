@@ -9,6 +9,9 @@
 #include "libslic3r/Extruder.hpp"
 #include "libslic3r/MultiNozzleUtils.hpp"
 
+#include <boost/preprocessor/cat.hpp>
+#include <boost/preprocessor/seq/for_each.hpp>
+
 #include <cstdint>
 #include <array>
 #include <vector>
@@ -431,14 +434,34 @@ namespace Slic3r {
             std::unordered_map<char, std::unique_ptr<TrieNode>> children;
             bool early_quit{ false }; // stop matching, trigger handle imediately
         };
+        // The commands made of a letter and a number (G28, M104) are most of the commands,
+        // they are looked up in a dense table per letter indexed by the number, case insensitive.
+        static constexpr size_t max_command_number = 9999;
+        static bool parse_numbered_command(std::string_view cmd, size_t& letter_id, size_t& number);
     public:
         CommandProcessor();
         void register_command(const std::string& str, command_handler_t handler,bool early_quit = false);
         bool process_comand(std::string_view cmd, const GCodeReader::GCodeLine& line);
     private:
         std::unique_ptr<TrieNode> root;
+        std::array<std::vector<command_handler_t>, 26> numbered_handlers;
     };
 
+// Members of GCodeProcessor (without the m_ prefix) holding the state of the line by line processing, which is saved
+// by the checkpoints of the layers. A member added to this state has to be listed here to be restored by reprocess_file().
+#define GCODE_PROCESSOR_CHECKPOINT_STATE \
+    (nozzle_status_recorder) (units) (global_positioning_type) (e_local_positioning_type) (start_position) \
+    (end_position) (origin) (cached_position) (wiping) (flushing) (virtual_flushing) (wipe_tower) (skippable) \
+    (skippable_type) (object_label_id) (print_z) (remaining_volume) (move_path_type) (arc_center) (line_id) \
+    (last_line_id) (feedrate) (width) (height) (forced_width) (forced_height) (mm3_per_mm) (fan_speed) \
+    (additional_fan_speed) (extrusion_role) (last_filament_id) (filament_id) (extruder_id) (extruder_colors) \
+    (extruder_temps) (thermal_index) (is_helio_gcode) (highest_bed_temp) (extruded_last_z) (first_layer_height) \
+    (zero_layer_height) (processing_start_custom_gcode) (pa_line_calibration) (g1_line_id) (layer_id) (cp_color) \
+    (seams_detector) (last_default_color_id) (seams_count) (measure_g29_time) (used_filaments)
+#define GCODE_PROCESSOR_CHECKPOINT_STATE_DEFINITION(r, data, elem) decltype(GCodeProcessor::BOOST_PP_CAT(m_, elem)) elem;
+#define GCODE_PROCESSOR_CHECKPOINT_STATE_SAVE(r, checkpoint, elem) checkpoint.elem = BOOST_PP_CAT(m_, elem);
+#define GCODE_PROCESSOR_CHECKPOINT_STATE_RESTORE(r, checkpoint, elem) BOOST_PP_CAT(m_, elem) = checkpoint.elem;
+
 
     class GCodeProcessor
     {
@@ -599,6 +622,77 @@ namespace Slic3r {
 
 
     private:
+        // Inputs of the time estimator which do not depend on the machine limits, recorded while processing
+        // when enabled by enable_planner_record(). estimate_times() replays them through the planner.
+        struct PlannerRecord
+        {
+            enum class EMoveKind : unsigned char
+            {
+                Line,
+                Arc,
+                ToolChange
+            };
+
+            struct Move
+            {
+                EMoveKind kind{ EMoveKind::Line };
+                EMoveType move_type{ EMoveType::Noop };
+                ExtrusionRole role{ erNone };
+                SkipType skippable_type{ SkipType::stNone };
+                bool prepare_stage{ false };
+                // index of the machine limits used by the move, see get_machine_config_idx()
+                int machine_config_idx{ 0 };
+                unsigned int move_id{ 0 };
+                unsigned int g1_line_id{ 0 };
+                unsigned int layer_id{ 0 };
+                // feedrate requested by the G-code
+                float feedrate{ 0.0f }; // mm/s
+                float distance{ 0.0f }; // mm
+                AxisCoords delta_pos{ 0.0, 0.0, 0.0, 0.0 }; // mm
+            };
+
+            // Geometry of the arc moves, stored in the order of the moves of kind Arc.
+            struct Arc
+            {
+                Vec3f start_dir;
+                Vec3f end_dir;
+                float length; // mm
+                float radius; // mm
+            };
+
+            enum class EEventType : unsigned char
+            {
+                Synchronize,
+                CustomGCodeTime,
+                Acceleration,
+                RetractAcceleration,
+                TravelAcceleration,
+                ExtrudeFactor
+            };
+
+            struct Event
+            {
+                // number of moves recorded before the event
+                size_t moves_count{ 0 };
+                EEventType type{ EEventType::Synchronize };
+                // time mode the event applies to, Count for all of them
+                PrintEstimatedStatistics::ETimeMode mode{ PrintEstimatedStatistics::ETimeMode::Count };
+                ExtrusionRole role{ erNone };
+                CustomGCode::Type code{ CustomGCode::ColorChange };
+                float value{ 0.0f };
+            };
+
+            std::vector<Move> moves;
+            std::vector<Arc> arcs;
+            std::vector<Event> events;
+            // time modes enabled when the processing was finalized
+            std::array<bool, static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count)> enabled_modes;
+            // false if the G-code contains moves which cannot be replayed
+            bool valid;
+
+            void reset();
+        };
+
         struct TimeMachine
         {
             struct State
@@ -700,6 +794,21 @@ namespace Slic3r {
             void calculate_time(size_t keep_last_n_blocks = 0, float additional_time = 0.0f, ExtrusionRole target_role = ExtrusionRole::erNone, block_handler_t block_handler = block_handler_t());
 
             void handle_time_block(const TimeBlock& block, float time, int activate_machine_idx, GCodeProcessorResult& result);
+
+            // Sets the accelerations and their hard limits to the maximum values of the given machine limits.
+            void init_accelerations(const MachineEnvelopeConfig& limits, size_t mode_id);
+            // Set the accelerations requested by the G-code, clamped with the hard limits.
+            void set_acceleration(float value);
+            void set_retract_acceleration(float value);
+            void set_travel_acceleration(float value);
+
+            // Builds the planner block of the given move and appends it to the blocks.
+            // The arc geometry is required for the moves of kind Arc.
+            void plan_move(const PlannerRecord::Move& move, const PlannerRecord::Arc* arc, const MachineEnvelopeConfig& limits, size_t mode_id);
+
+            std::vector<std::pair<CustomGCode::Type, std::pair<float, float>>> get_custom_gcode_times(bool include_remaining) const;
+            std::vector<std::pair<EMoveType, float>> get_moves_time() const;
+            std::vector<std::pair<ExtrusionRole, float>> get_roles_time() const;
         };
 
         struct UsedFilaments  // filaments per ColorChange
@@ -1034,6 +1143,9 @@ namespace Slic3r {
                 m_move_id.reset();
                 m_custom_gcode_per_print_z_id.reset();
             }
+
+            // true if the z of an option is waiting for the next move
+            bool is_pending() const { return m_move_id.has_value(); }
         };
 
 #if ENABLE_GCODE_VIEWER_DATA_CHECKING
@@ -1206,8 +1318,59 @@ namespace Slic3r {
         EProducer m_producer;
 
         TimeProcessor m_time_processor;
+        bool m_planner_record_enabled{ false };
+        PlannerRecord m_planner_record;
         UsedFilaments m_used_filaments;
 
+        // Processing state at the beginning of a layer, saved by process_file() when enabled by enable_checkpoints().
+        // reprocess_file() resumes the processing from it.
+        struct Checkpoint
+        {
+            // where to resume parsing
+            size_t file_pos{ 0 };
+            size_t lines_count{ 0 };
+            std::array<float, 7> parser_position; // X, Y, Z, E, F, I, J
+
+            // copies of the members listed by GCODE_PROCESSOR_CHECKPOINT_STATE
+            BOOST_PP_SEQ_FOR_EACH(GCODE_PROCESSOR_CHECKPOINT_STATE_DEFINITION, _, GCODE_PROCESSOR_CHECKPOINT_STATE)
+            // The G1 lines caches, the layers times and the stop times of the time machines are not copied, they only grow
+            // and only their items since the first block still in the planner are updated.
+            TimeProcessor time_processor;
+            std::array<size_t, static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count)> g1_times_cache_size;
+            std::array<TimeMachine::G1LinesCacheItem, static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count)> g1_times_cache_back;
+            std::array<size_t, static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count)> layers_time_size;
+            std::array<std::vector<float>, static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count)> layers_time_back;
+            std::array<size_t, static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count)> stop_times_size;
+            std::array<std::vector<TimeMachine::StopTime>, static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count)> stop_times_back;
+            std::unordered_map<SkipType, float> skippable_part_time;
+
+            // sizes of the containers which are only appended to while processing
+            size_t planner_moves_count;
+            size_t planner_arcs_count;
+            size_t planner_events_count;
+            bool planner_record_valid;
+            size_t moves_count;
+            size_t custom_gcode_per_print_z_count;
+            size_t spiral_vase_layers_count;
+            std::pair<float, std::pair<size_t, size_t>> spiral_vase_layers_back;
+        };
+
+        struct Checkpoints
+        {
+            bool enabled{ false };
+            // sorted by lines_count
+            std::vector<Checkpoint> items;
+            // layer ids of the moves, saved before finalize() replaces them with the layer durations
+            std::vector<unsigned int> moves_layer_ids;
+
+            void reset() {
+                items = std::vector<Checkpoint>();
+                moves_layer_ids = std::vector<unsigned int>();
+            }
+        };
+
+        Checkpoints m_checkpoints;
+
         GCodeProcessorResult m_result;
         static unsigned int s_result_id;
 
@@ -1241,6 +1404,10 @@ namespace Slic3r {
             return m_time_processor.machines[static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Stealth)].enabled;
         }
         void enable_machine_envelope_processing(bool enabled) { m_time_processor.machine_envelope_processing_enabled = enabled; }
+        // Keep the inputs of the time estimator, so that estimate_times() can be used once the processing is finalized.
+        void enable_planner_record(bool enabled) { m_planner_record_enabled = enabled; }
+        // Save the processing state at the beginning of each layer while processing a file, so that reprocess_file() can be used.
+        void enable_checkpoints(bool enabled) { m_checkpoints.enabled = enabled; }
         void reset();
 
         const GCodeProcessorResult& get_result() const { return m_result; }
@@ -1257,6 +1424,11 @@ namespace Slic3r {
         void initialize(const std::string& filename);
         void initialize_from_context(const std::shared_ptr<MultiNozzleUtils::NozzleGroupResultBase> &nozzle_group_result);
         void process_buffer(const std::string& buffer);
+        // Process again the file last processed by process_file() with checkpoints enabled, after it was modified
+        // starting from the given line (1-based, as the line ids of the moves). Lines may be inserted, removed or appended.
+        // The processing resumes from the last checkpoint before that line, the moves and the statistics of the result
+        // are updated from there. The configuration block shall not be modified, it is not parsed again.
+        void reprocess_file(const std::string& filename, size_t first_modified_line, std::function<void()> cancel_callback = nullptr);
         void finalize(bool post_process);
 
         float get_time(PrintEstimatedStatistics::ETimeMode mode) const;
@@ -1268,6 +1440,13 @@ namespace Slic3r {
         std::vector<std::pair<ExtrusionRole, float>> get_roles_time(PrintEstimatedStatistics::ETimeMode mode) const;
         std::vector<float> get_layers_time(PrintEstimatedStatistics::ETimeMode mode) const;
 
+        // Estimates the print times for other machine limits from the planner record, without processing the G-code again.
+        // Only the planner is replayed, for each time mode in parallel. The machine limits set by the G-code itself
+        // (M201, M203, M205) are replaced by the given ones, the accelerations requested by M204 are clamped with them.
+        // Fills the times of the given statistics, returns false if no planner record is available.
+        // Safe to be called concurrently for different machine limits.
+        bool estimate_times(const MachineEnvelopeConfig& machine_limits, PrintEstimatedStatistics& statistics) const;
+
         //BBS: set offset for gcode writer
         void set_xy_offset(double x, double y) { m_x_offset = x; m_y_offset = y; }
         // Orca: if true, only change new layer if ETags::Layer_Change occurs
@@ -1456,6 +1635,16 @@ namespace Slic3r {
         void set_extrusion_role(ExtrusionRole role);
         void set_skippable_type(const std::string_view type);
 
+        // Records the move if enabled and appends its planner block to the enabled time machines.
+        void plan_move(const PlannerRecord::Move& move, const PlannerRecord::Arc* arc = nullptr);
+        void record_planner_event(PlannerRecord::EEventType type, PrintEstimatedStatistics::ETimeMode mode, float value,
+                                  ExtrusionRole role = erNone, CustomGCode::Type code = CustomGCode::ColorChange);
+
+        // Parses the file from the given position and processes its lines, saving the checkpoints if enabled.
+        void process_lines(const std::string& filename, size_t file_pos, size_t lines_count, std::function<void()> cancel_callback);
+        void save_checkpoint(size_t file_pos, size_t lines_count);
+        void restore_checkpoint(const Checkpoint& checkpoint);
+
         float minimum_feedrate(PrintEstimatedStatistics::ETimeMode mode, float feedrate) const;
         float minimum_travel_feedrate(PrintEstimatedStatistics::ETimeMode mode, float feedrate) const;
         float get_axis_max_feedrate(PrintEstimatedStatistics::ETimeMode mode, Axis axis, int extruder_id) const;
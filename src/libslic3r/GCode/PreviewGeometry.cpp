@@ -0,0 +1,124 @@
+#include "PreviewGeometry.hpp"
+
+#include <algorithm>
+
+#include <tbb/parallel_for.h>
+
+namespace Slic3r {
+namespace GCodePreview {
+
+static uint32_t add_segment_vertex(LayerGeometry &layer, uint32_t move_id, const GCodeProcessorResult::MoveVertex &t_move)
+{
+    uint32_t t_index = layer.segment_vertices.size();
+    SegmentVertex t_seg_vertex;
+    t_seg_vertex.m_move_id = move_id;
+    t_seg_vertex.m_indices.reserve(10);
+    float hight_offset = 0.0f;
+    if (t_move.type == EMoveType::Wipe) {
+        hight_offset = 0.5f * GCodeProcessor::Wipe_Height;
+    }
+    uint32_t pos_index = layer.position_data.size();
+    if (t_move.is_arc_move_with_interpolation_points()) {
+        const size_t loop_num = t_move.interpolation_points.size();
+        for (size_t i = 0; i < loop_num; ++i) {
+            PositionData t_pos_data;
+            t_pos_data.m_position = t_move.interpolation_points[i];
+            t_pos_data.m_position.z() += hight_offset;
+            t_pos_data.m_segment_vertex_index = t_index;
+            layer.position_data.emplace_back(std::move(t_pos_data));
+            t_seg_vertex.m_indices.push_back(pos_index);
+            ++pos_index;
+        }
+    }
+
+    PositionData t_pos_data;
+    t_pos_data.m_position = t_move.position;
+    t_pos_data.m_position.z() += hight_offset;
+    t_pos_data.m_segment_vertex_index = t_index;
+    layer.position_data.emplace_back(std::move(t_pos_data));
+    t_seg_vertex.m_indices.push_back(pos_index);
+    layer.segment_vertices.emplace_back(std::move(t_seg_vertex));
+
+    return t_index;
+}
+
+void build_layer_geometry(LayerGeometry &layer, const std::vector<size_t> &sid_to_mid, const std::vector<std::vector<size_t>> &sid_to_seam_mids,
+                          const GCodeProcessorResult &gcode_result)
+{
+    layer.segment_vertices.clear();
+    layer.segments.clear();
+    layer.position_data.clear();
+    layer.has_custom_options = false;
+    if (layer.empty_range())
+        return;
+
+    const uint32_t start_sid = layer.start_sid;
+    const uint32_t end_sid   = layer.end_sid;
+
+    std::vector<uint32_t> t_sid_to_index(end_sid - start_sid + 1);
+    std::vector<std::vector<uint32_t>> t_seam_to_index(end_sid - start_sid + 1);
+    uint32_t t_count = 0;
+    for (uint32_t sid = start_sid; sid <= end_sid; ++sid) {
+        size_t move_id = sid_to_mid[sid];
+        const auto& curr_move = gcode_result.moves[move_id];
+        if (curr_move.type == EMoveType::Pause_Print || curr_move.type == EMoveType::Custom_GCode)
+            layer.has_custom_options = true;
+        t_sid_to_index[t_count] = add_segment_vertex(layer, move_id, curr_move);
+
+        if (sid_to_seam_mids[sid].size()) {
+            std::vector<uint32_t> indices;
+            for (size_t seam_mid : sid_to_seam_mids[sid])
+                indices.emplace_back(add_segment_vertex(layer, seam_mid, gcode_result.moves[seam_mid]));
+            t_seam_to_index[t_count] = std::move(indices);
+        }
+        ++t_count;
+    }
+
+    layer.segments.reserve(end_sid - start_sid + 1);
+    t_count = 1;
+    for (uint32_t sid = start_sid + 1; sid <= end_sid; ++sid) {
+        const uint32_t prev_move_index = t_sid_to_index[t_count - 1];
+        const uint32_t curr_move_index = t_sid_to_index[t_count];
+        const auto& curr_move = gcode_result.moves[layer.segment_vertices[curr_move_index].m_move_id];
+
+        Segment t_seg;
+        t_seg.m_first_mid = prev_move_index;
+        t_seg.m_second_mid = curr_move_index;
+        t_seg.m_type = curr_move.type;
+        t_seg.m_role = curr_move.extrusion_role;
+        t_seg.m_extruder_id = curr_move.extruder_id;
+        layer.segments.emplace_back(std::move(t_seg));
+
+        const std::vector<uint32_t>& indices = t_seam_to_index[t_count];
+        for (size_t i = 0; i < sid_to_seam_mids[sid].size(); ++i) {
+            const auto& curr_seam = gcode_result.moves[sid_to_seam_mids[sid][i]];
+            Segment t_seam_seg;
+            t_seam_seg.m_first_mid = indices[i];
+            t_seam_seg.m_second_mid = t_seam_seg.m_first_mid;
+            t_seam_seg.m_type = curr_seam.type;
+            t_seam_seg.m_role = curr_seam.extrusion_role;
+            t_seam_seg.m_extruder_id = curr_seam.extruder_id;
+            layer.segments.emplace_back(std::move(t_seam_seg));
+        }
+        ++t_count;
+    }
+}
+
+void build_layers_geometry(std::vector<LayerGeometry> &layers, const std::vector<size_t> &sid_to_mid, const std::vector<std::vector<size_t>> &sid_to_seam_mids,
+                           const GCodeProcessorResult &gcode_result, const std::function<void(size_t)> &on_block_built)
+{
+    // about ten blocks, so that the progress is reported in steps of ten percent
+    const size_t block_size = std::max<size_t>(1, layers.size() / 10);
+    for (size_t block_start = 0; block_start < layers.size(); block_start += block_size) {
+        const size_t block_end = std::min(block_start + block_size, layers.size());
+        tbb::parallel_for(tbb::blocked_range<size_t>(block_start, block_end), [&](const tbb::blocked_range<size_t> &range) {
+            for (size_t i = range.begin(); i < range.end(); ++i)
+                build_layer_geometry(layers[i], sid_to_mid, sid_to_seam_mids, gcode_result);
+        });
+        if (on_block_built)
+            on_block_built(block_end);
+    }
+}
+
+} // namespace GCodePreview
+} // namespace Slic3r
@@ -0,0 +1,67 @@
+// Geometry of the G-code preview built from the processed moves, independent of OpenGL.
+// The preview keeps it in per layer chunks, which are built in parallel.
+
+#ifndef slic3r_PreviewGeometry_hpp_
+#define slic3r_PreviewGeometry_hpp_
+
+#include "../libslic3r.h"
+#include "GCodeProcessor.hpp"
+
+#include <functional>
+#include <vector>
+
+namespace Slic3r {
+namespace GCodePreview {
+
+// A move drawn by the preview, with the indices of its positions (more than one for an interpolated arc).
+struct SegmentVertex
+{
+    uint32_t m_move_id{ -1u };
+    std::vector<uint32_t> m_indices;
+};
+
+// Segment between two vertices of a layer, a seam is a segment from a vertex to itself.
+struct Segment
+{
+    uint32_t m_first_mid{ -1u };
+    uint32_t m_second_mid{ -1u };
+    EMoveType m_type{ EMoveType::Count };
+    ExtrusionRole m_role{ ExtrusionRole::erCount };
+    uint16_t m_extruder_id{ UINT16_MAX };
+};
+
+struct PositionData
+{
+    Vec3f m_position;
+    uint32_t m_segment_vertex_index{ 0 };
+};
+
+// Geometry of the moves of one layer, given by the range of its segment ids. The segment ids number the moves
+// without the seams, which are attached to the segment id of the move they belong to.
+struct LayerGeometry
+{
+    uint32_t start_sid{ -1u };
+    uint32_t end_sid{ -1u };
+
+    std::vector<SegmentVertex> segment_vertices;
+    std::vector<Segment>       segments;
+    std::vector<PositionData>  position_data;
+    // the layer contains a pause or a custom G-code
+    bool                       has_custom_options{ false };
+
+    bool empty_range() const { return start_sid == -1u || end_sid == -1u || start_sid > end_sid; }
+};
+
+// Build the geometry of the layer from its segment id range. Layers with an empty range are left empty.
+void build_layer_geometry(LayerGeometry &layer, const std::vector<size_t> &sid_to_mid, const std::vector<std::vector<size_t>> &sid_to_seam_mids,
+                          const GCodeProcessorResult &gcode_result);
+
+// Build the geometry of all the layers in parallel. The layers are processed in blocks, after each block
+// on_block_built is called from the calling thread with the number of layers built so far, to report the progress.
+void build_layers_geometry(std::vector<LayerGeometry> &layers, const std::vector<size_t> &sid_to_mid, const std::vector<std::vector<size_t>> &sid_to_seam_mids,
+                           const GCodeProcessorResult &gcode_result, const std::function<void(size_t)> &on_block_built = nullptr);
+
+} // namespace GCodePreview
+} // namespace Slic3r
+
+#endif // slic3r_PreviewGeometry_hpp_
@@ -0,0 +1,319 @@
+#include "ThumbnailRasterizer.hpp"
+
+#include "libslic3r/BuildVolume.hpp"
+#include "libslic3r/Geometry.hpp"
+#include "libslic3r/TriangleMesh.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <limits>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+namespace Slic3r {
+
+namespace {
+
+// constants of the "thumbnail" shader
+const Vec3f  LIGHT_TOP_DIR(-0.4574957f, 0.4574957f, 0.7624929f);
+const float  LIGHT_TOP_DIFFUSE    = 0.8f * 0.6f;
+const float  LIGHT_TOP_SPECULAR   = 0.125f * 0.6f;
+const float  LIGHT_TOP_SHININESS  = 20.f;
+const Vec3f  LIGHT_FRONT_DIR(0.6985074f, 0.1397015f, 0.6985074f);
+const float  LIGHT_FRONT_DIFFUSE  = 0.3f * 0.6f;
+const float  INTENSITY_AMBIENT    = 0.3f;
+const float  EMISSION_FACTOR      = 0.1f;
+
+// same as Camera::DefaultZoomToBoxMarginFactor
+const double ZOOM_TO_BOX_MARGIN_FACTOR = 1.025;
+// rows of pixels rendered by one task
+const int    BAND_HEIGHT = 16;
+
+struct ScreenTriangle
+{
+    // x, y in pixels, z grows towards the camera
+    Vec3f    vertices[3];
+    // world z of the vertices, the shader discards everything below the bed
+    float    world_z[3];
+    // RGBA8
+    uint32_t color;
+};
+
+uint32_t pack_color(const std::array<float, 4> &color)
+{
+    uint32_t out = 0;
+    for (size_t i = 0; i < 4; ++i)
+        out |= uint32_t(std::lround(std::clamp(color[i], 0.f, 1.f) * 255.f)) << (8 * i);
+    return out;
+}
+
+// Rows of the view rotation are the right, up and backward directions of the camera, see Camera::look_at().
+Matrix3d look_at_rotation(const Vec3d &dir_to_camera, const Vec3d &up)
+{
+    const Vec3d unit_z = dir_to_camera.normalized();
+    const Vec3d unit_x = up.cross(unit_z).normalized();
+    const Vec3d unit_y = unit_z.cross(unit_x).normalized();
+    Matrix3d rotation;
+    rotation.row(0) = unit_x;
+    rotation.row(1) = unit_y;
+    rotation.row(2) = unit_z;
+    return rotation;
+}
+
+Matrix3d iso_rotation(double z_angle)
+{
+    return (Eigen::AngleAxisd(Geometry::deg2rad(-45.0), Vec3d::UnitX()) * Eigen::AngleAxisd(Geometry::deg2rad(z_angle), Vec3d::UnitZ())).toRotationMatrix();
+}
+
+Matrix3d view_rotation(ThumbnailRasterizer::View view)
+{
+    using View = ThumbnailRasterizer::View;
+    switch (view) {
+    case View::Iso:      return iso_rotation(45.0);
+    case View::Iso_1:    return iso_rotation(135.0);
+    case View::Iso_2:    return iso_rotation(225.0);
+    case View::Iso_3:    return iso_rotation(315.0);
+    case View::Left:     return look_at_rotation(-Vec3d::UnitX(), Vec3d::UnitZ());
+    case View::Right:    return look_at_rotation(Vec3d::UnitX(), Vec3d::UnitZ());
+    case View::Bottom:   return look_at_rotation(-Vec3d::UnitZ(), -Vec3d::UnitY());
+    case View::Front:    return look_at_rotation(-Vec3d::UnitY(), Vec3d::UnitZ());
+    case View::Rear:     return look_at_rotation(Vec3d::UnitY(), Vec3d::UnitZ());
+    case View::TopFront: return look_at_rotation(Vec3d(0., -0.707, 0.707), Vec3d(0., 1., 1.));
+    case View::Top:
+    case View::TopPlate:
+    default:             return look_at_rotation(Vec3d::UnitZ(), Vec3d::UnitY());
+    }
+}
+
+// Flat shaded color of a face with the given normal in camera space.
+std::array<float, 4> shade(const std::array<float, 4> &color, const Vec3f &normal)
+{
+    float NdotL     = std::max(normal.dot(LIGHT_TOP_DIR), 0.f);
+    float intensity = INTENSITY_AMBIENT + NdotL * LIGHT_TOP_DIFFUSE;
+    // orthographic camera, the eye vector is constant
+    const Vec3f reflected = 2.f * normal.dot(LIGHT_TOP_DIR) * normal - LIGHT_TOP_DIR;
+    float specular  = LIGHT_TOP_SPECULAR * std::pow(std::max(reflected.z(), 0.f), LIGHT_TOP_SHININESS);
+    NdotL           = std::max(normal.dot(LIGHT_FRONT_DIR), 0.f);
+    intensity      += NdotL * LIGHT_FRONT_DIFFUSE;
+    intensity      += EMISSION_FACTOR;
+    return { specular + color[0] * intensity, specular + color[1] * intensity, specular + color[2] * intensity, color[3] };
+}
+
+std::array<float, 4> mesh_color(const ThumbnailRasterizer::Mesh &mesh, ThumbnailRasterizer::Mode mode)
+{
+    if (mode == ThumbnailRasterizer::Mode::Picking) {
+        const unsigned int id = mesh.picking_id;
+        return { float(id & 0xFF) / 255.f, float((id >> 8) & 0xFF) / 255.f, float((id >> 16) & 0xFF) / 255.f, 1.f };
+    }
+    std::array<float, 4> color = ThumbnailRasterizer::adjust_color(mesh.color);
+    if (mode == ThumbnailRasterizer::Mode::NoLight)
+        color[3] = float(255 - (mesh.extruder_id - 1)) / 255.f;
+    return color;
+}
+
+// Box the camera is zoomed to, see GLCanvas3D::_render_thumbnail_internal().
+BoundingBoxf3 volumes_box(const std::vector<ThumbnailRasterizer::Mesh> &meshes)
+{
+    BoundingBoxf3 box;
+    box.min.z() = 0.;
+    box.max.z() = 0.;
+    for (const ThumbnailRasterizer::Mesh &mesh : meshes)
+        if (mesh.its != nullptr && ! mesh.its->vertices.empty())
+            box.merge(bounding_box(*mesh.its).transformed(mesh.trafo));
+    box.min.z() = -BuildVolume::SceneEpsilon;
+    const Vec3d size = box.size();
+    box.min -= Vec3d(size.x() * 0.1, size.y() * 0.1, size.z() * 0.2);
+    box.max += Vec3d(size.x() * 0.1, size.y() * 0.1, size.z() * 0.2);
+    return box;
+}
+
+// Zoom fitting the box into the viewport, see Camera::calc_zoom_to_bounding_box_factor().
+double zoom_to_box(const BoundingBoxf3 &box, const Matrix3d &rotation, double w, double h)
+{
+    const Vec3d center = box.center();
+    double min_x = DBL_MAX, min_y = DBL_MAX, max_x = -DBL_MAX, max_y = -DBL_MAX;
+    for (int i = 0; i < 8; ++i) {
+        const Vec3d corner((i & 1) ? box.max.x() : box.min.x(), (i & 2) ? box.max.y() : box.min.y(), (i & 4) ? box.max.z() : box.min.z());
+        const Vec3d pos = rotation * (corner - center);
+        min_x = std::min(min_x, pos.x());
+        min_y = std::min(min_y, pos.y());
+        max_x = std::max(max_x, pos.x());
+        max_y = std::max(max_y, pos.y());
+    }
+    const double dx = (max_x - min_x) * ZOOM_TO_BOX_MARGIN_FACTOR;
+    const double dy = (max_y - min_y) * ZOOM_TO_BOX_MARGIN_FACTOR;
+    return (dx <= 0. || dy <= 0.) ? -1. : std::min(w / dx, h / dy);
+}
+
+void rasterize_band(const ScreenTriangle &triangle, int width, int y_begin, int y_end, uint32_t *colors, float *depths)
+{
+    const Vec3f &a = triangle.vertices[0];
+    const Vec3f &b = triangle.vertices[1];
+    const Vec3f &c = triangle.vertices[2];
+    const float area = (b.x() - a.x()) * (c.y() - a.y()) - (b.y() - a.y()) * (c.x() - a.x());
+    if (std::abs(area) < 1e-12f)
+        return;
+    const float inv_area = 1.f / area;
+
+    const int x_min = std::max(0, int(std::floor(std::min({ a.x(), b.x(), c.x() }))));
+    const int x_max = std::min(width - 1, int(std::ceil(std::max({ a.x(), b.x(), c.x() }))));
+    const int y_min = std::max(y_begin, int(std::floor(std::min({ a.y(), b.y(), c.y() }))));
+    const int y_max = std::min(y_end - 1, int(std::ceil(std::max({ a.y(), b.y(), c.y() }))));
+    for (int y = y_min; y <= y_max; ++y) {
+        const float py = float(y) + 0.5f;
+        for (int x = x_min; x <= x_max; ++x) {
+            const float px = float(x) + 0.5f;
+            // barycentric coordinates, independent of the winding
+            const float w0 = ((b.x() - px) * (c.y() - py) - (b.y() - py) * (c.x() - px)) * inv_area;
+            const float w1 = ((c.x() - px) * (a.y() - py) - (c.y() - py) * (a.x() - px)) * inv_area;
+            const float w2 = 1.f - w0 - w1;
+            if (w0 < 0.f || w1 < 0.f || w2 < 0.f)
+                continue;
+            if (w0 * triangle.world_z[0] + w1 * triangle.world_z[1] + w2 * triangle.world_z[2] < 0.f)
+                continue;
+            const float  depth = w0 * a.z() + w1 * b.z() + w2 * c.z();
+            const size_t idx   = size_t(y - y_begin) * width + x;
+            if (depth > depths[idx]) {
+                depths[idx] = depth;
+                colors[idx] = triangle.color;
+            }
+        }
+    }
+}
+
+} // namespace
+
+std::array<float, 4> ThumbnailRasterizer::adjust_color(const std::array<float, 4> &color)
+{
+    // completely transparent
+    if (color[3] < 0.1f)
+        return { 1.f, 1.f, 1.f, 0.3f };
+    // black filament, too hard to see
+    if (color[0] < 0.2f && color[1] < 0.2f && color[2] < 0.2f)
+        return { 0.2f, 0.2f, 0.2f, color[3] };
+    return color;
+}
+
+void ThumbnailRasterizer::render(ThumbnailData &thumbnail_data, unsigned int w, unsigned int h, const std::vector<Mesh> &meshes, const Params &params)
+{
+    thumbnail_data.set(w, h);
+    if (! thumbnail_data.is_valid())
+        return;
+
+    const bool picking = params.mode == Mode::Picking;
+    const int  samples = (params.antialiasing && ! picking) ? 2 : 1;
+    const int  width   = int(w) * samples;
+    const int  height  = int(h) * samples;
+
+    // camera
+    const Matrix3d rotation = view_rotation(params.view);
+    Vec3d          target;
+    double         zoom;
+    if (params.view == View::TopPlate) {
+        target = Vec3d(params.plate_box.center().x(), params.plate_box.center().y(), 0.);
+        const Vec3d plate_size = params.plate_box.size();
+        zoom = std::min(double(w) / plate_size.x(), double(h) / plate_size.y());
+    } else {
+        const BoundingBoxf3 box = volumes_box(meshes);
+        target = box.center();
+        zoom   = zoom_to_box(box, rotation, double(w), double(h));
+        if (zoom <= 0.)
+            // nothing to zoom to, the camera keeps its default zoom
+            zoom = 1.;
+    }
+    zoom *= double(samples);
+
+    // Project all the triangles, each one is shaded once as the normals are per face.
+    std::vector<size_t> offsets(meshes.size() + 1, 0);
+    for (size_t i = 0; i < meshes.size(); ++i)
+        offsets[i + 1] = offsets[i] + (meshes[i].its == nullptr ? 0 : meshes[i].its->indices.size());
+    std::vector<ScreenTriangle> triangles(offsets.back());
+    // triangles culled as back faces or collapsed to a point are marked by an empty band range
+    std::vector<std::pair<int, int>> triangle_bands(triangles.size(), { 0, 0 });
+    const int bands_count = (height + BAND_HEIGHT - 1) / BAND_HEIGHT;
+
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, meshes.size()), [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t mesh_id = range.begin(); mesh_id < range.end(); ++mesh_id) {
+            const Mesh &mesh = meshes[mesh_id];
+            if (mesh.its == nullptr)
+                continue;
+            const std::array<float, 4> color = mesh_color(mesh, params.mode);
+            const uint32_t flat_color = pack_color(color);
+            // mirrored meshes have their faces oriented inside out
+            const bool     left_handed = mesh.trafo.matrix().block<3, 3>(0, 0).determinant() < 0.;
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, mesh.its->indices.size()), [&](const tbb::blocked_range<size_t> &faces) {
+                for (size_t face_id = faces.begin(); face_id < faces.end(); ++face_id) {
+                    const stl_triangle_vertex_indices &face     = mesh.its->indices[face_id];
+                    ScreenTriangle                    &triangle = triangles[offsets[mesh_id] + face_id];
+                    Vec3d                              eye[3];
+                    for (int i = 0; i < 3; ++i) {
+                        const Vec3d world = mesh.trafo * mesh.its->vertices[face(i)].cast<double>();
+                        eye[i]               = rotation * (world - target);
+                        triangle.vertices[i] = Vec3f(float(eye[i].x() * zoom + 0.5 * width), float(eye[i].y() * zoom + 0.5 * height), float(eye[i].z()));
+                        triangle.world_z[i]  = float(world.z());
+                    }
+                    Vec3d normal = (eye[1] - eye[0]).cross(eye[2] - eye[0]);
+                    if (left_handed)
+                        normal = -normal;
+                    const double length = normal.norm();
+                    if (length == 0. || (! picking && normal.z() <= 0.))
+                        continue;
+                    triangle.color = picking ? flat_color : pack_color(shade(color, (normal / length).cast<float>()));
+                    const float y_min = std::min({ triangle.vertices[0].y(), triangle.vertices[1].y(), triangle.vertices[2].y() });
+                    const float y_max = std::max({ triangle.vertices[0].y(), triangle.vertices[1].y(), triangle.vertices[2].y() });
+                    const int   band_min = std::max(0, int(std::floor(y_min)) / BAND_HEIGHT);
+                    const int   band_max = std::min(bands_count - 1, int(std::ceil(y_max)) / BAND_HEIGHT);
+                    if (y_max >= 0.f && band_min <= band_max)
+                        triangle_bands[offsets[mesh_id] + face_id] = { band_min, band_max + 1 };
+                }
+            });
+        }
+    });
+
+    // Sort the triangles into the bands they cover, keeping their order.
+    std::vector<size_t> band_offsets(bands_count + 1, 0);
+    for (const std::pair<int, int> &bands : triangle_bands)
+        for (int band = bands.first; band < bands.second; ++band)
+            ++band_offsets[band + 1];
+    for (int band = 0; band < bands_count; ++band)
+        band_offsets[band + 1] += band_offsets[band];
+    std::vector<uint32_t> band_triangles(band_offsets.back());
+    {
+        std::vector<size_t> cursors(band_offsets.begin(), band_offsets.end() - 1);
+        for (size_t triangle_id = 0; triangle_id < triangle_bands.size(); ++triangle_id)
+            for (int band = triangle_bands[triangle_id].first; band < triangle_bands[triangle_id].second; ++band)
+                band_triangles[cursors[band]++] = uint32_t(triangle_id);
+    }
+
+    const uint32_t background = picking ? 0 :
+        pack_color({ params.background_color.x(), params.background_color.y(), params.background_color.z(), params.background_color.w() });
+    tbb::parallel_for(tbb::blocked_range<int>(0, bands_count), [&](const tbb::blocked_range<int> &range) {
+        std::vector<uint32_t> colors;
+        std::vector<float>    depths;
+        for (int band = range.begin(); band < range.end(); ++band) {
+            const int y_begin = band * BAND_HEIGHT;
+            const int y_end   = std::min(height, y_begin + BAND_HEIGHT);
+            colors.assign(size_t(y_end - y_begin) * width, background);
+            depths.assign(colors.size(), -std::numeric_limits<float>::max());
+            for (size_t i = band_offsets[band]; i < band_offsets[band + 1]; ++i)
+                rasterize_band(triangles[band_triangles[i]], width, y_begin, y_end, colors.data(), depths.data());
+
+            // resolve the samples into the thumbnail, both are stored bottom-up
+            for (int y = y_begin / samples; y < y_end / samples; ++y)
+                for (int x = 0; x < int(w); ++x) {
+                    unsigned char *pixel = thumbnail_data.pixels.data() + (size_t(y) * w + x) * 4;
+                    for (int channel = 0; channel < 4; ++channel) {
+                        unsigned int sum = 0;
+                        for (int sy = 0; sy < samples; ++sy)
+                            for (int sx = 0; sx < samples; ++sx)
+                                sum += (colors[size_t(y * samples + sy - y_begin) * width + x * samples + sx] >> (8 * channel)) & 0xFF;
+                        pixel[channel] = (unsigned char)((sum + samples * samples / 2) / (samples * samples));
+                    }
+                }
+        }
+    });
+}
+
+} // namespace Slic3r
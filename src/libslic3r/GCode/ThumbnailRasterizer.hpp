@@ -0,0 +1,78 @@
+#ifndef slic3r_ThumbnailRasterizer_hpp_
+#define slic3r_ThumbnailRasterizer_hpp_
+
+#include <array>
+#include <vector>
+
+#include "admesh/stl.h"
+#include "libslic3r/BoundingBox.hpp"
+#include "libslic3r/Point.hpp"
+#include "ThumbnailData.hpp"
+
+namespace Slic3r {
+
+// Software rasterizer producing the plate thumbnails without an OpenGL context.
+// It follows GLCanvas3D::render_thumbnail_framebuffer() with the "thumbnail" shader: orthographic camera,
+// the same view angles and zoom to the visible volumes, the same two light sources and the same color rules,
+// so that the images written into the 3MF and the G-code match the ones rendered through OpenGL.
+// The image is rendered in horizontal bands in parallel, the rows are stored bottom-up like glReadPixels().
+class ThumbnailRasterizer
+{
+public:
+    // Mirrors Camera::ViewAngleType.
+    enum class View : unsigned char {
+        Iso,
+        Iso_1,
+        Iso_2,
+        Iso_3,
+        TopFront,
+        Top,
+        Bottom,
+        Front,
+        Rear,
+        Left,
+        Right,
+        // top view zoomed to the plate instead of the objects
+        TopPlate,
+    };
+
+    enum class Mode : unsigned char {
+        // lit with the filament colors
+        Shaded,
+        // flat filament colors, the alpha channel stores 255 - (extruder_id - 1)
+        NoLight,
+        // flat colors encoding the picking id, no back face culling
+        Picking,
+    };
+
+    struct Mesh
+    {
+        const indexed_triangle_set *its{ nullptr };
+        Transform3d                 trafo{ Transform3d::Identity() };
+        // filament color, adjusted the same way as for the OpenGL thumbnails
+        std::array<float, 4>        color{ 1.f, 1.f, 1.f, 1.f };
+        // 1 based
+        int                         extruder_id{ 1 };
+        unsigned int                picking_id{ 0 };
+    };
+
+    struct Params
+    {
+        View          view{ View::Iso };
+        Mode          mode{ Mode::Shaded };
+        Vec4f         background_color{ 0.f, 0.f, 0.f, 0.f };
+        // build volume of the plate, used by View::TopPlate only
+        BoundingBoxf3 plate_box;
+        // render with 2x2 samples per pixel and average them, like the multisampled framebuffer, ignored for picking
+        bool          antialiasing{ true };
+    };
+
+    static void render(ThumbnailData &thumbnail_data, unsigned int w, unsigned int h, const std::vector<Mesh> &meshes, const Params &params);
+
+    // Same as adjust_color_for_rendering() of the GUI: lighten black and fully transparent filaments.
+    static std::array<float, 4> adjust_color(const std::array<float, 4> &color);
+};
+
+} // namespace Slic3r
+
+#endif // slic3r_ThumbnailRasterizer_hpp_
@@ -1008,13 +1008,35 @@ namespace Slic3r
 
 
 
+    struct FilamentOrderCache::LayerOrders
+    {
+        std::unordered_map<boost::multiprecision::uint128_t, std::pair<float, std::vector<unsigned int>>> orders;
+    };
+
+    FilamentOrderCache::FilamentOrderCache() = default;
+    FilamentOrderCache::~FilamentOrderCache() = default;
+
+    FilamentOrderCache::LayerOrders& FilamentOrderCache::get_layer_orders(int extruder_id)
+    {
+        auto& layer_orders = m_layer_orders[extruder_id];
+        if (!layer_orders)
+            layer_orders = std::make_unique<LayerOrders>();
+        return *layer_orders;
+    }
+
+    void FilamentOrderCache::clear()
+    {
+        m_layer_orders.clear();
+    }
+
     // TODO:  add cusotm sequence
     static int reorder_filaments_for_minimum_flush_volume_base(const std::vector<unsigned int>& filament_lists,
         const std::vector<std::vector<unsigned int>>& layer_filaments,
         const FlushMatrix& flush_matrix,
         const std::function<bool(int, std::vector<int>&)> get_custom_seq,
         std::vector<std::vector<unsigned int>>* filament_sequences,
-        std::optional<unsigned int> initial_filament_id = std::nullopt)
+        std::optional<unsigned int> initial_filament_id = std::nullopt,
+        FilamentOrderCache::LayerOrders* shared_caches = nullptr)
     {
         constexpr int max_n_with_forcast = 5;
         using uint128_t = boost::multiprecision::uint128_t;
@@ -1039,7 +1061,9 @@ namespace Slic3r
 
         int cost = 0;
         std::map<size_t, std::vector<unsigned int>> custom_layer_sequence_map;
-        std::unordered_map<uint128_t, std::pair<float, std::vector<unsigned int>>> caches;
+        std::unordered_map<uint128_t, std::pair<float, std::vector<unsigned int>>> local_caches;
+        // the key only depends on the filaments of the layer and the previous filament, so orders can be reused across calls
+        auto& caches = shared_caches ? shared_caches->orders : local_caches;
         std::unordered_set<unsigned int> filament_sets(filament_lists.begin(), filament_lists.end());
         std::optional<unsigned int>      curr_filament_id;
         // 如果传入了有效的初始材料ID，则使用它作为初始状态
@@ -1549,7 +1573,8 @@ namespace Slic3r
         const std::vector<FlushMatrix>& flush_matrix,
         const std::function<bool(int, std::vector<int>&)> get_custom_seq,
         std::vector<std::vector<unsigned int>>* filament_sequences,
-        const MultiNozzleUtils::NozzleStatusRecorder& initial_status)
+        const MultiNozzleUtils::NozzleStatusRecorder& initial_status,
+        FilamentOrderCache* order_cache)
     {
         std::map<int,std::set<unsigned int>> nozzle_filament_groups;
         std::map<int,std::set<int>> extruder_to_nozzle;
@@ -1607,7 +1632,8 @@ namespace Slic3r
 
             std::vector<std::vector<unsigned int>> filament_seq;
             cost += reorder_filaments_for_minimum_flush_volume_base(filament_vec_in_nozzle, layer_filaments, flush_matrix[extruder_id], get_custom_seq,
-                                                                    store_sequence ? &filament_seq : nullptr, initial_fil_id);
+                                                                    store_sequence ? &filament_seq : nullptr, initial_fil_id,
+                                                                    order_cache ? &order_cache->get_layer_orders(extruder_id) : nullptr);
             if(store_sequence)
                 nozzle_filament_sequences.emplace(nozzle_id, std::move(filament_seq));
 
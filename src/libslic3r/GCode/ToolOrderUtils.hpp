@@ -184,6 +184,25 @@ private:
 };
 
 
+// Memoized per-layer filament orders used by reorder_filaments_for_multi_nozzle_extruder.
+// The order of a layer only depends on the filaments printed by a nozzle in that layer, the filament loaded before
+// and the flush matrix of the extruder, so one cache can be shared by the evaluation of many filament groups of the
+// same model. Not thread safe, use one instance per thread.
+class FilamentOrderCache
+{
+public:
+    struct LayerOrders;
+
+    FilamentOrderCache();
+    ~FilamentOrderCache();
+
+    LayerOrders& get_layer_orders(int extruder_id);
+    void clear();
+
+private:
+    std::unordered_map<int, std::unique_ptr<LayerOrders>> m_layer_orders;
+};
+
 int reorder_filaments_for_minimum_flush_volume(const std::vector<unsigned int> &filament_lists,
                                                const std::vector<int> &filament_maps,
                                                const std::vector<std::vector<unsigned int>> &layer_filaments,
@@ -221,7 +240,8 @@ int reorder_filaments_for_multi_nozzle_extruder(const std::vector<unsigned int>&
                                                 const std::vector<FlushMatrix>& flush_matrix,
                                                 const std::function<bool(int,std::vector<int>&)> get_custom_seq,
                                                 std::vector<std::vector<unsigned int>> * filament_sequences,
-                                                const MultiNozzleUtils::NozzleStatusRecorder& initial_status = {});
+                                                const MultiNozzleUtils::NozzleStatusRecorder& initial_status = {},
+                                                FilamentOrderCache* order_cache = nullptr);
 
 }
 #endif // !TOOL_ORDER_UTILS_HPP
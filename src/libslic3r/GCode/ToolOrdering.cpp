@@ -546,7 +546,7 @@ std::vector<unsigned int> ToolOrdering::generate_first_layer_tool_order(const Pr
         const Layer* target_layer = nullptr;
         for(auto layer : object->layers()){
             for(auto layerm : layer->regions()){
-                for(auto& expoly : layerm->raw_slices){
+                for(auto& expoly : layerm->raw_slices.expolygons()){
                     if (!offset_ex(expoly, -0.2 * scale_(print.config().initial_layer_line_width)).empty()) {
                         target_layer = layer;
                         break;
@@ -565,7 +565,7 @@ std::vector<unsigned int> ToolOrdering::generate_first_layer_tool_order(const Pr
         for (auto layerm : target_layer->regions()) {
             int extruder_id = layerm->region().config().option("wall_filament")->getInt();
 
-            for (auto expoly : layerm->raw_slices) {
+            for (auto expoly : layerm->raw_slices.expolygons()) {
                 if (offset_ex(expoly, -0.2 * scale_(print.config().initial_layer_line_width)).empty())
                     continue;
 
@@ -621,7 +621,7 @@ std::vector<unsigned int> ToolOrdering::generate_first_layer_tool_order(const Pr
     const Layer* target_layer = nullptr;
     for(auto layer : object.layers()){
         for(auto layerm : layer->regions()){
-            for(auto& expoly : layerm->raw_slices){
+            for(auto& expoly : layerm->raw_slices.expolygons()){
                 if (!offset_ex(expoly, -0.2 * scale_(object.config().line_width)).empty()) {
                     target_layer = layer;
                     break;
@@ -639,7 +639,7 @@ std::vector<unsigned int> ToolOrdering::generate_first_layer_tool_order(const Pr
 
     for (auto layerm : target_layer->regions()) {
         int extruder_id = layerm->region().config().option("wall_filament")->getInt();
-        for (auto expoly : layerm->raw_slices) {
+        for (auto expoly : layerm->raw_slices.expolygons()) {
             if (offset_ex(expoly, -0.2 * scale_(object.config().line_width)).empty())
                 continue;
 
@@ -2862,13 +2862,14 @@ void ToolOrdering::mark_skirt_layers(const PrintConfig &config, coordf_t max_lay
 // If multiple events are planned over a span of a single layer, use the last one.
 
 // BBS: replace model custom gcode with current plate custom gcode
-static CustomGCode::Info custom_gcode_per_print_z;
 void ToolOrdering::assign_custom_gcodes(const Print& print)
 {
     // Only valid for non-sequential print.
     assert(print.config().print_sequence == PrintSequence::ByLayer);
 
-    custom_gcode_per_print_z = print.model().get_curr_plate_custom_gcodes();
+    // Kept by this ToolOrdering, not in a static, as several prints may be processed at once.
+    m_custom_gcodes = std::make_shared<const CustomGCode::Info>(print.model().get_curr_plate_custom_gcodes());
+    const CustomGCode::Info &custom_gcode_per_print_z = *m_custom_gcodes;
     if (custom_gcode_per_print_z.gcodes.empty())
         return;
 
@@ -2877,7 +2878,7 @@ void ToolOrdering::assign_custom_gcodes(const Print& print)
     CustomGCode::Mode mode =
         (num_filaments == 1) ? CustomGCode::SingleExtruder :
         print.object_extruders().size() == 1 ? CustomGCode::MultiAsSingle : CustomGCode::MultiExtruder;
-    CustomGCode::Mode           model_mode = print.model().get_curr_plate_custom_gcodes().mode;
+    CustomGCode::Mode           model_mode = custom_gcode_per_print_z.mode;
     auto custom_gcode_it = custom_gcode_per_print_z.gcodes.rbegin();
     // Tool changes and color changes will be ignored, if the model's tool/color changes were entered in mm mode and the print is in non mm mode
     // or vice versa.
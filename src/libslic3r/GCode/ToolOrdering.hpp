@@ -7,6 +7,7 @@
 
 #include <functional>
 #include <map>
+#include <memory>
 #include <utility>
 
 #include <boost/container/small_vector.hpp>
@@ -21,7 +22,7 @@ namespace Slic3r {
 class Print;
 class PrintObject;
 class LayerTools;
-namespace CustomGCode { struct Item; }
+namespace CustomGCode { struct Item; struct Info; }
 class PrintRegion;
 
 // Object of this class holds information about whether an extrusion is printed immediately
@@ -446,6 +447,9 @@ private:
     MultiNozzleUtils::NozzleStatusRecorder m_nozzle_status;          // 本 object 结束后的喷嘴状态
 
     int               m_most_used_extruder;
+
+    // Custom G-codes of the plate pointed to by LayerTools::custom_gcode, shared by the copies of this ToolOrdering.
+    std::shared_ptr<const CustomGCode::Info> m_custom_gcodes;
 };
 
 } // namespace SLic3r
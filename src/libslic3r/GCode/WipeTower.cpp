@@ -1461,20 +1461,28 @@ private:
 	std::string   set_format_X(float x)
     {
         m_current_pos.x() = x;
-        return " X" + Slic3r::float_to_string_decimal_point(x, 3);
+        std::string out(" X");
+        Slic3r::append_float_decimal_point(out, x, 3);
+        return out;
 	}
 
 	std::string   set_format_Y(float y) {
         m_current_pos.y() = y;
-        return " Y" + Slic3r::float_to_string_decimal_point(y, 3);
+        std::string out(" Y");
+        Slic3r::append_float_decimal_point(out, y, 3);
+        return out;
 	}
 
 	std::string   set_format_Z(float z) {
-        return " Z" + Slic3r::float_to_string_decimal_point(z, 3);
+        std::string out(" Z");
+        Slic3r::append_float_decimal_point(out, z, 3);
+        return out;
 	}
 
 	std::string   set_format_E(float e) {
-        return " E" + Slic3r::float_to_string_decimal_point(e, 4);
+        std::string out(" E");
+        Slic3r::append_float_decimal_point(out, e, 4);
+        return out;
 	}
 
 	std::string   set_format_F(float f) {
@@ -1483,8 +1491,16 @@ private:
         m_current_feedrate = f;
         return buf;
 	}
-    std::string set_format_I(float i) { return " I" + Slic3r::float_to_string_decimal_point(i, 3); }
-    std::string set_format_J(float j) { return " J" + Slic3r::float_to_string_decimal_point(j, 3); }
+    std::string set_format_I(float i) {
+        std::string out(" I");
+        Slic3r::append_float_decimal_point(out, i, 3);
+        return out;
+    }
+    std::string set_format_J(float j) {
+        std::string out(" J");
+        Slic3r::append_float_decimal_point(out, j, 3);
+        return out;
+    }
 
 	WipeTowerWriter& operator=(const WipeTowerWriter &rhs);
 
@@ -123,15 +123,24 @@ void GCodeReader::update_coordinates(GCodeLine &gline, std::pair<const char*, co
 }
 
 template<typename ParseLineCallback, typename LineEndCallback>
-bool GCodeReader::parse_file_raw_internal(const std::string &filename, ParseLineCallback parse_line_callback, LineEndCallback line_end_callback)
+bool GCodeReader::parse_file_raw_internal(const std::string &filename, size_t start_pos, ParseLineCallback parse_line_callback, LineEndCallback line_end_callback)
 {
     FilePtr in{ boost::nowide::fopen(filename.c_str(), "rb") };
+    if (start_pos > 0) {
+        // Seek with 64bit offsets, G-code files may be larger than 2GB.
+#ifdef _WIN32
+        if (::_fseeki64(in.f, static_cast<__int64>(start_pos), SEEK_SET) != 0)
+#else
+        if (::fseeko(in.f, static_cast<off_t>(start_pos), SEEK_SET) != 0)
+#endif
+            return false;
+    }
 
     // Read the input stream 64kB at a time, extract lines and process them.
     std::vector<char> buffer(65536 * 10, 0);
     // Line buffer.
     std::string gcode_line;
-    size_t file_pos = 0;
+    size_t file_pos = start_pos;
     m_parsing = true;
     for (;;) {
         size_t cnt_read = ::fread(buffer.data(), 1, buffer.size(), in.f);
@@ -179,10 +188,10 @@ bool GCodeReader::parse_file_raw_internal(const std::string &filename, ParseLine
 }
 
 template<typename ParseLineCallback, typename LineEndCallback>
-bool GCodeReader::parse_file_internal(const std::string &filename, ParseLineCallback parse_line_callback, LineEndCallback line_end_callback)
+bool GCodeReader::parse_file_internal(const std::string &filename, size_t start_pos, ParseLineCallback parse_line_callback, LineEndCallback line_end_callback)
 {
     GCodeLine gline;    
-    return this->parse_file_raw_internal(filename, 
+    return this->parse_file_raw_internal(filename, start_pos,
         [this, &gline, parse_line_callback](const char *begin, const char *end) {
             gline.reset();
 
@@ -199,7 +208,7 @@ bool GCodeReader::parse_file_internal(const std::string &filename, ParseLineCall
 bool GCodeReader::parse_file(const std::string &file, callback_t callback)
 {
     BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << boost::format(":  before parse_file %1%") % file.c_str();
-    auto ret = this->parse_file_internal(file, callback, [](size_t) {});
+    auto ret = this->parse_file_internal(file, 0, callback, [](size_t) {});
     BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << boost::format(":  finished parse_file %1%") % file.c_str();
 
     return ret;
@@ -209,7 +218,16 @@ bool GCodeReader::parse_file(const std::string &file, callback_t callback, std::
 {
     lines_ends.clear();
     BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << boost::format(":  before parse_file %1%") % file.c_str();
-    auto ret = this->parse_file_internal(file, callback, [&lines_ends](size_t file_pos){ lines_ends.emplace_back(file_pos); });
+    auto ret = this->parse_file_internal(file, 0, callback, [&lines_ends](size_t file_pos){ lines_ends.emplace_back(file_pos); });
+    BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << boost::format(":  finished parse_file %1%") % file.c_str();
+
+    return ret;
+}
+
+bool GCodeReader::parse_file(const std::string &file, size_t start_pos, callback_t callback, std::vector<size_t> &lines_ends)
+{
+    BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << boost::format(":  before parse_file %1% from %2%") % file.c_str() % start_pos;
+    auto ret = this->parse_file_internal(file, start_pos, callback, [&lines_ends](size_t file_pos){ lines_ends.emplace_back(file_pos); });
     BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << boost::format(":  finished parse_file %1%") % file.c_str();
 
     return ret;
@@ -217,7 +235,7 @@ bool GCodeReader::parse_file(const std::string &file, callback_t callback, std::
 
 bool GCodeReader::parse_file_raw(const std::string &filename, raw_line_callback_t line_callback)
 {
-    return this->parse_file_raw_internal(filename,
+    return this->parse_file_raw_internal(filename, 0,
         [this, line_callback](const char *begin, const char *end) { line_callback(*this, begin, end); }, 
         [](size_t){});
 }
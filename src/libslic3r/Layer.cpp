@@ -85,7 +85,7 @@ void Layer::backup_untyped_slices()
 {
     if (layer_needs_raw_backup(this)) {
         for (LayerRegion *layerm : m_regions) {
-            layerm->raw_slices = to_expolygons(layerm->slices.surfaces);
+            layerm->raw_slices.assign(to_expolygons(layerm->slices.surfaces));
             layerm->raw_counter_circle_compensation.clear();
             layerm->raw_holes_circle_compensation.clear();
             for (Surface &surface : layerm->slices.surfaces) {
@@ -105,7 +105,7 @@ void Layer::restore_untyped_slices()
 {
     if (layer_needs_raw_backup(this)) {
         for (LayerRegion *layerm : m_regions) {
-            layerm->slices.set(layerm->raw_slices, stInternal);
+            layerm->slices.set(layerm->raw_slices.expolygons(), stInternal);
             int surface_idx = 0;
             for (Surface &surface : layerm->slices.surfaces) {
                 if (surface_idx < layerm->raw_counter_circle_compensation.size()
@@ -137,7 +137,7 @@ void Layer::restore_untyped_slices_no_extra_perimeters()
         for (LayerRegion *layerm : m_regions)
             //BBS: remove extra_perimeters. Always false
         	//if (! layerm->region().config().extra_perimeters.value)
-            	layerm->slices.set(layerm->raw_slices, stInternal);
+            	layerm->slices.set(layerm->raw_slices.expolygons(), stInternal);
     } else {
     	assert(m_regions.size() == 1);
     	LayerRegion *layerm = m_regions.front();
@@ -5,6 +5,7 @@
 #include "BoundingBox.hpp"
 #include "Flow.hpp"
 #include "SurfaceCollection.hpp"
+#include "CompactExPolygons.hpp"
 #include "ExtrusionEntityCollection.hpp"
 #include "RegionExpansion.hpp"
 #include <libslic3r/Print.hpp>
@@ -45,7 +46,8 @@ public:
     // Backed up slices before they are split into top/bottom/internal.
     // Only backed up for multi-region layers or layers with elephant foot compensation.
     //FIXME Review whether not to simplify the code by keeping the raw_slices all the time.
-    ExPolygons                  raw_slices;
+    // Kept for the whole life of the layer, but only read when reslicing, thus stored compactly.
+    CompactExPolygons           raw_slices;
     //During the reset process, the circular hole compensation flag needs to be retained 
     // to prevent abnormal speed of circular hole compensation when modifying parameters and then slicing.
     std::vector <bool>             raw_counter_circle_compensation; //vector match to size of slices.surfaces (expolygons)
@@ -3,6 +3,9 @@
 #ifdef _WIN32
     #include <charconv>
 #endif
+#include <cassert>
+#include <cmath>
+#include <cstdint>
 #include <stdexcept>
 
 #include <fast_float/fast_float.h>
@@ -84,6 +87,34 @@ std::string float_to_string_decimal_point(double value, int precision/* = -1*/)
 #endif
 }
 
+void append_float_decimal_point(std::string &out, float value, int precision)
+{
+    static constexpr const int64_t pow_10[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
+    assert(precision >= 0 && precision <= 9);
+    // A float multiplied by a power of ten up to 10^9 is exactly representable by a double,
+    // thus rounding the scaled value half to even (as printf does) gives the exact decimal digits.
+    double scaled = std::abs(double(value) * double(pow_10[precision]));
+    if (! (scaled < 1e15)) {
+        // NaN, infinity or too large to be formatted through an integer.
+        out += float_to_string_decimal_point(value, precision);
+        return;
+    }
+    int64_t digits = int64_t(std::nearbyint(scaled));
+    char    buf[32];
+    char   *end = buf + sizeof(buf);
+    char   *ptr = end;
+    for (int i = 0; i < precision; ++ i, digits /= 10)
+        *(-- ptr) = char('0' + digits % 10);
+    if (precision > 0)
+        *(-- ptr) = '.';
+    do {
+        *(-- ptr) = char('0' + digits % 10);
+        digits /= 10;
+    } while (digits > 0);
+    if (std::signbit(value))
+        *(-- ptr) = '-';
+    out.append(ptr, end);
+}
 
 } // namespace Slic3r
 
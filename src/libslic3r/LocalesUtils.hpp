@@ -41,6 +41,9 @@ bool is_decimal_separator_point();
 // (We use user C locales and "C" C++ locales in most of the code.)
 std::string float_to_string_decimal_point(double value, int precision = -1);
 //std::string float_to_string_decimal_point(float value,  int precision = -1);
+// Append a float with a fixed number of decimal digits (0 to 9), giving the same digits as printf("%.*f")
+// without any locale lookup or stream, to be used when formatting G-code coordinates in tight loops.
+void append_float_decimal_point(std::string &out, float value, int precision);
 double string_to_double_decimal_point(const std::string_view str, size_t* pos = nullptr);
 
 } // namespace Slic3r
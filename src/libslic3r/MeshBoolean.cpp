@@ -475,6 +475,12 @@ bool empty(const CGALMesh &mesh)
     return mesh.m.is_empty();
 }
 
+void merge(CGALMesh &A, CGALMesh &B)
+{
+    A.m.join(B.m);
+    B.m.clear();
+}
+
 CGALMeshPtr clone(const CGALMesh &m)
 {
     return CGALMeshPtr{new CGALMesh{m}};
@@ -497,6 +503,7 @@ struct McutMesh
 void McutMeshDeleter::operator()(McutMesh *ptr) { delete ptr; }
 
 bool empty(const McutMesh &mesh) { return mesh.vertexCoordsArray.empty() || mesh.faceIndicesArray.empty(); }
+McutMeshPtr clone(const McutMesh &mesh) { return McutMeshPtr{ new McutMesh{ mesh } }; }
 void triangle_mesh_to_mcut(const TriangleMesh &src_mesh, McutMesh &srcMesh, const Transform3d &src_nm = Transform3d::Identity())
 {
     // vertices precision convention and copy
@@ -563,14 +570,20 @@ TriangleMesh mcut_to_triangle_mesh(const McutMesh &mcutmesh)
     return out;
 }
 
+void merge(McutMesh &dst, const McutMesh &src)
+{
+    const uint32_t vertex_offset = uint32_t(dst.vertexCoordsArray.size() / 3);
+    dst.vertexCoordsArray.insert(dst.vertexCoordsArray.end(), src.vertexCoordsArray.begin(), src.vertexCoordsArray.end());
+    dst.faceSizesArray.insert(dst.faceSizesArray.end(), src.faceSizesArray.begin(), src.faceSizesArray.end());
+    dst.faceIndicesArray.reserve(dst.faceIndicesArray.size() + src.faceIndicesArray.size());
+    for (uint32_t idx : src.faceIndicesArray)
+        dst.faceIndicesArray.push_back(idx + vertex_offset);
+}
+
 void merge_mcut_meshes(McutMesh& src, const McutMesh& cut) {
-    indexed_triangle_set all_its;
-    TriangleMesh tri_src = mcut_to_triangle_mesh(src);
-    TriangleMesh tri_cut = mcut_to_triangle_mesh(cut);
-    its_merge(all_its, tri_src.its);
-    its_merge(all_its, tri_cut.its);
-    src = *triangle_mesh_to_mcut(all_its);
-    }
+    // keep the double precision coordinates, no round trip through TriangleMesh
+    merge(src, cut);
+}
 
 MCAPI_ATTR void MCAPI_CALL mcDebugOutput(McDebugSource source,
     McDebugType type,
@@ -851,15 +864,26 @@ bool do_boolean(McutMesh& srcMesh, const McutMesh& cutMesh, const std::string& b
                 }
             };
         }
+        // The cut parts are converted once, the pairs of parts with disjoint bounding boxes are not passed to mcut
+        // when the result is known: the difference keeps the source part and the intersection is empty.
+        std::vector<McutMeshPtr>   cut_mcut_parts(cut_parts.size());
+        std::vector<BoundingBoxf3> cut_bboxes(cut_parts.size());
+        for (size_t j = 0; j < cut_parts.size(); j++) {
+            cut_mcut_parts[j] = triangle_mesh_to_mcut(cut_parts[j]);
+            cut_bboxes[j]     = bounding_box(cut_parts[j]);
+        }
+        auto disjoint = [&cut_bboxes](const BoundingBoxf3 &src_bbox, size_t j) { return ! bounding_boxes_overlap(src_bbox, cut_bboxes[j]); };
+
         if (boolean_opts == "UNION" || boolean_opts == "A_NOT_B") {
             for (size_t i = 0; i < src_parts.size(); i++) {
                 auto src_part = triangle_mesh_to_mcut(src_parts[i]);
+                const BoundingBoxf3 src_bbox = bounding_box(src_parts[i]);
                 for (size_t j = 0; j < cut_parts.size(); j++) {
                     if (cancel_cb && cancel_cb()) {
                         return false;
                     }
-                    auto cut_part = triangle_mesh_to_mcut(cut_parts[j]);
-                    do_boolean_single(*src_part, *cut_part, boolean_opts, cancel_cb, temp_progress_cb);
+                    if (boolean_opts == "UNION" || ! disjoint(src_bbox, j))
+                        do_boolean_single(*src_part, *cut_mcut_parts[j], boolean_opts, cancel_cb, temp_progress_cb);
                     ++count_index;
                 }
                 TriangleMesh tri_part = mcut_to_triangle_mesh(*src_part);
@@ -867,14 +891,16 @@ bool do_boolean(McutMesh& srcMesh, const McutMesh& cutMesh, const std::string& b
             }
         } else if (boolean_opts == "INTERSECTION") {
             for (size_t i = 0; i < src_parts.size(); i++) {
+                const BoundingBoxf3 src_bbox = bounding_box(src_parts[i]);
                 for (size_t j = 0; j < cut_parts.size(); j++) {
                     if (cancel_cb && cancel_cb()) {
                         return false;
                     }
                     ++count_index;
+                    if (disjoint(src_bbox, j))
+                        continue;
                     auto src_part = triangle_mesh_to_mcut(src_parts[i]);
-                    auto cut_part = triangle_mesh_to_mcut(cut_parts[j]);
-                    bool success  = do_boolean_single(*src_part, *cut_part, boolean_opts, cancel_cb, temp_progress_cb);
+                    bool success  = do_boolean_single(*src_part, *cut_mcut_parts[j], boolean_opts, cancel_cb, temp_progress_cb);
                     if (success) {
                         TriangleMesh tri_part = mcut_to_triangle_mesh(*src_part);
                         its_merge(all_its, tri_part.its);
@@ -22,6 +22,14 @@ void self_union(EigenMesh &A);
 void minus(TriangleMesh& A, const TriangleMesh& B);
 void self_union(TriangleMesh& mesh);
 
+// Conservative test of the bounding boxes of two boolean operands, touching boxes overlap.
+// The boolean of operands with disjoint bounding boxes does not need to intersect any triangles.
+inline bool bounding_boxes_overlap(const BoundingBoxf3 &a, const BoundingBoxf3 &b)
+{
+    return a.defined && b.defined &&
+           (a.min.array() <= b.max.array() + EPSILON).all() && (b.min.array() <= a.max.array() + EPSILON).all();
+}
+
 namespace cgal {
 
 struct CGALMesh;
@@ -70,6 +78,8 @@ TriangleMesh merge(std::vector<TriangleMesh> meshes);
 
 bool does_bound_a_volume(const CGALMesh &mesh);
 bool empty(const CGALMesh &mesh);
+// Append the triangles of B to A without any boolean, B is left empty.
+void merge(CGALMesh &A, CGALMesh &B);
 }
 
 namespace mcut {
@@ -80,9 +90,12 @@ struct McutMeshDeleter
 };
 using McutMeshPtr = std::unique_ptr<McutMesh, McutMeshDeleter>;
 bool empty(const McutMesh &mesh);
+McutMeshPtr clone(const McutMesh &mesh);
 
 McutMeshPtr  triangle_mesh_to_mcut(const indexed_triangle_set &M);
 TriangleMesh mcut_to_triangle_mesh(const McutMesh &mcutmesh);
+// Append the triangles of src to dst without any boolean.
+void merge(McutMesh &dst, const McutMesh &src);
 
 using BooleanCancelCB = std::function<bool()>;
 using BooleanProgressCB = std::function<void(float)>;
@@ -2163,6 +2163,8 @@ std::vector<std::vector<ExPolygons>> multi_material_segmentation_by_painting(con
                     continue;
                 MeshSlicingParamsEx params;
                 params.trafo = print_object.trafo_centered() * mv->get_matrix();
+                std::shared_ptr<const std::vector<Vec3i>> face_edge_ids = mv->mesh().face_edge_ids();
+                params.face_edge_ids = face_edge_ids.get();
                 auto vol_slices = slice_mesh_ex(mv->mesh().its, zs, params, throw_on_cancel_callback);
                 assert(vol_slices.size() == num_layers);
                 for (size_t i = 0; i < num_layers; ++i)
@@ -246,11 +246,13 @@ bool extract_colors_to_obj_dialog(
                     new_mesh_its.indices.emplace_back(temp_face);
                 }
                 new_mesh.its = new_mesh_its;
+                new_mesh.invalidate_topology();
                 volume->origin_render_info_ptr->vertices_with_colors.first = std::move(new_mesh);
                 volume->origin_render_info_ptr->vertices_with_colors.second = std::move(vertex_colors);
             }
             else {
                 new_mesh.its = src_mesh.its;
+                new_mesh.invalidate_topology();
                 // If exist last untracked face_idx range or all triangles use one color
                 if (current_start_face_idx > current_end_face_idx && current_start_face_idx < face_count && current_color_valid) {
                     // Neen't split use origin mesh
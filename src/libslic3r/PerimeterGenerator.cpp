@@ -18,6 +18,9 @@
 #include <unordered_set>
 #include "OverhangDetector.hpp"
 #include "FuzzySkin.hpp"
+#include "ThreadLocalCache.hpp"
+
+#include <boost/functional/hash.hpp>
 
 static const double narrow_loop_length_threshold = 10;
 //BBS: when the width of expolygon is smaller than
@@ -1473,6 +1476,79 @@ void PerimeterGenerator::add_infill_contour_for_arachne( ExPolygons        infil
     append(*this->fill_no_overlap, offset2_ex(union_ex(inner_pp), float(-min_perimeter_infill_spacing / 2.), float(+min_perimeter_infill_spacing / 2.)));
 }
 
+// Walls of an island generated by Arachne and the contour of the area left for the infill.
+struct ArachneWalls
+{
+    std::vector<Arachne::VariableWidthLines> toolpaths;
+    Polygons                                 inner_contour;
+};
+
+// Inputs of WallToolPaths. Only an outline at the same position is matched: the Voronoi vertices are computed in floating point
+// and rounded, thus the walls of a shifted outline are not exactly the shifted walls.
+struct ArachneWallsKey
+{
+    Polygons                     outline;
+    coord_t                      bead_width_0;
+    coord_t                      bead_width_x;
+    size_t                       inset_count;
+    coord_t                      wall_0_inset;
+    coordf_t                     layer_height;
+    Arachne::WallToolPathsParams params;
+    std::vector<int>             hole_indices;
+    bool                         hole_compensation;
+    size_t                       hash;
+
+    // Hash of the outline and of the wall counts and widths.
+    void update_hash()
+    {
+        this->hash = this->outline.size();
+        for (const Polygon &polygon : this->outline) {
+            boost::hash_combine(this->hash, polygon.size());
+            for (const Point &pt : polygon.points) {
+                boost::hash_combine(this->hash, pt.x());
+                boost::hash_combine(this->hash, pt.y());
+            }
+        }
+        boost::hash_combine(this->hash, this->inset_count);
+        boost::hash_combine(this->hash, this->bead_width_0);
+    }
+
+    bool operator==(const ArachneWallsKey &rhs) const {
+        return this->hash == rhs.hash && this->bead_width_0 == rhs.bead_width_0 && this->bead_width_x == rhs.bead_width_x &&
+               this->inset_count == rhs.inset_count && this->wall_0_inset == rhs.wall_0_inset && this->layer_height == rhs.layer_height &&
+               this->params.min_bead_width == rhs.params.min_bead_width && this->params.min_feature_size == rhs.params.min_feature_size &&
+               this->params.wall_transition_length == rhs.params.wall_transition_length &&
+               this->params.wall_transition_angle == rhs.params.wall_transition_angle &&
+               this->params.wall_transition_filter_deviation == rhs.params.wall_transition_filter_deviation &&
+               this->params.wall_distribution_count == rhs.params.wall_distribution_count &&
+               this->hole_compensation == rhs.hole_compensation && this->hole_indices == rhs.hole_indices && this->outline == rhs.outline;
+    }
+};
+
+// Enough for several islands of a layer and the one wall / remaining walls variants of the same island.
+static ThreadLocalLRUCache<ArachneWallsKey, ArachneWalls, 8> arachne_walls_cache;
+
+// Generate the Arachne walls of an outline or reuse the walls of the same outline generated before by this thread.
+static ArachneWalls generate_arachne_walls(const Polygons &outline, coord_t bead_width_0, coord_t bead_width_x, size_t inset_count, coord_t wall_0_inset,
+                                           coordf_t layer_height, const Arachne::WallToolPathsParams &params, const std::vector<int> *hole_indices = nullptr)
+{
+    ArachneWallsKey key { outline, bead_width_0, bead_width_x, inset_count, wall_0_inset, layer_height, params, {}, hole_indices != nullptr, 0 };
+    if (hole_indices)
+        key.hole_indices = *hole_indices;
+    key.update_hash();
+    if (const ArachneWalls *cached = arachne_walls_cache.find(key); cached)
+        return *cached;
+
+    Arachne::WallToolPaths wall_tool_paths(outline, bead_width_0, bead_width_x, inset_count, wall_0_inset, layer_height, params);
+    if (hole_indices)
+        wall_tool_paths.EnableHoleCompensation(true, *hole_indices);
+    ArachneWalls walls;
+    walls.toolpaths     = wall_tool_paths.getToolPaths();
+    walls.inner_contour = wall_tool_paths.getInnerContour();
+    arachne_walls_cache.insert(std::move(key), ArachneWalls(walls));
+    return walls;
+}
+
 // Thanks, Cura developers, for implementing an algorithm for generating perimeters with variable width (Arachne) that is based on the paper
 // "A framework for adaptive width control of dense contour-parallel toolpaths in fused deposition modeling"
 void PerimeterGenerator::process_arachne()
@@ -1575,12 +1651,11 @@ void PerimeterGenerator::process_arachne()
 
             // do detail check whether to enable one wall
             if (seperate_wall_generation) {
-                Arachne::WallToolPaths one_wall_paths(last_p, ext_perimeter_spacing, perimeter_spacing, 1, wall_0_inset, layer_height, input_params);
-                if (apply_circle_compensation)
-                    one_wall_paths.EnableHoleCompensation(true, circle_poly_indices);
+                ArachneWalls one_wall_paths = generate_arachne_walls(last_p, ext_perimeter_spacing, perimeter_spacing, 1, wall_0_inset, layer_height, input_params,
+                                                                     apply_circle_compensation ? &circle_poly_indices : nullptr);
 
-                first_perimeters = one_wall_paths.getToolPaths();
-                infill_contour_by_one_wall = union_ex(one_wall_paths.getInnerContour());
+                first_perimeters = std::move(one_wall_paths.toolpaths);
+                infill_contour_by_one_wall = union_ex(one_wall_paths.inner_contour);
 
                 BoundingBox infill_bbox = get_extents(infill_contour_by_one_wall);
                 infill_bbox.offset(EPSILON);
@@ -1609,8 +1684,8 @@ void PerimeterGenerator::process_arachne()
                 if (loop_number > 0) {
                     last = diff_ex(infill_contour_by_one_wall, top_expolys_by_one_wall);
                     last_p = to_polygons(last); // disable contour compensation in remaining walls
-                    Arachne::WallToolPaths paths_new(last_p, perimeter_spacing, perimeter_spacing, loop_number, wall_0_inset, layer_height, input_params);
-                    auto new_perimeters = paths_new.getToolPaths();
+                    ArachneWalls paths_new = generate_arachne_walls(last_p, perimeter_spacing, perimeter_spacing, loop_number, wall_0_inset, layer_height, input_params);
+                    auto new_perimeters = std::move(paths_new.toolpaths);
                     for (auto& perimeters : new_perimeters) {
                         if (!perimeters.empty()) {
                             for (auto& p : perimeters) {
@@ -1619,26 +1694,24 @@ void PerimeterGenerator::process_arachne()
                             total_perimeters.emplace_back(std::move(perimeters));
                         }
                     }
-                    infill_contour = union_ex(union_ex(paths_new.getInnerContour()), top_expolys_by_one_wall);
+                    infill_contour = union_ex(union_ex(paths_new.inner_contour), top_expolys_by_one_wall);
                     infill_contour = intersection_ex(infill_contour, infill_contour_by_one_wall);
                 }
             }
             else {
                 if (is_one_wall) {
                     // plan wall width as one wall
-                    Arachne::WallToolPaths one_wall_paths(last_p, ext_perimeter_spacing, perimeter_spacing, 1, wall_0_inset, layer_height, input_params);
-                    if (apply_circle_compensation)
-                        one_wall_paths.EnableHoleCompensation(true, circle_poly_indices);
-                    total_perimeters = one_wall_paths.getToolPaths();
-                    infill_contour = union_ex(one_wall_paths.getInnerContour());
+                    ArachneWalls one_wall_paths = generate_arachne_walls(last_p, ext_perimeter_spacing, perimeter_spacing, 1, wall_0_inset, layer_height, input_params,
+                                                                         apply_circle_compensation ? &circle_poly_indices : nullptr);
+                    total_perimeters = std::move(one_wall_paths.toolpaths);
+                    infill_contour = union_ex(one_wall_paths.inner_contour);
                 }
                 else {
                     // plan wall width as noraml
-                    Arachne::WallToolPaths normal_paths(last_p, ext_perimeter_spacing, perimeter_spacing, loop_number + 1, wall_0_inset, layer_height, input_params);
-                    if (apply_circle_compensation)
-                        normal_paths.EnableHoleCompensation(true, circle_poly_indices);
-                    total_perimeters = normal_paths.getToolPaths();
-                    infill_contour = union_ex(normal_paths.getInnerContour());
+                    ArachneWalls normal_paths = generate_arachne_walls(last_p, ext_perimeter_spacing, perimeter_spacing, loop_number + 1, wall_0_inset, layer_height, input_params,
+                                                                       apply_circle_compensation ? &circle_poly_indices : nullptr);
+                    total_perimeters = std::move(normal_paths.toolpaths);
+                    infill_contour = union_ex(normal_paths.inner_contour);
                 }
             }
         }
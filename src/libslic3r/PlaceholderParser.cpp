@@ -6,6 +6,9 @@
 #include <iomanip>
 #include <sstream>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 #ifdef _MSC_VER
     #include <stdlib.h>  // provides **_environ
 #else
@@ -1169,6 +1172,12 @@ namespace client
         }
     };
 
+    // Keywords, which could not be used as variable names.
+    static constexpr const char *macro_keywords[] = {
+        "and", "digits", "zdigits", "if", "int", /* "inf", */ "else", "elsif", "endif", "false", "min", "max",
+        "random", "filament_change", "round", "floor", "ceil", "not", "or", "true"
+    };
+
     ///////////////////////////////////////////////////////////////////////////
     //  Our macro_processor grammar
     ///////////////////////////////////////////////////////////////////////////
@@ -1410,27 +1419,8 @@ namespace client
             regular_expression = raw[lexeme['/' > *((utf8char - char_('\\') - char_('/')) | ('\\' > char_)) > '/']];
             regular_expression.name("regular_expression");
 
-            keywords.add
-                ("and")
-                ("digits")
-                ("zdigits")
-                ("if")
-                ("int")
-                //("inf")
-                ("else")
-                ("elsif")
-                ("endif")
-                ("false")
-                ("min")
-                ("max")
-                ("random")
-                ("filament_change")
-                ("round")
-                ("floor")
-                ("ceil")
-                ("not")
-                ("or")
-                ("true");
+            for (const char *keyword : macro_keywords)
+                keywords.add(keyword);
 
             if (0) {
                 debug(start);
@@ -1531,15 +1521,219 @@ static std::string process_macro(const std::string &templ, client::MyContext &co
     return output;
 }
 
+// A template split into segments once, so that the literal text and the plain variable references are expanded
+// without running the macro_processor grammar. Only the remaining macros are parsed each time the template is processed.
+struct TemplateSegment
+{
+    enum class Type {
+        // Literal text copied to the output.
+        Text,
+        // [variable]
+        LegacyVariable,
+        // {variable}
+        Variable,
+        // Any other macro or a whole {if}...{endif} block, to be processed by the macro_processor grammar.
+        Macro,
+    };
+    Type        type;
+    // Literal text, variable name or the macro source.
+    std::string text;
+};
+using CompiledTemplate = std::vector<TemplateSegment>;
+
+static bool is_macro_keyword(const std::string &name)
+{
+    return std::find_if(std::begin(client::macro_keywords), std::end(client::macro_keywords),
+        [&name](const char *keyword) { return name == keyword; }) != std::end(client::macro_keywords);
+}
+
+static bool is_plain_identifier(const std::string &name)
+{
+    if (name.empty() || ! (std::isalpha((unsigned char)name.front()) || name.front() == '_'))
+        return false;
+    for (char c : name)
+        if (! (std::isalnum((unsigned char)c) || c == '_'))
+            return false;
+    return ! is_macro_keyword(name);
+}
+
+// Returns the position after the '}' closing the macro starting at templ[begin] == '{',
+// skipping string literals and regular expressions, or std::string::npos if the macro is not closed.
+static size_t find_macro_end(const std::string &templ, size_t begin)
+{
+    auto skip_quoted = [&templ](size_t i, char quote) -> size_t {
+        for (++ i; i < templ.size(); ++ i)
+            if (templ[i] == '\\')
+                ++ i;
+            else if (templ[i] == quote)
+                return i;
+        return std::string::npos;
+    };
+    for (size_t i = begin + 1; i < templ.size(); ++ i) {
+        char c = templ[i];
+        if (c == '}')
+            return i + 1;
+        if (c == '{')
+            return std::string::npos;
+        if (c == '"') {
+            if ((i = skip_quoted(i, '"')) == std::string::npos)
+                return i;
+        } else if (c == '~' && (templ[i - 1] == '=' || templ[i - 1] == '!')) {
+            size_t j = templ.find_first_not_of(" \t\r\n", i + 1);
+            if (j != std::string::npos && templ[j] == '/' && (i = skip_quoted(j, '/')) == std::string::npos)
+                return i;
+        }
+    }
+    return std::string::npos;
+}
+
+// First word of a macro, to detect the {if}...{endif} blocks.
+static std::string macro_leading_word(const std::string &templ, size_t begin, size_t end)
+{
+    size_t i = templ.find_first_not_of(" \t\r\n", begin + 1);
+    size_t j = i;
+    while (j < end && (std::isalnum((unsigned char)templ[j]) || templ[j] == '_'))
+        ++ j;
+    return i < j ? templ.substr(i, j - i) : std::string();
+}
+
+static CompiledTemplate compile_template(const std::string &templ)
+{
+    CompiledTemplate out;
+    auto add_segment = [&out](TemplateSegment::Type type, std::string text) {
+        if (type == TemplateSegment::Type::Text && ! out.empty() && out.back().type == TemplateSegment::Type::Text)
+            out.back().text += text;
+        else
+            out.push_back({ type, std::move(text) });
+    };
+    size_t i = 0;
+    while (i < templ.size()) {
+        size_t begin = templ.find_first_of("[{", i);
+        if (begin == std::string::npos) {
+            add_segment(TemplateSegment::Type::Text, templ.substr(i));
+            break;
+        }
+        if (begin > i)
+            add_segment(TemplateSegment::Type::Text, templ.substr(i, begin - i));
+        size_t end = std::string::npos;
+        if (templ[begin] == '[') {
+            // Either [variable] or [variable[index]].
+            end = templ.find(']', begin);
+            if (end != std::string::npos) {
+                std::string name = boost::trim_copy(templ.substr(begin + 1, end - begin - 1));
+                if (is_plain_identifier(name)) {
+                    add_segment(TemplateSegment::Type::LegacyVariable, std::move(name));
+                    i = end + 1;
+                    continue;
+                }
+                if (name.find('[') != std::string::npos)
+                    end = templ.find(']', end + 1);
+                if (end != std::string::npos)
+                    ++ end;
+            }
+        } else if ((end = find_macro_end(templ, begin)) != std::string::npos) {
+            std::string word = macro_leading_word(templ, begin, end);
+            if (word == "if") {
+                // Extend the macro up to the matching {endif}.
+                for (int depth = 1; depth > 0 && end != std::string::npos;) {
+                    size_t next = templ.find('{', end);
+                    end = next == std::string::npos ? next : find_macro_end(templ, next);
+                    if (end != std::string::npos) {
+                        word = macro_leading_word(templ, next, end);
+                        depth += word == "if" ? 1 : word == "endif" ? -1 : 0;
+                    }
+                }
+            } else {
+                std::string name = boost::trim_copy(templ.substr(begin + 1, end - begin - 2));
+                if (is_plain_identifier(name)) {
+                    add_segment(TemplateSegment::Type::Variable, std::move(name));
+                    i = end;
+                    continue;
+                }
+            }
+        }
+        // Let the macro_processor grammar report an unterminated macro.
+        if (end == std::string::npos)
+            end = templ.size();
+        add_segment(TemplateSegment::Type::Macro, templ.substr(begin, end - begin));
+        i = end;
+    }
+    return out;
+}
+
+// Templates are compiled once and shared by all the PlaceholderParser instances and threads.
+static std::shared_ptr<const CompiledTemplate> compiled_template(const std::string &templ)
+{
+    static std::mutex                                                                mutex;
+    static std::unordered_map<std::string, std::shared_ptr<const CompiledTemplate>> cache;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (auto it = cache.find(templ); it != cache.end())
+            return it->second;
+    }
+    auto compiled = std::make_shared<const CompiledTemplate>(compile_template(templ));
+    std::lock_guard<std::mutex> lock(mutex);
+    // The templates are taken from the configs, the limit is only reached if the custom G-codes are edited many times.
+    if (cache.size() >= 1024)
+        cache.clear();
+    cache.emplace(templ, compiled);
+    return compiled;
+}
+
+static std::string process_compiled_template(const CompiledTemplate &compiled, client::MyContext &context)
+{
+    typedef std::string::const_iterator iterator_type;
+    std::string output;
+    for (const TemplateSegment &segment : compiled) {
+        switch (segment.type) {
+        case TemplateSegment::Type::Text:
+            output += segment.text;
+            break;
+        case TemplateSegment::Type::LegacyVariable:
+        {
+            boost::iterator_range<iterator_type> opt_key(segment.text.begin(), segment.text.end());
+            std::string value;
+            client::MyContext::legacy_variable_expansion<iterator_type>(&context, opt_key, value);
+            output += value;
+            break;
+        }
+        case TemplateSegment::Type::Variable:
+        {
+            boost::iterator_range<iterator_type> opt_key(segment.text.begin(), segment.text.end());
+            client::OptWithPos<iterator_type>    opt;
+            client::expr<iterator_type>          value;
+            client::MyContext::resolve_variable<iterator_type>(&context, opt_key, opt);
+            client::MyContext::scalar_variable_reference<iterator_type>(&context, opt, value);
+            output += value.to_string();
+            break;
+        }
+        case TemplateSegment::Type::Macro:
+            output += process_macro(segment.text, context);
+            break;
+        }
+    }
+    return output;
+}
+
 std::string PlaceholderParser::process(const std::string &templ, unsigned int current_extruder_id, const DynamicConfig *config_override, ContextData *context_data) const
 {
+    auto init_context = [&](client::MyContext &context) {
+        context.external_config 	= this->external_config();
+        context.config              = &this->config();
+        context.config_override     = config_override;
+        context.current_extruder_id = current_extruder_id;
+        context.context_data        = context_data;
+    };
     client::MyContext context;
-    context.external_config 	= this->external_config();
-    context.config              = &this->config();
-    context.config_override     = config_override;
-    context.current_extruder_id = current_extruder_id;
-    context.context_data        = context_data;
-    return process_macro(templ, context);
+    init_context(context);
+    try {
+        return process_compiled_template(*compiled_template(templ), context);
+    } catch (const std::exception &) {
+        // Process the whole template again to report the error in the context of the complete template.
+        client::MyContext context_full;
+        init_context(context_full);
+        return process_macro(templ, context_full);
+    }
 }
 
 // Evaluate a boolean expression using the full expressive power of the PlaceholderParser boolean expression syntax.
@@ -1,6 +1,7 @@
 #include <cassert>
 
 #include "PresetBundle.hpp"
+#include "PresetSnapshot.hpp"
 #include "Semver.hpp"
 #include "FilamentMixer.hpp"
 #include "nlohmann/json.hpp"
@@ -4751,6 +4752,31 @@ std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_vendor_configs_
         return std::make_pair(PresetsConfigSubstitutions{}, 0);
 
     // 3) paste the process/filament/print configs
+    // The system bundle of the data directory is restored from its binary snapshot as long as the preset files are unchanged.
+    std::string snapshot_file;
+    uint64_t    snapshot_hash = 0;
+    boost::system::error_code ec;
+    if (flags.has(LoadConfigBundleAttribute::LoadSystem) && !flags.has(LoadConfigBundleAttribute::LoadFilamentOnly) &&
+        boost::filesystem::equivalent(path, boost::filesystem::path(data_dir()) / PRESET_SYSTEM_DIR, ec)) {
+        std::vector<std::string> subpaths;
+        for (const auto *subfiles : { &process_subfiles, &filament_subfiles, &machine_subfiles })
+            for (const auto &subfile : *subfiles)
+                subpaths.emplace_back(subfile.second);
+        snapshot_file = PresetSnapshot::snapshot_file(path, vendor_name);
+        snapshot_hash = PresetSnapshot::hash_sources(path, vendor_name, subpaths);
+
+        PresetSnapshot snapshot;
+        if (snapshot.load(snapshot_file, snapshot_hash)) {
+            size_t presets_loaded = this->load_vendor_presets_from_snapshot(snapshot, current_vendor_profile);
+            if (presets_loaded > 0) {
+                BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << boost::format(", loaded %1% presets of vendor %2% from snapshot") % presets_loaded % vendor_name;
+                return std::make_pair(PresetsConfigSubstitutions{}, presets_loaded);
+            }
+        }
+    }
+    // presets loaded from the json files in loading order: type, name, whether the preset holds its alias
+    std::vector<std::tuple<Preset::Type, std::string, bool>> snapshot_presets;
+
     PresetCollection         *presets = nullptr;
     size_t                   presets_loaded = 0;
 #if PARALLEL_LOAD_PRESET
@@ -4765,7 +4791,7 @@ std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_vendor_configs_
     std::vector<std::shared_ptr<ParallelPresetLoadData>> parallelLoadData;
 
     auto parse_config = [this, path, vendor_name, presets_loaded,
-                         current_vendor_profile](std::shared_ptr<ParallelPresetLoadData> presetLoadData, ConfigSubstitutionContext &substitution_context,
+                         current_vendor_profile, &snapshot_presets](std::shared_ptr<ParallelPresetLoadData> presetLoadData, ConfigSubstitutionContext &substitution_context,
                                                  PresetsConfigSubstitutions &substitutions, LoadConfigBundleAttributes &flags, std::pair<std::string, std::string> &subfile_iter,
                                                  std::map<std::string, DynamicPrintConfig> &config_maps, std::map<std::string, std::string> &filament_id_maps,
                                                  PresetCollection *presets_collection, size_t &count, std::map<std::string, std::string> &description_maps) -> std::string {
@@ -4998,6 +5024,7 @@ std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_vendor_configs_
                 boost::trim_right(alias_name);
             }
         }
+        bool hold_alias = !alias_name.empty();
         if (alias_name.empty())
             loaded.alias = preset_name;
         else {
@@ -5005,6 +5032,7 @@ std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_vendor_configs_
             filaments.set_printer_hold_alias(loaded.alias, loaded);
         }
         loaded.renamed_from = std::move(renamed_from);
+        snapshot_presets.emplace_back(presets_collection->type(), preset_name, hold_alias);
         if (! substitution_context.empty())
             substitutions.push_back({
                 preset_name, presets_collection->type(), PresetConfigSubstitutions::Source::ConfigBundle,
@@ -5016,7 +5044,7 @@ std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_vendor_configs_
         return reason;
     };
 #else
-    auto parse_subfile = [this, path, vendor_name, presets_loaded, current_vendor_profile](\
+    auto parse_subfile = [this, path, vendor_name, presets_loaded, current_vendor_profile, &snapshot_presets](\
         ConfigSubstitutionContext& substitution_context,
         PresetsConfigSubstitutions& substitutions,
         LoadConfigBundleAttributes& flags,
@@ -5248,6 +5276,7 @@ std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_vendor_configs_
                 boost::trim_right(alias_name);
             }
         }
+        bool hold_alias = !alias_name.empty();
         if (alias_name.empty())
             loaded.alias = preset_name;
         else {
@@ -5255,6 +5284,7 @@ std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_vendor_configs_
             filaments.set_printer_hold_alias(loaded.alias, loaded);
         }
         loaded.renamed_from = std::move(renamed_from);
+        snapshot_presets.emplace_back(presets_collection->type(), preset_name, hold_alias);
         if (! substitution_context.empty())
             substitutions.push_back({
                 preset_name, presets_collection->type(), PresetConfigSubstitutions::Source::ConfigBundle,
@@ -5403,11 +5433,65 @@ std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_vendor_configs_
         }
     }
 #endif
+
+    if (!snapshot_file.empty() && substitutions.empty()) {
+        PresetSnapshot snapshot;
+        for (const auto &[type, name, hold_alias] : snapshot_presets) {
+            PresetCollection *collection = type == Preset::TYPE_PRINT ? &this->prints : type == Preset::TYPE_FILAMENT ? &this->filaments : &this->printers;
+            if (const Preset *preset = collection->find_preset(name, false); preset != nullptr)
+                snapshot.add_preset(*collection, *preset, hold_alias);
+        }
+        snapshot.save(snapshot_file, snapshot_hash);
+    }
+
     //BBS: add config related logs
     BOOST_LOG_TRIVIAL(debug) << __FUNCTION__ << boost::format(", finished, presets_loaded %1%")%presets_loaded;
     return std::make_pair(std::move(substitutions), presets_loaded);
 }
 
+size_t PresetBundle::load_vendor_presets_from_snapshot(const PresetSnapshot &snapshot, const VendorProfile *vendor_profile)
+{
+    auto collection_for = [this](Preset::Type type) -> PresetCollection* {
+        switch (type) {
+        case Preset::TYPE_PRINT: return &this->prints;
+        case Preset::TYPE_FILAMENT: return &this->filaments;
+        case Preset::TYPE_PRINTER: return &this->printers;
+        default: return nullptr;
+        }
+    };
+
+    // resolve all the configs first, so that a broken snapshot leaves the bundle untouched
+    std::vector<DynamicPrintConfig> configs(snapshot.entries.size());
+    try {
+        for (const PresetSnapshot::Entry &entry : snapshot.entries)
+            if (collection_for(entry.type) == nullptr)
+                throw ConfigurationError("invalid preset type of " + entry.name);
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, snapshot.entries.size()), [&](const tbb::blocked_range<size_t> &range) {
+            for (size_t i = range.begin(); i < range.end(); ++i)
+                configs[i] = PresetSnapshot::resolve_config(*collection_for(snapshot.entries[i].type), snapshot.entries[i]);
+        });
+    } catch (const std::exception &err) {
+        BOOST_LOG_TRIVIAL(error) << __FUNCTION__ << ": failed to resolve preset snapshot of vendor " << vendor_profile->name << ", reason = " << err.what();
+        return 0;
+    }
+
+    for (size_t i = 0; i < snapshot.entries.size(); ++i) {
+        const PresetSnapshot::Entry &entry = snapshot.entries[i];
+        Preset &loaded = collection_for(entry.type)->load_preset(entry.file, entry.name, std::move(configs[i]), false);
+        loaded.is_system   = true;
+        loaded.vendor      = vendor_profile;
+        loaded.version     = vendor_profile->config_version;
+        loaded.description = entry.description;
+        loaded.setting_id  = entry.setting_id;
+        loaded.filament_id = entry.filament_id;
+        loaded.alias       = entry.alias;
+        if (entry.hold_alias)
+            filaments.set_printer_hold_alias(loaded.alias, loaded);
+        loaded.renamed_from = entry.renamed_from;
+    }
+    return snapshot.entries.size();
+}
+
 VendorProfile::PrinterModel PresetBundle::load_vendor_configs_from_json(const std::string &path)
 {
     VendorProfile::PrinterModel model;
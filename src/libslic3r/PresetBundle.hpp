@@ -118,6 +118,7 @@ struct SupportRecommendedParams
 };
 
 class PresetBundle;
+class PresetSnapshot;
 struct ExtruderNozzleStat
 {
 public:
@@ -423,6 +424,8 @@ private:
     std::pair<PresetsConfigSubstitutions, std::string> load_system_presets_from_json(ForwardCompatibilitySubstitutionRule compatibility_rule);
     // Merge one vendor's presets with the other vendor's presets, report duplicates.
     std::vector<std::string>    merge_presets(PresetBundle &&other);
+    // Load the presets of a vendor from its binary snapshot, returns 0 and loads nothing if the snapshot cannot be resolved.
+    size_t                      load_vendor_presets_from_snapshot(const PresetSnapshot &snapshot, const VendorProfile *vendor_profile);
     // Update the multicolor information for filaments.
     void update_filament_multi_color();
     // Update renamed_from and alias maps of system profiles.
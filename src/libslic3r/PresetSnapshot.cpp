@@ -0,0 +1,319 @@
+#include "PresetSnapshot.hpp"
+#include "libslic3r.h"
+#include "PrintConfig.hpp"
+#include "Utils.hpp"
+
+#include <cstring>
+#include <boost/filesystem.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/log/trivial.hpp>
+#include <boost/nowide/fstream.hpp>
+
+namespace Slic3r {
+
+static constexpr char     SNAPSHOT_MAGIC[8]       = { 'B', 'B', 'S', 'P', 'S', 'N', 'A', 'P' };
+// increase when the layout of the snapshot changes
+static constexpr uint32_t SNAPSHOT_FORMAT_VERSION = 1;
+
+namespace {
+
+struct Fnv1aHash
+{
+    uint64_t value = 14695981039346656037ULL;
+
+    void add(const char *data, size_t size)
+    {
+        for (size_t i = 0; i < size; ++i) {
+            value ^= uint64_t(uint8_t(data[i]));
+            value *= 1099511628211ULL;
+        }
+    }
+    void add(const std::string &str)
+    {
+        uint64_t size = str.size();
+        this->add(reinterpret_cast<const char*>(&size), sizeof(size));
+        this->add(str.data(), str.size());
+    }
+};
+
+class SnapshotWriter
+{
+public:
+    explicit SnapshotWriter(std::ostream &os) : m_os(os) {}
+
+    template<typename T> void write_pod(const T &value) { m_os.write(reinterpret_cast<const char*>(&value), sizeof(T)); }
+    void write(const std::string &str)
+    {
+        this->write_pod(uint32_t(str.size()));
+        m_os.write(str.data(), str.size());
+    }
+    void write(const std::vector<std::string> &strs)
+    {
+        this->write_pod(uint32_t(strs.size()));
+        for (const std::string &str : strs)
+            this->write(str);
+    }
+
+private:
+    std::ostream &m_os;
+};
+
+// Reads directly from the mapped file, any read past the end marks the reader as failed.
+class SnapshotReader
+{
+public:
+    SnapshotReader(const char *begin, const char *end) : m_ptr(begin), m_end(end) {}
+
+    bool ok() const { return m_ok; }
+
+    template<typename T> T read_pod()
+    {
+        T value{};
+        if (this->check(sizeof(T))) {
+            std::memcpy(&value, m_ptr, sizeof(T));
+            m_ptr += sizeof(T);
+        }
+        return value;
+    }
+    std::string read_string()
+    {
+        uint32_t size = this->read_pod<uint32_t>();
+        if (! this->check(size))
+            return {};
+        std::string str(m_ptr, size);
+        m_ptr += size;
+        return str;
+    }
+    std::vector<std::string> read_strings()
+    {
+        uint32_t size = this->read_pod<uint32_t>();
+        std::vector<std::string> strs;
+        // each string takes at least its length
+        if (this->check(size_t(size) * sizeof(uint32_t))) {
+            strs.reserve(size);
+            for (uint32_t i = 0; i < size && m_ok; ++i)
+                strs.emplace_back(this->read_string());
+        }
+        return strs;
+    }
+
+private:
+    bool check(size_t size)
+    {
+        if (m_ok && size_t(m_end - m_ptr) >= size)
+            return true;
+        m_ok = false;
+        return false;
+    }
+
+    const char *m_ptr;
+    const char *m_end;
+    bool        m_ok { true };
+};
+
+// The snapshot stores the options differing from the defaults, so any change of the option definitions or of their
+// defaults invalidates it, even if the application version has not been increased.
+uint64_t config_def_fingerprint()
+{
+    static const uint64_t fingerprint = []() {
+        Fnv1aHash hash;
+        for (const auto &[key, def] : print_config_def.options) {
+            hash.add(key);
+            hash.add(reinterpret_cast<const char*>(&def.type), sizeof(def.type));
+            hash.add(def.default_value ? def.default_value->serialize() : std::string("<none>"));
+        }
+        return hash.value;
+    }();
+    return fingerprint;
+}
+
+const DynamicPrintConfig& default_config_for(const PresetCollection &collection, const DynamicPrintConfig &config)
+{
+    return collection.type() == Preset::TYPE_PRINTER ? collection.default_preset_for(config).config : collection.default_preset().config;
+}
+
+} // namespace
+
+std::string PresetSnapshot::snapshot_file(const std::string &path, const std::string &vendor_name)
+{
+    return (boost::filesystem::path(path) / (vendor_name + ".snapshot")).make_preferred().string();
+}
+
+uint64_t PresetSnapshot::hash_sources(const std::string &path, const std::string &vendor_name, const std::vector<std::string> &subpaths)
+{
+    Fnv1aHash hash;
+    hash.add(std::string(SLIC3R_VERSION));
+    hash.add(reinterpret_cast<const char*>(&SNAPSHOT_FORMAT_VERSION), sizeof(SNAPSHOT_FORMAT_VERSION));
+    const uint64_t def_fingerprint = config_def_fingerprint();
+    hash.add(reinterpret_cast<const char*>(&def_fingerprint), sizeof(def_fingerprint));
+    // the presets store absolute file paths
+    hash.add(path);
+
+    // The contents are hashed, as a preset file may be edited without changing its size and within the resolution
+    // of its modification time. Reading the files takes a small part of the time spent parsing them.
+    auto add_file = [&hash](const std::string &relative_path, const std::string &file) {
+        hash.add(relative_path);
+        boost::nowide::ifstream ifs(file, std::ios::binary);
+        if (! ifs.good()) {
+            // a missing file must never match a snapshot built while it existed
+            hash.add(std::string("<missing>"));
+            return;
+        }
+        char     buffer[65536];
+        uint64_t size = 0;
+        while (ifs.read(buffer, sizeof(buffer)) || ifs.gcount() > 0) {
+            hash.add(buffer, size_t(ifs.gcount()));
+            size += uint64_t(ifs.gcount());
+        }
+        hash.add(reinterpret_cast<const char*>(&size), sizeof(size));
+    };
+
+    add_file(vendor_name + ".json", path + "/" + vendor_name + ".json");
+    for (const std::string &subpath : subpaths)
+        add_file(subpath, path + "/" + vendor_name + "/" + subpath);
+    return hash.value;
+}
+
+bool PresetSnapshot::load(const std::string &file, uint64_t source_hash)
+{
+    entries.clear();
+    if (! boost::filesystem::exists(file))
+        return false;
+
+    try {
+        boost::iostreams::mapped_file_source mapped(file);
+        SnapshotReader reader(mapped.data(), mapped.data() + mapped.size());
+
+        char magic[sizeof(SNAPSHOT_MAGIC)];
+        for (char &c : magic)
+            c = reader.read_pod<char>();
+        if (! reader.ok() || std::memcmp(magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 ||
+            reader.read_pod<uint32_t>() != SNAPSHOT_FORMAT_VERSION || reader.read_pod<uint64_t>() != source_hash) {
+            BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << ": preset snapshot " << PathSanitizer::sanitize(file) << " is outdated";
+            return false;
+        }
+
+        uint32_t count = reader.read_pod<uint32_t>();
+        entries.reserve(std::min<size_t>(count, mapped.size()));
+        for (uint32_t i = 0; i < count && reader.ok(); ++i) {
+            Entry entry;
+            entry.type         = Preset::Type(reader.read_pod<uint8_t>());
+            entry.name         = reader.read_string();
+            entry.file         = reader.read_string();
+            entry.alias        = reader.read_string();
+            entry.hold_alias   = reader.read_pod<uint8_t>() != 0;
+            entry.description  = reader.read_string();
+            entry.setting_id   = reader.read_string();
+            entry.filament_id  = reader.read_string();
+            entry.renamed_from = reader.read_strings();
+            std::vector<std::string> options = reader.read_strings();
+            if (options.size() % 2 != 0) {
+                entries.clear();
+                return false;
+            }
+            entry.options.reserve(options.size() / 2);
+            for (size_t j = 0; j < options.size(); j += 2)
+                entry.options.emplace_back(std::move(options[j]), std::move(options[j + 1]));
+            entry.erased_options = reader.read_strings();
+            entries.emplace_back(std::move(entry));
+        }
+        if (! reader.ok()) {
+            BOOST_LOG_TRIVIAL(error) << __FUNCTION__ << ": preset snapshot " << PathSanitizer::sanitize(file) << " is corrupted";
+            entries.clear();
+            return false;
+        }
+    } catch (const std::exception &err) {
+        BOOST_LOG_TRIVIAL(error) << __FUNCTION__ << ": failed to map preset snapshot " << PathSanitizer::sanitize(file) << ", reason = " << err.what();
+        entries.clear();
+        return false;
+    }
+    return true;
+}
+
+bool PresetSnapshot::save(const std::string &file, uint64_t source_hash) const
+{
+    // write into a temporary file first, so that a crash never leaves a truncated snapshot behind
+    std::string tmp_file = file + ".tmp";
+    try {
+        {
+            boost::nowide::ofstream ofs(tmp_file, std::ios::binary | std::ios::trunc);
+            if (! ofs.good())
+                return false;
+            SnapshotWriter writer(ofs);
+            ofs.write(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+            writer.write_pod(SNAPSHOT_FORMAT_VERSION);
+            writer.write_pod(source_hash);
+            writer.write_pod(uint32_t(entries.size()));
+            for (const Entry &entry : entries) {
+                writer.write_pod(uint8_t(entry.type));
+                writer.write(entry.name);
+                writer.write(entry.file);
+                writer.write(entry.alias);
+                writer.write_pod(uint8_t(entry.hold_alias));
+                writer.write(entry.description);
+                writer.write(entry.setting_id);
+                writer.write(entry.filament_id);
+                writer.write(entry.renamed_from);
+                writer.write_pod(uint32_t(entry.options.size() * 2));
+                for (const auto &[key, value] : entry.options) {
+                    writer.write(key);
+                    writer.write(value);
+                }
+                writer.write(entry.erased_options);
+            }
+            if (! ofs.good())
+                return false;
+        }
+        boost::filesystem::rename(tmp_file, file);
+    } catch (const std::exception &err) {
+        BOOST_LOG_TRIVIAL(error) << __FUNCTION__ << ": failed to save preset snapshot " << PathSanitizer::sanitize(file) << ", reason = " << err.what();
+        boost::system::error_code ec;
+        boost::filesystem::remove(tmp_file, ec);
+        return false;
+    }
+    BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << ": saved " << entries.size() << " presets into " << PathSanitizer::sanitize(file);
+    return true;
+}
+
+void PresetSnapshot::add_preset(const PresetCollection &collection, const Preset &preset, bool hold_alias)
+{
+    Entry entry;
+    entry.type         = collection.type();
+    entry.name         = preset.name;
+    entry.file         = preset.file;
+    entry.alias        = preset.alias;
+    entry.hold_alias   = hold_alias;
+    entry.description  = preset.description;
+    entry.setting_id   = preset.setting_id;
+    entry.filament_id  = preset.filament_id;
+    entry.renamed_from = preset.renamed_from;
+
+    const DynamicPrintConfig &default_config = default_config_for(collection, preset.config);
+    for (const std::string &key : preset.config.keys()) {
+        const ConfigOption *opt = preset.config.option(key);
+        const ConfigOption *default_opt = default_config.option(key);
+        // the printer technology selects the default preset when resolving, always keep it
+        if (default_opt == nullptr || *opt != *default_opt || key == "printer_technology")
+            entry.options.emplace_back(key, opt->serialize());
+    }
+    for (const std::string &key : default_config.keys())
+        if (! preset.config.has(key))
+            entry.erased_options.emplace_back(key);
+    entries.emplace_back(std::move(entry));
+}
+
+DynamicPrintConfig PresetSnapshot::resolve_config(const PresetCollection &collection, const Entry &entry)
+{
+    ConfigSubstitutionContext context(ForwardCompatibilitySubstitutionRule::Disable);
+    DynamicPrintConfig options;
+    for (const auto &[key, value] : entry.options)
+        options.set_deserialize(key, value, context);
+
+    DynamicPrintConfig config = default_config_for(collection, options);
+    config.apply(options, true);
+    for (const std::string &key : entry.erased_options)
+        config.erase(key);
+    return config;
+}
+
+} // namespace Slic3r
@@ -0,0 +1,56 @@
+#ifndef slic3r_PresetSnapshot_hpp_
+#define slic3r_PresetSnapshot_hpp_
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Preset.hpp"
+
+namespace Slic3r {
+
+// Binary snapshot of the system presets of one vendor bundle with the "inherits" and "includes" chains already resolved.
+// It is written next to the vendor bundle after its json files were loaded successfully, and restored on the following
+// starts instead of parsing thousands of json files, as long as the hash of the source files still matches.
+class PresetSnapshot
+{
+public:
+    struct Entry
+    {
+        Preset::Type                                     type{ Preset::TYPE_INVALID };
+        std::string                                      name;
+        std::string                                      file;
+        std::string                                      alias;
+        // the alias was derived from the preset, so the preset is registered in the alias map of its compatible printers
+        bool                                             hold_alias{ false };
+        std::string                                      description;
+        std::string                                      setting_id;
+        std::string                                      filament_id;
+        std::vector<std::string>                         renamed_from;
+        // serialized options, which differ from the default preset of the collection
+        std::vector<std::pair<std::string, std::string>> options;
+        // options of the default preset, which are missing in the preset
+        std::vector<std::string>                         erased_options;
+    };
+
+    // Snapshot file of a vendor bundle stored in path.
+    static std::string snapshot_file(const std::string &path, const std::string &vendor_name);
+    // Hash of the application version, the option definitions, and the contents of the vendor root file
+    // and of the preset files referenced by it.
+    static uint64_t    hash_sources(const std::string &path, const std::string &vendor_name, const std::vector<std::string> &subpaths);
+
+    // Load a snapshot through a memory mapping of the file, fails if the file is missing, corrupted or has been built from other sources.
+    bool               load(const std::string &file, uint64_t source_hash);
+    bool               save(const std::string &file, uint64_t source_hash) const;
+
+    void               add_preset(const PresetCollection &collection, const Preset &preset, bool hold_alias);
+    // Rebuild the full config of an entry, throws if an option value cannot be parsed.
+    static DynamicPrintConfig resolve_config(const PresetCollection &collection, const Entry &entry);
+
+    std::vector<Entry> entries;
+};
+
+} // namespace Slic3r
+
+#endif /* slic3r_PresetSnapshot_hpp_ */
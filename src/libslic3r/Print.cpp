@@ -10,6 +10,7 @@
 #include "ShortestPath.hpp"
 #include "Support/SupportMaterial.hpp"
 #include "Thread.hpp"
+#include "ThreadLocalCache.hpp"
 #include "Time.hpp"
 #include "GCode.hpp"
 #include "GCode/WipeTower.hpp"
@@ -20,6 +21,7 @@
 #include <float.h>
 
 #include <algorithm>
+#include <atomic>
 #include <limits>
 #include <unordered_set>
 #include <boost/filesystem/path.hpp>
@@ -28,6 +30,7 @@
 #include <boost/nowide/fstream.hpp>
 
 #include <tbb/blocked_range.h>
+#include <tbb/flow_graph.h>
 #include <tbb/parallel_for.h>
 
 #include "format.hpp"
@@ -1808,20 +1811,29 @@ void Print::auto_assign_extruders(ModelObject* model_object) const
     }
 }
 
-void  PrintObject::set_shared_object(PrintObject *object)
+void  PrintObject::set_shared_object(PrintObject *object, const std::optional<Transform2d> &layers_trafo)
 {
     m_shared_object = object;
-    BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << boost::format(": this=%1%, found shared object from %2%")%this%m_shared_object;
+    m_shared_layers_trafo = layers_trafo;
+    BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << boost::format(": this=%1%, found shared object from %2%, transformed %3%")%this%m_shared_object%layers_trafo.has_value();
 }
 
 void  PrintObject::clear_shared_object()
 {
     if (m_shared_object) {
         BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << boost::format(": this=%1%, clear previous shared object data %2%")%this %m_shared_object;
-        m_layers.clear();
-        m_support_layers.clear();
+        if (m_shared_layers_trafo) {
+            // The transformed layers are owned by this object.
+            m_shared_object = nullptr;
+            m_shared_layers_trafo.reset();
+            this->clear_layers();
+            this->clear_support_layers();
+        } else {
+            m_layers.clear();
+            m_support_layers.clear();
 
-        m_shared_object = nullptr;
+            m_shared_object = nullptr;
+        }
 
         invalidate_all_steps_without_cancel();
     }
@@ -1830,6 +1842,10 @@ void  PrintObject::clear_shared_object()
 void  PrintObject::copy_layers_from_shared_object()
 {
     if (m_shared_object) {
+        if (m_shared_layers_trafo) {
+            this->transform_layers_from_shared_object();
+            return;
+        }
         m_layers.clear();
         m_support_layers.clear();
 
@@ -1847,7 +1863,8 @@ void  PrintObject::copy_layers_from_shared_object()
 
 void  PrintObject::copy_layers_overhang_from_shared_object()
 {
-    if (m_shared_object) {
+    // The transformed layers already carry their own copy of the overhangs.
+    if (m_shared_object && ! m_shared_layers_trafo) {
         for (size_t index = 0; index <  m_layers.size() && index <  m_shared_object->m_layers.size(); index++)
         {
             Layer* layer_src = m_layers[index];
@@ -1858,6 +1875,190 @@ void  PrintObject::copy_layers_overhang_from_shared_object()
     }
 }
 
+// Planar transformation of the slices of object1 into the slices of object2, if object2 is object1 rotated around the Z axis.
+// The slices are centered by center_offset(), thus the transformation is a rotation followed by a translation, in scaled coordinates.
+static std::optional<Transform2d> shared_layers_trafo(const PrintObject &object1, const PrintObject &object2)
+{
+    // Only a rounding error of the matrix products is tolerated, the transformed slices have to match the sliced ones.
+    static constexpr double eps = 1e-9;
+    const Transform3d &trafo1 = object1.trafo();
+    const Transform3d &trafo2 = object2.trafo();
+    if (std::abs(trafo1.translation().z() - trafo2.translation().z()) > eps)
+        return std::nullopt;
+    const Matrix3d rotation = trafo2.linear() * trafo1.linear().inverse();
+    if (std::abs(rotation(0, 2)) > eps || std::abs(rotation(1, 2)) > eps || std::abs(rotation(2, 0)) > eps || std::abs(rotation(2, 1)) > eps ||
+        std::abs(rotation(2, 2) - 1.) > eps)
+        return std::nullopt;
+    const Matrix2d rotation_xy = rotation.topLeftCorner<2, 2>();
+    // Mirroring would flip the orientation of the contours and of the perimeter loops, such objects are sliced on their own.
+    if (! (rotation_xy * rotation_xy.transpose()).isApprox(Matrix2d::Identity(), eps) || rotation_xy.determinant() < 0.)
+        return std::nullopt;
+
+    const Vec2d offset1 = object1.center_offset().cast<double>() - trafo1.translation().head<2>() / SCALING_FACTOR;
+    const Vec2d offset2 = object2.center_offset().cast<double>() - trafo2.translation().head<2>() / SCALING_FACTOR;
+    Transform2d out = Transform2d::Identity();
+    out.linear()      = rotation_xy;
+    out.translation() = rotation_xy * offset1 - offset2;
+    return out;
+}
+
+static inline Point transform_point(const Transform2d &trafo, const Point &pt)
+{
+    return Point(Vec2d(trafo * Vec2d(pt.cast<double>())));
+}
+
+static void transform_points(const Transform2d &trafo, Points &pts)
+{
+    for (Point &pt : pts)
+        pt = transform_point(trafo, pt);
+}
+
+static void transform_polyline(const Transform2d &trafo, Polyline &polyline)
+{
+    transform_points(trafo, polyline.points);
+    for (PathFittingData &fitting : polyline.fitting_result)
+        if (fitting.is_arc_move()) {
+            const ArcSegment &arc = fitting.arc_data;
+            fitting.arc_data = ArcSegment(transform_point(trafo, arc.center), arc.radius, transform_point(trafo, arc.start_point), transform_point(trafo, arc.end_point), arc.direction);
+        }
+}
+
+static void transform_expolygons(const Transform2d &trafo, ExPolygons &expolygons)
+{
+    for (ExPolygon &expolygon : expolygons) {
+        transform_points(trafo, expolygon.contour.points);
+        for (Polygon &hole : expolygon.holes)
+            transform_points(trafo, hole.points);
+    }
+}
+
+static void transform_surfaces(const Transform2d &trafo, double angle, Surfaces &surfaces)
+{
+    for (Surface &surface : surfaces) {
+        transform_points(trafo, surface.expolygon.contour.points);
+        for (Polygon &hole : surface.expolygon.holes)
+            transform_points(trafo, hole.points);
+        // The bridging direction is rotated together with the surface.
+        if (surface.bridge_angle >= 0.)
+            surface.bridge_angle = std::fmod(surface.bridge_angle + angle + 2. * PI, PI);
+    }
+}
+
+static void transform_extrusion_entity(const Transform2d &trafo, ExtrusionEntity &entity)
+{
+    if (auto *collection = dynamic_cast<ExtrusionEntityCollection*>(&entity)) {
+        for (ExtrusionEntity *ee : collection->entities)
+            transform_extrusion_entity(trafo, *ee);
+    } else if (auto *path = dynamic_cast<ExtrusionPath*>(&entity)) {
+        transform_polyline(trafo, path->polyline);
+    } else if (auto *multipath = dynamic_cast<ExtrusionMultiPath*>(&entity)) {
+        for (ExtrusionPath &path : multipath->paths)
+            transform_polyline(trafo, path.polyline);
+    } else if (auto *loop = dynamic_cast<ExtrusionLoop*>(&entity)) {
+        // Sloped loops are only created by the G-code generator.
+        assert(dynamic_cast<ExtrusionLoopSloped*>(loop) == nullptr);
+        for (ExtrusionPath &path : loop->paths)
+            transform_polyline(trafo, path.polyline);
+    } else
+        assert(false);
+}
+
+// Copy the layer data consumed after the object is processed, the same data as stored by export_cached_data().
+static void transform_layer(const Transform2d &trafo, double angle, const Layer &src, Layer &dst)
+{
+    dst.slicing_errors = src.slicing_errors;
+    dst.lslices = src.lslices;
+    transform_expolygons(trafo, dst.lslices);
+    dst.lslices_bboxes.reserve(dst.lslices.size());
+    for (const ExPolygon &expoly : dst.lslices)
+        dst.lslices_bboxes.emplace_back(get_extents(expoly));
+    dst.loverhangs = src.loverhangs;
+    transform_expolygons(trafo, dst.loverhangs);
+    dst.loverhangs_bbox = get_extents(dst.loverhangs);
+
+    assert(src.region_count() == dst.region_count());
+    for (size_t region_id = 0; region_id < src.region_count(); ++ region_id) {
+        const LayerRegion &src_layerm = *src.regions()[region_id];
+        LayerRegion       &layerm     = *dst.get_region(int(region_id));
+        layerm.slices = src_layerm.slices;
+        transform_surfaces(trafo, angle, layerm.slices.surfaces);
+        if (! src_layerm.raw_slices.empty()) {
+            ExPolygons raw_slices = src_layerm.raw_slices.expolygons();
+            transform_expolygons(trafo, raw_slices);
+            layerm.raw_slices.assign(raw_slices);
+        }
+        layerm.raw_counter_circle_compensation = src_layerm.raw_counter_circle_compensation;
+        layerm.raw_holes_circle_compensation   = src_layerm.raw_holes_circle_compensation;
+        layerm.thin_fills = src_layerm.thin_fills;
+        transform_extrusion_entity(trafo, layerm.thin_fills);
+        layerm.fill_expolygons = src_layerm.fill_expolygons;
+        transform_expolygons(trafo, layerm.fill_expolygons);
+        layerm.fill_surfaces = src_layerm.fill_surfaces;
+        transform_surfaces(trafo, angle, layerm.fill_surfaces.surfaces);
+        layerm.fill_no_overlap_expolygons = src_layerm.fill_no_overlap_expolygons;
+        transform_expolygons(trafo, layerm.fill_no_overlap_expolygons);
+        layerm.unsupported_bridge_edges = src_layerm.unsupported_bridge_edges;
+        for (Polyline &polyline : layerm.unsupported_bridge_edges)
+            transform_polyline(trafo, polyline);
+        layerm.perimeters = src_layerm.perimeters;
+        transform_extrusion_entity(trafo, layerm.perimeters);
+        layerm.fills = src_layerm.fills;
+        transform_extrusion_entity(trafo, layerm.fills);
+    }
+}
+
+void PrintObject::transform_layers_from_shared_object()
+{
+    assert(m_shared_object && m_shared_layers_trafo);
+    BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << boost::format(": this=%1%, transform layers from object %2%")%this%m_shared_object;
+    this->clear_layers();
+    this->clear_support_layers();
+
+    const Transform2d &trafo = *m_shared_layers_trafo;
+    const double       angle = std::atan2(trafo.linear()(1, 0), trafo.linear()(0, 0));
+
+    for (const Layer *src : m_shared_object->layers()) {
+        Layer *layer = this->add_layer(src->id(), src->height, src->print_z, src->slice_z);
+        for (const LayerRegion *src_layerm : src->regions())
+            layer->add_region(&src_layerm->region());
+        if (m_layers.size() > 1) {
+            m_layers[m_layers.size() - 2]->upper_layer = layer;
+            layer->lower_layer = m_layers[m_layers.size() - 2];
+        }
+    }
+    for (const SupportLayer *src : m_shared_object->support_layers()) {
+        SupportLayer *layer = this->add_support_layer(src->id(), src->interface_id(), src->height, src->print_z);
+        layer->slice_z = src->slice_z;
+        if (m_support_layers.size() > 1) {
+            m_support_layers[m_support_layers.size() - 2]->upper_layer = layer;
+            layer->lower_layer = m_support_layers[m_support_layers.size() - 2];
+        }
+    }
+
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, m_layers.size()), [this, &trafo, angle](const tbb::blocked_range<size_t> &range) {
+        for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx)
+            transform_layer(trafo, angle, *m_shared_object->layers()[layer_idx], *m_layers[layer_idx]);
+    });
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, m_support_layers.size()), [this, &trafo, angle](const tbb::blocked_range<size_t> &range) {
+        for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx) {
+            const SupportLayer &src   = *m_shared_object->support_layers()[layer_idx];
+            SupportLayer       &layer = *m_support_layers[layer_idx];
+            transform_layer(trafo, angle, src, layer);
+            layer.support_islands = src.support_islands;
+            transform_expolygons(trafo, layer.support_islands);
+            layer.support_fills = src.support_fills;
+            transform_extrusion_entity(trafo, layer.support_fills);
+        }
+    });
+
+    firstLayerObjSliceByVolume = m_shared_object->firstLayerObjSlice();
+    for (VolumeSlices &volume_slices : firstLayerObjSliceByVolume)
+        for (ExPolygons &slices : volume_slices.slices)
+            transform_expolygons(trafo, slices);
+    firstLayerObjSliceByGroups = m_shared_object->firstLayerObjGroups();
+    for (groupedVolumeSlices &group : firstLayerObjSliceByGroups)
+        transform_expolygons(trafo, group.slices);
+}
 
 // BBS
 BoundingBox PrintObject::get_first_layer_bbox(float& a, float& layer_height, std::string& name)
@@ -1909,6 +2110,72 @@ std::map<ObjectID, unsigned int> getObjectExtruderMap(const Print& print) {
 }
 
 // Slicing process, running at a background thread.
+// The steps of a single object work on the same layers and they read the results of each other (for example the support
+// reads the bridging fills, to which ironing adds), thus they are chained in the order of the former serial loops.
+// The tree support reads the layer counts of all the objects to find the layers of skirt and brim, thus the support of any
+// object waits until all the objects are sliced and have their perimeters. Up to then, an object with a few layers
+// does not wait for the others to finish a step and the cores are kept busy when there are many small objects.
+void Print::process_objects(const std::vector<PrintObject*> &objects, const AutoContourHolesCompensationParams &auto_contour_holes_compensation_params,
+                            std::unordered_map<std::string, long long> *slice_time)
+{
+    if (objects.empty())
+        return;
+
+    // With objects processed concurrently, the step times are summed over the objects.
+    std::atomic<long long> perimeters_time { 0 }, infill_time { 0 }, support_time { 0 };
+    auto run_timed = [slice_time](std::atomic<long long> *time, const std::function<void()> &step) {
+        if (slice_time == nullptr || time == nullptr) {
+            step();
+            return;
+        }
+        long long start_time = (long long)Slic3r::Utils::get_current_milliseconds_time_utc();
+        step();
+        *time += (long long)Slic3r::Utils::get_current_milliseconds_time_utc() - start_time;
+    };
+
+    using StepNode = tbb::flow::continue_node<tbb::flow::continue_msg>;
+    tbb::flow::graph                                    graph;
+    tbb::flow::broadcast_node<tbb::flow::continue_msg>  start(graph);
+    // Fires when the perimeters of all the objects are done, it is a predecessor of the support of each object.
+    StepNode                                            perimeters_done(graph, [](const tbb::flow::continue_msg &) {});
+    std::vector<std::unique_ptr<StepNode>>              nodes;
+    nodes.reserve(objects.size() * 5);
+    for (PrintObject *obj : objects) {
+        StepNode *previous = nullptr;
+        auto add_step = [&graph, &start, &nodes, &previous, &run_timed](std::atomic<long long> *time, std::function<void()> step) -> StepNode& {
+            nodes.emplace_back(std::make_unique<StepNode>(graph, [&run_timed, time, step = std::move(step)](const tbb::flow::continue_msg &) {
+                run_timed(time, step);
+            }));
+            if (previous)
+                tbb::flow::make_edge(*previous, *nodes.back());
+            else
+                tbb::flow::make_edge(start, *nodes.back());
+            previous = nodes.back().get();
+            return *previous;
+        };
+        StepNode &perimeters = add_step(&perimeters_time, [obj, &auto_contour_holes_compensation_params]() {
+            obj->set_auto_circle_compenstaion_params(auto_contour_holes_compensation_params);
+            obj->make_perimeters();
+        });
+        tbb::flow::make_edge(perimeters, perimeters_done);
+        add_step(&infill_time, [obj]() { obj->infill(); });
+        add_step(nullptr, [obj]() { obj->ironing(); });
+        StepNode &support = add_step(&support_time, [obj]() { obj->generate_support_material(); });
+        tbb::flow::make_edge(perimeters_done, support);
+        add_step(nullptr, [obj]() { obj->detect_overhangs_for_lift(); });
+    }
+
+    start.try_put(tbb::flow::continue_msg());
+    // Rethrows the exception of a failed step, including the cancelation.
+    graph.wait_for_all();
+
+    if (slice_time) {
+        (*slice_time)[TIME_MAKE_PERIMETERS] += perimeters_time;
+        (*slice_time)[TIME_INFILL] += infill_time;
+        (*slice_time)[TIME_GENERATE_SUPPORT] += support_time;
+    }
+}
+
 void Print::process(std::unordered_map<std::string, long long>* slice_time, bool use_cache)
 {
     long long start_time = 0, end_time = 0;
@@ -1926,14 +2193,15 @@ void Print::process(std::unordered_map<std::string, long long>* slice_time, bool
     BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << boost::format(": this=%1%, enter, use_cache=%2%, object size=%3%")%this%use_cache%m_objects.size();
     if (m_objects.empty())
         return;
+    // The results cached by the slicing threads are released once no print is processed, this one may run along others.
+    ThreadLocalCache::Use use_thread_local_caches;
 
     for (PrintObject *obj : m_objects)
         obj->clear_shared_object();
 
     //add the print_object share check logic
+    // Compares everything except of the transformation, which is checked by find_shared_object().
     auto is_print_object_the_same = [this](const PrintObject* object1, const PrintObject* object2) -> bool{
-        if (object1->trafo().matrix() != object2->trafo().matrix())
-            return false;
         const ModelObject* model_obj1 = object1->model_object();
         const ModelObject* model_obj2 = object2->model_object();
         if (model_obj1->volumes.size() != model_obj2->volumes.size())
@@ -1983,20 +2251,34 @@ void Print::process(std::unordered_map<std::string, long long>* slice_time, bool
     };
     int object_count = m_objects.size();
     std::set<PrintObject*> need_slicing_objects;
+    // Share the layers of an object with the same transformation, otherwise derive the layers from an object rotated around the Z axis.
+    auto find_shared_object = [&need_slicing_objects, &is_print_object_the_same](PrintObject *obj) -> bool {
+        PrintObject               *rotated_object = nullptr;
+        std::optional<Transform2d> rotated_trafo;
+        for (PrintObject *slicing_obj : need_slicing_objects)
+        {
+            if (! is_print_object_the_same(obj, slicing_obj))
+                continue;
+            if (obj->trafo().matrix() == slicing_obj->trafo().matrix()) {
+                obj->set_shared_object(slicing_obj);
+                return true;
+            }
+            if (! rotated_object && (rotated_trafo = shared_layers_trafo(*slicing_obj, *obj)))
+                rotated_object = slicing_obj;
+        }
+        if (rotated_object) {
+            obj->set_shared_object(rotated_object, rotated_trafo);
+            return true;
+        }
+        return false;
+    };
     //std::set<PrintObject*> re_slicing_objects;
     m_reslicing_objects.clear();
     if (!use_cache) {
         for (int index = 0; index < object_count; index++)
         {
             PrintObject *obj =  m_objects[index];
-            for (PrintObject *slicing_obj : need_slicing_objects)
-            {
-                if (is_print_object_the_same(obj, slicing_obj)) {
-                    obj->set_shared_object(slicing_obj);
-                    break;
-                }
-            }
-            if (!obj->get_shared_object()) {
+            if (!find_shared_object(obj)) {
                 need_slicing_objects.insert(obj);
                 m_reslicing_objects.insert(obj);
             }
@@ -2012,17 +2294,8 @@ void Print::process(std::unordered_map<std::string, long long>* slice_time, bool
         for (int index = 0; index < object_count; index++)
         {
             PrintObject *obj =  m_objects[index];
-            bool found_shared = false;
             if (need_slicing_objects.find(obj) == need_slicing_objects.end()) {
-                for (PrintObject *slicing_obj : need_slicing_objects)
-                {
-                    if (is_print_object_the_same(obj, slicing_obj)) {
-                        obj->set_shared_object(slicing_obj);
-                        found_shared = true;
-                        break;
-                    }
-                }
-                if (!found_shared) {
+                if (!find_shared_object(obj)) {
                     BOOST_LOG_TRIVIAL(warning) << boost::format("Also can not find the shared object, identify_id %1%, maybe shared object is skipped")%obj->model_object()->instances[0]->loaded_id;
                     //throw Slic3r::SlicingError("Can not find the cached data.");
                     //don't report errot, set use_cache to false, and reslice these objects
@@ -2038,120 +2311,31 @@ void Print::process(std::unordered_map<std::string, long long>* slice_time, bool
     BOOST_LOG_TRIVIAL(info) << "Starting the slicing process." << log_memory_info();
 
     const AutoContourHolesCompensationParams &auto_contour_holes_compensation_params = AutoContourHolesCompensationParams(m_config);
+    // Objects restored from the cache or sharing the slices of another object skip the processing steps.
+    auto set_object_steps_done = [](PrintObject *obj) {
+        for (PrintObjectStep step : { posSlice, posPerimeters, posPrepareInfill, posInfill, posIroning, posSupportMaterial, posDetectOverhangsForLift })
+            if (obj->set_started(step))
+                obj->set_done(step);
+    };
     if (!use_cache) {
-
-        if (slice_time) {
-            start_time = (long long)Slic3r::Utils::get_current_milliseconds_time_utc();
-        }
-
-
-        for (PrintObject* obj : m_objects) {
-            if (need_slicing_objects.count(obj) != 0) {
-                obj->set_auto_circle_compenstaion_params(auto_contour_holes_compensation_params);
-                obj->make_perimeters();
-            }
-            else {
-                if (obj->set_started(posSlice))
-                    obj->set_done(posSlice);
-                if (obj->set_started(posPerimeters))
-                    obj->set_done(posPerimeters);
-            }
-        }
-
-        if (slice_time) {
-            end_time = (long long)Slic3r::Utils::get_current_milliseconds_time_utc();
-            (*slice_time)[TIME_MAKE_PERIMETERS] = (*slice_time)[TIME_MAKE_PERIMETERS] + end_time - start_time;
-            start_time = (long long)Slic3r::Utils::get_current_milliseconds_time_utc();
-        }
-
-        for (PrintObject *obj : m_objects) {
-            if (need_slicing_objects.count(obj) != 0) {
-                obj->infill();
-            }
-            else {
-                if (obj->set_started(posPrepareInfill))
-                    obj->set_done(posPrepareInfill);
-                if (obj->set_started(posInfill))
-                    obj->set_done(posInfill);
-            }
-        }
-
-        if (slice_time) {
-            end_time = (long long)Slic3r::Utils::get_current_milliseconds_time_utc();
-            (*slice_time)[TIME_INFILL] = (*slice_time)[TIME_INFILL] + end_time - start_time;
-        }
-
-        for (PrintObject *obj : m_objects) {
-            if (need_slicing_objects.count(obj) != 0) {
-                obj->ironing();
-            }
-            else {
-                if (obj->set_started(posIroning))
-                    obj->set_done(posIroning);
-            }
-        }
-
-        if (slice_time) {
-            start_time = (long long)Slic3r::Utils::get_current_milliseconds_time_utc();
-        }
-
-        tbb::parallel_for(tbb::blocked_range<int>(0, int(m_objects.size())),
-            [this, need_slicing_objects](const tbb::blocked_range<int>& range) {
-                for (int i = range.begin(); i < range.end(); i++) {
-                    PrintObject* obj = m_objects[i];
-                    if (need_slicing_objects.count(obj) != 0) {
-                        obj->generate_support_material();
-                    }
-                    else {
-                        if (obj->set_started(posSupportMaterial))
-                            obj->set_done(posSupportMaterial);
-                    }
-                }
-            }
-        );
-
-        if (slice_time) {
-            end_time = (long long)Slic3r::Utils::get_current_milliseconds_time_utc();
-            (*slice_time)[TIME_GENERATE_SUPPORT] = (*slice_time)[TIME_GENERATE_SUPPORT] + end_time - start_time;
-        }
-
+        std::vector<PrintObject*> slicing_objects;
         for (PrintObject* obj : m_objects) {
-            if (need_slicing_objects.count(obj) != 0) {
-                obj->detect_overhangs_for_lift();
-            }
-            else {
-                if (obj->set_started(posDetectOverhangsForLift))
-                    obj->set_done(posDetectOverhangsForLift);
-            }
+            if (need_slicing_objects.count(obj) != 0)
+                slicing_objects.emplace_back(obj);
+            else
+                set_object_steps_done(obj);
         }
+        this->process_objects(slicing_objects, auto_contour_holes_compensation_params, slice_time);
     }
     else {
+        std::vector<PrintObject*> reslicing_objects;
         for (PrintObject *obj : m_objects) {
-            if (m_reslicing_objects.count(obj) == 0) {
-                if (obj->set_started(posSlice))
-                    obj->set_done(posSlice);
-                if (obj->set_started(posPerimeters))
-                    obj->set_done(posPerimeters);
-                if (obj->set_started(posPrepareInfill))
-                    obj->set_done(posPrepareInfill);
-                if (obj->set_started(posInfill))
-                    obj->set_done(posInfill);
-                if (obj->set_started(posIroning))
-                    obj->set_done(posIroning);
-                if (obj->set_started(posSupportMaterial))
-                    obj->set_done(posSupportMaterial);
-                if (obj->set_started(posDetectOverhangsForLift))
-                    obj->set_done(posDetectOverhangsForLift);
-            }
-            else {
-                obj->set_auto_circle_compenstaion_params(auto_contour_holes_compensation_params);
-                obj->make_perimeters();
-                obj->infill();
-                obj->ironing();
-                obj->generate_support_material();
-                obj->detect_overhangs_for_lift();
-            }
+            if (m_reslicing_objects.count(obj) == 0)
+                set_object_steps_done(obj);
+            else
+                reslicing_objects.emplace_back(obj);
         }
+        this->process_objects(reslicing_objects, auto_contour_holes_compensation_params, nullptr);
     }
 
     for (PrintObject *obj : m_objects)
@@ -2357,8 +2541,10 @@ void Print::process(std::unordered_map<std::string, long long>* slice_time, bool
     }
     //BBS
     for (PrintObject *obj : m_objects) {
+        // The transformed layers are copied before the shared object simplifies its extrusions.
         if (((!use_cache)&&(need_slicing_objects.count(obj) != 0))
-            || (use_cache &&(m_reslicing_objects.count(obj) != 0))){
+            || (use_cache &&(m_reslicing_objects.count(obj) != 0))
+            || obj->has_transformed_shared_layers()){
             obj->simplify_extrusion_path();
         }
         else {
@@ -2681,9 +2867,9 @@ FilamentTempType Print::get_filament_temp_type(const std::string& filament_type)
     const static std::string HighTempFilamentStr = "high_temp_filament";
     const static std::string LowTempFilamentStr = "low_temp_filament";
     const static std::string HighLowCompatibleFilamentStr = "high_low_compatible_filament";
-    static std::unordered_map<std::string, std::unordered_set<std::string>>filament_temp_type_map;
-
-    if (filament_temp_type_map.empty()) {
+    // initialized once in a thread safe way, the plates may be validated and processed at once
+    const static std::unordered_map<std::string, std::unordered_set<std::string>> filament_temp_type_map = []() {
+        std::unordered_map<std::string, std::unordered_set<std::string>> filament_temp_type_map;
         fs::path file_path = fs::path(resources_dir()) / "info" / "filament_info.json";
         std::ifstream in(file_path.string());
         json j;
@@ -2699,26 +2885,31 @@ FilamentTempType Print::get_filament_temp_type(const std::string& filament_type)
         }
         catch (const json::parse_error& err){
             in.close();
-            BOOST_LOG_TRIVIAL(error) << __FUNCTION__ << ": parse " << file_path.string() << " got a nlohmann::detail::parse_error, reason = " << err.what();
+            BOOST_LOG_TRIVIAL(error) << "Print::get_filament_temp_type: parse " << file_path.string() << " got a nlohmann::detail::parse_error, reason = " << err.what();
             filament_temp_type_map[HighTempFilamentStr] = {"ABS","ASA","PC","PA","PA-CF","PA-GF","PA6-CF","PET-CF","PPS","PPS-CF","PPA-GF","PPA-CF","ABS-Aero","ABS-GF"};
             filament_temp_type_map[LowTempFilamentStr] = {"PLA","TPU","PLA-CF","PLA-AERO","PVA","BVOH"};
             filament_temp_type_map[HighLowCompatibleFilamentStr] = { "HIPS","PETG","PCTG","PE","PP","EVA","PE-CF","PP-CF","PP-GF","PHA"};
         }
-    }
+        return filament_temp_type_map;
+    }();
 
-    if (filament_temp_type_map[HighLowCompatibleFilamentStr].find(filament_type) != filament_temp_type_map[HighLowCompatibleFilamentStr].end())
+    auto is_of_type = [&filament_type](const std::string& type_str) {
+        auto iter = filament_temp_type_map.find(type_str);
+        return iter != filament_temp_type_map.end() && iter->second.count(filament_type) > 0;
+    };
+    if (is_of_type(HighLowCompatibleFilamentStr))
         return HighLowCompatible;
-    if (filament_temp_type_map[HighTempFilamentStr].find(filament_type) != filament_temp_type_map[HighTempFilamentStr].end())
+    if (is_of_type(HighTempFilamentStr))
         return HighTemp;
-    if (filament_temp_type_map[LowTempFilamentStr].find(filament_type) != filament_temp_type_map[LowTempFilamentStr].end())
+    if (is_of_type(LowTempFilamentStr))
         return LowTemp;
     return Undefine;
 }
 
 int Print::get_hrc_by_nozzle_type(const NozzleType&type)
 {
-    static std::map<std::string, int>nozzle_type_to_hrc;
-    if (nozzle_type_to_hrc.empty()) {
+    const static std::map<std::string, int> nozzle_type_to_hrc = []() {
+        std::map<std::string, int> nozzle_type_to_hrc;
         fs::path file_path = fs::path(resources_dir()) / "info" / "nozzle_info.json";
         boost::nowide::ifstream in(file_path.string());
         //std::ifstream in(file_path.string());
@@ -2731,7 +2922,7 @@ int Print::get_hrc_by_nozzle_type(const NozzleType&type)
         }
         catch (const json::parse_error& err) {
             in.close();
-            BOOST_LOG_TRIVIAL(error) << __FUNCTION__ << ": parse " << file_path.string() << " got a nlohmann::detail::parse_error, reason = " << err.what();
+            BOOST_LOG_TRIVIAL(error) << "Print::get_hrc_by_nozzle_type: parse " << file_path.string() << " got a nlohmann::detail::parse_error, reason = " << err.what();
             nozzle_type_to_hrc = {
                 {"hardened_steel",55},
                 {"stainless_steel",20},
@@ -2740,7 +2931,8 @@ int Print::get_hrc_by_nozzle_type(const NozzleType&type)
                 {"undefine",0}
             };
         }
-    }
+        return nozzle_type_to_hrc;
+    }();
     auto iter = nozzle_type_to_hrc.find(NozzleTypeEumnToStr[type]);
     if (iter != nozzle_type_to_hrc.end())
         return iter->second;
@@ -2750,8 +2942,8 @@ int Print::get_hrc_by_nozzle_type(const NozzleType&type)
 
 std::vector<std::string> Print::get_incompatible_filaments_by_nozzle(const float nozzle_diameter, const std::optional<NozzleVolumeType> nozzle_volume_type)
 {
-    static std::map<std::string, std::map<std::string, std::vector<std::string>>> incompatible_filaments;
-    if(incompatible_filaments.empty()){
+    const static std::map<std::string, std::map<std::string, std::vector<std::string>>> incompatible_filaments = []() {
+        std::map<std::string, std::map<std::string, std::vector<std::string>>> incompatible_filaments;
         fs::path file_path = fs::path(resources_dir()) / "info" / "nozzle_incompatibles.json";
         boost::nowide::ifstream in(file_path.string());
         json j;
@@ -2765,18 +2957,23 @@ std::vector<std::string> Print::get_incompatible_filaments_by_nozzle(const float
         }
         catch(const json::parse_error& err){
             in.close();
-            BOOST_LOG_TRIVIAL(error) << __FUNCTION__ << ": parse " << file_path.string() << " got a nlohmann::detail::parse_error, reason = " << err.what();
+            BOOST_LOG_TRIVIAL(error) << "Print::get_incompatible_filaments_by_nozzle: parse " << file_path.string() << " got a nlohmann::detail::parse_error, reason = " << err.what();
 
             incompatible_filaments[get_nozzle_volume_type_string(NozzleVolumeType::nvtHighFlow)] = {};
             incompatible_filaments[get_nozzle_volume_type_string(NozzleVolumeType::nvtStandard)] = {};
         }
-    }
+        return incompatible_filaments;
+    }();
     std::ostringstream oss;
     oss << std::fixed << std::setprecision(1) << nozzle_diameter;
     std::string diameter_str = oss.str();
 
     if(nozzle_volume_type.has_value()){
-        return incompatible_filaments[get_nozzle_volume_type_string(nozzle_volume_type.value())][diameter_str];
+        auto volume_iter = incompatible_filaments.find(get_nozzle_volume_type_string(nozzle_volume_type.value()));
+        if (volume_iter == incompatible_filaments.end())
+            return {};
+        auto iter = volume_iter->second.find(diameter_str);
+        return iter == volume_iter->second.end() ? std::vector<std::string>() : iter->second;
     }
 
     std::vector<std::string> incompatible_filaments_list;
@@ -2879,6 +3076,7 @@ void Print::update_filament_maps_to_config(std::vector<int> f_maps, std::vector<
         }
     }
     update_filament_self_index_cache();
+    this->invalidate_config_digests();
     m_has_auto_filament_map_result = true;
 }
 
@@ -2935,11 +3133,13 @@ void Print::update_to_config_by_nozzle_group_result(const MultiNozzleUtils::Nozz
         m_config.apply(filament_overrides);
     }
     update_filament_self_index_cache();
+    this->invalidate_config_digests();
 }
 
 void Print::apply_config_for_render(const DynamicConfig &config)
 {
     m_config.apply(config);
+    this->invalidate_config_digests();
 }
 
 std::vector<int> Print::get_filament_maps() const
@@ -3812,7 +4012,7 @@ static void to_json(json& j, const LayerRegion& layer_region) {
     j.push_back({JSON_LAYER_REGION_SLICES, std::move(slices_surfaces_json)});
 
     //raw_slices
-    for (const ExPolygon& raw_slice_explogyon : layer_region.raw_slices) {
+    for (const ExPolygon& raw_slice_explogyon : layer_region.raw_slices.expolygons()) {
         json raw_polygon_json = raw_slice_explogyon;
 
         raw_slices_json.push_back(std::move(raw_polygon_json));
@@ -4098,13 +4298,16 @@ static void convert_layer_region_from_json(const json& j, LayerRegion& layer_reg
 
     //raw_slices
     int raw_slices_count = j[JSON_LAYER_REGION_RAW_SLICES].size();
+    ExPolygons raw_slices;
+    raw_slices.reserve(raw_slices_count);
     for (int raw_slices_index = 0; raw_slices_index < raw_slices_count; raw_slices_index++)
     {
         ExPolygon polygon;
 
         polygon = j[JSON_LAYER_REGION_RAW_SLICES][raw_slices_index];
-        layer_region.raw_slices.push_back(std::move(polygon));
+        raw_slices.push_back(std::move(polygon));
     }
+    layer_region.raw_slices.assign(raw_slices);
 
     //thin fills
     layer_region.thin_fills.no_sort = j[JSON_LAYER_REGION_THIN_FILLS][JSON_EXTRUSION_NO_SORT];
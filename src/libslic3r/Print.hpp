@@ -25,6 +25,7 @@
 #include <Eigen/Geometry>
 
 #include <functional>
+#include <optional>
 #include <set>
 #include "Calib.hpp"
 
@@ -516,7 +517,12 @@ public:
     void         get_certain_layers(float start, float end, std::vector<LayerPtrs> &out, std::vector<BoundingBox> &boundingbox_objects);
     std::vector<Point> get_instances_shift_without_plate_offset() const;
     PrintObject* get_shared_object() const { return m_shared_object; }
-    void         set_shared_object(PrintObject *object);
+    // Share the layers of an object with the same geometry and configuration.
+    // If layers_trafo is set, the object is a copy of the shared object rotated around the Z axis: its layers are derived
+    // from the layers of the shared object by the planar transformation layers_trafo instead of being referenced.
+    void         set_shared_object(PrintObject *object, const std::optional<Transform2d> &layers_trafo = std::nullopt);
+    // Layers derived from the shared object are owned by this object, the referenced ones by the shared object.
+    bool         has_transformed_shared_layers() const { return m_shared_layers_trafo.has_value(); }
     void         clear_shared_object();
     void         copy_layers_from_shared_object();
     void         copy_layers_overhang_from_shared_object();
@@ -565,6 +571,10 @@ private:
     void ironing();
     void generate_support_material();
     void simplify_extrusion_path();
+    // Fill m_layers and m_support_layers with copies of the layers of m_shared_object transformed by m_shared_layers_trafo.
+    void transform_layers_from_shared_object();
+    // Layers referenced from the shared object must not be released by this object.
+    bool owns_layers() const { return m_shared_object == nullptr || m_shared_layers_trafo.has_value(); }
 
     /**
      * @brief Determines the unprintable filaments for each extruder based on its printable area.
@@ -642,6 +652,8 @@ private:
     ExtrusionEntityCollection               m_skirt;
 
     PrintObject*                            m_shared_object{ nullptr };
+    // Transformation of the layers of m_shared_object into this object, in scaled coordinates.
+    std::optional<Transform2d>              m_shared_layers_trafo;
 
     // OrcaSlicer
     //
@@ -1149,10 +1161,17 @@ private:
     bool                has_tpu_filament() const;
     bool                invalidate_state_by_config_options(const ConfigOptionResolver &new_config, const std::vector<t_config_option_key> &opt_keys);
 
+    // Run the object steps from make_perimeters() up to detect_overhangs_for_lift() for the objects, each object advancing independently.
+    void                process_objects(const std::vector<PrintObject*> &objects, const AutoContourHolesCompensationParams &auto_contour_holes_compensation_params,
+                                        std::unordered_map<std::string, long long> *slice_time);
     void                _make_skirt();
     void                _make_wipe_tower();
     void                finalize_first_layer_convex_hull();
     void                update_filament_self_index_cache();
+    // Collect the digests of m_config, m_full_print_config and the default object and region configs if they were invalidated.
+    void                update_config_digests();
+    // To be called whenever one of the configs above is modified.
+    void                invalidate_config_digests() { m_config_digests_valid = false; }
 
     // Islands of objects and their supports extruded at the 1st layer.
     Polygons            first_layer_islands() const;
@@ -1162,6 +1181,13 @@ private:
     PrintRegionConfig                       m_default_region_config;
     PrintObjectPtrs                         m_objects;
     PrintRegionPtrs                         m_print_regions;
+    // Digests of the configs above and of m_full_print_config, compared by apply() against the digest of the new config.
+    // They point to the options of the configs, thus they are only valid until one of the configs is modified.
+    ConfigDigest                            m_config_digest;
+    ConfigDigest                            m_full_print_config_digest;
+    ConfigDigest                            m_default_object_config_digest;
+    ConfigDigest                            m_default_region_config_digest;
+    bool                                    m_config_digests_valid { false };
     //BBS.
     bool m_isBBLPrinter = false;
     
@@ -219,8 +219,9 @@ static bool custom_per_printz_gcodes_tool_changes_differ(const std::vector<Custo
 // Collect changes to print config, account for overrides of extruder retract values by filament presets.
 //BBS: add plate index
 static t_config_option_keys print_config_diffs(
-    const PrintConfig        &current_config,
+    const ConfigDigest       &current_digest,
     const DynamicPrintConfig &new_full_config,
+    const ConfigDigest       &new_full_digest,
     DynamicPrintConfig       &filament_overrides,
     int                      plate_index,
     std::vector<int>&        filament_maps)
@@ -228,10 +229,11 @@ static t_config_option_keys print_config_diffs(
     const std::vector<std::string> &extruder_retract_keys = print_config_def.extruder_retract_keys();
     const std::string               filament_prefix       = "filament_";
     t_config_option_keys            print_diff;
-    for (const t_config_option_key &opt_key : current_config.keys()) {
-        const ConfigOption *opt_old = current_config.option(opt_key);
+    for (size_t ordinal : current_digest.ordinals()) {
+        const t_config_option_key &opt_key = current_digest.key(ordinal);
+        const ConfigOption *opt_old = current_digest.option(ordinal);
         assert(opt_old != nullptr);
-        const ConfigOption *opt_new = new_full_config.option(opt_key);
+        const ConfigOption *opt_new = new_full_digest.option(ordinal);
         // assert(opt_new != nullptr);
         if (opt_new == nullptr)
             //FIXME This may happen when executing some test cases.
@@ -243,7 +245,7 @@ static t_config_option_keys print_config_diffs(
             for (int i = 0; i < filament_maps.size(); i++)
                 filament_map_indices[i] = filament_maps[i] - 1;
             compute_filament_override_value(opt_key, opt_old, opt_new, opt_new_filament, new_full_config, print_diff, filament_overrides, filament_map_indices);
-        } else if (*opt_new != *opt_old) {
+        } else if (! current_digest.equal(new_full_digest, ordinal)) {
             //BBS: add plate_index logic for wipe_tower_x/wipe_tower_y
             if (!opt_key.compare("wipe_tower_x") || !opt_key.compare("wipe_tower_y")) {
                 const ConfigOptionFloats* option_new = dynamic_cast<const ConfigOptionFloats*>(opt_new);
@@ -268,30 +270,39 @@ static t_config_option_keys print_config_diffs(
 
 // Prepare for storing of the full print config into new_full_config to be exported into the G-code and to be used by the PlaceholderParser.
 //BBS: add plate index
-static t_config_option_keys full_print_config_diffs(const DynamicPrintConfig &current_full_config, const DynamicPrintConfig &new_full_config, int plate_index)
+static t_config_option_keys full_print_config_diffs(const ConfigDigest &current_full_digest, const ConfigDigest &new_full_digest, int plate_index)
 {
     t_config_option_keys full_config_diff;
-    for (const t_config_option_key &opt_key : new_full_config.keys()) {
-        const ConfigOption *opt_old = current_full_config.option(opt_key);
-        const ConfigOption *opt_new = new_full_config.option(opt_key);
-        if (opt_old == nullptr || *opt_new != *opt_old) {
-            //BBS: add plate_index logic for wipe_tower_x/wipe_tower_y
-            if (opt_old && (!opt_key.compare("wipe_tower_x") || !opt_key.compare("wipe_tower_y"))) {
-                const ConfigOptionFloats* option_new = dynamic_cast<const ConfigOptionFloats*>(opt_new);
-                const ConfigOptionFloats* option_old = dynamic_cast<const ConfigOptionFloats*>(opt_old);
-                if ((plate_index < option_new->values.size())&&(plate_index < option_old->values.size()))
-                {
-                    float value_new = option_new->values[plate_index];
-                    float value_old = option_old->values[plate_index];
-                    if (value_old != value_new)
-                        full_config_diff.emplace_back(opt_key);
-                }
-                else if ((plate_index < option_new->values.size())||(plate_index < option_old->values.size()))
+    auto add_diff = [&full_config_diff, plate_index](const t_config_option_key &opt_key, const ConfigOption *opt_old, const ConfigOption *opt_new) {
+        //BBS: add plate_index logic for wipe_tower_x/wipe_tower_y
+        if (opt_old && (!opt_key.compare("wipe_tower_x") || !opt_key.compare("wipe_tower_y"))) {
+            const ConfigOptionFloats* option_new = dynamic_cast<const ConfigOptionFloats*>(opt_new);
+            const ConfigOptionFloats* option_old = dynamic_cast<const ConfigOptionFloats*>(opt_old);
+            if ((plate_index < option_new->values.size())&&(plate_index < option_old->values.size()))
+            {
+                float value_new = option_new->values[plate_index];
+                float value_old = option_old->values[plate_index];
+                if (value_old != value_new)
                     full_config_diff.emplace_back(opt_key);
             }
-            else
+            else if ((plate_index < option_new->values.size())||(plate_index < option_old->values.size()))
                 full_config_diff.emplace_back(opt_key);
         }
+        else
+            full_config_diff.emplace_back(opt_key);
+    };
+    for (size_t ordinal : new_full_digest.ordinals()) {
+        const ConfigOption *opt_old = current_full_digest.option(ordinal);
+        if (opt_old == nullptr || ! new_full_digest.equal(current_full_digest, ordinal))
+            add_diff(new_full_digest.key(ordinal), opt_old, new_full_digest.option(ordinal));
+    }
+    // Options without a definition are not indexed by the digests, look them up by their keys.
+    for (const auto &[opt_key, opt_new] : new_full_digest.undefined_options()) {
+        const auto &old_undefined = current_full_digest.undefined_options();
+        auto it_old = std::find_if(old_undefined.begin(), old_undefined.end(), [&opt_key = opt_key](const auto &kvp) { return kvp.first == opt_key; });
+        const ConfigOption *opt_old = it_old == old_undefined.end() ? nullptr : it_old->second;
+        if (opt_old == nullptr || *opt_new != *opt_old)
+            add_diff(opt_key, opt_old, opt_new);
     }
     return full_config_diff;
 }
@@ -1174,6 +1185,17 @@ static PrintObjectRegions* generate_print_object_regions(
     return out.release();
 }
 
+void Print::update_config_digests()
+{
+    if (m_config_digests_valid)
+        return;
+    m_config_digest                = ConfigDigest(m_config);
+    m_full_print_config_digest     = ConfigDigest(m_full_print_config);
+    m_default_object_config_digest = ConfigDigest(m_default_object_config);
+    m_default_region_config_digest = ConfigDigest(m_default_region_config);
+    m_config_digests_valid         = true;
+}
+
 Print::ApplyStatus Print::apply(const Model &model, DynamicPrintConfig new_full_config, bool extruder_applied)
 {
 #ifdef _DEBUG
@@ -1377,11 +1399,15 @@ Print::ApplyStatus Print::apply(const Model &model, DynamicPrintConfig new_full_
     // Find modified keys of the various configs. Resolve overrides extruder retract values by filament profiles.
     DynamicPrintConfig   filament_overrides;
     //BBS: add plate index
-    t_config_option_keys print_diff       = print_config_diffs(m_config, new_full_config, filament_overrides, this->m_plate_index, filament_maps);
-    t_config_option_keys full_config_diff = full_print_config_diffs(m_full_print_config, new_full_config, this->m_plate_index);
+    // The digest of the new config is collected once and shared by all the diffs below,
+    // the digests of the current configs are kept from the previous call unless these configs were modified since.
+    const ConfigDigest   new_full_digest(new_full_config);
+    this->update_config_digests();
+    t_config_option_keys print_diff       = print_config_diffs(m_config_digest, new_full_config, new_full_digest, filament_overrides, this->m_plate_index, filament_maps);
+    t_config_option_keys full_config_diff = full_print_config_diffs(m_full_print_config_digest, new_full_digest, this->m_plate_index);
     // Collect changes to object and region configs.
-    t_config_option_keys object_diff      = m_default_object_config.diff(new_full_config);
-    t_config_option_keys region_diff      = m_default_region_config.diff(new_full_config);
+    t_config_option_keys object_diff      = m_default_object_config_digest.diff(new_full_digest);
+    t_config_option_keys region_diff      = m_default_region_config_digest.diff(new_full_digest);
 
     //BBS: process the filament_map related logic
     std::unordered_set<std::string> print_diff_set(print_diff.begin(), print_diff.end());
@@ -1389,6 +1415,10 @@ Print::ApplyStatus Print::apply(const Model &model, DynamicPrintConfig new_full_
     {
         FilamentMapMode map_mode = new_full_config.option<ConfigOptionEnum<FilamentMapMode>>("filament_map_mode", true)->value;
         if (is_auto_filament_map_mode(map_mode)) {
+            if (print_diff_set.find("filament_map") != print_diff_set.end() ||
+                print_diff_set.find("filament_volume_map") != print_diff_set.end() ||
+                print_diff_set.find("filament_nozzle_map") != print_diff_set.end())
+                this->invalidate_config_digests();
             if (print_diff_set.find("filament_map") != print_diff_set.end()) {
                 print_diff_set.erase("filament_map");
                 //full_config_diff.erase("filament_map");
@@ -1481,6 +1511,8 @@ Print::ApplyStatus Print::apply(const Model &model, DynamicPrintConfig new_full_
                 nozzle_volume_type = (NozzleVolumeType)(opt_filament_volume_maps->values[index]);
         m_config.filament_map_2.values[index] = new_full_config.get_index_for_extruder(filament_maps[index], "print_extruder_id", extruder_type, nozzle_volume_type, "print_extruder_variant");
     }
+    // filament_map_2 is recalculated by every call, only its hash is refreshed to keep the digest of m_config.
+    m_config_digest.update(m_config.def()->get("filament_map_2"));
 
     // Do not use the ApplyStatus as we will use the max function when updating apply_status.
     unsigned int apply_status = APPLY_STATUS_UNCHANGED;
@@ -1527,6 +1559,7 @@ Print::ApplyStatus Print::apply(const Model &model, DynamicPrintConfig new_full_
 	    m_default_region_config.apply_only(new_full_config, region_diff, true);
         //m_full_print_config = std::move(new_full_config);
         m_full_print_config = new_full_config;
+        this->invalidate_config_digests();
         update_filament_self_index_cache();
         if (num_extruders  != m_config.filament_diameter.size()) {
             num_extruders  = m_config.filament_diameter.size();
@@ -1897,6 +1930,7 @@ Print::ApplyStatus Print::apply(const Model &model, DynamicPrintConfig new_full_
         // Handle changes to regions config defaults
         m_default_region_config.apply_only(new_full_config, new_changed_keys, true);
         m_full_print_config = std::move(new_full_config);
+        this->invalidate_config_digests();
         update_filament_self_index_cache();
     }
 
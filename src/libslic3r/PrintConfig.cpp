@@ -9961,6 +9961,20 @@ CLIMiscConfigDef::CLIMiscConfigDef()
     def->tooltip = "Camera view angle for exporting png: 0-Iso, 1-Top_Front, 2-Left, 3-Right, 10-Iso_1, 11-Iso_2, 12-Iso_3";
     def->cli_params = "angle";
     def->set_default_value(new ConfigOptionInt(0));
+
+    def = this->add("parallel_plates", coInt);
+    def->label = "Plates sliced at once";
+    def->tooltip = "Number of plates to be sliced at once when slicing all the plates, the G-code is still exported plate by plate. "
+                   "Needs more memory, 0 or 1 slices the plates one by one.";
+    def->cli_params = "count";
+    def->min = 0;
+    def->set_default_value(new ConfigOptionInt(0));
+
+    def = this->add("cpu_thumbnails", coBool);
+    def->label = "Render thumbnails on the CPU";
+    def->tooltip = "Render the plate and G-code thumbnails with the built-in software rasterizer instead of OpenGL. "
+                   "It is also used when no OpenGL context can be created.";
+    def->set_default_value(new ConfigOptionBool(false));
 }
 
 const CLIActionsConfigDef    cli_actions_config_def;
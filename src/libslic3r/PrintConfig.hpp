@@ -752,6 +752,12 @@ protected:
         const std::vector<std::string>& keys()      const { return m_keys; }
         const T&                        defaults()  const { return *m_defaults; }
 
+        void                collect_digest(const T *owner, ConfigDigest &digest) const
+        {
+            for (const auto &[def, offset] : m_defs_offsets)
+                digest.add(def, reinterpret_cast<const ConfigOption*>((const char*)owner + offset));
+        }
+
         // To be called during the StaticCache setup.
         // Collect option keys from m_map_name_to_offset,
         // assign default values to m_defaults.
@@ -761,6 +767,8 @@ protected:
             m_defaults = defaults;
             m_keys.clear();
             m_keys.reserve(m_map_name_to_offset.size());
+            m_defs_offsets.clear();
+            m_defs_offsets.reserve(m_map_name_to_offset.size());
             for (const auto &kvp : defs->options) {
                 // Find the option given the option name kvp.first by an offset from (char*)m_defaults.
                 ConfigOption *opt = this->optptr(kvp.first, m_defaults);
@@ -770,6 +778,7 @@ protected:
                 m_keys.emplace_back(kvp.first);
                 const ConfigOptionDef *def = defs->get(kvp.first);
                 assert(def != nullptr);
+                m_defs_offsets.emplace_back(def, (const char*)opt - (const char*)m_defaults);
                 if (def->default_value)
                     opt->set(def->default_value.get());
             }
@@ -778,6 +787,8 @@ protected:
     private:
         T                                  *m_defaults;
         std::vector<std::string>            m_keys;
+        // Definitions and offsets of the options in the order of m_keys.
+        std::vector<std::pair<const ConfigOptionDef*, ptrdiff_t>> m_defs_offsets;
     };
 };
 
@@ -791,6 +802,8 @@ public: \
         { return s_cache_##CLASS_NAME.optptr(opt_key, this); } \
     /* Overrides ConfigBase::keys(). Collect names of all configuration values maintained by this configuration store. */ \
     t_config_option_keys     keys() const override { return s_cache_##CLASS_NAME.keys(); } \
+    /* Overrides ConfigBase::collect_digest(). Collect the options by their offsets without looking up their keys. */ \
+    void                     collect_digest(ConfigDigest &digest) const override { s_cache_##CLASS_NAME.collect_digest(this, digest); } \
     const t_config_option_keys& keys_ref() const override { return s_cache_##CLASS_NAME.keys(); } \
     static const CLASS_NAME& defaults() { assert(s_cache_##CLASS_NAME.initialized()); return s_cache_##CLASS_NAME.defaults(); } \
 private: \
@@ -293,7 +293,7 @@ std::vector<std::set<int>> PrintObject::detect_extruder_geometric_unprintables()
                                     fill_expolys = layerm->fill_expolygons;
                                     fill_bbox = get_extents(*fill_expolys);
                                 }
-                                wall_expolys = diff_ex(layerm->raw_slices, *fill_expolys);
+                                wall_expolys = diff_ex(layerm->raw_slices.expolygons(), *fill_expolys);
                                 wall_bbox = get_extents(*wall_expolys);
                             }
 
@@ -810,7 +810,7 @@ void PrintObject::ironing()
 // BBS
 void PrintObject::clear_overhangs_for_lift()
 {
-    if (!m_shared_object) {
+    if (this->owns_layers()) {
         for (Layer* l : m_layers)
             l->loverhangs.clear();
     }
@@ -1007,9 +1007,12 @@ FillLightning::GeneratorPtr PrintObject::prepare_lightning_infill_data()
 
 void PrintObject::clear_layers()
 {
-    if (!m_shared_object) {
-        for (Layer *l : m_layers)
-            delete l;
+    if (this->owns_layers()) {
+        // Layers own millions of extrusion entities and polylines, release them in parallel.
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, m_layers.size()), [this](const tbb::blocked_range<size_t> &range) {
+            for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx)
+                delete m_layers[layer_idx];
+        });
         m_layers.clear();
     }
 }
@@ -1034,9 +1037,11 @@ SupportLayer* PrintObject::get_support_layer_at_printz(coordf_t print_z, coordf_
 
 void PrintObject::clear_support_layers()
 {
-    if (!m_shared_object) {
-        for (SupportLayer* l : m_support_layers)
-            delete l;
+    if (this->owns_layers()) {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, m_support_layers.size()), [this](const tbb::blocked_range<size_t> &range) {
+            for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx)
+                delete m_support_layers[layer_idx];
+        });
         m_support_layers.clear();
         for (auto l : m_layers) {
             l->sharp_tails.clear();
@@ -54,13 +54,20 @@ static std::vector<ExPolygons> slice_volume(
 {
     std::vector<ExPolygons> layers;
     if (! zs.empty()) {
-        indexed_triangle_set its = volume.mesh().its;
-        if (its.indices.size() > 0) {
+        const TriangleMesh &mesh = volume.mesh();
+        if (mesh.its.indices.size() > 0) {
             MeshSlicingParamsEx params2 { params };
             params2.trafo = params2.trafo * volume.get_matrix();
-            if (params2.trafo.rotation().determinant() < 0.)
+            if (params2.trafo.rotation().determinant() < 0.) {
+                indexed_triangle_set its = mesh.its;
                 its_flip_triangles(its);
-            layers = slice_mesh_ex(its, zs, params2, throw_on_cancel_callback);
+                layers = slice_mesh_ex(its, zs, params2, throw_on_cancel_callback);
+            } else {
+                // Reuse the edge IDs cached by the mesh, they survive re-slicing after a configuration change.
+                std::shared_ptr<const std::vector<Vec3i>> face_edge_ids = mesh.face_edge_ids();
+                params2.face_edge_ids = face_edge_ids.get();
+                layers = slice_mesh_ex(mesh.its, zs, params2, throw_on_cancel_callback);
+            }
             throw_on_cancel_callback();
         }
     }
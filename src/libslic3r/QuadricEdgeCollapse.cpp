@@ -1,8 +1,12 @@
 #include "QuadricEdgeCollapse.hpp"
 #include <tuple>
 #include <optional>
+#include <mutex>
+#include <numeric>
+#include <unordered_map>
 #include "MutablePriorityQueue.hpp"
 #include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
 
 using namespace Slic3r;
 
@@ -115,8 +119,10 @@ namespace QuadricEdgeCollapse {
     // calculate error for vertex and quadrics, triangle quadrics and triangle vertex give zero, only pozitive number
     double vertex_error(const SymMat &q, const Vec3d &vertex);
     SymMat create_quadric(const Triangle &t, const Vec3d& n, const Vertices &vertices);
+    // vertices which must not be moved nor removed, empty when all vertices are free
+    using LockedVertices = std::vector<bool>;
     std::tuple<TriangleInfos, VertexInfos, EdgeInfos, Errors> 
-    init(const indexed_triangle_set &its, ThrowOnCancel& throw_on_cancel, StatusFn& status_fn);
+    init(const indexed_triangle_set &its, const LockedVertices &locked, ThrowOnCancel& throw_on_cancel, StatusFn& status_fn);
     std::optional<uint32_t> find_triangle_index1(uint32_t vi, const VertexInfo& v_info,
         uint32_t ti, const EdgeInfos& e_infos, const Indices& indices);
     void reorder_edges(EdgeInfos &e_infos, const VertexInfo &v_info, uint32_t ti0, uint32_t ti1);
@@ -127,13 +133,34 @@ namespace QuadricEdgeCollapse {
     bool create_no_volume(uint32_t vi0, uint32_t vi1, uint32_t ti0, uint32_t ti1,
         const VertexInfo &v_info0, const VertexInfo &v_info1, const EdgeInfos &e_infos, const Indices &indices);
     // find edge with smallest error in triangle
-    Vec3d calculate_3errors(const Triangle &t, const Vertices &vertices, const VertexInfos &v_infos);
-    Error calculate_error(uint32_t ti, const Triangle& t,const Vertices &vertices, const VertexInfos& v_infos, unsigned char& min_index);
+    Vec3d calculate_3errors(const Triangle &t, const Vertices &vertices, const VertexInfos &v_infos, const LockedVertices &locked);
+    Error calculate_error(uint32_t ti, const Triangle& t,const Vertices &vertices, const VertexInfos& v_infos, const LockedVertices &locked, unsigned char& min_index);
     void remove_triangle(EdgeInfos &e_infos, VertexInfo &v_info, uint32_t ti);
     void change_neighbors(EdgeInfos &e_infos, VertexInfos &v_infos, uint32_t ti0, uint32_t ti1,
                           uint32_t vi0, uint32_t vi1, uint32_t vi_top0,
                           const Triangle &t1, CopyEdgeInfos& infos, EdgeInfos &e_infos1);
-    void compact(const VertexInfos &v_infos, const TriangleInfos &t_infos, const EdgeInfos &e_infos, indexed_triangle_set &its);
+    void compact(const VertexInfos &v_infos, const TriangleInfos &t_infos, const EdgeInfos &e_infos, indexed_triangle_set &its,
+                 std::vector<uint32_t> *vertex_map = nullptr);
+    // collapse edges until triangle_count or maximal_error is reached, returns the last used error
+    float simplify(indexed_triangle_set &its, uint32_t triangle_count, float maximal_error, const LockedVertices &locked,
+                   ThrowOnCancel &throw_on_cancel, StatusFn &status_fn, std::vector<uint32_t> *vertex_map = nullptr);
+
+    // Partitioned simplification
+    struct Partition {
+        std::vector<uint32_t> triangles;
+        indexed_triangle_set  its;
+        // source vertex index of the partition vertices
+        std::vector<uint32_t> vertices;
+    };
+    using Partitions = std::vector<Partition>;
+    // split triangles into spatially coherent partitions of at most max_triangles,
+    // by recursive split of triangle centroids along the longest axis at split_ratio
+    Partitions split_partitions(const indexed_triangle_set &its, size_t max_triangles, float split_ratio, ThrowOnCancel &throw_on_cancel);
+    // simplify partitions in parallel with vertices shared with other partitions locked, and stitch them back together
+    float simplify_partitions(indexed_triangle_set &its, uint32_t triangle_count, float maximal_error, size_t max_triangles,
+                              float split_ratio, ThrowOnCancel &throw_on_cancel, StatusFn &status_fn);
+    // estimation of the working memory per triangle of the input mesh
+    size_t bytes_per_triangle();
 
 #ifdef EXPENSIVE_DEBUG_CHECKS
     void store_surround(const char *obj_filename, size_t triangle_index, int depth, const indexed_triangle_set &its,
@@ -153,6 +180,19 @@ namespace QuadricEdgeCollapse {
     const int status_set_offsets = 10;
     const int status_calc_errors = 30;
     const int status_create_refs = 10;
+
+    // partitioned simplification: smallest partition, when not limited by the memory budget
+    const size_t min_partition_triangles = 200000;
+    // lower limit of a partition limited by the memory budget, smaller partitions are mostly border
+    const size_t min_budget_partition_triangles = 10000;
+    // split ratios of partition rounds, shifted so that the borders of a round end up inside of the partitions of the next one
+    const float partition_split_ratios[] = { 0.5f, 0.3f, 0.7f };
+    // progress of the partition rounds, the rest is for the final pass over the whole mesh
+    const int status_partitions_size = 85;
+    // partitions are reduced to this multiple of the wanted triangle count, when the final pass fits into the memory budget
+    const size_t partition_slack = 2;
+    // limit of the partition rounds with a memory budget, when the reduced mesh does not fit the budget of the final pass yet
+    const size_t max_partition_rounds = 6;
     } // namespace QuadricEdgeCollapse
 
 using namespace QuadricEdgeCollapse;
@@ -171,6 +211,255 @@ void Slic3r::its_quadric_edge_collapse(
     if (throw_on_cancel == nullptr) throw_on_cancel = []() {};
     if (status_fn == nullptr) status_fn = [](int) {};
 
+    float last_collapsed_error = simplify(its, triangle_count, maximal_error, {}, throw_on_cancel, status_fn);
+    if (max_error != nullptr) *max_error = last_collapsed_error;
+}
+
+void Slic3r::its_quadric_edge_collapse_partitioned(
+    indexed_triangle_set &    its,
+    uint32_t                  triangle_count,
+    float *                   max_error,
+    std::function<void(void)> throw_on_cancel,
+    std::function<void(int)>  status_fn,
+    size_t                    memory_budget)
+{
+    size_t concurrency   = std::max(1, tbb::this_task_arena::max_concurrency());
+    size_t max_triangles = (memory_budget == 0) ?
+        std::max(min_partition_triangles, its.indices.size() / (4 * concurrency) + 1) :
+        std::max(min_budget_partition_triangles, memory_budget / (bytes_per_triangle() * concurrency));
+    if (its.indices.size() <= max_triangles) {
+        // whole mesh fits into one partition
+        its_quadric_edge_collapse(its, triangle_count, max_error, throw_on_cancel, status_fn);
+        return;
+    }
+
+    // check input
+    if (triangle_count >= its.indices.size()) return;
+    float maximal_error = (max_error == nullptr)? std::numeric_limits<float>::max() : *max_error;
+    if (maximal_error <= 0.f) return;
+    if (throw_on_cancel == nullptr) throw_on_cancel = []() {};
+    if (status_fn == nullptr) status_fn = [](int) {};
+
+    // The partitions are reduced proportionally to their size, not by the order of the errors over the whole mesh.
+    // Leave the last collapses to the final pass over the whole mesh, if it fits into the memory budget.
+    uint32_t partition_count = triangle_count;
+    if (memory_budget == 0 || size_t(triangle_count) * partition_slack <= max_triangles)
+        partition_count = static_cast<uint32_t>(std::min<size_t>(size_t(triangle_count) * partition_slack, its.indices.size()));
+    // The final pass over the whole mesh may use as much memory as the partitions simplified at once.
+    size_t final_max_triangles = (memory_budget == 0) ? std::numeric_limits<size_t>::max() :
+        std::max(max_triangles * concurrency, memory_budget / bytes_per_triangle());
+    // Without a budget one round leaves only the borders for the final pass. With a budget further rounds
+    // with shifted borders are run until the rest fits into one partition, and then as long as the rest does not fit
+    // the budget of the final pass and the rounds still reduce it.
+    float  last_collapsed_error = 0.f;
+    size_t num_rounds = (memory_budget == 0) ? 1 : std::size(partition_split_ratios);
+    for (size_t round = 0; round < max_partition_rounds && its.indices.size() > partition_count && its.indices.size() > max_triangles; ++round) {
+        size_t num_triangles = its.indices.size();
+        if (round >= num_rounds && num_triangles <= final_max_triangles)
+            break;
+        int status_begin = static_cast<int>(status_partitions_size * std::min(round, num_rounds) / num_rounds);
+        int status_end   = static_cast<int>(status_partitions_size * std::min(round + 1, num_rounds) / num_rounds);
+        StatusFn round_status_fn = [&](int percent) {
+            status_fn(status_begin + percent * (status_end - status_begin) / 100);
+        };
+        float error = simplify_partitions(its, partition_count, maximal_error, max_triangles,
+            partition_split_ratios[round % std::size(partition_split_ratios)], throw_on_cancel, round_status_fn);
+        last_collapsed_error = std::max(last_collapsed_error, error);
+        if (its.indices.size() == num_triangles)
+            // all the collapsible edges are locked at the borders
+            break;
+    }
+    throw_on_cancel();
+    status_fn(status_partitions_size);
+
+    // simplify the borders of the partitions over the whole mesh, if it fits into the memory budget
+    if (its.indices.size() > triangle_count && its.indices.size() <= final_max_triangles) {
+        StatusFn final_status_fn = [&](int percent) {
+            status_fn(status_partitions_size + percent * (100 - status_partitions_size) / 100);
+        };
+        float error = simplify(its, triangle_count, maximal_error, {}, throw_on_cancel, final_status_fn);
+        last_collapsed_error = std::max(last_collapsed_error, error);
+    }
+    if (max_error != nullptr) *max_error = last_collapsed_error;
+}
+
+size_t QuadricEdgeCollapse::bytes_per_triangle()
+{
+    // the partition copy of the triangle with its source index, triangle info, error in the vector and in the queue
+    // with queue index, three edge infos and about a half of a vertex with its vertex info and source index
+    return 2 * sizeof(Triangle) + sizeof(uint32_t) + sizeof(TriangleInfo) + 2 * sizeof(Error) + sizeof(size_t) +
+           3 * sizeof(EdgeInfo) + (sizeof(stl_vertex) + sizeof(VertexInfo) + sizeof(uint32_t)) / 2;
+}
+
+QuadricEdgeCollapse::Partitions QuadricEdgeCollapse::split_partitions(const indexed_triangle_set &its,
+                                                                      size_t                      max_triangles,
+                                                                      float                       split_ratio,
+                                                                      ThrowOnCancel &             throw_on_cancel)
+{
+    std::vector<Vec3f> centroids(its.indices.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, its.indices.size()),
+    [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++i) {
+            const Triangle &t = its.indices[i];
+            centroids[i] = (its.vertices[t[0]] + its.vertices[t[1]] + its.vertices[t[2]]) / 3.f;
+        }
+    }); // END parallel for
+
+    std::vector<uint32_t> order(its.indices.size());
+    std::iota(order.begin(), order.end(), 0);
+    // depth first, so that the neighboring partitions are stored next to each other
+    std::vector<std::pair<size_t, size_t>> ranges;
+    std::vector<std::pair<size_t, size_t>> stack{{0, order.size()}};
+    while (!stack.empty()) {
+        auto [begin, end] = stack.back();
+        stack.pop_back();
+        if (end - begin <= max_triangles) {
+            ranges.emplace_back(begin, end);
+            continue;
+        }
+        throw_on_cancel();
+        Vec3f min = centroids[order[begin]];
+        Vec3f max = min;
+        for (size_t i = begin + 1; i < end; ++i) {
+            min = min.cwiseMin(centroids[order[i]]);
+            max = max.cwiseMax(centroids[order[i]]);
+        }
+        int axis;
+        (max - min).maxCoeff(&axis);
+        size_t mid = begin + std::clamp<size_t>(static_cast<size_t>((end - begin) * split_ratio), 1, end - begin - 1);
+        std::nth_element(order.begin() + begin, order.begin() + mid, order.begin() + end,
+            [&centroids, axis](uint32_t ti1, uint32_t ti2) { return centroids[ti1][axis] < centroids[ti2][axis]; });
+        stack.emplace_back(mid, end);
+        stack.emplace_back(begin, mid);
+    }
+
+    Partitions partitions(ranges.size());
+    for (size_t i = 0; i < ranges.size(); ++i)
+        partitions[i].triangles.assign(order.begin() + ranges[i].first, order.begin() + ranges[i].second);
+    return partitions;
+}
+
+float QuadricEdgeCollapse::simplify_partitions(indexed_triangle_set &its,
+                                               uint32_t              triangle_count,
+                                               float                 maximal_error,
+                                               size_t                max_triangles,
+                                               float                 split_ratio,
+                                               ThrowOnCancel &       throw_on_cancel,
+                                               StatusFn &            status_fn)
+{
+    Partitions partitions = split_partitions(its, max_triangles, split_ratio, throw_on_cancel);
+
+    // vertices used by more partitions are locked
+    const uint32_t no_index = std::numeric_limits<uint32_t>::max();
+    LockedVertices border(its.vertices.size(), false);
+    {
+        std::vector<uint32_t> vertex_partition(its.vertices.size(), no_index);
+        for (uint32_t pi = 0; pi < partitions.size(); ++pi)
+            for (uint32_t ti : partitions[pi].triangles)
+                for (int vi : its.indices[ti]) {
+                    uint32_t &vertex_pi = vertex_partition[vi];
+                    if (vertex_pi == no_index)
+                        vertex_pi = pi;
+                    else if (vertex_pi != pi)
+                        border[vi] = true;
+                }
+    }
+
+    std::vector<float> errors(partitions.size(), 0.f);
+    size_t             finished = 0;
+    std::mutex         status_mutex;
+    // one partition per task, the memory budget counts with one partition per thread
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, partitions.size(), 1),
+    [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t pi = range.begin(); pi < range.end(); ++pi) {
+            Partition &partition = partitions[pi];
+            std::vector<uint32_t> &vertices = partition.vertices;
+            vertices.reserve(partition.triangles.size() * 3);
+            for (uint32_t ti : partition.triangles)
+                for (int vi : its.indices[ti])
+                    vertices.emplace_back(vi);
+            std::sort(vertices.begin(), vertices.end());
+            vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+            vertices.shrink_to_fit();
+
+            indexed_triangle_set &part = partition.its;
+            part.vertices.reserve(vertices.size());
+            LockedVertices locked(vertices.size());
+            for (size_t i = 0; i < vertices.size(); ++i) {
+                part.vertices.emplace_back(its.vertices[vertices[i]]);
+                locked[i] = border[vertices[i]];
+            }
+            part.indices.reserve(partition.triangles.size());
+            for (uint32_t ti : partition.triangles) {
+                Triangle t;
+                for (size_t j = 0; j < 3; ++j)
+                    t[j] = std::lower_bound(vertices.begin(), vertices.end(), uint32_t(its.indices[ti][j])) - vertices.begin();
+                part.indices.emplace_back(t);
+            }
+            partition.triangles = {};
+
+            // the wanted triangle count is split among the partitions by their size
+            uint32_t wanted_count = static_cast<uint32_t>(uint64_t(triangle_count) * part.indices.size() / its.indices.size());
+            std::vector<uint32_t> vertex_map;
+            if (wanted_count < part.indices.size()) {
+                StatusFn no_status_fn = [](int) {};
+                errors[pi] = simplify(part, wanted_count, maximal_error, locked, throw_on_cancel, no_status_fn, &vertex_map);
+            } else {
+                vertex_map.resize(vertices.size());
+                std::iota(vertex_map.begin(), vertex_map.end(), 0);
+            }
+
+            // keep the source index only for the locked vertices, they are shared with the other partitions
+            std::vector<uint32_t> shared(part.vertices.size(), no_index);
+            for (size_t i = 0; i < vertex_map.size(); ++i)
+                if (vertex_map[i] != no_index && locked[i])
+                    shared[vertex_map[i]] = vertices[i];
+            vertices = std::move(shared);
+
+            std::lock_guard<std::mutex> lock(status_mutex);
+            status_fn(static_cast<int>(100 * ++finished / partitions.size()));
+        }
+    }); // END parallel for
+
+    // stitch the partitions together
+    indexed_triangle_set out;
+    size_t count_vertices = 0, count_indices = 0;
+    for (const Partition &partition : partitions) {
+        count_vertices += partition.its.vertices.size();
+        count_indices += partition.its.indices.size();
+    }
+    out.vertices.reserve(count_vertices);
+    out.indices.reserve(count_indices);
+    std::unordered_map<uint32_t, uint32_t> shared_vertices;
+    std::vector<uint32_t>                  remap;
+    for (Partition &partition : partitions) {
+        remap.assign(partition.its.vertices.size(), no_index);
+        for (size_t i = 0; i < partition.its.vertices.size(); ++i) {
+            uint32_t vi_new = static_cast<uint32_t>(out.vertices.size());
+            if (partition.vertices[i] != no_index) {
+                auto [it, inserted] = shared_vertices.emplace(partition.vertices[i], vi_new);
+                remap[i] = it->second;
+                if (!inserted) continue;
+            } else
+                remap[i] = vi_new;
+            out.vertices.emplace_back(partition.its.vertices[i]);
+        }
+        for (const Triangle &t : partition.its.indices)
+            out.indices.emplace_back(remap[t[0]], remap[t[1]], remap[t[2]]);
+        partition = Partition();
+    }
+    its = std::move(out);
+    return *std::max_element(errors.begin(), errors.end());
+}
+
+float QuadricEdgeCollapse::simplify(indexed_triangle_set &its,
+                                    uint32_t              triangle_count,
+                                    float                 maximal_error,
+                                    const LockedVertices &locked,
+                                    ThrowOnCancel &       throw_on_cancel,
+                                    StatusFn &            status_fn,
+                                    std::vector<uint32_t> *vertex_map)
+{
     StatusFn init_status_fn = [&](int percent) {
         float n_percent = percent * status_init_size / 100.f;
         status_fn(static_cast<int>(std::round(n_percent)));
@@ -180,7 +469,7 @@ void Slic3r::its_quadric_edge_collapse(
     VertexInfos   v_infos;
     EdgeInfos     e_infos;
     Errors        errors;
-    std::tie(t_infos, v_infos, e_infos, errors) = init(its, throw_on_cancel, init_status_fn);
+    std::tie(t_infos, v_infos, e_infos, errors) = init(its, locked, throw_on_cancel, init_status_fn);
     throw_on_cancel();
     status_fn(status_init_size);
 
@@ -262,7 +551,7 @@ void Slic3r::its_quadric_edge_collapse(
             is_flipped(new_vertex0, ti0, ti1, v_info0, t_infos, e_infos, its) ||
             is_flipped(new_vertex0, ti0, ti1, v_info1, t_infos, e_infos, its)) {
             // try other triangle's edge
-            Vec3d errors = calculate_3errors(t0, its.vertices, v_infos);
+            Vec3d errors = calculate_3errors(t0, its.vertices, v_infos, locked);
             Vec3i ord = (errors[0] < errors[1]) ? 
                 ((errors[0] < errors[2])? 
                     ((errors[1] < errors[2]) ? Vec3i(0, 1, 2) : Vec3i(0, 2, 1)) :
@@ -326,7 +615,7 @@ void Slic3r::its_quadric_edge_collapse(
             size_t priority_queue_index = ti_2_mpqi[ti];
             TriangleInfo& t_info = t_infos[ti];
             t_info.n = create_normal(its.indices[ti], its.vertices).cast<float>(); // recalc normals
-            mpq[priority_queue_index] = calculate_error(ti, its.indices[ti], its.vertices, v_infos, t_info.min_index);
+            mpq[priority_queue_index] = calculate_error(ti, its.indices[ti], its.vertices, v_infos, locked, t_info.min_index);
             mpq.update(priority_queue_index);
         }
 
@@ -342,8 +631,8 @@ void Slic3r::its_quadric_edge_collapse(
     }
 
     // compact triangle
-    compact(v_infos, t_infos, e_infos, its);
-    if (max_error != nullptr) *max_error = last_collapsed_error;
+    compact(v_infos, t_infos, e_infos, its, vertex_map);
+    return last_collapsed_error;
 }
 
 Vec3d QuadricEdgeCollapse::create_normal(const Triangle &triangle,
@@ -438,7 +727,7 @@ SymMat QuadricEdgeCollapse::create_quadric(const Triangle &t,
 }
 
 std::tuple<TriangleInfos, VertexInfos, EdgeInfos, Errors> 
-QuadricEdgeCollapse::init(const indexed_triangle_set &its, ThrowOnCancel& throw_on_cancel, StatusFn& status_fn)
+QuadricEdgeCollapse::init(const indexed_triangle_set &its, const LockedVertices &locked, ThrowOnCancel& throw_on_cancel, StatusFn& status_fn)
 {
     int status_offset = 0;
     TriangleInfos t_infos(its.indices.size());
@@ -500,7 +789,7 @@ QuadricEdgeCollapse::init(const indexed_triangle_set &its, ThrowOnCancel& throw_
         for (size_t i = range.begin(); i < range.end(); ++i) {
             const Triangle &t      = its.indices[i];
             TriangleInfo &  t_info = t_infos[i];
-            errors[i] = calculate_error(i, t, its.vertices, v_infos, t_info.min_index);
+            errors[i] = calculate_error(i, t, its.vertices, v_infos, locked, t_info.min_index);
             if (i % 1000000 == 0) {
                 throw_on_cancel();
                 status_fn(status_offset + (i * status_calc_errors) / its.indices.size());
@@ -690,15 +979,21 @@ bool QuadricEdgeCollapse::create_no_volume(
     return false;
 }
 
-Vec3d QuadricEdgeCollapse::calculate_3errors(const Triangle &   t,
-                                             const Vertices &   vertices,
-                                             const VertexInfos &v_infos)
+Vec3d QuadricEdgeCollapse::calculate_3errors(const Triangle &      t,
+                                             const Vertices &      vertices,
+                                             const VertexInfos &   v_infos,
+                                             const LockedVertices &locked)
 {
     Vec3d error;
     for (size_t j = 0; j < 3; ++j) {
         size_t   j2  = (j == 2) ? 0 : (j + 1);
         uint32_t vi0 = t[j];
         uint32_t vi1 = t[j2];
+        if (! locked.empty() && (locked[vi0] || locked[vi1])) {
+            // never collapse an edge of a locked vertex, the error is above any maximal error and representable as float
+            error[j] = std::numeric_limits<float>::infinity();
+            continue;
+        }
         SymMat   q(v_infos[vi0].q); // copy
         q += v_infos[vi1].q;
         error[j] = calculate_error(vi0, vi1, q, vertices);
@@ -706,13 +1001,14 @@ Vec3d QuadricEdgeCollapse::calculate_3errors(const Triangle &   t,
     return error;
 }
 
-Error QuadricEdgeCollapse::calculate_error(uint32_t           ti,
-                                           const Triangle &   t,
-                                           const Vertices &   vertices,
-                                           const VertexInfos &v_infos,
-                                           unsigned char &    min_index)
+Error QuadricEdgeCollapse::calculate_error(uint32_t              ti,
+                                           const Triangle &      t,
+                                           const Vertices &      vertices,
+                                           const VertexInfos &   v_infos,
+                                           const LockedVertices &locked,
+                                           unsigned char &       min_index)
 {
-    Vec3d error = calculate_3errors(t, vertices, v_infos);
+    Vec3d error = calculate_3errors(t, vertices, v_infos, locked);
     // select min error
     min_index = (error[0] < error[1]) ? ((error[0] < error[2]) ? 0 : 2) :
                                         ((error[1] < error[2]) ? 1 : 2);
@@ -825,15 +1121,19 @@ void QuadricEdgeCollapse::change_neighbors(EdgeInfos &     e_infos,
     }
 }
 
-void QuadricEdgeCollapse::compact(const VertexInfos &   v_infos,
-                                  const TriangleInfos & t_infos,
-                                  const EdgeInfos &     e_infos,
-                                  indexed_triangle_set &its)
+void QuadricEdgeCollapse::compact(const VertexInfos &    v_infos,
+                                  const TriangleInfos &  t_infos,
+                                  const EdgeInfos &      e_infos,
+                                  indexed_triangle_set & its,
+                                  std::vector<uint32_t> *vertex_map)
 {
+    if (vertex_map != nullptr)
+        vertex_map->assign(v_infos.size(), std::numeric_limits<uint32_t>::max());
     uint32_t vi_new = 0;
     for (uint32_t vi = 0; vi < v_infos.size(); ++vi) {
         const VertexInfo &v_info = v_infos[vi];
         if (v_info.is_deleted()) continue; // deleted
+        if (vertex_map != nullptr) (*vertex_map)[vi] = vi_new;
         uint32_t e_info_end = v_info.start + v_info.count;
         for (uint32_t ei = v_info.start; ei < e_info_end; ++ei) { 
             const EdgeInfo &e_info = e_infos[ei];
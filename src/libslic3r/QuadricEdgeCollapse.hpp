@@ -25,4 +25,28 @@ void its_quadric_edge_collapse(
     std::function<void(void)> throw_on_cancel = nullptr,
     std::function<void(int)>  statusfn        = nullptr);
 
+/// <summary>
+/// Simplify mesh by Quadric metric in spatial partitions processed in parallel.
+/// Vertices shared by more partitions are locked while the partitions are simplified,
+/// the borders are simplified at the end over the whole mesh.
+/// Mesh fitting into one partition is simplified by its_quadric_edge_collapse.
+/// </summary>
+/// <param name="its">IN/OUT triangle mesh to be simplified.</param>
+/// <param name="triangle_count">Wanted triangle count.</param>
+/// <param name="max_error">Maximal Quadric for reduce.
+/// When nullptr then max float is used
+/// Output: Biggest of the last used ErrorValues to collapse edge</param>
+/// <param name="throw_on_cancel">Could stop process of calculation, called from worker threads.</param>
+/// <param name="statusfn">Give a feed back to user about progress. Values 1 - 100, called from worker threads.</param>
+/// <param name="memory_budget">Approximate limit of working memory in bytes for the partitions simplified at once,
+/// zero for no limit. The final pass over the borders works on the already reduced mesh and is skipped if that mesh
+/// does not fit the budget, then the mesh keeps more than the wanted count of triangles.</param>
+void its_quadric_edge_collapse_partitioned(
+    indexed_triangle_set &    its,
+    uint32_t                  triangle_count  = 0,
+    float *                   max_error       = nullptr,
+    std::function<void(void)> throw_on_cancel = nullptr,
+    std::function<void(int)>  statusfn        = nullptr,
+    size_t                    memory_budget   = 0);
+
 } // namespace Slic3r
@@ -204,7 +204,7 @@ public:
         return px;
     }
 
-    void clear() { Base::clear(Colors<TColor>::Black); }
+    void clear() override { Base::clear(Colors<TColor>::Black); }
 };
 
 class RasterGrayscaleAAGammaPower: public RasterGrayscaleAA {
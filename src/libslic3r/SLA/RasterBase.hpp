@@ -93,6 +93,9 @@ public:
     virtual Trafo      trafo() const = 0;
 
     virtual EncodedRaster encode(RasterEncoder encoder) const = 0;
+
+    /// Reset the raster to the background, so it can be reused for another layer.
+    virtual void clear() = 0;
 };
 
 struct PNGRasterEncoder {
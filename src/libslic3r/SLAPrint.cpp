@@ -10,6 +10,19 @@
 #include <numeric>
 
 #include <tbb/parallel_for.h>
+#include <tbb/enumerable_thread_specific.h>
+
+// Intel redesigned some TBB interface considerably when merging TBB with their oneAPI set of libraries, see GH #7332.
+#if ! defined(TBB_VERSION_MAJOR)
+    #include <tbb/version.h>
+#endif
+#if TBB_VERSION_MAJOR >= 2021
+    #include <tbb/parallel_pipeline.h>
+    using slic3r_tbb_filtermode = tbb::filter_mode;
+#else
+    #include <tbb/pipeline.h>
+    using slic3r_tbb_filtermode = tbb::filter;
+#endif
 #include <boost/filesystem/path.hpp>
 #include <boost/log/trivial.hpp>
 
@@ -668,6 +681,42 @@ StringObjectException SLAPrint::validate(StringObjectException *exception, Polyg
     return {};
 }
 
+void SLAArchive::stream_layers(size_t                                                   layer_num,
+                               const std::function<void(sla::RasterBase &, size_t)>     &drawfn,
+                               const std::function<void(size_t, sla::EncodedRaster &&)> &writefn,
+                               const std::function<bool()>                              &cancelfn,
+                               size_t                                                   max_live_layers) const
+{
+    using EncodedLayer = std::pair<size_t, sla::EncodedRaster>;
+
+    // one raster per thread, cleared between its layers
+    tbb::enumerable_thread_specific<std::unique_ptr<sla::RasterBase>> rasters;
+
+    size_t next_layer = 0;
+    const auto generator = tbb::make_filter<void, size_t>(slic3r_tbb_filtermode::serial_in_order,
+        [&next_layer, layer_num, &cancelfn](tbb::flow_control &fc) -> size_t {
+            if (next_layer == layer_num || cancelfn()) {
+                fc.stop();
+                return 0;
+            }
+            return next_layer++;
+        });
+    const auto encode = tbb::make_filter<size_t, EncodedLayer>(slic3r_tbb_filtermode::parallel,
+        [this, &rasters, &drawfn](size_t idx) -> EncodedLayer {
+            std::unique_ptr<sla::RasterBase> &rst = rasters.local();
+            if (rst)
+                rst->clear();
+            else
+                rst = create_raster();
+            drawfn(*rst, idx);
+            return { idx, rst->encode(get_encoder()) };
+        });
+    const auto output = tbb::make_filter<EncodedLayer, void>(slic3r_tbb_filtermode::serial_in_order,
+        [&writefn](EncodedLayer layer) { writefn(layer.first, std::move(layer.second)); });
+
+    tbb::parallel_pipeline(std::max<size_t>(1, max_live_layers), generator & encode & output);
+}
+
 void SLAPrint::set_printer(SLAArchive *arch)
 {
     invalidate_step(slapsRasterize);
@@ -400,6 +400,8 @@ public:
     virtual void apply(const SLAPrinterConfig &cfg) = 0;
 
     // Fn have to be thread safe: void(sla::RasterBase& raster, size_t lyrid);
+    // The layers are drawn in blocks, one full resolution raster is allocated
+    // per block and cleared between its layers, so only the encoded layers are kept.
     template<class Fn, class CancelFn, class EP = ExecutionTBB>
     void draw_layers(
         size_t     layer_num,
@@ -408,18 +410,35 @@ public:
         const EP & ep       = {})
     {
         m_layers.resize(layer_num);
+        const size_t block_size = std::max<size_t>(1, execution::max_concurrency(ep));
+        const size_t block_num  = (layer_num + block_size - 1) / block_size;
         execution::for_each(
-            ep, size_t(0), m_layers.size(),
-            [this, &drawfn, &cancelfn](size_t idx) {
-                if (cancelfn()) return;
-
-                sla::EncodedRaster &enc = m_layers[idx];
-                auto                rst = create_raster();
-                drawfn(*rst, idx);
-                enc = rst->encode(get_encoder());
-            },
-            execution::max_concurrency(ep));
+            ep, size_t(0), block_num,
+            [this, &drawfn, &cancelfn, block_size](size_t block) {
+                std::unique_ptr<sla::RasterBase> rst;
+                const size_t end = std::min(m_layers.size(), (block + 1) * block_size);
+                for (size_t idx = block * block_size; idx < end; ++idx) {
+                    if (cancelfn()) return;
+
+                    if (rst)
+                        rst->clear();
+                    else
+                        rst = create_raster();
+                    drawfn(*rst, idx);
+                    m_layers[idx] = rst->encode(get_encoder());
+                }
+            });
     }
+
+    // Draw and encode the layers in parallel and hand them over to writefn in the order of the layers, without keeping them.
+    // At most max_live_layers layers are being drawn or wait for writefn at a time, so the memory is proportional to it
+    // instead of to the number of layers, and the encoding overlaps with the writing.
+    // drawfn has to be thread safe, writefn is called by one thread at a time.
+    void stream_layers(size_t                                                   layer_num,
+                       const std::function<void(sla::RasterBase &, size_t)>     &drawfn,
+                       const std::function<void(size_t, sla::EncodedRaster &&)> &writefn,
+                       const std::function<bool()>                              &cancelfn,
+                       size_t                                                   max_live_layers) const;
 };
 
 /**
@@ -1462,7 +1462,7 @@ static inline ExPolygons detect_overhangs(
 
                 // BBS
                 if (g_config_support_sharp_tails) {
-                    for (ExPolygon& expoly : layerm->raw_slices) {
+                    for (const ExPolygon& expoly : layerm->raw_slices.expolygons()) {
                         if (offset_ex(expoly, -0.5 * fw).empty()) continue;
                         bool is_sharp_tail = false;
                         float accum_height = layer.height;
@@ -0,0 +1,120 @@
+#ifndef slic3r_ThreadLocalCache_hpp_
+#define slic3r_ThreadLocalCache_hpp_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <tbb/enumerable_thread_specific.h>
+
+namespace Slic3r {
+
+// Results of an expensive per layer computation recently made by the calling thread, see ThreadLocalLRUCache.
+// The caches may only be used while a ThreadLocalCache::Use is alive, Print::process() holds one.
+// Several prints may be processed at once, the caches of all the threads are released by the last Use.
+class ThreadLocalCache
+{
+public:
+    class Use
+    {
+    public:
+        Use()
+        {
+            std::lock_guard<std::mutex> lock(registry_mutex());
+            ++ s_num_uses;
+        }
+        ~Use()
+        {
+            std::lock_guard<std::mutex> lock(registry_mutex());
+            if (-- s_num_uses == 0)
+                for (ThreadLocalCache *cache : registry())
+                    cache->clear();
+        }
+        Use(const Use &) = delete;
+        Use& operator=(const Use &) = delete;
+    };
+
+    // The caches are enabled by default. Disabled caches neither find nor store anything,
+    // which allows to compare the cached results with the computed ones.
+    static void set_enabled(bool enabled) { s_enabled = enabled; }
+    static bool enabled() { return s_enabled; }
+
+protected:
+    ThreadLocalCache()
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        registry().emplace_back(this);
+    }
+    ~ThreadLocalCache()
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        std::vector<ThreadLocalCache*> &caches = registry();
+        caches.erase(std::remove(caches.begin(), caches.end(), this), caches.end());
+    }
+    ThreadLocalCache(const ThreadLocalCache &) = delete;
+    ThreadLocalCache& operator=(const ThreadLocalCache &) = delete;
+
+    virtual void clear() = 0;
+
+private:
+    static std::vector<ThreadLocalCache*>& registry() { static std::vector<ThreadLocalCache*> caches; return caches; }
+    static std::mutex&                     registry_mutex() { static std::mutex mutex; return mutex; }
+
+    // Number of alive Use, guarded by registry_mutex().
+    static inline size_t            s_num_uses { 0 };
+    static inline std::atomic<bool> s_enabled { true };
+};
+
+// Least recently used results of a computation, kept separately by each thread.
+// Prismatic parts produce the same islands and surfaces on many layers and the layers are processed in contiguous ranges
+// by a thread, therefore the result for the layer below is mostly found in the cache of the same thread, without locking.
+// The Key has to hold all the inputs of the computation and to compare them exactly, so that a hit returns exactly
+// the computed Value and the output depends neither on how the layers are split between the threads
+// nor on the other prints processed at once.
+template<class Key, class Value, size_t Capacity>
+class ThreadLocalLRUCache : public ThreadLocalCache
+{
+public:
+    ThreadLocalLRUCache() = default;
+    ~ThreadLocalLRUCache() = default;
+
+    // Value cached for the key by the calling thread, which becomes the most recently used entry.
+    // The value is valid until the next insert() by the calling thread.
+    const Value* find(const Key &key)
+    {
+        if (! ThreadLocalCache::enabled())
+            return nullptr;
+        Entries &entries = m_entries.local();
+        auto it = std::find_if(entries.begin(), entries.end(), [&key](const Entry &entry) { return entry.first == key; });
+        if (it == entries.end())
+            return nullptr;
+        entries.splice(entries.begin(), entries, it);
+        return &it->second;
+    }
+
+    void insert(Key &&key, Value &&value)
+    {
+        if (! ThreadLocalCache::enabled())
+            return;
+        Entries &entries = m_entries.local();
+        if (entries.size() == Capacity)
+            entries.pop_back();
+        entries.emplace_front(std::move(key), std::move(value));
+    }
+
+protected:
+    void clear() override { m_entries.clear(); }
+
+private:
+    using Entry   = std::pair<Key, Value>;
+    using Entries = std::list<Entry>;
+    tbb::enumerable_thread_specific<Entries> m_entries;
+};
+
+} // namespace Slic3r
+
+#endif // slic3r_ThreadLocalCache_hpp_
@@ -22,6 +22,8 @@
 #include <vector>
 #include <utility>
 #include <algorithm>
+#include <atomic>
+#include <mutex>
 #include <type_traits>
 
 #include <boost/log/trivial.hpp>
@@ -212,6 +214,7 @@ bool TriangleMesh::from_stl(stl_file& stl, bool repair)
 
     stl_generate_shared_vertices(&stl, this->its);
     fill_initial_stats(this->its, this->m_stats);
+    this->invalidate_topology();
     if (m_stats.volume < 0) {
         flip_triangles();
     }
@@ -275,6 +278,7 @@ void TriangleMesh::scale(const Vec3f &versor)
             v.z() *= versor.z();
         }
     }
+    this->invalidate_topology();
 }
 
 void TriangleMesh::translate(const Vec3f &displacement)
@@ -284,6 +288,7 @@ void TriangleMesh::translate(const Vec3f &displacement)
             v += displacement;
         m_stats.min += displacement;
         m_stats.max += displacement;
+        this->invalidate_topology();
     }
 }
 
@@ -303,6 +308,7 @@ void TriangleMesh::rotate(float angle, const Axis &axis)
         default: assert(false);                  return;
         }
         update_bounding_box(this->its, this->m_stats);
+        this->invalidate_topology();
     }
 }
 
@@ -314,6 +320,7 @@ void TriangleMesh::rotate(float angle, const Vec3d& axis)
         m.rotate(Eigen::AngleAxisd(angle, axis_norm));
         its_transform(its, m);
         update_bounding_box(this->its, this->m_stats);
+        this->invalidate_topology();
     }
 }
 
@@ -341,6 +348,7 @@ void TriangleMesh::mirror(const Axis axis)
     std::swap(m_stats.min[iaxis], m_stats.max[iaxis]);
     m_stats.min[iaxis] *= -1.0;
     m_stats.max[iaxis] *= -1.0;
+    this->invalidate_topology();
 }
 
 void TriangleMesh::transform(const Transform3d& t, bool fix_left_handed)
@@ -353,6 +361,7 @@ void TriangleMesh::transform(const Transform3d& t, bool fix_left_handed)
     }
     m_stats.volume *= det;
     update_bounding_box(this->its, this->m_stats);
+    this->invalidate_topology();
 }
 
 void TriangleMesh::transform(const Matrix3d& m, bool fix_left_handed)
@@ -365,12 +374,14 @@ void TriangleMesh::transform(const Matrix3d& m, bool fix_left_handed)
     }
     m_stats.volume *= det;
     update_bounding_box(this->its, this->m_stats);
+    this->invalidate_topology();
 }
 
 void TriangleMesh::flip_triangles()
 {
     its_flip_triangles(its);
     m_stats.volume = - m_stats.volume;
+    this->invalidate_topology();
 }
 
 void TriangleMesh::align_to_origin()
@@ -385,6 +396,7 @@ void TriangleMesh::rotate(double angle, Point* center)
         this->translate(-c(0), -c(1), 0);
         its_rotate_z(this->its, (float)angle);
         this->translate(c(0), c(1), 0);
+        this->invalidate_topology();
     }
 }
 
@@ -443,6 +455,7 @@ void TriangleMesh::merge(const TriangleMesh &mesh)
 {
     its_merge(this->its, mesh.its);
     m_stats = m_stats.merge(mesh.m_stats);
+    this->invalidate_topology();
 }
 
 // Calculate projection of the mesh into the XY plane, in scaled coordinates.
@@ -571,12 +584,112 @@ std::vector<ExPolygons> TriangleMesh::slice(const std::vector<double> &z) const
     return slice_mesh_ex(this->its, z_f, 0.0004f);
 }
 
+class TriangleMeshTopology
+{
+public:
+    std::shared_ptr<const std::vector<Vec3i>> face_neighbors(const indexed_triangle_set &its)
+    {
+        return get(m_face_neighbors, its, [&its]() { return its_face_neighbors(its); });
+    }
+
+    std::shared_ptr<const std::vector<Vec3i>> face_edge_ids(const indexed_triangle_set &its)
+    {
+        return get(m_face_edge_ids, its, [&its]() { return its_face_edge_ids(its); });
+    }
+
+    std::shared_ptr<const std::vector<Vec3f>> face_normals(const indexed_triangle_set &its)
+    {
+        return get(m_face_normals, its, [&its]() { return its_face_normals(its); });
+    }
+
+    size_t memsize() const
+    {
+        return sizeof(*this) + memsize(m_face_neighbors) + memsize(m_face_edge_ids) + memsize(m_face_normals);
+    }
+
+private:
+    template<typename T> struct Item
+    {
+        mutable std::mutex       mutex;
+        // Number of vertices and faces of the mesh the item was calculated from.
+        size_t                   num_vertices { 0 };
+        size_t                   num_faces    { 0 };
+        std::shared_ptr<const T> data;
+    };
+
+    // Calculate the item on the first request. The other threads requesting the same item wait.
+    // The modifications of the mesh detach it from the cache, the counts only guard against TriangleMesh::its
+    // being resized directly without calling TriangleMesh::invalidate_topology().
+    template<typename T, typename Fn>
+    static std::shared_ptr<const T> get(Item<T> &item, const indexed_triangle_set &its, Fn &&calculate)
+    {
+        std::lock_guard<std::mutex> lock(item.mutex);
+        if (! item.data || item.num_vertices != its.vertices.size() || item.num_faces != its.indices.size()) {
+            item.data         = std::make_shared<const T>(calculate());
+            item.num_vertices = its.vertices.size();
+            item.num_faces    = its.indices.size();
+        }
+        return item.data;
+    }
+
+    template<typename T>
+    static size_t memsize(const Item<std::vector<T>> &item)
+    {
+        std::lock_guard<std::mutex> lock(item.mutex);
+        return item.data ? item.data->capacity() * sizeof(T) : 0;
+    }
+
+    Item<std::vector<Vec3i>> m_face_neighbors;
+    Item<std::vector<Vec3i>> m_face_edge_ids;
+    Item<std::vector<Vec3f>> m_face_normals;
+};
+
 size_t TriangleMesh::memsize() const
 {
     size_t memsize = 8 + this->its.memsize() + sizeof(this->m_stats);
+    if (std::shared_ptr<TriangleMeshTopology> topology = std::atomic_load(&m_topology); topology)
+        memsize += topology->memsize();
     return memsize;
 }
 
+std::shared_ptr<TriangleMeshTopology> TriangleMesh::topology() const
+{
+    // Const methods may be called from multiple threads, let only one of them create the cache.
+    std::shared_ptr<TriangleMeshTopology> topology = std::atomic_load(&m_topology);
+    if (! topology) {
+        std::shared_ptr<TriangleMeshTopology> created = std::make_shared<TriangleMeshTopology>();
+        topology = std::atomic_compare_exchange_strong(&m_topology, &topology, created) ? created : topology;
+    }
+    return topology;
+}
+
+void TriangleMesh::invalidate_topology()
+{
+    // Don't modify the cache, it may still be used by the copies of this mesh.
+    std::atomic_store(&m_topology, std::shared_ptr<TriangleMeshTopology>());
+}
+
+std::shared_ptr<const std::vector<Vec3i>> TriangleMesh::face_neighbors() const
+{
+    return this->topology()->face_neighbors(this->its);
+}
+
+std::shared_ptr<const std::vector<Vec3i>> TriangleMesh::face_edge_ids() const
+{
+    return this->topology()->face_edge_ids(this->its);
+}
+
+std::shared_ptr<const std::vector<Vec3f>> TriangleMesh::face_normals() const
+{
+    return this->topology()->face_normals(this->its);
+}
+
+size_t TriangleMesh::release_optional()
+{
+    std::shared_ptr<TriangleMeshTopology> topology = std::atomic_exchange(&m_topology, std::shared_ptr<TriangleMeshTopology>());
+    return topology ? topology->memsize() : 0;
+}
+
 // Create a mapping from triangle edge into face.
 struct EdgeToFace {
     // Index of the 1st vertex of the triangle edge. vertex_low <= vertex_high.
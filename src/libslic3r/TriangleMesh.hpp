@@ -4,6 +4,7 @@
 #include "libslic3r.h"
 #include <admesh/stl.h>
 #include <functional>
+#include <memory>
 #include <vector>
 #include "BoundingBox.hpp"
 #include "Line.hpp"
@@ -15,6 +16,7 @@ namespace Slic3r {
 
 class TriangleMesh;
 class TriangleMeshSlicer;
+class TriangleMeshTopology;
 struct Groove;
 struct RepairedMeshErrors {
     // How many edges were united by merging their end points with some other end points in epsilon neighborhood?
@@ -98,7 +100,7 @@ public:
     TriangleMesh(std::vector<Vec3f> &&vertices, const std::vector<Vec3i> &&faces);
     explicit TriangleMesh(const indexed_triangle_set &M);
     explicit TriangleMesh(indexed_triangle_set &&M, const RepairedMeshErrors& repaired_errors = RepairedMeshErrors());
-    void clear() { this->its.clear(); this->m_stats.clear(); }
+    void clear() { this->its.clear(); this->m_stats.clear(); this->invalidate_topology(); }
     bool from_stl(stl_file& stl, bool repair = true);
     bool  ReadSTLFile(const char *input_file, bool repair = true, ImportstlProgressFn stlFn = nullptr, int custom_header_length = 80);
     bool write_ascii(const char* output_file);
@@ -151,13 +153,25 @@ public:
     // Estimate of the memory occupied by this structure, important for keeping an eye on the Undo / Redo stack allocation.
     size_t memsize() const;
 
-    // Used by the Undo / Redo stack, legacy interface. As of now there is nothing cached at TriangleMesh,
-    // but we may decide to cache some data in the future (for example normals), thus we keep the interface in place.
+    // Topology of the mesh, calculated on the first request and cached. The cache is shared by the copies of this mesh,
+    // the methods modifying the mesh detach from it. The returned data is not updated if the mesh is modified later.
+    // Code modifying its directly after the topology was requested has to call invalidate_topology().
+    // Face neighbors, see its_face_neighbors().
+    std::shared_ptr<const std::vector<Vec3i>> face_neighbors() const;
+    // Unique edge IDs for chaining of slice lines, see its_face_edge_ids().
+    std::shared_ptr<const std::vector<Vec3i>> face_edge_ids() const;
+    // Normalized face normals, see its_face_normals().
+    std::shared_ptr<const std::vector<Vec3f>> face_normals() const;
+
+    // Used by the Undo / Redo stack, legacy interface. The cached topology is the only optional data of TriangleMesh.
     // Release optional data from the mesh if the object is on the Undo / Redo stack only. Returns the amount of memory released.
-    size_t release_optional() { return 0; }
-    // Restore optional data possibly released by release_optional().
+    size_t release_optional();
+    // Restore optional data possibly released by release_optional(). The topology is recalculated on demand.
     void   restore_optional() {}
 
+    // Detach from the cached topology, to be called after its was modified directly.
+    void   invalidate_topology();
+
     const TriangleMeshStats& stats() const { return m_stats; }
 
     void set_init_shift(const Vec3d &offset) { m_init_shift = offset; }
@@ -166,8 +180,12 @@ public:
     indexed_triangle_set its;
 
 private:
+    std::shared_ptr<TriangleMeshTopology> topology() const;
+
     TriangleMeshStats m_stats;
     Vec3d m_init_shift {0.0, 0.0, 0.0};
+    // Created on demand by topology(), shared by the copies of this mesh.
+    mutable std::shared_ptr<TriangleMeshTopology> m_topology;
 };
 
 // Index of face indices incident with a vertex index.
@@ -33,6 +33,9 @@ struct MeshSlicingParams
     SlicingMode   mode_below { SlicingMode::Regular };
     // Transforming faces during the slicing.
     Transform3d   trafo { Transform3d::Identity() };
+    // Optional edge IDs of the sliced mesh as returned by its_face_edge_ids(), for example cached by TriangleMesh::face_edge_ids().
+    // Calculated by slice_mesh() if not provided. Ignored when slicing with a single plane.
+    const std::vector<Vec3i> *face_edge_ids { nullptr };
 };
 
 struct MeshSlicingParamsEx : public MeshSlicingParams
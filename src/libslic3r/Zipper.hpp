@@ -50,6 +50,9 @@ public:
     /// Add a new binary file entry with an instantly given byte buffer.
     /// This method throws exactly like finish_entry() does.
     void add_entry(const std::string& name, const void* data, size_t bytes);
+    /// Same as above with the compression level of this entry only, e.g. to
+    /// store data which is already compressed without deflating it again.
+    void add_entry(const std::string& name, const void* data, size_t bytes, e_compression compression);
 
     // Writing data to the archive works like with standard streams. The target
     // within the zip file is the entry created with the add_entry method.
@@ -10,6 +10,7 @@
 #include <GL/glew.h>
 #include <boost/nowide/cstdio.hpp>
 #include <wx/numformatter.h>
+#include <tbb/parallel_for.h>
 namespace
 {
     Slic3r::Vec2f get_view_data_index_from_view_type(const Slic3r::GUI::gcode::EViewType type)
@@ -1057,20 +1058,31 @@ namespace Slic3r
                     return;
                 }
 
+                // the segments of the layers are built in parallel, the progress is reported from this thread
                 last_progress = 0;
                 const auto t_layer_count = p_layer_manager->size();
+                std::vector<GCodePreview::LayerGeometry> t_layers_geometry(t_layer_count);
                 for (size_t i = 0; i < t_layer_count; ++i) {
-                    auto& t_layer = (*p_layer_manager)[i];
-                    t_layer.init_sgments(m_ssid_to_moveid_map, t_sid_to_seamMoveIds, gcode_result);
+                    const auto& t_layer = (*p_layer_manager)[i];
+                    if (t_layer.is_valid()) {
+                        t_layers_geometry[i].start_sid = t_layer.get_start();
+                        t_layers_geometry[i].end_sid = t_layer.get_end();
+                    }
+                }
+                GCodePreview::build_layers_geometry(t_layers_geometry, m_ssid_to_moveid_map, t_sid_to_seamMoveIds, gcode_result, [&](size_t t_layers_built) {
                     if (progress_dialog != nullptr) {
-                        float progress_value = 100.0f * float(i + 1) / float(t_layer_count);
-                        if (int(progress_value) != last_progress && int(progress_value) % 10 == 0) {
+                        float progress_value = 100.0f * float(t_layers_built) / float(t_layer_count);
+                        if (int(progress_value) != last_progress) {
                             progress_dialog->Update(int(progress_value),
                                                     _L("Loading segments") + ": " + wxNumberFormatter::ToString(progress_value, 0, wxNumberFormatter::Style_None) + "%");
                             progress_dialog->Fit();
                             last_progress = int(progress_value);
                         }
                     }
+                });
+                for (size_t i = 0; i < t_layer_count; ++i) {
+                    if ((*p_layer_manager)[i].is_valid())
+                        (*p_layer_manager)[i].set_geometry(std::move(t_layers_geometry[i]));
                 }
 
                 if (progress_dialog != nullptr) {
@@ -1830,85 +1842,16 @@ namespace Slic3r
                 return m_zs;
             }
 
-            void Layer::init_sgments(const std::vector<size_t>& sid_to_mid, const std::vector<std::vector<size_t>>& sid_to_seamMoveIds, const GCodeProcessorResult& gcode_result)
+            void Layer::set_geometry(GCodePreview::LayerGeometry&& geometry)
             {
-                if (!is_valid()) {
-                    return;
-                }
-
-                std::vector<uint32_t> t_sid_to_index;
-                std::vector<std::vector<uint32_t>> m_seam_to_index;
-                m_seam_to_index.resize(m_end_sid - m_start_sid + 1);
-                t_sid_to_index.resize(m_end_sid - m_start_sid + 1);
-                uint32_t t_count = 0;
-                bool b_has_custom_options = false;
-
-                for (uint32_t sid = m_start_sid; sid <= m_end_sid; ++sid)
-                {
-                    size_t move_id = sid_to_mid[sid];
-                    const auto& curr_move = gcode_result.moves[move_id];
-                    if (curr_move.type == EMoveType::Pause_Print || curr_move.type == EMoveType::Custom_GCode) {
-                        b_has_custom_options = true;
-                    }
-                    const uint32_t index = add_segment_vertex(move_id, curr_move);
-                    t_sid_to_index[t_count] = index;
-
-                    if (sid_to_seamMoveIds[sid].size()) {
-                        std::vector<uint32_t> indices;
-                        for (size_t j = 0; j < sid_to_seamMoveIds[sid].size(); ++j) {
-                            const auto seam_mid = sid_to_seamMoveIds[sid][j];
-                            const auto& curr_seam = gcode_result.moves[seam_mid];
-                            const uint32_t seam_index = add_segment_vertex(seam_mid, curr_seam);
-                            indices.emplace_back(seam_index);
-                        }
-                        m_seam_to_index[t_count] = std::move(indices);
-                    }
-                    ++t_count;
-                }
-
-                if (b_has_custom_options) {
+                if (geometry.has_custom_options) {
                     const auto p_color_effect = std::make_shared<render::ColorEffect>();
                     p_color_effect->set_color(0.8f, 0.8f, 0.8f, 1.0f);
                     add_effect(p_color_effect);
                 }
-
-                m_segments.clear();
-                m_segments.reserve(m_end_sid - m_start_sid + 1);
-                t_count = 1;
-                for (uint32_t sid = m_start_sid + 1; sid <= m_end_sid; ++sid) {
-                    size_t prev_move_index = t_sid_to_index[t_count - 1];
-                    SegmentVertex t_perv_vertex = m_segment_vertices[prev_move_index];
-                    const auto& prev_move = gcode_result.moves[t_perv_vertex.m_move_id];
-
-                    size_t curr_move_index = t_sid_to_index[t_count];
-                    SegmentVertex t_curr_vertex = m_segment_vertices[curr_move_index];
-                    const auto& curr_move = gcode_result.moves[t_curr_vertex.m_move_id];
-
-                    Segment t_seg;
-                    t_seg.m_first_mid = prev_move_index;
-                    t_seg.m_second_mid = curr_move_index;
-                    t_seg.m_type = curr_move.type;
-                    t_seg.m_role = curr_move.extrusion_role;
-                    t_seg.m_extruder_id = curr_move.extruder_id;
-                    m_segments.emplace_back(std::move(t_seg));
-
-                    if (sid_to_seamMoveIds[sid].size()) {
-                        const std::vector<uint32_t>& indices = m_seam_to_index[t_count];
-                        for (size_t i = 0; i < sid_to_seamMoveIds[sid].size(); ++i) {
-
-                            const auto seam_mid = sid_to_seamMoveIds[sid][i];
-                            const auto& curr_seam = gcode_result.moves[seam_mid];
-                            Segment t_seg;
-                            t_seg.m_first_mid = indices[i];
-                            t_seg.m_second_mid = t_seg.m_first_mid;
-                            t_seg.m_type = curr_seam.type;
-                            t_seg.m_role = curr_seam.extrusion_role;
-                            t_seg.m_extruder_id = curr_seam.extruder_id;
-                            m_segments.emplace_back(std::move(t_seg));
-                        }
-                    }
-                    ++t_count;
-                }
+                m_segment_vertices = std::move(geometry.segment_vertices);
+                m_segments = std::move(geometry.segments);
+                m_position_data = std::move(geometry.position_data);
             }
 
             bool Layer::is_valid() const
@@ -2280,42 +2223,6 @@ namespace Slic3r
                 return m_position_data;
             }
 
-            uint32_t Layer::add_segment_vertex(uint32_t move_id, const GCodeProcessorResult::MoveVertex& t_move)
-            {
-                uint32_t t_index = m_segment_vertices.size();
-                SegmentVertex t_seg_vertex;
-                t_seg_vertex.m_move_id = move_id;
-                t_seg_vertex.m_indices.clear();
-                t_seg_vertex.m_indices.reserve(10);
-                float hight_offset = 0.0f;
-                if (t_move.type == EMoveType::Wipe) {
-                    hight_offset = 0.5f * GCodeProcessor::Wipe_Height;
-                }
-                uint32_t pos_index = m_position_data.size();
-                if (t_move.is_arc_move_with_interpolation_points()) {
-                    const size_t loop_num = t_move.interpolation_points.size();
-                    for (size_t i = 0; i < loop_num; ++i) {
-                        PositionData t_pos_data;
-                        t_pos_data.m_position = t_move.interpolation_points[i];
-                        t_pos_data.m_position.z() += hight_offset;
-                        t_pos_data.m_segment_vertex_index = t_index;
-                        m_position_data.emplace_back(std::move(t_pos_data));
-                        t_seg_vertex.m_indices.push_back(pos_index);
-                        ++pos_index;
-                    }
-                }
-
-                PositionData t_pos_data;
-                t_pos_data.m_position = t_move.position;
-                t_pos_data.m_position.z() += hight_offset;
-                t_pos_data.m_segment_vertex_index = t_index;
-                m_position_data.emplace_back(std::move(t_pos_data));
-                t_seg_vertex.m_indices.push_back(pos_index);
-                m_segment_vertices.emplace_back(std::move(t_seg_vertex));
-
-                return t_index;
-            }
-
             LayerManager::LayerManager()
             {
                 for (unsigned int i = 0; i < erCount; ++i) {
@@ -2567,9 +2474,10 @@ namespace Slic3r
             bool LayerManager::update_visibile_segment_list(bool b_force_update, const std::vector<bool>& filament_visible_flags)
             {
                 if (is_visibility_dirty() || b_force_update) {
-                    for (size_t i_layer = 0; i_layer < m_layer_list.size(); ++i_layer) {
-                        m_layer_list[i_layer].update_visible_segment_list(*this, filament_visible_flags);
-                    }
+                    tbb::parallel_for(tbb::blocked_range<size_t>(0, m_layer_list.size()), [this, &filament_visible_flags](const tbb::blocked_range<size_t>& range) {
+                        for (size_t i_layer = range.begin(); i_layer < range.end(); ++i_layer)
+                            m_layer_list[i_layer].update_visible_segment_list(*this, filament_visible_flags);
+                    });
                     clear_visibility_dirty();
                     return true;
                 }
@@ -2650,9 +2558,10 @@ namespace Slic3r
                     return;
                 }
 
-                for (size_t i_layer = 0; i_layer < m_layer_list.size(); ++i_layer) {
-                    m_layer_list[i_layer].update_per_move_data(t_view_type, t_gcode_result);
-                }
+                tbb::parallel_for(tbb::blocked_range<size_t>(0, m_layer_list.size()), [this, t_view_type, &t_gcode_result](const tbb::blocked_range<size_t>& range) {
+                    for (size_t i_layer = range.begin(); i_layer < range.end(); ++i_layer)
+                        m_layer_list[i_layer].update_per_move_data(t_view_type, t_gcode_result);
+                });
 
                 clear_view_type_dirty();
             }
@@ -1,6 +1,7 @@
 #pragma once
 #include "slic3r/GUI/GCodeRenderer/BaseRenderer.hpp"
 #include "slic3r/GUI/GLModel.hpp"
+#include "libslic3r/GCode/PreviewGeometry.hpp"
 #include <memory>
 #include <vector>
 #include <unordered_map>
@@ -132,26 +133,9 @@ namespace Slic3r {
                 bool m_b_loading{false};
             };
 
-            struct SegmentVertex
-            {
-                uint32_t m_move_id{ -1u };
-                std::vector<uint32_t> m_indices;
-            };
-
-            struct Segment
-            {
-                uint32_t m_first_mid{ -1u };
-                uint32_t m_second_mid{ -1u };
-                EMoveType m_type{ EMoveType::Count };
-                ExtrusionRole m_role{ ExtrusionRole::erCount };
-                uint16_t m_extruder_id{ UINT16_MAX };
-            };
-
-            struct PositionData
-            {
-                Vec3f m_position;
-                uint32_t m_segment_vertex_index{ 0 };
-            };
+            using GCodePreview::SegmentVertex;
+            using GCodePreview::Segment;
+            using GCodePreview::PositionData;
 
             class Layer: public render::EffectContainer
             {
@@ -168,7 +152,8 @@ namespace Slic3r {
                 Layer& set_z(float z);
                 float get_z() const;
 
-                void init_sgments(const std::vector<size_t>& sid_to_mid, const std::vector<std::vector<size_t>>& sid_to_seamMoveId, const GCodeProcessorResult& gcode_result);
+                // takes the segments built by GCodePreview::build_layers_geometry()
+                void set_geometry(GCodePreview::LayerGeometry&& geometry);
 
                 bool is_valid() const;
                 void set_vaild(bool is_valid);
@@ -204,9 +189,6 @@ namespace Slic3r {
 
                 const std::vector<PositionData>& get_position_data() const;
 
-            private:
-                uint32_t add_segment_vertex(uint32_t move_id, const GCodeProcessorResult::MoveVertex& t_move);
-
             private:
                 bool m_b_valid{ true };
                 uint32_t m_start_sid{ -1u };
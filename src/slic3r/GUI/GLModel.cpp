@@ -541,6 +541,7 @@ void GLModel::init_from(Geometry &&data, bool generate_mesh)
     if (generate_mesh) {
         if (!mesh) { mesh = new TriangleMesh(); }
         mesh->its = data.get_as_indexed_triangle_set();
+        mesh->invalidate_topology();
     }
     m_render_data.back().geometry = std::move(data);
     const auto& geometry = m_render_data.back().geometry;
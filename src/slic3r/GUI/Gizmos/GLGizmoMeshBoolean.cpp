@@ -1080,6 +1080,7 @@ std::optional<TriangleMesh> BooleanOperationEngine::execute_boolean_on_meshes_as
                             // Minimal cleanup after each step
                             its_merge_vertices(acc_before.its);
                             its_remove_degenerate_faces(acc_before.its);
+                            acc_before.invalidate_topology();
                         }
                     }
 
@@ -1114,6 +1115,7 @@ std::optional<TriangleMesh> BooleanOperationEngine::execute_boolean_on_meshes_as
                 its_remove_degenerate_faces(accumulated_result.its);
                 its_compactify_vertices(accumulated_result.its);
             }
+            accumulated_result.invalidate_topology();
 
         } catch (const std::exception &e) {
             BOOST_LOG_TRIVIAL(warning) << "[Mesh Boolean] Executing boolean on meshes failed: " << e.what();
@@ -1467,6 +1469,7 @@ std::optional<TriangleMesh> BooleanOperationEngine::execute_boolean_on_meshes(
                         // Minimal cleanup after each step
                         its_merge_vertices(acc_before.its);
                         its_remove_degenerate_faces(acc_before.its);
+                        acc_before.invalidate_topology();
                     }
 
                     try {
@@ -1500,6 +1503,7 @@ std::optional<TriangleMesh> BooleanOperationEngine::execute_boolean_on_meshes(
                 its_remove_degenerate_faces(accumulated_result.its);
                 its_compactify_vertices(accumulated_result.its);
             }
+            accumulated_result.invalidate_topology();
 
         } catch (const std::exception &e) {
             BOOST_LOG_TRIVIAL(warning) << "Executing boolean on meshes failed: " << e.what();
@@ -2328,6 +2332,7 @@ std::vector<TriangleMesh> GLGizmoMeshBoolean::group_and_union_by_object(
                 // Cleanup after each internal union
                 its_remove_degenerate_faces(obj_merged.its);
                 its_merge_vertices(obj_merged.its, true);
+                obj_merged.invalidate_topology();
             }
             per_object_meshes.push_back(std::move(obj_merged));
         }
@@ -10,6 +10,7 @@
 #include "libslic3r/AppConfig.hpp"
 #include "libslic3r/Model.hpp"
 #include "libslic3r/QuadricEdgeCollapse.hpp"
+#include "libslic3r/Utils.hpp"
 
 #include <GL/glew.h>
 
@@ -524,7 +525,8 @@ void GLGizmoSimplify::process()
 
         // Start the actual calculation.
         try {
-            its_quadric_edge_collapse(*its, triangle_count, &max_error, throw_on_cancel, statusfn);
+            // huge meshes are simplified in partitions within a quarter of the physical memory
+            its_quadric_edge_collapse_partitioned(*its, triangle_count, &max_error, throw_on_cancel, statusfn, total_physical_memory() / 4);
         } catch (SimplifyCanceledException &) {
             std::lock_guard lk(m_state_mutex);
             m_state.status = State::idle;
@@ -334,6 +334,21 @@ std::string slice(std::initializer_list<TriangleMesh> meshes, std::initializer_l
 	return gcode(print);
 }
 
+ExtrusionPaths extrusion_paths(const ExtrusionEntityCollection &collection)
+{
+    ExtrusionPaths                  out;
+    const ExtrusionEntityCollection flattened = collection.flatten();
+    for (const ExtrusionEntity *entity : flattened.entities) {
+        if (const auto *path = dynamic_cast<const ExtrusionPath*>(entity))
+            out.emplace_back(*path);
+        else if (const auto *multi_path = dynamic_cast<const ExtrusionMultiPath*>(entity))
+            append(out, multi_path->paths);
+        else if (const auto *loop = dynamic_cast<const ExtrusionLoop*>(entity))
+            append(out, loop->paths);
+    }
+    return out;
+}
+
 } } // namespace Slic3r::Test
 
 #include <catch2/catch.hpp>
@@ -7,8 +7,11 @@
 #include "libslic3r/Fill/Fill.hpp"
 #include "libslic3r/Flow.hpp"
 #include "libslic3r/Geometry.hpp"
+#include "libslic3r/Layer.hpp"
 #include "libslic3r/Print.hpp"
 #include "libslic3r/SVG.hpp"
+#include "libslic3r/ThreadLocalCache.hpp"
+#include "libslic3r/Utils.hpp"
 #include "libslic3r/libslic3r.h"
 
 #include "test_data.hpp"
@@ -190,6 +193,90 @@ TEST_CASE("Fill: Pattern Path Length", "[Fill]") {
     }
 }
 
+SCENARIO("Fill: Layers with identical fill surfaces get identical infill", "[Fill]") {
+    GIVEN("20mm cube with sparse zig-zag infill") {
+        Slic3r::DynamicPrintConfig config = Slic3r::DynamicPrintConfig::full_print_config();
+        config.set_deserialize_strict({
+            { "sparse_infill_pattern",      "zig-zag" },
+            { "sparse_infill_density",      "20%" },
+            { "layer_height",               0.2 },
+            { "initial_layer_print_height", 0.2 }
+        });
+        Slic3r::Print print;
+        Slic3r::Model model;
+        Slic3r::Test::init_print({Slic3r::Test::TestMesh::cube_20x20x20}, print, model, config);
+        WHEN("the print is processed") {
+            print.process();
+            auto infill_polylines = [&print](int layer_id) {
+                Polylines polylines;
+                for (const LayerRegion *layerm : print.objects().front()->get_layer(layer_id)->regions())
+                    layerm->fills.collect_polylines(polylines);
+                return polylines;
+            };
+            THEN("the infill repeats with the period of two layers") {
+                const Polylines infill = infill_polylines(50);
+                REQUIRE(! infill.empty());
+                REQUIRE(infill_polylines(52) == infill);
+                REQUIRE(infill_polylines(54) == infill);
+                REQUIRE(infill_polylines(51) != infill);
+            }
+        }
+    }
+    GIVEN("Bridge and 20mm cube with combined sparse zig-zag infill") {
+        Slic3r::DynamicPrintConfig config = Slic3r::DynamicPrintConfig::full_print_config();
+        config.set_deserialize_strict({
+            { "sparse_infill_pattern",      "zig-zag" },
+            { "sparse_infill_density",      "20%" },
+            { "infill_combination",         1 },
+            { "layer_height",               0.1 },
+            { "initial_layer_print_height", 0.2 }
+        });
+        WHEN("the objects are processed with and without the thread local caches") {
+            Slic3r::Print print_cached;
+            Slic3r::Print print_computed;
+            Slic3r::Test::init_and_process_print({Slic3r::Test::TestMesh::bridge, Slic3r::Test::TestMesh::cube_20x20x20}, print_cached, config);
+            {
+                ThreadLocalCache::set_enabled(false);
+                ScopeGuard enable_caches([]() { ThreadLocalCache::set_enabled(true); });
+                Slic3r::Test::init_and_process_print({Slic3r::Test::TestMesh::bridge, Slic3r::Test::TestMesh::cube_20x20x20}, print_computed, config);
+            }
+            THEN("the cached infill is the computed one, including the bridges and the infill of combined layers") {
+                bool has_bridge   = false;
+                bool has_combined = false;
+                REQUIRE(print_cached.objects().size() == print_computed.objects().size());
+                for (size_t object_id = 0; object_id < print_cached.objects().size(); ++ object_id) {
+                    const PrintObject &object_cached   = *print_cached.objects()[object_id];
+                    const PrintObject &object_computed = *print_computed.objects()[object_id];
+                    REQUIRE(object_cached.layers().size() == object_computed.layers().size());
+                    for (size_t layer_id = 0; layer_id < object_cached.layers().size(); ++ layer_id) {
+                        const Layer &layer_cached   = *object_cached.get_layer(int(layer_id));
+                        const Layer &layer_computed = *object_computed.get_layer(int(layer_id));
+                        REQUIRE(layer_cached.regions().size() == layer_computed.regions().size());
+                        for (size_t region_id = 0; region_id < layer_cached.regions().size(); ++ region_id) {
+                            const ExtrusionPaths paths_cached   = Slic3r::Test::extrusion_paths(layer_cached.regions()[region_id]->fills);
+                            const ExtrusionPaths paths_computed = Slic3r::Test::extrusion_paths(layer_computed.regions()[region_id]->fills);
+                            REQUIRE(paths_cached.size() == paths_computed.size());
+                            for (size_t path_id = 0; path_id < paths_cached.size(); ++ path_id) {
+                                const ExtrusionPath &path_cached   = paths_cached[path_id];
+                                const ExtrusionPath &path_computed = paths_computed[path_id];
+                                REQUIRE(path_cached.role() == path_computed.role());
+                                REQUIRE(path_cached.polyline.points == path_computed.polyline.points);
+                                REQUIRE(path_cached.width == path_computed.width);
+                                REQUIRE(path_cached.height == path_computed.height);
+                                REQUIRE(path_cached.mm3_per_mm == path_computed.mm3_per_mm);
+                                has_bridge |= path_cached.role() == erBridgeInfill;
+                                has_combined |= path_cached.role() == erInternalInfill && path_cached.height > layer_cached.height + EPSILON;
+                            }
+                        }
+                    }
+                }
+                REQUIRE(has_bridge);
+                REQUIRE(has_combined);
+            }
+        }
+    }
+}
+
 /*
 {
     my $collection = Slic3r::Polyline::Collection->new(
@@ -3,6 +3,18 @@
 #include <memory>
 
 #include "libslic3r/GCode.hpp"
+#include "libslic3r/GCode/GCodeProcessor.hpp"
+#include "libslic3r/GCode/PreviewGeometry.hpp"
+#include "libslic3r/GCode/WipeTower.hpp"
+#include "libslic3r/LocalesUtils.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <iomanip>
+#include <sstream>
+
+#include <boost/filesystem.hpp>
+#include <boost/nowide/cstdio.hpp>
 
 using namespace Slic3r;
 
@@ -20,3 +32,420 @@ SCENARIO("Origin manipulation", "[GCode]") {
     	}
     }
 }
+
+SCENARIO("Time re-estimation from the planner record", "[GCode]") {
+	GIVEN("A processed G-code with extrusions, travels and an acceleration change") {
+		std::string path = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("gcode-%%%%-%%%%.gcode")).string();
+		FILE *f = boost::nowide::fopen(path.c_str(), "wb");
+		REQUIRE(f != nullptr);
+		fprintf(f, "G90\nM83\nG1 Z0.2 F600\n");
+		for (int i = 0; i < 200; ++ i) {
+			if (i == 100)
+				fprintf(f, "M204 S2000\n");
+			fprintf(f, "G1 X%d Y%d F9000\nG1 X%d Y%d E0.5 F3000\n", 10 + i % 7, 10 + i % 5, 100 - i % 3, 80 + i % 11);
+		}
+		fclose(f);
+
+		const FullPrintConfig &config = FullPrintConfig::defaults();
+		GCodeProcessor processor;
+		processor.apply_config(config);
+		processor.enable_planner_record(true);
+		processor.process_file(path);
+		boost::filesystem::remove(path);
+		const float time = processor.get_time(PrintEstimatedStatistics::ETimeMode::Normal);
+
+		WHEN("the times are estimated for the same machine limits") {
+			PrintEstimatedStatistics statistics;
+			REQUIRE(processor.estimate_times(config, statistics));
+			THEN("the processed times are reproduced") {
+				REQUIRE(time > 0.f);
+				REQUIRE(statistics.modes[size_t(PrintEstimatedStatistics::ETimeMode::Normal)].time == Approx(time));
+			}
+		}
+		WHEN("the times are estimated for slower machine limits") {
+			MachineEnvelopeConfig limits = config;
+			for (double &value : limits.machine_max_acceleration_extruding.values)
+				value = 500.;
+			for (double &value : limits.machine_max_acceleration_travel.values)
+				value = 500.;
+			PrintEstimatedStatistics statistics;
+			REQUIRE(processor.estimate_times(limits, statistics));
+			THEN("the print takes longer") {
+				REQUIRE(statistics.modes[size_t(PrintEstimatedStatistics::ETimeMode::Normal)].time > time);
+			}
+		}
+	}
+}
+
+static void write_layers_gcode(const std::string &path, int layers, int modified_layer)
+{
+	FILE *f = boost::nowide::fopen(path.c_str(), "wb");
+	REQUIRE(f != nullptr);
+	fprintf(f, "G90\nM83\n");
+	for (int layer = 0; layer < layers; ++ layer) {
+		fprintf(f, "; CHANGE_LAYER\nG1 Z%.1f F600\n", 0.2 * (layer + 1));
+		for (int i = 0; i < 20; ++ i)
+			fprintf(f, "G1 X%d Y%d F9000\nG1 X%d Y%d E0.5 F%d\n", 10 + i % 7, 10 + i % 5, 100 - i % 3, 80 + i % 11, layer == modified_layer ? 600 : 3000);
+	}
+	fclose(f);
+}
+
+SCENARIO("Reprocessing of a modified G-code from a checkpoint", "[GCode]") {
+	GIVEN("A G-code processed with checkpoints") {
+		std::string path = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("gcode-%%%%-%%%%.gcode")).string();
+		write_layers_gcode(path, 10, -1);
+		const FullPrintConfig &config = FullPrintConfig::defaults();
+		GCodeProcessor processor;
+		processor.apply_config(config);
+		processor.enable_checkpoints(true);
+		processor.process_file(path);
+
+		WHEN("a layer is modified and the G-code is reprocessed from there") {
+			const float time_before = processor.get_time(PrintEstimatedStatistics::ETimeMode::Normal);
+			write_layers_gcode(path, 10, 7);
+			// 2 header lines, then 42 lines per layer
+			processor.reprocess_file(path, 2 + 7 * 42 + 1);
+			GCodeProcessor reference;
+			reference.apply_config(config);
+			reference.process_file(path);
+			boost::filesystem::remove(path);
+			THEN("the result matches the processing from scratch") {
+				const float time = processor.get_time(PrintEstimatedStatistics::ETimeMode::Normal);
+				REQUIRE(time > time_before);
+				REQUIRE(time == Approx(reference.get_time(PrintEstimatedStatistics::ETimeMode::Normal)));
+				REQUIRE(processor.get_result().moves.size() == reference.get_result().moves.size());
+				REQUIRE(processor.get_result().lines_ends == reference.get_result().lines_ends);
+				REQUIRE(processor.get_result().moves.back().position == reference.get_result().moves.back().position);
+			}
+		}
+	}
+}
+
+// Layers changing the units, the positioning, the fans, the temperatures and the extrusion role and width on the way,
+// so that any of this state not restored from a checkpoint shows in the moves.
+static void write_stateful_layers_gcode(const std::string &path, int layers)
+{
+	FILE *f = boost::nowide::fopen(path.c_str(), "wb");
+	REQUIRE(f != nullptr);
+	fprintf(f, "G90\nM83\nM104 S210\n");
+	for (int layer = 0; layer < layers; ++ layer) {
+		fprintf(f, "; CHANGE_LAYER\nG1 Z%.1f F600\n", 0.2 * (layer + 1));
+		fprintf(f, "; FEATURE: %s\n; LINE_WIDTH: %.2f\n", layer % 2 ? "Inner wall" : "Sparse infill", 0.4 + 0.05 * (layer % 3));
+		fprintf(f, "M106 S%d\nM104 S%d\n", 50 * (layer % 5), 200 + layer);
+		for (int i = 0; i < 10; ++ i)
+			fprintf(f, "G1 X%d Y%d F9000\nG1 X%d Y%d E0.5 F%d\n", 10 + i % 7, 10 + i % 5, 100 - i % 3, 80 + i % 11, 1200 + 300 * (layer % 4));
+		// skippable moves, whose times are summed per type while the blocks leave the planner
+		fprintf(f, "; SKIPPABLE_START\n; SKIPTYPE: %s\nG1 X5 Y5 F9000\nG1 X150 Y%d\n; SKIPPABLE_END\n",
+			layer % 2 ? "timelapse" : "head_wrap_detect", 100 + 10 * layer);
+		if (layer == layers / 2)
+			fprintf(f, "; PAUSE_PRINTING\n");
+		if (layer % 3 == 1)
+			fprintf(f, "G91\nG1 X5 Y5 E0.2\nG90\n");
+		else if (layer % 3 == 2)
+			fprintf(f, "G2 X60 Y80 I-20 J0 E1 F1800\n");
+	}
+	fclose(f);
+}
+
+SCENARIO("Reprocessing an unmodified G-code from any checkpoint", "[GCode]") {
+	GIVEN("A G-code processed from scratch") {
+		std::string path = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("gcode-%%%%-%%%%.gcode")).string();
+		write_stateful_layers_gcode(path, 8);
+		const FullPrintConfig &config = FullPrintConfig::defaults();
+		GCodeProcessor reference;
+		reference.apply_config(config);
+		reference.process_file(path);
+		const GCodeProcessorResult &expected = reference.get_result();
+
+		THEN("the processing resumed from the checkpoint of any layer restores the whole processing state") {
+			for (size_t line = 8; line < expected.lines_ends.size(); line += 13) {
+				GCodeProcessor processor;
+				processor.apply_config(config);
+				processor.enable_checkpoints(true);
+				processor.process_file(path);
+				processor.reprocess_file(path, line);
+				const GCodeProcessorResult &result = processor.get_result();
+				REQUIRE(processor.get_time(PrintEstimatedStatistics::ETimeMode::Normal) == Approx(reference.get_time(PrintEstimatedStatistics::ETimeMode::Normal)));
+				const std::vector<float> layers_time = processor.get_layers_time(PrintEstimatedStatistics::ETimeMode::Normal);
+				const std::vector<float> expected_layers_time = reference.get_layers_time(PrintEstimatedStatistics::ETimeMode::Normal);
+				REQUIRE(layers_time.size() == expected_layers_time.size());
+				for (size_t i = 0; i < layers_time.size(); ++ i)
+					REQUIRE(layers_time[i] == Approx(expected_layers_time[i]));
+				const auto custom_gcode_times = processor.get_custom_gcode_times(PrintEstimatedStatistics::ETimeMode::Normal, true);
+				const auto expected_custom_gcode_times = reference.get_custom_gcode_times(PrintEstimatedStatistics::ETimeMode::Normal, true);
+				REQUIRE(custom_gcode_times.size() == expected_custom_gcode_times.size());
+				for (size_t i = 0; i < custom_gcode_times.size(); ++ i) {
+					REQUIRE(custom_gcode_times[i].first == expected_custom_gcode_times[i].first);
+					REQUIRE(custom_gcode_times[i].second.first == Approx(expected_custom_gcode_times[i].second.first));
+					REQUIRE(custom_gcode_times[i].second.second == Approx(expected_custom_gcode_times[i].second.second));
+				}
+				REQUIRE(expected.skippable_part_time.size() == 2);
+				REQUIRE(result.skippable_part_time.size() == expected.skippable_part_time.size());
+				for (const auto &[type, time] : expected.skippable_part_time) {
+					REQUIRE(result.skippable_part_time.count(type) == 1);
+					REQUIRE(result.skippable_part_time.at(type) == Approx(time));
+				}
+				REQUIRE(result.lines_ends == expected.lines_ends);
+				REQUIRE(result.moves.size() == expected.moves.size());
+				for (size_t i = 0; i < result.moves.size(); ++ i) {
+					const GCodeProcessorResult::MoveVertex &move = result.moves[i], &expected_move = expected.moves[i];
+					REQUIRE(move.type == expected_move.type);
+					REQUIRE(move.extrusion_role == expected_move.extrusion_role);
+					REQUIRE(move.move_path_type == expected_move.move_path_type);
+					REQUIRE(move.extruder_id == expected_move.extruder_id);
+					REQUIRE(move.gcode_id == expected_move.gcode_id);
+					REQUIRE(move.position == expected_move.position);
+					REQUIRE(move.feedrate == expected_move.feedrate);
+					REQUIRE(move.width == expected_move.width);
+					REQUIRE(move.height == expected_move.height);
+					REQUIRE(move.fan_speed == expected_move.fan_speed);
+					REQUIRE(move.temperature == expected_move.temperature);
+					REQUIRE(move.layer_duration == Approx(expected_move.layer_duration));
+				}
+			}
+		}
+		boost::filesystem::remove(path);
+	}
+}
+
+SCENARIO("Dispatch of G-code commands", "[GCode]") {
+	GIVEN("A command processor with numbered, early quit and named commands") {
+		CommandProcessor processor;
+		std::string      handled;
+		auto handler = [&handled](const std::string &name) { return [&handled, name](const GCodeReader::GCodeLine &) { handled = name; }; };
+		processor.register_command("G28", handler("G28"));
+		processor.register_command("M104", handler("M104"));
+		processor.register_command("M1020", handler("M1020"));
+		processor.register_command("T", handler("T"), true);
+		processor.register_command("SYNC", handler("SYNC"));
+		GCodeReader::GCodeLine line;
+		auto dispatch = [&](const char *cmd) { handled.clear(); return processor.process_comand(cmd, line) ? handled : std::string("none"); };
+		THEN("the commands reach their handlers") {
+			REQUIRE(dispatch("G28") == "G28");
+			REQUIRE(dispatch("M104") == "M104");
+			REQUIRE(dispatch("M1020") == "M1020");
+			REQUIRE(dispatch("SYNC") == "SYNC");
+		}
+		THEN("the numbered commands are case insensitive") {
+			REQUIRE(dispatch("m104") == "M104");
+		}
+		THEN("the early quit commands match any suffix") {
+			REQUIRE(dispatch("T3") == "T");
+			REQUIRE(dispatch("T1000") == "T");
+		}
+		THEN("the unknown commands are not handled") {
+			REQUIRE(dispatch("M0104") == "none");
+			REQUIRE(dispatch("M105") == "none");
+			REQUIRE(dispatch("G2800") == "none");
+			REQUIRE(dispatch("SYN") == "none");
+		}
+	}
+}
+
+// The wipe tower moves as transformed through string streams before the moves were scanned in place.
+// When the G-code does not end with a new line, the last std::getline() fails without clearing the last line,
+// which is then transformed once more. When it does, the failing std::getline() yields an empty line.
+static std::string transform_gcode_through_streams(const std::string &gcode, Vec2f pos, const Vec2f &translation, float angle)
+{
+    std::istringstream gcode_str(gcode);
+    std::string        gcode_out;
+    std::string        line;
+    Vec2f              transformed_pos = pos;
+    Vec2f              old_pos(-1000.1f, -1000.1f);
+    while (gcode_str) {
+        std::getline(gcode_str, line);
+        if (line.find("G1 ") == 0) {
+            bool never_skip = false;
+            auto it         = line.find(WipeTower::never_skip_tag());
+            if (it != std::string::npos) {
+                never_skip = true;
+                line.erase(it, it + WipeTower::never_skip_tag().size());
+            }
+            std::ostringstream line_out;
+            std::istringstream line_str(line);
+            line_str >> std::noskipws;
+            char ch = 0;
+            while (line_str >> ch) {
+                if (ch == 'X' || ch == 'Y')
+                    line_str >> (ch == 'X' ? pos.x() : pos.y());
+                else
+                    line_out << ch;
+            }
+            transformed_pos = Eigen::Rotation2Df(angle) * pos + translation;
+            if (transformed_pos != old_pos || never_skip) {
+                line = line_out.str();
+                std::ostringstream oss;
+                oss << std::fixed << std::setprecision(3) << "G1 ";
+                if (transformed_pos.x() != old_pos.x() || never_skip) oss << " X" << transformed_pos.x();
+                if (transformed_pos.y() != old_pos.y() || never_skip) oss << " Y" << transformed_pos.y();
+                oss << " ";
+                line.replace(line.find("G1 "), 3, oss.str());
+                old_pos = transformed_pos;
+            }
+        }
+        gcode_out += line + "\n";
+    }
+    return gcode_out;
+}
+
+SCENARIO("Wipe tower moves transformation", "[GCode]") {
+    const Vec2f translation(120.5f, 80.25f);
+    const float angle = float(M_PI) / 6.f;
+    GIVEN("Wipe tower G-code with repeated positions, a never skip tag and other commands") {
+        const std::string gcode = "G1 X10 Y20 F3000\n"
+                                  "; comment\n"
+                                  "G1 X10 Y20 E0.5\n"
+                                  "G1 X12.5 E1.25\n"
+                                  "G1 Y22.75 E0.75" + WipeTower::never_skip_tag() + "\n"
+                                  "M204 S2000\n"
+                                  "G1 X3 Y4";
+        WHEN("the G-code does not end with a new line") {
+            const std::string out = transform_gcode(gcode, Vec2f(5.f, 5.f), translation, angle);
+            THEN("the output is the one of the string streams without the last move transformed twice") {
+                const std::string streams_out = transform_gcode_through_streams(gcode, Vec2f(5.f, 5.f), translation, angle);
+                REQUIRE(boost::starts_with(streams_out, out));
+                REQUIRE(std::count(streams_out.begin(), streams_out.end(), '\n') == std::count(out.begin(), out.end(), '\n') + 1);
+                REQUIRE(out + "\n" == transform_gcode_through_streams(gcode + "\n", Vec2f(5.f, 5.f), translation, angle));
+                REQUIRE(! boost::ends_with(out, "\n\n"));
+            }
+        }
+        WHEN("the G-code ends with a new line") {
+            const std::string out = transform_gcode(gcode + "\n", Vec2f(5.f, 5.f), translation, angle);
+            THEN("the output is the one of the string streams, including the empty line after the last new line") {
+                REQUIRE(out == transform_gcode_through_streams(gcode + "\n", Vec2f(5.f, 5.f), translation, angle));
+                REQUIRE(boost::ends_with(out, "\n\n"));
+            }
+        }
+    }
+    GIVEN("Wipe tower moves formatted by append_float_decimal_point") {
+        std::string gcode;
+        for (int i = 0; i < 500; ++ i) {
+            const float x = -50.f + 0.0137f * float(i * i);
+            const float y = 200.f - 0.731f * float(i);
+            gcode += "G1 X";
+            append_float_decimal_point(gcode, x, 3);
+            gcode += " Y";
+            append_float_decimal_point(gcode, y, 3);
+            gcode += " E";
+            append_float_decimal_point(gcode, 0.01f * float(i % 17), 4);
+            gcode += '\n';
+        }
+        THEN("the transformed moves are the ones of the string streams") {
+            REQUIRE(transform_gcode(gcode, Vec2f::Zero(), translation, angle) == transform_gcode_through_streams(gcode, Vec2f::Zero(), translation, angle));
+        }
+        THEN("the coordinates have the digits of printf") {
+            for (float value : { 0.f, -0.f, 0.0005f, 1.0005f, -12.3456f, 255.9995f, 123456.789f, -0.0004f }) {
+                char expected[64];
+                snprintf(expected, sizeof(expected), "%.3f", value);
+                std::string out;
+                append_float_decimal_point(out, value, 3);
+                REQUIRE(out == expected);
+            }
+        }
+    }
+}
+
+SCENARIO("G-code preview geometry of the layers", "[GCode]") {
+    GIVEN("Moves of 40 layers with seams, arcs, wipes and a pause") {
+        GCodeProcessorResult result;
+        std::vector<size_t> sid_to_mid;
+        std::vector<std::vector<size_t>> sid_to_seam_mids;
+        std::vector<GCodePreview::LayerGeometry> layers;
+        auto add_move = [&](EMoveType type, const Vec3f &pos) -> GCodeProcessorResult::MoveVertex& {
+            GCodeProcessorResult::MoveVertex move;
+            move.type = type;
+            move.extrusion_role = type == EMoveType::Extrude ? erExternalPerimeter : erNone;
+            move.position = pos;
+            result.moves.emplace_back(std::move(move));
+            if (type == EMoveType::Seam) {
+                // a seam belongs to the segment id of the previous move
+                sid_to_seam_mids.back().emplace_back(result.moves.size() - 1);
+            } else {
+                sid_to_mid.emplace_back(result.moves.size() - 1);
+                sid_to_seam_mids.emplace_back();
+            }
+            return result.moves.back();
+        };
+        for (int layer = 0; layer < 40; ++ layer) {
+            const float z = 0.2f * float(layer + 1);
+            GCodePreview::LayerGeometry geometry;
+            geometry.start_sid = uint32_t(sid_to_mid.size());
+            add_move(EMoveType::Travel, Vec3f(0.f, 0.f, z));
+            for (int i = 0; i < 6; ++ i) {
+                GCodeProcessorResult::MoveVertex &move = add_move(EMoveType::Extrude, Vec3f(float(i), float(layer), z));
+                if (i == 3 && layer % 3 == 0) {
+                    move.move_path_type = EMovePathType::Arc_move_ccw;
+                    move.interpolation_points = { Vec3f(2.2f, 0.5f, z), Vec3f(2.5f, 0.7f, z), Vec3f(2.8f, 0.5f, z) };
+                }
+                if (i == 1)
+                    add_move(EMoveType::Seam, Vec3f(float(i), float(layer), z));
+            }
+            if (layer % 5 == 0)
+                add_move(EMoveType::Wipe, Vec3f(7.f, float(layer), z));
+            if (layer == 7)
+                add_move(EMoveType::Pause_Print, Vec3f(7.f, float(layer), z));
+            geometry.end_sid = uint32_t(sid_to_mid.size() - 1);
+            layers.emplace_back(std::move(geometry));
+        }
+        // a layer left out of the preview
+        layers.emplace_back();
+
+        WHEN("the layers are built in parallel") {
+            std::vector<GCodePreview::LayerGeometry> parallel = layers;
+            std::vector<size_t> progress;
+            GCodePreview::build_layers_geometry(parallel, sid_to_mid, sid_to_seam_mids, result, [&progress](size_t built) { progress.emplace_back(built); });
+            THEN("the progress is reported in increasing steps up to all the layers") {
+                REQUIRE(! progress.empty());
+                REQUIRE(std::is_sorted(progress.begin(), progress.end()));
+                REQUIRE(progress.back() == parallel.size());
+            }
+            THEN("each layer is the one built alone") {
+                for (size_t i = 0; i < layers.size(); ++ i) {
+                    GCodePreview::LayerGeometry sequential = layers[i];
+                    GCodePreview::build_layer_geometry(sequential, sid_to_mid, sid_to_seam_mids, result);
+                    const GCodePreview::LayerGeometry &built = parallel[i];
+                    REQUIRE(built.has_custom_options == sequential.has_custom_options);
+                    REQUIRE(built.segment_vertices.size() == sequential.segment_vertices.size());
+                    for (size_t j = 0; j < built.segment_vertices.size(); ++ j) {
+                        REQUIRE(built.segment_vertices[j].m_move_id == sequential.segment_vertices[j].m_move_id);
+                        REQUIRE(built.segment_vertices[j].m_indices == sequential.segment_vertices[j].m_indices);
+                    }
+                    REQUIRE(built.segments.size() == sequential.segments.size());
+                    for (size_t j = 0; j < built.segments.size(); ++ j) {
+                        REQUIRE(built.segments[j].m_first_mid == sequential.segments[j].m_first_mid);
+                        REQUIRE(built.segments[j].m_second_mid == sequential.segments[j].m_second_mid);
+                        REQUIRE(built.segments[j].m_type == sequential.segments[j].m_type);
+                    }
+                    REQUIRE(built.position_data.size() == sequential.position_data.size());
+                    for (size_t j = 0; j < built.position_data.size(); ++ j) {
+                        REQUIRE(built.position_data[j].m_position == sequential.position_data[j].m_position);
+                        REQUIRE(built.position_data[j].m_segment_vertex_index == sequential.position_data[j].m_segment_vertex_index);
+                    }
+                }
+            }
+            THEN("the segments join the moves and the seams of a layer") {
+                const GCodePreview::LayerGeometry &layer = parallel[3];
+                // 7 moves, 1 seam, the arc has 3 interpolation points
+                REQUIRE(layer.segment_vertices.size() == 8);
+                REQUIRE(layer.position_data.size() == 11);
+                REQUIRE(layer.segments.size() == 7);
+                const auto seam = std::find_if(layer.segments.begin(), layer.segments.end(),
+                                               [](const GCodePreview::Segment &segment) { return segment.m_type == EMoveType::Seam; });
+                REQUIRE(seam != layer.segments.end());
+                REQUIRE(seam->m_first_mid == seam->m_second_mid);
+                REQUIRE(std::count_if(layer.segment_vertices.begin(), layer.segment_vertices.end(),
+                                      [](const GCodePreview::SegmentVertex &vertex) { return vertex.m_indices.size() == 4; }) == 1);
+            }
+            THEN("the wipes are lifted and the pause is flagged") {
+                const GCodePreview::LayerGeometry &layer = parallel[5];
+                REQUIRE(layer.position_data.back().m_position.z() == Approx(1.2f + 0.5f * GCodeProcessor::Wipe_Height));
+                for (size_t i = 0; i < layers.size(); ++ i)
+                    REQUIRE(parallel[i].has_custom_options == (i == 7));
+            }
+            THEN("a layer without moves is empty") {
+                REQUIRE(parallel.back().segment_vertices.empty());
+                REQUIRE(parallel.back().segments.empty());
+            }
+        }
+    }
+}
@@ -3,9 +3,13 @@
 #include "libslic3r/libslic3r.h"
 #include "libslic3r/Print.hpp"
 #include "libslic3r/Layer.hpp"
+#include "libslic3r/ThreadLocalCache.hpp"
+#include "libslic3r/Utils.hpp"
 
 #include "test_data.hpp"
 
+#include <tbb/parallel_invoke.h>
+
 using namespace Slic3r;
 using namespace Slic3r::Test;
 
@@ -126,3 +130,245 @@ SCENARIO("Print: Brim generation", "[Print]") {
         }
     }
 }
+
+SCENARIO("Print: Objects rotated around Z share their layers", "[Print]") {
+    GIVEN("L shaped object with a second instance rotated by 90 degrees") {
+        Slic3r::DynamicPrintConfig config = Slic3r::DynamicPrintConfig::full_print_config();
+        Slic3r::Print print;
+        Slic3r::Model model;
+        Slic3r::Test::init_print({TestMesh::L}, print, model, config);
+        ModelObject   *model_object = model.objects.front();
+        ModelInstance *instance     = model_object->add_instance(*model_object->instances.front());
+        instance->set_rotation(Vec3d(0., 0., 0.5 * PI));
+        instance->set_offset(instance->get_offset() + Vec3d(60., 0., 0.));
+        print.apply(model, config);
+        // The rotated instance alone, there is no other object to share the layers with.
+        Slic3r::Print print_rotated;
+        Slic3r::Model model_rotated;
+        model_rotated.add_object(*model_object)->delete_instance(0);
+        print_rotated.apply(model_rotated, config);
+        print_rotated.set_status_silent();
+        WHEN("the print is processed") {
+            print.process();
+            print_rotated.process();
+            THEN("the rotated object derives its layers from the other one") {
+                REQUIRE(print.objects().size() == 2);
+                const PrintObject &object1 = *print.objects().front();
+                const PrintObject &object2 = *print.objects().back();
+                REQUIRE(object2.get_shared_object() == &object1);
+                REQUIRE(object2.has_transformed_shared_layers());
+                REQUIRE(object2.layers().size() == object1.layers().size());
+                for (size_t layer_id = 0; layer_id < object1.layers().size(); ++ layer_id) {
+                    const Layer &layer1 = *object1.get_layer(int(layer_id));
+                    const Layer &layer2 = *object2.get_layer(int(layer_id));
+                    REQUIRE(layer2.object() == &object2);
+                    REQUIRE(layer2.print_z == layer1.print_z);
+                    REQUIRE(layer2.regions().front()->perimeters.items_count() == layer1.regions().front()->perimeters.items_count());
+                }
+            }
+            THEN("the derived layers match the layers of the rotated object sliced on its own") {
+                REQUIRE(print_rotated.objects().size() == 1);
+                const PrintObject &object  = *print.objects().back();
+                const PrintObject &sliced  = *print_rotated.objects().front();
+                REQUIRE(sliced.get_shared_object() == nullptr);
+                REQUIRE(object.layers().size() == sliced.layers().size());
+                // Only the rounding of the transformed and of the sliced coordinates differs.
+                static constexpr coord_t eps = 5;
+                auto require_extents_equal = [](const BoundingBox &bbox1, const BoundingBox &bbox2) {
+                    REQUIRE(std::abs(bbox1.min.x() - bbox2.min.x()) <= eps);
+                    REQUIRE(std::abs(bbox1.min.y() - bbox2.min.y()) <= eps);
+                    REQUIRE(std::abs(bbox1.max.x() - bbox2.max.x()) <= eps);
+                    REQUIRE(std::abs(bbox1.max.y() - bbox2.max.y()) <= eps);
+                };
+                for (size_t layer_id = 0; layer_id < sliced.layers().size(); ++ layer_id) {
+                    const Layer &layer        = *object.get_layer(int(layer_id));
+                    const Layer &layer_sliced = *sliced.get_layer(int(layer_id));
+                    REQUIRE(layer.print_z == layer_sliced.print_z);
+                    REQUIRE(layer.lslices.size() == layer_sliced.lslices.size());
+                    REQUIRE(std::abs(area(layer.lslices) - area(layer_sliced.lslices)) < scaled<double>(0.01) * scaled<double>(0.01));
+                    require_extents_equal(get_extents(layer.lslices), get_extents(layer_sliced.lslices));
+                    const ExtrusionEntityCollection &perimeters        = layer.regions().front()->perimeters;
+                    const ExtrusionEntityCollection &perimeters_sliced = layer_sliced.regions().front()->perimeters;
+                    REQUIRE(perimeters.items_count() == perimeters_sliced.items_count());
+                    Polylines polylines, polylines_sliced;
+                    perimeters.collect_polylines(polylines);
+                    perimeters_sliced.collect_polylines(polylines_sliced);
+                    REQUIRE(polylines.size() == polylines_sliced.size());
+                    require_extents_equal(get_extents(polylines), get_extents(polylines_sliced));
+                    size_t num_points = 0;
+                    for (const Polyline &polyline : polylines)
+                        num_points += polyline.size();
+                    REQUIRE(std::abs(total_length(polylines) - total_length(polylines_sliced)) <= double(2 * eps) * double(num_points));
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("PrintObject: Cached Arachne walls are the generated ones", "[PrintObject]") {
+    GIVEN("Prismatic objects with holes and Arachne walls") {
+        Slic3r::DynamicPrintConfig config = Slic3r::DynamicPrintConfig::full_print_config();
+        config.set_deserialize_strict({
+            { "wall_generator", "arachne" },
+            { "wall_loops",     3 }
+        });
+        WHEN("the objects are sliced with and without the thread local caches") {
+            Slic3r::Print print_cached;
+            Slic3r::Print print_computed;
+            Slic3r::Test::init_and_process_print({TestMesh::two_hollow_squares, TestMesh::gt2_teeth}, print_cached, config);
+            {
+                ThreadLocalCache::set_enabled(false);
+                ScopeGuard enable_caches([]() { ThreadLocalCache::set_enabled(true); });
+                Slic3r::Test::init_and_process_print({TestMesh::two_hollow_squares, TestMesh::gt2_teeth}, print_computed, config);
+            }
+            THEN("the walls and the fill surfaces are identical") {
+                REQUIRE(print_cached.objects().size() == print_computed.objects().size());
+                for (size_t object_id = 0; object_id < print_cached.objects().size(); ++ object_id) {
+                    const PrintObject &object_cached   = *print_cached.objects()[object_id];
+                    const PrintObject &object_computed = *print_computed.objects()[object_id];
+                    REQUIRE(object_cached.layers().size() == object_computed.layers().size());
+                    for (size_t layer_id = 0; layer_id < object_cached.layers().size(); ++ layer_id) {
+                        const Layer &layer_cached   = *object_cached.get_layer(int(layer_id));
+                        const Layer &layer_computed = *object_computed.get_layer(int(layer_id));
+                        REQUIRE(layer_cached.regions().size() == layer_computed.regions().size());
+                        for (size_t region_id = 0; region_id < layer_cached.regions().size(); ++ region_id) {
+                            const LayerRegion &layerm_cached   = *layer_cached.regions()[region_id];
+                            const LayerRegion &layerm_computed = *layer_computed.regions()[region_id];
+                            const ExtrusionPaths paths_cached   = extrusion_paths(layerm_cached.perimeters);
+                            const ExtrusionPaths paths_computed = extrusion_paths(layerm_computed.perimeters);
+                            REQUIRE(! paths_cached.empty());
+                            REQUIRE(paths_cached.size() == paths_computed.size());
+                            for (size_t path_id = 0; path_id < paths_cached.size(); ++ path_id) {
+                                const ExtrusionPath &path_cached   = paths_cached[path_id];
+                                const ExtrusionPath &path_computed = paths_computed[path_id];
+                                REQUIRE(path_cached.role() == path_computed.role());
+                                REQUIRE(path_cached.polyline.points == path_computed.polyline.points);
+                                REQUIRE(path_cached.width == path_computed.width);
+                                REQUIRE(path_cached.mm3_per_mm == path_computed.mm3_per_mm);
+                            }
+                            REQUIRE(layerm_cached.fill_surfaces.surfaces.size() == layerm_computed.fill_surfaces.surfaces.size());
+                            for (size_t surface_id = 0; surface_id < layerm_cached.fill_surfaces.surfaces.size(); ++ surface_id) {
+                                const Surface &surface_cached   = layerm_cached.fill_surfaces.surfaces[surface_id];
+                                const Surface &surface_computed = layerm_computed.fill_surfaces.surfaces[surface_id];
+                                REQUIRE(surface_cached.surface_type == surface_computed.surface_type);
+                                REQUIRE(surface_cached.expolygon == surface_computed.expolygon);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Requires the walls and the infill of both prints to be identical, layer by layer.
+static void require_same_extrusions(const Print &print, const Print &reference)
+{
+    REQUIRE(print.objects().size() == reference.objects().size());
+    for (size_t object_id = 0; object_id < print.objects().size(); ++ object_id) {
+        const PrintObject &object           = *print.objects()[object_id];
+        const PrintObject &object_reference = *reference.objects()[object_id];
+        REQUIRE(object.layers().size() == object_reference.layers().size());
+        for (size_t layer_id = 0; layer_id < object.layers().size(); ++ layer_id) {
+            const Layer &layer           = *object.get_layer(int(layer_id));
+            const Layer &layer_reference = *object_reference.get_layer(int(layer_id));
+            REQUIRE(layer.regions().size() == layer_reference.regions().size());
+            for (size_t region_id = 0; region_id < layer.regions().size(); ++ region_id) {
+                const LayerRegion &layerm           = *layer.regions()[region_id];
+                const LayerRegion &layerm_reference = *layer_reference.regions()[region_id];
+                for (auto [collection, collection_reference] : { std::make_pair(&layerm.perimeters, &layerm_reference.perimeters),
+                                                                 std::make_pair(&layerm.fills, &layerm_reference.fills) }) {
+                    const ExtrusionPaths paths           = extrusion_paths(*collection);
+                    const ExtrusionPaths paths_reference = extrusion_paths(*collection_reference);
+                    REQUIRE(paths.size() == paths_reference.size());
+                    for (size_t path_id = 0; path_id < paths.size(); ++ path_id) {
+                        REQUIRE(paths[path_id].role() == paths_reference[path_id].role());
+                        REQUIRE(paths[path_id].polyline.points == paths_reference[path_id].polyline.points);
+                        REQUIRE(paths[path_id].width == paths_reference[path_id].width);
+                        REQUIRE(paths[path_id].mm3_per_mm == paths_reference[path_id].mm3_per_mm);
+                    }
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("Print: Plates processed at once share the thread local caches", "[Print]") {
+    GIVEN("A plate with Arachne walls and a plate with rectilinear infill") {
+        Slic3r::DynamicPrintConfig config_walls = Slic3r::DynamicPrintConfig::full_print_config();
+        config_walls.set_deserialize_strict({
+            { "wall_generator", "arachne" },
+            { "wall_loops",     3 }
+        });
+        Slic3r::DynamicPrintConfig config_infill = Slic3r::DynamicPrintConfig::full_print_config();
+        config_infill.set_deserialize_strict({
+            { "sparse_infill_pattern", "zig-zag" },
+            { "sparse_infill_density", "20%" }
+        });
+        Slic3r::Print reference_walls, reference_infill;
+        Slic3r::Test::init_and_process_print({TestMesh::two_hollow_squares, TestMesh::gt2_teeth}, reference_walls, config_walls);
+        Slic3r::Test::init_and_process_print({TestMesh::cube_20x20x20}, reference_infill, config_infill);
+        WHEN("both plates are processed at once, several times") {
+            THEN("each plate gets the walls and the infill of the plate processed alone") {
+                for (int run = 0; run < 4; ++ run) {
+                    // The plates are applied one by one and processed at once, as by the command line with --parallel_plates.
+                    Slic3r::Print print_walls, print_infill;
+                    Slic3r::Model model_walls, model_infill;
+                    Slic3r::Test::init_print({TestMesh::two_hollow_squares, TestMesh::gt2_teeth}, print_walls, model_walls, config_walls);
+                    Slic3r::Test::init_print({TestMesh::cube_20x20x20}, print_infill, model_infill, config_infill);
+                    tbb::parallel_invoke([&print_walls]() { print_walls.process(); }, [&print_infill]() { print_infill.process(); });
+                    require_same_extrusions(print_walls, reference_walls);
+                    require_same_extrusions(print_infill, reference_infill);
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("Print: Custom G-codes of plates processed at once", "[Print]") {
+    GIVEN("Two cubes with a pause at a different height") {
+        Slic3r::DynamicPrintConfig config = Slic3r::DynamicPrintConfig::full_print_config();
+        config.set_deserialize_strict({
+            { "layer_height",               0.2 },
+            { "initial_layer_print_height", 0.2 }
+        });
+        auto init_print_with_pause = [&config](Slic3r::Print &print, Slic3r::Model &model, double pause_z) {
+            CustomGCode::Info &custom_gcodes = model.plates_custom_gcodes[model.curr_plate_index];
+            custom_gcodes.mode = CustomGCode::SingleExtruder;
+            custom_gcodes.gcodes.push_back({ pause_z, CustomGCode::PausePrint, 1, "", "" });
+            Slic3r::Test::init_print({TestMesh::cube_20x20x20}, print, model, config);
+            print.process();
+        };
+        Slic3r::Print print_low, print_high;
+        Slic3r::Model model_low, model_high;
+        init_print_with_pause(print_low,  model_low,  5.);
+        init_print_with_pause(print_high, model_high, 10.);
+        WHEN("the custom G-codes are assigned to the tool ordering of both prints") {
+            ToolOrdering ordering_low  = print_low.tool_ordering();
+            ToolOrdering ordering_high = print_high.tool_ordering();
+            ordering_low.assign_custom_gcodes(print_low);
+            ordering_high.assign_custom_gcodes(print_high);
+            // A copy keeps the custom G-codes, which the layers point to.
+            ToolOrdering ordering_low_copy = ordering_low;
+            ordering_low = ToolOrdering();
+            THEN("each tool ordering pauses at the height of its own plate only") {
+                auto pauses = [](const ToolOrdering &ordering) {
+                    std::vector<double> pauses_z;
+                    for (const LayerTools &layer_tools : ordering.layer_tools())
+                        if (layer_tools.custom_gcode != nullptr) {
+                            REQUIRE(layer_tools.custom_gcode->type == CustomGCode::PausePrint);
+                            REQUIRE(layer_tools.custom_gcode->print_z == Approx(layer_tools.print_z));
+                            pauses_z.emplace_back(layer_tools.print_z);
+                        }
+                    return pauses_z;
+                };
+                const std::vector<double> pauses_low  = pauses(ordering_low_copy);
+                const std::vector<double> pauses_high = pauses(ordering_high);
+                REQUIRE(pauses_low.size() == 1);
+                REQUIRE(pauses_low.front() == Approx(5.));
+                REQUIRE(pauses_high.size() == 1);
+                REQUIRE(pauses_high.front() == Approx(10.));
+            }
+        }
+    }
+}
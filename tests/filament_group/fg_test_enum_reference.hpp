@@ -0,0 +1,169 @@
+#ifndef FG_TEST_ENUM_REFERENCE_HPP
+#define FG_TEST_ENUM_REFERENCE_HPP
+
+#include <libslic3r/FilamentGroup.hpp>
+#include <libslic3r/FilamentGroupUtils.hpp>
+#include <libslic3r/GCode/ToolOrderUtils.hpp>
+#include <libslic3r/MultiNozzleUtils.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace Slic3r {
+
+// Access to the private search of FilamentGroup.
+struct FilamentGroupTestAccess {
+    static std::vector<int> calc_min_flush_group(FilamentGroup& fg, int* cost) { return fg.calc_min_flush_group(cost); }
+
+    static std::unordered_map<int, std::vector<int>> unplaceable_limits(FilamentGroup& fg, const std::vector<unsigned int>& used_filaments) {
+        std::unordered_map<int, std::vector<int>> limits;
+        FilamentGroupUtils::extract_unprintable_limit_indices(fg.ctx.model_info.unprintable_filaments, used_filaments, limits);
+        return fg.rebuild_nozzle_unprintables(used_filaments, limits, fg.ctx.group_info.filament_volume_map);
+    }
+};
+
+namespace FGTest {
+
+// Rewards of the prefer level of a group, as in FilamentGroup.cpp.
+static constexpr int REF_UNPLACEABLE_LIMIT_REWARD = 10000;
+static constexpr int REF_MAX_SIZE_LIMIT_REWARD    = 5000;
+static constexpr int REF_SUPPORT_PREFER_REWARD    = 100;
+static constexpr int REF_BEST_FIT_LIMIT_REWARD    = 10;
+
+// Score of a group as evaluated by the search: the flush converted to time plus the filament change and print times.
+inline double reference_group_score(const FilamentGroupContext& ctx, const std::vector<unsigned int>& used_filaments,
+                                    const std::vector<int>& filament_map, int* flush) {
+    *flush = 0;
+    auto group_res = MultiNozzleUtils::LayeredNozzleGroupResult::create(filament_map, ctx.nozzle_info.nozzle_list, used_filaments);
+    if (!group_res)
+        return 0.0;
+
+    MultiNozzleUtils::NozzleStatusRecorder initial_status;
+    for (auto& [nozzle_id, filament_id] : ctx.nozzle_info.nozzle_status) {
+        if (filament_id >= 0) {
+            int extruder_id = 0;
+            for (const auto& nozzle : ctx.nozzle_info.nozzle_list) {
+                if (nozzle.group_id == nozzle_id) { extruder_id = nozzle.extruder_id; break; }
+            }
+            initial_status.set_nozzle_status(nozzle_id, filament_id, extruder_id);
+        }
+    }
+
+    std::vector<std::vector<unsigned int>> filament_sequences;
+    *flush = reorder_filaments_for_multi_nozzle_extruder(used_filaments, *group_res, ctx.model_info.layer_filaments,
+        ctx.model_info.flush_matrix, std::function<bool(int, std::vector<int>&)>{}, &filament_sequences, initial_status);
+
+    double change_time = 0.0;
+    if (!filament_sequences.empty()) {
+        std::vector<int> filament_change_seq;
+        std::vector<int> nozzle_change_seq;
+        int prev_fil = -1, prev_nozzle = -1;
+        for (const auto& layer_seq : filament_sequences) {
+            for (unsigned int fil : layer_seq) {
+                auto nozzle_info = group_res->get_first_nozzle_for_filament(fil);
+                if (!nozzle_info) continue;
+                int nid = nozzle_info->group_id;
+                if ((int)fil == prev_fil && nid == prev_nozzle) continue;
+                filament_change_seq.push_back((int)fil);
+                nozzle_change_seq.push_back(nid);
+                prev_fil = (int)fil;
+                prev_nozzle = nid;
+            }
+        }
+        std::vector<int> logical_filaments(used_filaments.begin(), used_filaments.end());
+        std::vector<int> group_of_filament(used_filaments.size(), 0);
+        for (size_t fi = 0; fi < used_filaments.size(); ++fi) {
+            int nid = filament_map[used_filaments[fi]];
+            if (nid >= 0 && nid < (int)ctx.nozzle_info.nozzle_list.size())
+                group_of_filament[fi] = ctx.nozzle_info.nozzle_list[nid].extruder_id;
+        }
+        change_time = MultiNozzleUtils::simulate_filament_change_time(logical_filaments, ctx.nozzle_info.nozzle_list, filament_change_seq,
+            nozzle_change_seq, group_of_filament, ctx.speed_info.change_time_params, ctx.speed_info.ams_preload_enabled).actual_time;
+    }
+
+    double print_time = 0.0;
+    if (ctx.speed_info.group_with_time)
+        print_time = TimeEvaluator(ctx.speed_info).get_estimated_time(filament_map);
+
+    // flush converted to seconds as evaluate_score() does: density 1.26 g/cm^3, 180 s/g, correction factor 2
+    double flush_score = *flush * 1.26 * 180 * 2 / 1000;
+    return flush_score + change_time + print_time;
+}
+
+// Reference for FilamentGroup::calc_min_flush_group(): evaluates every group of the used filaments in the order of counting up
+// a base-k number and keeps the first one of the highest prefer level and of the lowest score. Only usable for a few filaments.
+inline std::vector<int> calc_min_flush_group_by_enum(const FilamentGroupContext& ctx, int* cost) {
+    FilamentGroup fg(ctx);
+    const std::vector<unsigned int> used_filaments = collect_sorted_used_filaments(ctx.model_info.layer_filaments);
+    const std::unordered_map<int, std::vector<int>> unplaceable_limits = FilamentGroupTestAccess::unplaceable_limits(fg, used_filaments);
+    const int n = (int)used_filaments.size();
+    const int k = (int)ctx.nozzle_info.nozzle_list.size();
+
+    std::vector<int> best_map(ctx.group_info.total_filament_num, ctx.machine_info.master_extruder_id);
+    double best_score = std::numeric_limits<double>::max();
+    int best_prefer_level = 0;
+    int best_flush = 0;
+
+    const long long total = (long long)std::pow(k, n);
+    for (long long mask = 0; mask < total; ++mask) {
+        std::vector<int> labels(n);
+        std::vector<int> groups_count(k, 0);
+        long long num = mask;
+        for (int i = 0; i < n; ++i) {
+            labels[i] = int(num % k);
+            num /= k;
+            ++groups_count[labels[i]];
+        }
+
+        int prefer_level = 0;
+        for (int i = 0; i < n; ++i) {
+            auto it = unplaceable_limits.find(i);
+            if (it == unplaceable_limits.end() || std::find(it->second.begin(), it->second.end(), labels[i]) == it->second.end())
+                prefer_level += REF_UNPLACEABLE_LIMIT_REWARD;
+        }
+        bool size_ok = true;
+        bool all_full = true;
+        for (int g = 0; g < k && g < (int)ctx.machine_info.max_group_size.size(); ++g) {
+            size_ok &= groups_count[g] <= ctx.machine_info.max_group_size[g];
+            all_full &= groups_count[g] >= ctx.machine_info.max_group_size[g];
+        }
+        if (size_ok)
+            prefer_level += REF_MAX_SIZE_LIMIT_REWARD;
+        if (ctx.group_info.strategy == FGStrategy::BestFit && all_full)
+            prefer_level += REF_BEST_FIT_LIMIT_REWARD;
+        for (int i = 0; i < n; ++i) {
+            int g = labels[i];
+            if (g < (int)ctx.machine_info.prefer_non_model_filament.size() && ctx.machine_info.prefer_non_model_filament[g] &&
+                ctx.model_info.filament_info[used_filaments[i]].usage_type == SupportOnly)
+                prefer_level += REF_SUPPORT_PREFER_REWARD;
+        }
+
+        std::vector<int> filament_map(ctx.group_info.total_filament_num, ctx.machine_info.master_extruder_id);
+        for (int i = 0; i < n; ++i)
+            filament_map[used_filaments[i]] = labels[i];
+        int flush = 0;
+        double score = reference_group_score(ctx, used_filaments, filament_map, &flush);
+        int master_ex_id = ctx.machine_info.master_extruder_id;
+        if (master_ex_id < k && groups_count[master_ex_id] < (n + 1) / 2)
+            score += ABSOLUTE_FLUSH_GAP_TOLERANCE;
+
+        if (prefer_level > best_prefer_level || (prefer_level == best_prefer_level && score < best_score)) {
+            best_prefer_level = prefer_level;
+            best_score = score;
+            best_map = filament_map;
+            best_flush = flush;
+        }
+    }
+
+    if (cost) *cost = best_flush;
+    return best_map;
+}
+
+} // namespace FGTest
+} // namespace Slic3r
+
+#endif // FG_TEST_ENUM_REFERENCE_HPP
@@ -3,6 +3,7 @@
 #include "fg_test_serialization.hpp"
 #include "fg_test_evaluator.hpp"
 #include "fg_test_utils.hpp"
+#include "fg_test_enum_reference.hpp"
 
 #include <filesystem>
 #include <iostream>
@@ -272,6 +273,41 @@ TEST_CASE("FilamentGroup property checks", "[filament_group][property]") {
     }
 }
 
+// ============ Layer 3: Exact Search ============
+
+// The branch and bound search behind calc_min_flush_group has to find the same group as the plain enumeration
+// of every group in fg_test_enum_reference.hpp, including the tie breaking between groups of the same score.
+TEST_CASE("FilamentGroup branch and bound matches enumeration", "[filament_group][property]") {
+    struct ExactSpec { std::string config; int seed; int num_filaments; bool with_constraints; FGStrategy strategy; };
+    std::vector<ExactSpec> specs;
+    for (int i = 0; i < 4; ++i) {
+        specs.push_back({"A", 93000 + i, 3 + i, false, FGStrategy::BestCost});
+        specs.push_back({"B", 93100 + i, 2 + i % 3, i % 2 == 1, FGStrategy::BestCost});
+        specs.push_back({"C", 93200 + i, 2 + i % 3, i % 2 == 1, FGStrategy::BestCost});
+    }
+    specs.push_back({"A", 93300, 5, true, FGStrategy::BestFit});
+    specs.push_back({"B", 93301, 4, false, FGStrategy::BestFit});
+
+    auto spec = GENERATE_REF(from_range(specs));
+
+    DYNAMIC_SECTION("Exact: " << spec.config << "_" << spec.seed) {
+        auto tc = build_test_case("exact_" + std::to_string(spec.seed), spec.config, spec.seed,
+                                  spec.num_filaments, 200, false, spec.with_constraints,
+                                  FGMode::FlushMode, spec.strategy, false);
+
+        int enum_cost = 0;
+        int search_cost = 0;
+        std::vector<int> enum_map = FGTest::calc_min_flush_group_by_enum(tc.context, &enum_cost);
+        FilamentGroup fg(tc.context);
+        std::vector<int> search_map = FilamentGroupTestAccess::calc_min_flush_group(fg, &search_cost);
+
+        INFO("Enumeration flush: " << enum_cost);
+        INFO("Search flush: " << search_cost);
+        REQUIRE(search_cost == enum_cost);
+        REQUIRE(search_map == enum_map);
+    }
+}
+
 // ============ Golden Update Utility ============
 
 TEST_CASE("FilamentGroup update golden", "[filament_group][update-golden][.]") {
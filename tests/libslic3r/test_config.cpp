@@ -274,3 +274,24 @@ SCENARIO("get_real_skirt_dist calculates the correct boundary including loop wid
         }
     }
 }
+
+SCENARIO("ConfigDigest diff matches ConfigBase diff", "[Config]") {
+    GIVEN("A full print config and a static object config") {
+        DynamicPrintConfig config = DynamicPrintConfig::full_print_config();
+        PrintObjectConfig  object_config;
+        object_config.apply(config, true);
+        WHEN("Some object and print options are modified") {
+            config.set_deserialize_strict({ { "layer_height", "0.12" }, { "sparse_infill_density", "40%" }, { "machine_start_gcode", "G28 ; home" } });
+            const ConfigDigest digest(config);
+            THEN("The object config digest reports the same changes as ConfigBase::diff") {
+                REQUIRE(ConfigDigest(object_config).diff(digest) == object_config.diff(config));
+                REQUIRE(! ConfigDigest(object_config).diff(digest).empty());
+            }
+            THEN("The full config digest reports the modified options only") {
+                DynamicPrintConfig old_config = DynamicPrintConfig::full_print_config();
+                REQUIRE(ConfigDigest(old_config).diff(digest) == old_config.diff(config));
+                REQUIRE(ConfigDigest(old_config).diff(digest).size() == 3);
+            }
+        }
+    }
+}
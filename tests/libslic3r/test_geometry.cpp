@@ -10,6 +10,7 @@
 #include "libslic3r/Geometry/ConvexHull.hpp"
 #include "libslic3r/ClipperUtils.hpp"
 #include "libslic3r/ShortestPath.hpp"
+#include "libslic3r/ArcFitter.hpp"
 
 //#include <random>
 //#include "libnest2d/tools/benchmark.h"
@@ -708,3 +709,32 @@ TEST_CASE("Convex polygon intersection test prusa polygons", "[Geometry][Rotcali
         REQUIRE(res == ref);
     }
 }
+
+TEST_CASE("Arc fitting", "[Geometry][ArcFitter]") {
+    std::vector<PathFittingData> result;
+
+    SECTION("points sampled on a quarter of a circle are fitted by a single arc") {
+        const double radius = scale_(10.);
+        Points points;
+        for (size_t i = 0; i <= 60; ++ i) {
+            double angle = M_PI * double(i) / 120.;
+            points.emplace_back(coord_t(radius * cos(angle)), coord_t(radius * sin(angle)));
+        }
+        ArcFitter::do_arc_fitting_and_simplify(points, result, scale_(0.01));
+        REQUIRE(result.size() == 1);
+        CHECK(result.front().path_type == EMovePathType::Arc_move_ccw);
+        CHECK(result.front().start_point_index == 0);
+        CHECK(result.front().end_point_index == points.size() - 1);
+        CHECK(result.front().arc_data.radius == Approx(radius).epsilon(0.01));
+    }
+
+    SECTION("points on a straight line are simplified to a single linear move") {
+        Points points;
+        for (coord_t i = 0; i < 20; ++ i)
+            points.emplace_back(i * scale_(1.), i * scale_(0.5));
+        ArcFitter::do_arc_fitting_and_simplify(points, result, scale_(0.01));
+        REQUIRE(result.size() == 1);
+        CHECK(result.front().is_linear_move());
+        CHECK(points.size() == 2);
+    }
+}
@@ -291,6 +291,26 @@ bool exist_triangle_with_twice_vertices(const std::vector<stl_triangle_vertex_in
     return false;
 }
 
+TEST_CASE("Simplify mesh in partitions by Quadric edge collapse to 5%", "[its]")
+{
+    TriangleMesh mesh = load_model("frog_legs.obj");
+    uint32_t wanted_count = mesh.its.indices.size() * 0.05;
+    REQUIRE_FALSE(mesh.empty());
+    indexed_triangle_set its = mesh.its; // copy
+    float max_error = std::numeric_limits<float>::max();
+    // tiny memory budget splits the mesh into the smallest partitions
+    its_quadric_edge_collapse_partitioned(its, wanted_count, &max_error, nullptr, nullptr, 1);
+    CHECK(its.indices.size() <= wanted_count);
+    CHECK(!exist_triangle_with_twice_vertices(its.indices));
+
+    CompareConfig cfg;
+    cfg.max_average_distance = 0.043f;
+    cfg.max_distance         = 0.32f;
+
+    CHECK(is_similar(mesh.its, its, cfg));
+    CHECK(is_similar(its, mesh.its, cfg));
+}
+
 TEST_CASE("Simplify trouble case", "[its]")
 {
     TriangleMesh tm = load_model("simplification.obj");
@@ -309,3 +329,53 @@ TEST_CASE("Simplified cube should not be empty.", "[its]")
     its_quadric_edge_collapse(its, wanted_count, &max_error);
     CHECK(!its.indices.empty());
 }
+
+TEST_CASE("Cached mesh topology", "[its]")
+{
+    TriangleMesh mesh(its_make_cube(10., 10., 10.));
+
+    auto neighbors = mesh.face_neighbors();
+    auto edge_ids  = mesh.face_edge_ids();
+    auto normals   = mesh.face_normals();
+    CHECK(*neighbors == its_face_neighbors(mesh.its));
+    CHECK(*edge_ids == its_face_edge_ids(mesh.its));
+    CHECK(*normals == its_face_normals(mesh.its));
+
+    SECTION("Topology is calculated once and shared by copies") {
+        CHECK(mesh.face_edge_ids() == edge_ids);
+        TriangleMesh copy = mesh;
+        CHECK(copy.face_neighbors() == neighbors);
+    }
+
+    SECTION("Modifying the mesh invalidates the topology") {
+        mesh.rotate_x(float(M_PI / 4.));
+        CHECK(*mesh.face_normals() == its_face_normals(mesh.its));
+        CHECK(*normals != *mesh.face_normals());
+    }
+
+    SECTION("Modifying the mesh data directly and invalidating the topology") {
+        its_flip_triangles(mesh.its);
+        mesh.invalidate_topology();
+        CHECK(*mesh.face_neighbors() == its_face_neighbors(mesh.its));
+        CHECK(*mesh.face_normals() == its_face_normals(mesh.its));
+        CHECK(*normals != *mesh.face_normals());
+    }
+
+    SECTION("Moving a vertex directly updates the normals once the topology is invalidated") {
+        TriangleMesh copy = mesh;
+        copy.its.vertices[0] += Vec3f(-3.f, -2.f, -1.f);
+        // the counts did not change, the cache is only detached by invalidate_topology()
+        CHECK(copy.face_normals() == normals);
+        copy.invalidate_topology();
+        CHECK(*copy.face_normals() == its_face_normals(copy.its));
+        CHECK(*copy.face_normals() != *normals);
+        CHECK(mesh.face_normals() == normals);
+    }
+
+    SECTION("Resizing the mesh data directly is detected") {
+        its_merge(mesh.its, its_make_cube(1., 1., 1.));
+        CHECK(*mesh.face_neighbors() == its_face_neighbors(mesh.its));
+        CHECK(*mesh.face_edge_ids() == its_face_edge_ids(mesh.its));
+        CHECK(mesh.face_normals()->size() == mesh.its.indices.size());
+    }
+}
@@ -3,6 +3,8 @@
 
 #include <libslic3r/TriangleMesh.hpp>
 #include <libslic3r/MeshBoolean.hpp>
+#include <libslic3r/CSGMesh/CSGMesh.hpp>
+#include <libslic3r/CSGMesh/PerformCSGMeshBooleans.hpp>
 
 using namespace Slic3r;
 
@@ -23,3 +25,141 @@ TEST_CASE("CGAL and TriangleMesh conversions", "[MeshBoolean]") {
     
     REQUIRE(! MeshBoolean::cgal::does_self_intersect(M));
 }
+
+namespace {
+
+using MeshBoolean::cgal::CGALMeshPtr;
+
+// The parts of the CSG tests are cubes of the given size moved to the given position.
+csg::CSGPart csg_cube(const indexed_triangle_set *cube, const Vec3f &pos, csg::CSGType op,
+                      csg::CSGStackOp stack_op = csg::CSGStackOp::Continue)
+{
+    Transform3f tr = Transform3f::Identity();
+    tr.translate(pos);
+    csg::CSGPart part{ cube, op, tr };
+    part.stack_operation = stack_op;
+    return part;
+}
+
+// The parts applied one by one on a stack of frames, as the CSG booleans were evaluated before they were parsed into a tree.
+CGALMeshPtr perform_csgmesh_booleans_sequentially(const std::vector<csg::CSGPart> &parts)
+{
+    struct Frame {
+        csg::CSGType op;
+        CGALMeshPtr  cgalptr;
+    };
+    std::vector<Frame> opstack;
+    opstack.push_back({ csg::CSGType::Union, MeshBoolean::cgal::triangle_mesh_to_cgal(indexed_triangle_set{}) });
+
+    for (const csg::CSGPart &part : parts) {
+        CGALMeshPtr cgalptr = csg::get_cgalmesh(part);
+        if (part.stack_operation == csg::CSGStackOp::Push)
+            opstack.push_back({ part.operation, MeshBoolean::cgal::triangle_mesh_to_cgal(indexed_triangle_set{}) });
+
+        csg::detail_cgal::perform_csg(part.operation, opstack.back().cgalptr, cgalptr);
+
+        if (part.stack_operation == csg::CSGStackOp::Pop) {
+            Frame top = std::move(opstack.back());
+            opstack.pop_back();
+            csg::detail_cgal::perform_csg(top.op, opstack.back().cgalptr, top.cgalptr);
+        }
+    }
+    return std::move(opstack.front().cgalptr);
+}
+
+// The tree evaluation and the sequential one produce the same solid.
+TriangleMesh require_same_csg_result(const std::vector<csg::CSGPart> &parts)
+{
+    CGALMeshPtr tree;
+    csg::perform_csgmesh_booleans_cgal(tree, Range{ parts.begin(), parts.end() });
+    CGALMeshPtr sequential = perform_csgmesh_booleans_sequentially(parts);
+    REQUIRE(tree);
+    REQUIRE(sequential);
+
+    TriangleMesh tree_mesh       = MeshBoolean::cgal::cgal_to_triangle_mesh(*tree);
+    TriangleMesh sequential_mesh = MeshBoolean::cgal::cgal_to_triangle_mesh(*sequential);
+    REQUIRE(tree_mesh.its.indices.empty() == sequential_mesh.its.indices.empty());
+    REQUIRE(tree_mesh.volume() == Approx(sequential_mesh.volume()));
+    if (! tree_mesh.its.indices.empty()) {
+        BoundingBoxf3 tree_bbox       = tree_mesh.bounding_box();
+        BoundingBoxf3 sequential_bbox = sequential_mesh.bounding_box();
+        REQUIRE(tree_bbox.min.isApprox(sequential_bbox.min));
+        REQUIRE(tree_bbox.max.isApprox(sequential_bbox.max));
+    }
+    return tree_mesh;
+}
+
+} // namespace
+
+TEST_CASE("CSG parts evaluated as a tree equal the sequential evaluation", "[MeshBoolean]") {
+    const indexed_triangle_set cube       = its_make_cube(10., 10., 10.);
+    const indexed_triangle_set small_cube = its_make_cube(4., 4., 4.);
+    std::vector<csg::CSGPart> parts;
+
+    SECTION("Union of disjoint parts") {
+        parts.emplace_back(csg_cube(&cube, { 0.f, 0.f, 0.f }, csg::CSGType::Union));
+        parts.emplace_back(csg_cube(&cube, { 20.f, 0.f, 0.f }, csg::CSGType::Union));
+        parts.emplace_back(csg_cube(&cube, { 40.f, 0.f, 0.f }, csg::CSGType::Union));
+        parts.emplace_back(csg_cube(&cube, { 0.f, 20.f, 0.f }, csg::CSGType::Union));
+        TriangleMesh result = require_same_csg_result(parts);
+        REQUIRE(result.volume() == Approx(4000.));
+    }
+
+    SECTION("Union of overlapping and disjoint parts") {
+        parts.emplace_back(csg_cube(&cube, { 0.f, 0.f, 0.f }, csg::CSGType::Union));
+        parts.emplace_back(csg_cube(&cube, { 5.f, 0.f, 0.f }, csg::CSGType::Union));
+        parts.emplace_back(csg_cube(&cube, { 40.f, 0.f, 0.f }, csg::CSGType::Union));
+        TriangleMesh result = require_same_csg_result(parts);
+        REQUIRE(result.volume() == Approx(2500.));
+    }
+
+    SECTION("Subtractor outside of the minuend overlapping another subtractor") {
+        parts.emplace_back(csg_cube(&cube, { 0.f, 0.f, 0.f }, csg::CSGType::Union));
+        // cuts 2 x 4 x 4 out of the cube
+        parts.emplace_back(csg_cube(&small_cube, { 8.f, 3.f, 3.f }, csg::CSGType::Difference));
+        // outside of the cube, overlaps the previous subtractor
+        parts.emplace_back(csg_cube(&small_cube, { 11.f, 3.f, 3.f }, csg::CSGType::Difference));
+        // far away from everything
+        parts.emplace_back(csg_cube(&small_cube, { 50.f, 0.f, 0.f }, csg::CSGType::Difference));
+        // cuts a corner of 2 x 2 x 2
+        parts.emplace_back(csg_cube(&small_cube, { -2.f, -2.f, -2.f }, csg::CSGType::Difference));
+        TriangleMesh result = require_same_csg_result(parts);
+        REQUIRE(result.volume() == Approx(1000. - 32. - 8.));
+    }
+
+    SECTION("Intersection with an overlapping part") {
+        parts.emplace_back(csg_cube(&cube, { 0.f, 0.f, 0.f }, csg::CSGType::Union));
+        parts.emplace_back(csg_cube(&cube, { 5.f, 5.f, 0.f }, csg::CSGType::Intersection));
+        TriangleMesh result = require_same_csg_result(parts);
+        REQUIRE(result.volume() == Approx(250.));
+    }
+
+    SECTION("Intersection with a disjoint part") {
+        parts.emplace_back(csg_cube(&cube, { 0.f, 0.f, 0.f }, csg::CSGType::Union));
+        parts.emplace_back(csg_cube(&cube, { 5.f, 5.f, 0.f }, csg::CSGType::Intersection));
+        parts.emplace_back(csg_cube(&cube, { 30.f, 0.f, 0.f }, csg::CSGType::Intersection));
+        TriangleMesh result = require_same_csg_result(parts);
+        REQUIRE(result.its.indices.empty());
+    }
+
+    SECTION("Nested groups") {
+        parts.emplace_back(csg_cube(&cube, { 0.f, 0.f, 0.f }, csg::CSGType::Union));
+        parts.emplace_back(csg_cube(&cube, { 20.f, 0.f, 0.f }, csg::CSGType::Union));
+        // subtracted group: the union of two small cubes cut by the intersection of two others
+        parts.emplace_back(csg::CSGPart{ nullptr, csg::CSGType::Difference });
+        parts.back().stack_operation = csg::CSGStackOp::Push;
+        parts.emplace_back(csg_cube(&small_cube, { 3.f, 3.f, 8.f }, csg::CSGType::Union));
+        parts.emplace_back(csg_cube(&small_cube, { 23.f, 3.f, 8.f }, csg::CSGType::Union));
+        parts.emplace_back(csg::CSGPart{ nullptr, csg::CSGType::Difference });
+        parts.back().stack_operation = csg::CSGStackOp::Push;
+        parts.emplace_back(csg_cube(&cube, { 0.f, 0.f, 10.f }, csg::CSGType::Union));
+        parts.emplace_back(csg_cube(&cube, { 0.f, 0.f, 11.f }, csg::CSGType::Intersection, csg::CSGStackOp::Pop));
+        parts.emplace_back(csg::CSGPart{ nullptr, csg::CSGType::Union });
+        parts.back().stack_operation = csg::CSGStackOp::Pop;
+        // added after the groups
+        parts.emplace_back(csg_cube(&cube, { 0.f, 20.f, 0.f }, csg::CSGType::Union));
+        TriangleMesh result = require_same_csg_result(parts);
+        // the inner group trims the first small cube above z = 11, then each small cube cuts 4 x 4 x 2 out of its cube
+        REQUIRE(result.volume() == Approx(3000. - 32. - 32.));
+    }
+}
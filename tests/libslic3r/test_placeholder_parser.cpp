@@ -33,6 +33,13 @@ SCENARIO("Placeholder parser scripting", "[PlaceholderParser]") {
     SECTION("nested config options (legacy syntax)") { REQUIRE(parser.process("[temperature_[foo]]") == "357"); }
     SECTION("array reference") { REQUIRE(parser.process("{temperature[foo]}") == "357"); }
     SECTION("whitespaces and newlines are maintained") { REQUIRE(parser.process("test [ temperature_ [foo] ] \n hu") == "test 357 \n hu"); }
+    SECTION("mixed text, variables and macros") {
+        const std::string templ = "T[bar] {bar}/[num_extruders] {bar*2} {if bar == 2}two{else}other{endif} {\"}\"}";
+        REQUIRE(parser.process(templ) == "T2 2/4 4 two }");
+        // The second call expands the cached compiled template.
+        REQUIRE(parser.process(templ) == "T2 2/4 4 two }");
+    }
+    SECTION("error in a compiled template") { REQUIRE_THROWS_AS(parser.process("[bar] {nonexistent_variable}"), Slic3r::PlaceholderParserError); }
 
     // Test the math expressions.
     SECTION("math: 2*3") { REQUIRE(parser.process("{2*3}") == "6"); }
@@ -2,6 +2,7 @@
 
 #include "libslic3r/Point.hpp"
 #include "libslic3r/Polygon.hpp"
+#include "libslic3r/CompactExPolygons.hpp"
 
 using namespace Slic3r;
 
@@ -148,3 +149,34 @@ SCENARIO("Remove collinear points from Polygon", "[Polygon]") {
         }
     }
 }
+
+SCENARIO("Compact storage of ExPolygons", "[Polygon]") {
+    GIVEN("Square with a hole and a triangle") {
+        ExPolygon square{ Polygon{ { 0, 0 }, { 1000, 0 }, { 1000, 1000 }, { 0, 1000 } } };
+        square.holes.emplace_back(Polygon{ { 250, 250 }, { 250, 750 }, { 750, 750 }, { 750, 250 } });
+        ExPolygon triangle{ Polygon{ { -5000, -5000 }, { -4000, -5000 }, { -4500, -4000 } } };
+        ExPolygons expolygons{ square, triangle };
+
+        WHEN("stored compactly") {
+            CompactExPolygons compact(expolygons);
+            THEN("the geometry decodes to the original") {
+                REQUIRE(compact.size() == 2);
+                REQUIRE(compact.polygons_count() == 3);
+                REQUIRE(compact.points_count() == 11);
+                REQUIRE(compact.bounding_box().min == Point(-5000, -5000));
+                REQUIRE(compact.bounding_box().max == Point(1000, 1000));
+                REQUIRE(compact.expolygons() == expolygons);
+                REQUIRE(compact.expolygon(1) == triangle);
+            }
+        }
+        WHEN("cleared") {
+            CompactExPolygons compact(expolygons);
+            compact.clear();
+            THEN("it is empty") {
+                REQUIRE(compact.empty());
+                REQUIRE(compact.size() == 0);
+                REQUIRE(compact.expolygons().empty());
+            }
+        }
+    }
+}
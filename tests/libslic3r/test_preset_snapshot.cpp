@@ -0,0 +1,259 @@
+#include <catch2/catch.hpp>
+
+#include "libslic3r/PresetBundle.hpp"
+#include "libslic3r/PresetSnapshot.hpp"
+#include "libslic3r/Utils.hpp"
+
+#include <algorithm>
+
+#include <boost/filesystem.hpp>
+#include <boost/nowide/fstream.hpp>
+
+using namespace Slic3r;
+
+static PresetSnapshot::Entry make_entry(Preset::Type type, const std::string &name)
+{
+    PresetSnapshot::Entry entry;
+    entry.type           = type;
+    entry.name           = name;
+    entry.file           = "/vendor/" + name + ".json";
+    entry.alias          = name + " alias";
+    entry.hold_alias     = true;
+    entry.description    = "Description of " + name;
+    entry.setting_id     = "GP" + name;
+    entry.filament_id    = "GF" + name;
+    entry.renamed_from   = { name + " old", name + " older" };
+    entry.options        = { { "layer_height", "0.16" }, { "wall_loops", "3" }, { "filament_settings_id", "" } };
+    entry.erased_options = { "compatible_printers_condition" };
+    return entry;
+}
+
+static void require_equal(const PresetSnapshot::Entry &lhs, const PresetSnapshot::Entry &rhs)
+{
+    REQUIRE(lhs.type == rhs.type);
+    REQUIRE(lhs.name == rhs.name);
+    REQUIRE(lhs.file == rhs.file);
+    REQUIRE(lhs.alias == rhs.alias);
+    REQUIRE(lhs.hold_alias == rhs.hold_alias);
+    REQUIRE(lhs.description == rhs.description);
+    REQUIRE(lhs.setting_id == rhs.setting_id);
+    REQUIRE(lhs.filament_id == rhs.filament_id);
+    REQUIRE(lhs.renamed_from == rhs.renamed_from);
+    REQUIRE(lhs.options == rhs.options);
+    REQUIRE(lhs.erased_options == rhs.erased_options);
+}
+
+static std::string read_file(const std::string &path)
+{
+    boost::nowide::ifstream ifs(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+}
+
+static void write_file(const std::string &path, const std::string &data)
+{
+    boost::nowide::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+    ofs.write(data.data(), data.size());
+}
+
+SCENARIO("Preset snapshot round trip", "[PresetSnapshot]") {
+    GIVEN("A snapshot of three presets saved to a file") {
+        const std::string file = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("preset-%%%%-%%%%.snapshot")).string();
+        const uint64_t    hash = 0x0123456789abcdefULL;
+        PresetSnapshot snapshot;
+        snapshot.entries.emplace_back(make_entry(Preset::TYPE_PRINT, "print"));
+        snapshot.entries.emplace_back(make_entry(Preset::TYPE_FILAMENT, "filament"));
+        snapshot.entries.emplace_back(make_entry(Preset::TYPE_PRINTER, "printer"));
+        snapshot.entries.back().hold_alias = false;
+        REQUIRE(snapshot.save(file, hash));
+
+        WHEN("it is loaded with the same source hash") {
+            PresetSnapshot loaded;
+            THEN("all the entries are restored") {
+                REQUIRE(loaded.load(file, hash));
+                REQUIRE(loaded.entries.size() == snapshot.entries.size());
+                for (size_t i = 0; i < snapshot.entries.size(); ++ i)
+                    require_equal(loaded.entries[i], snapshot.entries[i]);
+            }
+        }
+        WHEN("it is loaded with another source hash") {
+            PresetSnapshot loaded;
+            THEN("it is rejected") {
+                REQUIRE(! loaded.load(file, hash + 1));
+                REQUIRE(loaded.entries.empty());
+            }
+        }
+        WHEN("the file is truncated") {
+            const std::string data = read_file(file);
+            PresetSnapshot loaded;
+            THEN("every truncated length is rejected") {
+                for (size_t size : { size_t(0), size_t(4), size_t(20), data.size() / 2, data.size() - 1 }) {
+                    write_file(file, data.substr(0, size));
+                    REQUIRE(! loaded.load(file, hash));
+                    REQUIRE(loaded.entries.empty());
+                }
+            }
+        }
+        WHEN("the magic or a string length is corrupted") {
+            const std::string data = read_file(file);
+            PresetSnapshot loaded;
+            THEN("it is rejected") {
+                std::string corrupted = data;
+                corrupted[0] ^= 0x55;
+                write_file(file, corrupted);
+                REQUIRE(! loaded.load(file, hash));
+
+                // the length of the name of the first entry follows the magic, version, hash, entry count and type
+                corrupted = data;
+                corrupted[8 + 4 + 8 + 4 + 1 + 3] = char(0x7f);
+                write_file(file, corrupted);
+                REQUIRE(! loaded.load(file, hash));
+                REQUIRE(loaded.entries.empty());
+            }
+        }
+        WHEN("the file does not exist") {
+            boost::filesystem::remove(file);
+            PresetSnapshot loaded;
+            THEN("it is rejected") {
+                REQUIRE(! loaded.load(file, hash));
+            }
+        }
+        boost::system::error_code ec;
+        boost::filesystem::remove(file, ec);
+    }
+}
+
+TEST_CASE("Preset snapshot source hash", "[PresetSnapshot]") {
+    const boost::filesystem::path dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("vendor-%%%%-%%%%");
+    boost::filesystem::create_directories(dir / "Vendor");
+    write_file((dir / "Vendor.json").string(), "{}");
+    write_file((dir / "Vendor" / "print.json").string(), "{ \"name\": \"print\" }");
+
+    const uint64_t hash = PresetSnapshot::hash_sources(dir.string(), "Vendor", { "print.json" });
+    REQUIRE(hash == PresetSnapshot::hash_sources(dir.string(), "Vendor", { "print.json" }));
+    SECTION("a changed preset file changes the hash") {
+        write_file((dir / "Vendor" / "print.json").string(), "{ \"name\": \"print 2\" }");
+        REQUIRE(hash != PresetSnapshot::hash_sources(dir.string(), "Vendor", { "print.json" }));
+    }
+    SECTION("an edit keeping the size and the modification time changes the hash") {
+        const boost::filesystem::path print_file = dir / "Vendor" / "print.json";
+        const std::time_t             time       = boost::filesystem::last_write_time(print_file);
+        write_file(print_file.string(), "{ \"name\": \"PRINT\" }");
+        boost::filesystem::last_write_time(print_file, time);
+        REQUIRE(hash != PresetSnapshot::hash_sources(dir.string(), "Vendor", { "print.json" }));
+    }
+    SECTION("a missing preset file changes the hash") {
+        REQUIRE(hash != PresetSnapshot::hash_sources(dir.string(), "Vendor", { "print.json", "missing.json" }));
+    }
+    boost::system::error_code ec;
+    boost::filesystem::remove_all(dir, ec);
+}
+
+// A small vendor bundle with inherited presets of each type.
+static void write_vendor_bundle(const boost::filesystem::path &system_dir)
+{
+    const boost::filesystem::path vendor_dir = system_dir / "Vendor";
+    boost::filesystem::create_directories(vendor_dir / "machine");
+    boost::filesystem::create_directories(vendor_dir / "process");
+    boost::filesystem::create_directories(vendor_dir / "filament");
+    write_file((system_dir / "Vendor.json").string(), R"({
+    "name": "Vendor", "version": "01.00.00.00", "description": "Vendor configurations",
+    "machine_model_list": [ { "name": "Vendor Printer", "sub_path": "machine/Vendor Printer.json" } ],
+    "process_list": [ { "name": "process_common", "sub_path": "process/process_common.json" },
+                      { "name": "0.20mm Standard @Vendor", "sub_path": "process/0.20mm Standard @Vendor.json" } ],
+    "filament_list": [ { "name": "filament_common", "sub_path": "filament/filament_common.json" },
+                       { "name": "Generic PLA @Vendor", "sub_path": "filament/Generic PLA @Vendor.json" } ],
+    "machine_list": [ { "name": "machine_common", "sub_path": "machine/machine_common.json" },
+                      { "name": "Vendor Printer 0.4 nozzle", "sub_path": "machine/Vendor Printer 0.4 nozzle.json" } ]
+})");
+    write_file((vendor_dir / "machine" / "Vendor Printer.json").string(), R"({
+    "type": "machine_model", "name": "Vendor Printer", "model_id": "Vendor-Printer", "nozzle_diameter": "0.4",
+    "machine_tech": "FFF", "family": "Vendor", "default_materials": "Generic PLA @Vendor"
+})");
+    write_file((vendor_dir / "process" / "process_common.json").string(), R"({
+    "type": "process", "name": "process_common", "from": "system", "instantiation": "false",
+    "wall_loops": "3", "sparse_infill_density": "20%", "compatible_printers": []
+})");
+    write_file((vendor_dir / "process" / "0.20mm Standard @Vendor.json").string(), R"({
+    "type": "process", "setting_id": "GP_Vendor_001", "name": "0.20mm Standard @Vendor", "from": "system",
+    "inherits": "process_common", "instantiation": "true", "layer_height": "0.2", "description": "Standard quality",
+    "compatible_printers": [ "Vendor Printer 0.4 nozzle" ]
+})");
+    write_file((vendor_dir / "filament" / "filament_common.json").string(), R"({
+    "type": "filament", "name": "filament_common", "from": "system", "instantiation": "false",
+    "filament_type": [ "PLA" ], "nozzle_temperature": [ "220" ], "compatible_printers": []
+})");
+    write_file((vendor_dir / "filament" / "Generic PLA @Vendor.json").string(), R"({
+    "type": "filament", "filament_id": "GFL99", "setting_id": "GFSL99_Vendor_00", "name": "Generic PLA @Vendor", "from": "system",
+    "inherits": "filament_common", "instantiation": "true", "filament_flow_ratio": [ "0.98" ],
+    "compatible_printers": [ "Vendor Printer 0.4 nozzle" ]
+})");
+    write_file((vendor_dir / "machine" / "machine_common.json").string(), R"({
+    "type": "machine", "name": "machine_common", "from": "system", "instantiation": "false",
+    "printer_technology": "FFF", "nozzle_diameter": [ "0.4" ], "printable_height": "250"
+})");
+    write_file((vendor_dir / "machine" / "Vendor Printer 0.4 nozzle.json").string(), R"({
+    "type": "machine", "setting_id": "GM_Vendor_001", "name": "Vendor Printer 0.4 nozzle", "from": "system",
+    "inherits": "machine_common", "instantiation": "true", "printer_model": "Vendor Printer",
+    "default_print_profile": "0.20mm Standard @Vendor", "printable_area": [ "0x0", "220x0", "220x220", "0x220" ]
+})");
+}
+
+static void require_equal_presets(const PresetCollection &restored, const PresetCollection &loaded)
+{
+    size_t system_presets = 0;
+    for (const Preset &preset : loaded) {
+        if (! preset.is_system)
+            continue;
+        ++ system_presets;
+        INFO("Preset " << preset.name);
+        const Preset *other = restored.find_preset(preset.name, false);
+        REQUIRE(other != nullptr);
+        REQUIRE(other->is_system);
+        REQUIRE(other->file == preset.file);
+        REQUIRE(other->alias == preset.alias);
+        REQUIRE(other->description == preset.description);
+        REQUIRE(other->setting_id == preset.setting_id);
+        REQUIRE(other->filament_id == preset.filament_id);
+        REQUIRE(other->renamed_from == preset.renamed_from);
+        REQUIRE(other->version == preset.version);
+        REQUIRE(other->vendor != nullptr);
+        REQUIRE(other->vendor->name == preset.vendor->name);
+        REQUIRE(other->config == preset.config);
+    }
+    REQUIRE(system_presets > 0);
+    REQUIRE(size_t(std::count_if(restored.begin(), restored.end(), [](const Preset &preset) { return preset.is_system; })) == system_presets);
+}
+
+TEST_CASE("Presets restored from a snapshot equal the presets loaded from json", "[PresetSnapshot]") {
+    const std::string             old_data_dir = data_dir();
+    const boost::filesystem::path dir          = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("data-%%%%-%%%%");
+    const boost::filesystem::path system_dir   = dir / PRESET_SYSTEM_DIR;
+    // the snapshot is only used for the system bundles of the data directory
+    set_data_dir(dir.string());
+    ScopeGuard restore_data_dir([&old_data_dir, &dir]() {
+        set_data_dir(old_data_dir);
+        boost::system::error_code ec;
+        boost::filesystem::remove_all(dir, ec);
+    });
+    write_vendor_bundle(system_dir);
+
+    PresetBundle json_bundle;
+    const size_t json_loaded = json_bundle.load_vendor_configs_from_json(system_dir.string(), "Vendor", PresetBundle::LoadSystem,
+                                                                         ForwardCompatibilitySubstitutionRule::Disable).second;
+    REQUIRE(json_loaded > 0);
+
+    const std::string snapshot_file = PresetSnapshot::snapshot_file(system_dir.string(), "Vendor");
+    PresetSnapshot    snapshot;
+    REQUIRE(snapshot.load(snapshot_file, PresetSnapshot::hash_sources(system_dir.string(), "Vendor", {
+        "process/process_common.json", "process/0.20mm Standard @Vendor.json", "filament/filament_common.json",
+        "filament/Generic PLA @Vendor.json", "machine/machine_common.json", "machine/Vendor Printer 0.4 nozzle.json" })));
+    REQUIRE(snapshot.entries.size() == json_loaded);
+
+    PresetBundle snapshot_bundle;
+    const size_t snapshot_loaded = snapshot_bundle.load_vendor_configs_from_json(system_dir.string(), "Vendor", PresetBundle::LoadSystem,
+                                                                                 ForwardCompatibilitySubstitutionRule::Disable).second;
+    REQUIRE(snapshot_loaded == json_loaded);
+    require_equal_presets(snapshot_bundle.prints, json_bundle.prints);
+    require_equal_presets(snapshot_bundle.filaments, json_bundle.filaments);
+    require_equal_presets(snapshot_bundle.printers, json_bundle.printers);
+}
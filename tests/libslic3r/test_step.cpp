@@ -0,0 +1,81 @@
+#include <catch2/catch.hpp>
+
+#include "libslic3r/Format/STEP.hpp"
+
+#include <BRepMesh_IncrementalMesh.hxx>
+#include <BRepPrimAPI_MakeSphere.hxx>
+#include <BRep_Tool.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS.hxx>
+
+using namespace Slic3r;
+
+// Triangulation attached to the first face of the solid.
+static Handle(Poly_Triangulation) first_face_triangulation(const NamedSolid &named_solid)
+{
+    TopLoc_Location loc;
+    return BRep_Tool::Triangulation(TopoDS::Face(TopExp_Explorer(named_solid.solid, TopAbs_FACE).Current()), loc);
+}
+
+SCENARIO("STEP solid triangulations are reused", "[STEP]") {
+    GIVEN("A sphere solid") {
+        NamedSolid named_solid(BRepPrimAPI_MakeSphere(10.).Solid(), "sphere");
+        int  num_meshed = 0;
+        auto mesh_fn    = [&num_meshed](double linear_defletion, double angle_defletion) {
+            return [&num_meshed, linear_defletion, angle_defletion](const TopoDS_Shape &shape) {
+                ++ num_meshed;
+                BRepMesh_IncrementalMesh mesh(shape, linear_defletion, false, angle_defletion, true);
+                return true;
+            };
+        };
+        const int coarse = named_solid.tessellate(0.1, 0.5, mesh_fn(0.1, 0.5));
+        const Handle(Poly_Triangulation) coarse_triangulation = first_face_triangulation(named_solid);
+        REQUIRE(num_meshed == 1);
+        REQUIRE(coarse > 0);
+
+        WHEN("it is triangulated again with the same deflections") {
+            THEN("the cached triangulation is returned") {
+                REQUIRE(named_solid.tessellate(0.1, 0.5, mesh_fn(0.1, 0.5)) == coarse);
+                REQUIRE(num_meshed == 1);
+                REQUIRE(first_face_triangulation(named_solid) == coarse_triangulation);
+            }
+        }
+        WHEN("it is triangulated with finer deflections and then with the first ones") {
+            const int fine = named_solid.tessellate(0.01, 0.1, mesh_fn(0.01, 0.1));
+            THEN("the first triangulation is attached to the faces again") {
+                REQUIRE(num_meshed == 2);
+                REQUIRE(fine > coarse);
+                REQUIRE(first_face_triangulation(named_solid) != coarse_triangulation);
+                REQUIRE(named_solid.tessellate(0.1, 0.5, mesh_fn(0.1, 0.5)) == coarse);
+                REQUIRE(num_meshed == 2);
+                REQUIRE(first_face_triangulation(named_solid) == coarse_triangulation);
+            }
+        }
+        WHEN("it is triangulated with more deflections than are cached") {
+            for (size_t i = 1; i <= NamedSolid::max_tessellations; ++ i)
+                named_solid.tessellate(0.1 / double(i + 1), 0.5, mesh_fn(0.1 / double(i + 1), 0.5));
+            THEN("the least recently used triangulation is dropped") {
+                REQUIRE(named_solid.tessellations.size() == NamedSolid::max_tessellations);
+                REQUIRE(named_solid.tessellate(0.1, 0.5, mesh_fn(0.1, 0.5)) == coarse);
+                REQUIRE(num_meshed == int(NamedSolid::max_tessellations) + 2);
+            }
+        }
+        WHEN("the meshing is canceled") {
+            const int num_canceled = named_solid.tessellate(0.05, 0.5, [](const TopoDS_Shape &) { return false; });
+            THEN("nothing is cached") {
+                REQUIRE(num_canceled == 0);
+                REQUIRE(named_solid.tessellations.size() == 1);
+                named_solid.tessellate(0.05, 0.5, mesh_fn(0.05, 0.5));
+                REQUIRE(num_meshed == 2);
+            }
+        }
+        WHEN("the triangulations are cleared") {
+            named_solid.clear_tessellations();
+            THEN("the solid is triangulated again") {
+                REQUIRE(first_face_triangulation(named_solid).IsNull());
+                REQUIRE(named_solid.tessellate(0.1, 0.5, mesh_fn(0.1, 0.5)) == coarse);
+                REQUIRE(num_meshed == 2);
+            }
+        }
+    }
+}
@@ -3,6 +3,9 @@
 #include "libslic3r/Model.hpp"
 #include "libslic3r/Format/STL.hpp"
 
+#include <boost/filesystem.hpp>
+#include <boost/nowide/cstdio.hpp>
+
 using namespace Slic3r;
 
 static inline std::string stl_path(const char* path)
@@ -54,4 +57,32 @@ SCENARIO("Reading an STL file", "[stl]") {
 			}
 		}
 	}
+	GIVEN("ASCII STL with several solids and facets spread over more parse chunks") {
+		std::string path = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("stl-%%%%-%%%%.stl")).string();
+		FILE *f = boost::nowide::fopen(path.c_str(), "wb");
+		REQUIRE(f != nullptr);
+		fprintf(f, "solid first\n");
+		for (int i = 0; i < 1000; ++ i) {
+			if (i == 500)
+				fprintf(f, "endsolid first\nsolid second\n");
+			fprintf(f, "  facet normal nan 0 +1\n    outer loop\n");
+			fprintf(f, "      vertex %d 0 0\n      vertex +%d.5 1e0 0\n      vertex %d -1.0E+0 2\n", i, i, i);
+			fprintf(f, "    endloop\n  endfacet text after the tag\n");
+		}
+		fprintf(f, "endsolid second\n");
+		fclose(f);
+		WHEN("STL file is read") {
+			stl_file stl;
+			bool     loaded = stl_open(&stl, path.c_str());
+			boost::filesystem::remove(path);
+			THEN("all facets are read in the order of the file") {
+				REQUIRE(loaded);
+				REQUIRE(stl.stats.number_of_facets == 1000);
+				REQUIRE(stl.facet_start[999].vertex[1] == stl_vertex(999.5f, 1.f, 0.f));
+				REQUIRE((std::isnan(stl.facet_start[999].normal.x()) && stl.facet_start[999].normal.z() == 1.f));
+				REQUIRE(stl.stats.min == stl_vertex(0.f, -1.f, 0.f));
+				REQUIRE(stl.stats.max == stl_vertex(999.5f, 1.f, 2.f));
+			}
+		}
+	}
 }
@@ -0,0 +1,45 @@
+#include <catch2/catch.hpp>
+
+#include "libslic3r/ThreadLocalCache.hpp"
+
+#include <memory>
+
+using namespace Slic3r;
+
+TEST_CASE("Thread local LRU cache evicts the least recently used entry", "[ThreadLocalCache]") {
+    ThreadLocalLRUCache<int, int, 2> cache;
+    ThreadLocalCache::Use use;
+    cache.insert(1, 10);
+    cache.insert(2, 20);
+    REQUIRE(cache.find(1) != nullptr);
+    cache.insert(3, 30);
+    REQUIRE(cache.find(2) == nullptr);
+    REQUIRE(*cache.find(1) == 10);
+    REQUIRE(*cache.find(3) == 30);
+}
+
+TEST_CASE("Thread local caches are released by the last use only", "[ThreadLocalCache]") {
+    ThreadLocalLRUCache<int, int, 4> cache;
+    auto first_use = std::make_unique<ThreadLocalCache::Use>();
+    {
+        // Another print processed along the first one finishes first.
+        ThreadLocalCache::Use second_use;
+        cache.insert(1, 10);
+    }
+    REQUIRE(cache.find(1) != nullptr);
+    REQUIRE(*cache.find(1) == 10);
+    first_use.reset();
+    REQUIRE(cache.find(1) == nullptr);
+}
+
+TEST_CASE("Disabled thread local caches neither find nor store", "[ThreadLocalCache]") {
+    ThreadLocalLRUCache<int, int, 4> cache;
+    ThreadLocalCache::Use use;
+    cache.insert(1, 10);
+    ThreadLocalCache::set_enabled(false);
+    REQUIRE(cache.find(1) == nullptr);
+    cache.insert(2, 20);
+    ThreadLocalCache::set_enabled(true);
+    REQUIRE(cache.find(1) != nullptr);
+    REQUIRE(cache.find(2) == nullptr);
+}
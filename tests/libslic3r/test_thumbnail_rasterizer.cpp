@@ -0,0 +1,72 @@
+#include <catch2/catch.hpp>
+
+#include "libslic3r/GCode/ThumbnailRasterizer.hpp"
+#include "libslic3r/TriangleMesh.hpp"
+
+using namespace Slic3r;
+
+static const unsigned char* pixel(const ThumbnailData &thumbnail, unsigned int x, unsigned int y)
+{
+    return thumbnail.pixels.data() + (size_t(y) * thumbnail.width + x) * 4;
+}
+
+SCENARIO("Software rendering of thumbnails", "[Thumbnail]") {
+    GIVEN("A cube standing on the bed") {
+        const indexed_triangle_set cube = its_make_cube(20., 20., 20.);
+        ThumbnailRasterizer::Mesh mesh;
+        mesh.its         = &cube;
+        mesh.trafo       = Transform3d(Eigen::Translation3d(100., 100., 0.));
+        mesh.color       = { 0.f, 0.5f, 1.f, 1.f };
+        mesh.extruder_id = 3;
+        mesh.picking_id  = 0x030201;
+        ThumbnailRasterizer::Params params;
+
+        WHEN("rendered shaded from the iso view") {
+            ThumbnailData thumbnail;
+            ThumbnailRasterizer::render(thumbnail, 64, 64, { mesh }, params);
+            THEN("the cube fills the center and the background stays transparent") {
+                REQUIRE(thumbnail.is_valid());
+                REQUIRE(pixel(thumbnail, 32, 32)[3] == 255);
+                REQUIRE(pixel(thumbnail, 0, 0)[3] == 0);
+                REQUIRE(pixel(thumbnail, 63, 63)[3] == 0);
+            }
+            THEN("the lit faces are brighter than the filament color") {
+                REQUIRE(pixel(thumbnail, 32, 32)[2] > 128);
+            }
+        }
+        WHEN("rendered for picking") {
+            ThumbnailData thumbnail;
+            params.mode = ThumbnailRasterizer::Mode::Picking;
+            ThumbnailRasterizer::render(thumbnail, 64, 64, { mesh }, params);
+            THEN("the pixels encode the picking id") {
+                const unsigned char *center = pixel(thumbnail, 32, 32);
+                REQUIRE(center[0] == 1);
+                REQUIRE(center[1] == 2);
+                REQUIRE(center[2] == 3);
+                REQUIRE(center[3] == 255);
+            }
+        }
+        WHEN("rendered without light") {
+            ThumbnailData thumbnail;
+            params.mode = ThumbnailRasterizer::Mode::NoLight;
+            ThumbnailRasterizer::render(thumbnail, 64, 64, { mesh }, params);
+            THEN("the alpha channel encodes the extruder") {
+                REQUIRE(pixel(thumbnail, 32, 32)[3] == 253);
+            }
+        }
+        WHEN("the cube is below the bed") {
+            ThumbnailData thumbnail;
+            ThumbnailRasterizer::Mesh sunk = mesh;
+            sunk.trafo = Transform3d(Eigen::Translation3d(100., 100., -30.));
+            params.view       = ThumbnailRasterizer::View::TopPlate;
+            params.plate_box  = BoundingBoxf3(Vec3d(0., 0., 0.), Vec3d(256., 256., 256.));
+            ThumbnailRasterizer::render(thumbnail, 64, 64, { sunk }, params);
+            THEN("nothing is rendered") {
+                bool empty = true;
+                for (size_t i = 3; i < thumbnail.pixels.size(); i += 4)
+                    empty &= thumbnail.pixels[i] == 0;
+                REQUIRE(empty);
+            }
+        }
+    }
+}
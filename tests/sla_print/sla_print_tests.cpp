@@ -9,6 +9,13 @@
 #include <libslic3r/TriangleMeshSlicer.hpp>
 #include <libslic3r/SLA/SupportTreeMesher.hpp>
 #include <libslic3r/SLA/Concurrency.hpp>
+#include <libslic3r/Zipper.hpp>
+#include <libslic3r/miniz_extension.hpp>
+
+#include <atomic>
+#include <cstring>
+
+#include <boost/filesystem.hpp>
 
 namespace {
 
@@ -223,6 +230,134 @@ TEST_CASE("RasterizedPolygonAreaShouldMatch", "[SLARasterOutput]") {
 }
 
 
+static bool same_encoding(const sla::EncodedRaster &a, const sla::EncodedRaster &b)
+{
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size()) == 0;
+}
+
+TEST_CASE("ClearedRasterShouldEqualNewRaster", "[SLARasterOutput]") {
+    sla::Resolution res{256, 144};
+    sla::PixelDim   pixdim{12. / res.width_px, 6.8 / res.height_px};
+
+    sla::RasterGrayscaleAAGammaPower raster(res, pixdim, {}, 1.);
+    ExPolygon poly = square_with_hole(4.);
+    poly.translate(scaled(6.), scaled(3.4));
+    raster.draw(poly);
+    REQUIRE(raster_pxsum(raster) > 0);
+
+    // cleared through the interface used by SLAArchive to reuse the rasters
+    static_cast<sla::RasterBase &>(raster).clear();
+    REQUIRE(raster_pxsum(raster) == 0);
+
+    sla::RasterGrayscaleAAGammaPower fresh(res, pixdim, {}, 1.);
+    REQUIRE(same_encoding(raster.encode(sla::PNGRasterEncoder{}), fresh.encode(sla::PNGRasterEncoder{})));
+
+    raster.draw(poly);
+    fresh.draw(poly);
+    REQUIRE(same_encoding(raster.encode(sla::PNGRasterEncoder{}), fresh.encode(sla::PNGRasterEncoder{})));
+}
+
+TEST_CASE("ZipperEntryShouldUseItsOwnCompression", "[SLARasterOutput]") {
+    const std::string path = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("zipper-%%%%-%%%%.zip")).string();
+    const std::string data(10000, 'a');
+    {
+        Zipper zipper(path, Zipper::TIGHT_COMPRESSION);
+        zipper.add_entry("stored.txt", data.data(), data.size(), Zipper::NO_COMPRESSION);
+        zipper.add_entry("deflated.txt", data.data(), data.size());
+        zipper.finalize();
+    }
+
+    MZ_Archive zip;
+    REQUIRE(open_zip_reader(&zip.arch, path));
+    auto check_entry = [&zip, &data](const char *name, bool stored) {
+        const int idx = mz_zip_reader_locate_file(&zip.arch, name, nullptr, 0);
+        REQUIRE(idx >= 0);
+        mz_zip_archive_file_stat stat;
+        REQUIRE(mz_zip_reader_file_stat(&zip.arch, mz_uint(idx), &stat));
+        REQUIRE(stat.m_uncomp_size == data.size());
+        if (stored) {
+            REQUIRE(stat.m_method == 0);
+            REQUIRE(stat.m_comp_size == stat.m_uncomp_size);
+        } else {
+            REQUIRE(stat.m_method == MZ_DEFLATED);
+            REQUIRE(stat.m_comp_size < stat.m_uncomp_size);
+        }
+        size_t size = 0;
+        void  *buf  = mz_zip_reader_extract_to_heap(&zip.arch, mz_uint(idx), &size, 0);
+        REQUIRE(buf != nullptr);
+        REQUIRE(std::string(static_cast<const char *>(buf), size) == data);
+        mz_free(buf);
+    };
+    check_entry("stored.txt", true);
+    check_entry("deflated.txt", false);
+    close_zip_reader(&zip.arch);
+    boost::filesystem::remove(path);
+}
+
+namespace {
+
+class TestSLAArchive : public SLAArchive {
+    sla::Resolution m_res{256, 144};
+    sla::PixelDim   m_pixdim{12. / 256, 6.8 / 144};
+
+protected:
+    std::unique_ptr<sla::RasterBase> create_raster() const override { return sla::create_raster_grayscale_aa(m_res, m_pixdim); }
+    sla::RasterEncoder get_encoder() const override { return sla::PNGRasterEncoder{}; }
+
+public:
+    void apply(const SLAPrinterConfig &) override {}
+    const std::vector<sla::EncodedRaster> &layers() const { return m_layers; }
+};
+
+} // namespace
+
+TEST_CASE("StreamedLayersShouldEqualDrawnLayers", "[SLARasterOutput]") {
+    const size_t layer_num       = 50;
+    const size_t max_live_layers = 4;
+    auto drawfn = [](sla::RasterBase &raster, size_t idx) {
+        ExPolygon poly = square_with_hole(1. + 0.1 * double(idx));
+        poly.translate(scaled(6.), scaled(3.4));
+        raster.draw(poly);
+    };
+
+    TestSLAArchive archive;
+    archive.draw_layers(layer_num, drawfn, []() { return false; });
+    REQUIRE(archive.layers().size() == layer_num);
+
+    std::atomic<size_t> drawn{0};
+    std::atomic<size_t> written{0};
+    std::atomic<size_t> max_in_flight{0};
+    std::vector<size_t> order;
+    std::vector<bool>   same;
+    archive.stream_layers(
+        layer_num,
+        [&](sla::RasterBase &raster, size_t idx) {
+            const size_t in_flight = ++drawn - written;
+            for (size_t m = max_in_flight; in_flight > m && ! max_in_flight.compare_exchange_weak(m, in_flight);) ;
+            drawfn(raster, idx);
+        },
+        [&](size_t idx, sla::EncodedRaster &&rst) {
+            order.emplace_back(idx);
+            same.emplace_back(same_encoding(rst, archive.layers()[idx]));
+            ++written;
+        },
+        []() { return false; }, max_live_layers);
+
+    REQUIRE(order.size() == layer_num);
+    for (size_t i = 0; i < layer_num; ++i) {
+        REQUIRE(order[i] == i);
+        REQUIRE(same[i]);
+    }
+    REQUIRE(max_in_flight <= max_live_layers);
+
+    SECTION("Canceled streaming stops writing the layers") {
+        size_t count = 0;
+        archive.stream_layers(layer_num, drawfn, [&count](size_t, sla::EncodedRaster &&) { ++count; },
+                              [&count]() { return count >= 10; }, max_live_layers);
+        REQUIRE(count < layer_num);
+    }
+}
+
 TEST_CASE("halfcone test", "[halfcone]") {
     sla::DiffBridge br{Vec3d{1., 1., 1.}, Vec3d{10., 10., 10.}, 0.25, 0.5};
 